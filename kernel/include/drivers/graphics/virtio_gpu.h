@@ -45,15 +45,42 @@ enum CtrlType {
     RespErrInvalidParameter,
 };
 
-struct gpu_dev {
+typedef struct gpu_cursor_pos {
+    uint32_t scanout_id;
+    uint32_t x;
+    uint32_t y;
+    uint32_t padding;
+} gpu_cursor_pos_t;
+
+enum GpuQueue {
+    GpuControlQueue = 0,
+    GpuCursorQueue = 1,
+};
+
+struct gpu_queue {
     virtio_queue_desc_t queue_desc;
-    volatile virtio_mmio_registers_t* registers;
+    uint32_t id;
     uint32_t idx;
     uint32_t ack_used_idx;
+    uint32_t free_descs;
+};
+typedef struct gpu_queue gpu_queue_t;
+
+enum GpuResource {
+    GpuFirstFramebufferResource = 1,
+    GpuCursorResource = 3,
+};
+
+struct gpu_dev {
+    gpu_queue_t controlq;
+    gpu_queue_t cursorq;
+    volatile virtio_mmio_registers_t* registers;
     virtio_buffer_desc_t fb_desc;
+    virtio_buffer_desc_t cursor_desc;
     size_t width;
     size_t height;
     int current_fb;
+    gpu_cursor_pos_t cursor_pos;
 };
 typedef struct gpu_dev gpu_dev_t;
 
@@ -165,13 +192,6 @@ typedef struct gpu_detach_backing {
     uint32_t padding;
 } gpu_detach_backing_t;
 
-typedef struct gpu_cursor_pos {
-    uint32_t scanout_id;
-    uint32_t x;
-    uint32_t y;
-    uint32_t padding;
-} gpu_cursor_pos_t;
-
 typedef struct gpu_update_cursor {
     gpu_ctrl_header_t hdr;
     gpu_cursor_pos_t pos;
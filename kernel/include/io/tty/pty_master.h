@@ -16,6 +16,13 @@
 #define PTYS_COUNT 16
 #endif
 
+// Size of the buffer which holds output of the slave side until the master
+// reads it. Output of a program is read in one go, so the buffer bounds
+// how much a reader gets per syscall.
+#ifndef PTY_BUFFER_SIZE
+#define PTY_BUFFER_SIZE (64 * KB)
+#endif
+
 struct pty_slave_entry;
 struct pty_master_entry {
     sync_ringbuffer_t buffer;
@@ -0,0 +1,7 @@
+#ifndef _KERNEL_LIBKERN_BITS_FUTEX_H
+#define _KERNEL_LIBKERN_BITS_FUTEX_H
+
+#define FUTEX_WAIT 0
+#define FUTEX_WAKE 1
+
+#endif // _KERNEL_LIBKERN_BITS_FUTEX_H
@@ -0,0 +1,8 @@
+#ifndef _KERNEL_LIBKERN_BITS_SHARED_BUFFER_H
+#define _KERNEL_LIBKERN_BITS_SHARED_BUFFER_H
+
+// On creation, the buffer may be opened for reading only by everyone except
+// its owner. On opening, the buffer is mapped for reading only.
+#define SHBUF_READONLY 0x1
+
+#endif // _KERNEL_LIBKERN_BITS_SHARED_BUFFER_H
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef _KERNEL_LIBKERN_BITS_SYS_IOCTLS_H
 #define _KERNEL_LIBKERN_BITS_SYS_IOCTLS_H
 
+#include <libkern/types.h>
+
 /* TTY */
 #define TIOCGPGRP 0x0101
 #define TIOCSPGRP 0x0102
@@ -14,5 +16,43 @@
 #define BGA_GET_HEIGHT 0x0102
 #define BGA_GET_WIDTH 0x0103
 #define BGA_GET_SCALE 0x0104
+#define BGA_SWAP_BUFFERS_DAMAGED 0x0105
+#define BGA_SET_CURSOR 0x0106
+#define BGA_MOVE_CURSOR 0x0107
+
+#define BGA_MAX_DAMAGED_RECTS 32
+#define BGA_CURSOR_SIZE 64
+
+struct bga_rect {
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+};
+typedef struct bga_rect bga_rect_t;
+
+/* Shows the buffer, only the rects which changed since the buffer was shown last time are sent to the display. */
+struct bga_swap_damaged {
+    uint32_t buffer;
+    uint32_t rects_count;
+    bga_rect_t rects[BGA_MAX_DAMAGED_RECTS];
+};
+typedef struct bga_swap_damaged bga_swap_damaged_t;
+
+/* Sets the image of the cursor plane, no pixels hides the cursor. Pixels are in the format of the screen. */
+struct bga_cursor {
+    uint32_t width;
+    uint32_t height;
+    uint32_t hot_x;
+    uint32_t hot_y;
+    const uint32_t* pixels;
+};
+typedef struct bga_cursor bga_cursor_t;
+
+struct bga_cursor_pos {
+    uint32_t x;
+    uint32_t y;
+};
+typedef struct bga_cursor_pos bga_cursor_pos_t;
 
 #endif // _KERNEL_LIBKERN_BITS_SYS_IOCTLS_H
\ No newline at end of file
@@ -4,9 +4,10 @@
 #include <libkern/types.h>
 
 struct thread_create_params {
-    uint32_t entry_point;
-    uint32_t stack_start;
-    uint32_t stack_size;
+    uintptr_t entry_point;
+    uintptr_t stack_start;
+    uintptr_t stack_size;
+    uintptr_t arg; // Passed as the first argument to entry_point.
 };
 typedef struct thread_create_params thread_create_params_t;
 
@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef _KERNEL_LIBKERN_BITS_VDSO_H
+#define _KERNEL_LIBKERN_BITS_VDSO_H
+
+#include <libkern/types.h>
+
+#define VDSO_CYCLES_SHIFT 24
+
+/**
+ * The time page is maintained by the kernel and mapped read-only into
+ * every process. Readers use @seq as a seqlock: an odd value means that
+ * an update is in progress, a changed value means the read must be retried.
+ */
+struct vdso_time_data {
+    uint32_t seq;
+    uint32_t ticks_per_second;
+    uint32_t nsec_per_tick;
+    time_t secs_since_boot;
+    time_t secs_since_epoch;
+    time_t ticks_since_second;
+    uint64_t cycles_at_tick;
+    uint64_t cycles_per_tick;
+    uint64_t cycles_mult; // nsec per cycle << VDSO_CYCLES_SHIFT, 0 if no user-readable counter.
+};
+typedef struct vdso_time_data vdso_time_data_t;
+
+#endif // _KERNEL_LIBKERN_BITS_VDSO_H
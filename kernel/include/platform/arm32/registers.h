@@ -180,4 +180,13 @@ static inline void write_iciallu(uint32_t val)
     system_instruction_barrier();
 }
 
+// User read-only thread ID register.
+static inline void write_tpidruro(uint32_t val)
+{
+    asm volatile("mcr p15, 0, %0, c13, c0, 3"
+                 :
+                 : "r"(val)
+                 : "memory");
+}
+
 #endif /* _KERNEL_PLATFORM_ARM32_REGISTERS_H */
\ No newline at end of file
@@ -76,4 +76,13 @@ static inline void write_tpidr(uint64_t val)
     asm volatile("isb");
 }
 
+// EL0 read-only thread ID register.
+static inline void write_tpidrro_el0(uint64_t val)
+{
+    asm volatile("msr TPIDRRO_EL0, %x0"
+                 :
+                 : "r"(val)
+                 : "memory");
+}
+
 #endif /* _KERNEL_PLATFORM_ARM64_REGISTERS_H */
\ No newline at end of file
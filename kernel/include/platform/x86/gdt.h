@@ -19,7 +19,7 @@
 #define GDT_LONGMODE_FLAG 1
 #define GDT_DB_FLAG 0
 #else
-#define GDT_MAX_ENTRIES 6
+#define GDT_MAX_ENTRIES 7
 
 #define GDT_LONGMODE_FLAG 0
 #define GDT_DB_FLAG 1
@@ -28,9 +28,18 @@
 #define GDT_SEG_NULL 0 // kernel code
 #define GDT_SEG_KCODE 1 // kernel code
 #define GDT_SEG_KDATA 2 // kernel data+stack
+#ifdef __x86_64__
+// SYSRET expects user data to be followed by user code.
+#define GDT_SEG_UDATA 3 // user data+stack
+#define GDT_SEG_UCODE 4 // user code
+#else
 #define GDT_SEG_UCODE 3 // user code
 #define GDT_SEG_UDATA 4 // user data+stack
+#endif
 #define GDT_SEG_TSS 5 // task state NOT USED CURRENTLY
+#ifndef __x86_64__
+#define GDT_SEG_UTLS 6 // user thread pointer, selected by gs
+#endif
 
 #define GDT_SEGF_X 0x8 // exec
 #define GDT_SEGF_A 0x1 // accessed
@@ -118,6 +118,7 @@ static inline void tf_setup_as_user_thread(trapframe_t* tf)
     tf->ds = (GDT_SEG_UDATA << 3) | DPL_USER;
     tf->es = tf->ds;
     tf->ss = tf->ds;
+    tf->gs = (GDT_SEG_UTLS << 3) | DPL_USER;
     tf->eflags = FL_IF;
 }
 
@@ -91,6 +91,11 @@ extern void irq_empty_handler();
 
 extern void syscall();
 
+#ifdef __x86_64__
+extern void syscall_entry();
+void fast_syscall_setup();
+#endif
+
 #define IRQ0 32
 #define IRQ1 33
 #define IRQ2 34
@@ -70,4 +70,21 @@ static inline void write_cr0(uintptr_t val)
                  : "memory");
 }
 
+static inline uint64_t read_msr(uint32_t msr)
+{
+    uint32_t lo, hi;
+    asm volatile("rdmsr"
+                 : "=a"(lo), "=d"(hi)
+                 : "c"(msr));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static inline void write_msr(uint32_t msr, uint64_t val)
+{
+    asm volatile("wrmsr"
+                 :
+                 : "c"(msr), "a"((uint32_t)val), "d"((uint32_t)(val >> 32))
+                 : "memory");
+}
+
 #endif /* _KERNEL_PLATFORM_X86_REGISTERS_H */
\ No newline at end of file
@@ -61,6 +61,9 @@ void sys_ioctl(trapframe_t* tf);
 void sys_setpgid(trapframe_t* tf);
 void sys_getpgid(trapframe_t* tf);
 void sys_create_thread(trapframe_t* tf);
+void sys_pthread_exit(trapframe_t* tf);
+void sys_set_tls(trapframe_t* tf);
+void sys_futex(trapframe_t* tf);
 void sys_sleep(trapframe_t* tf);
 void sys_select(trapframe_t* tf);
 void sys_fstat(trapframe_t* tf);
@@ -75,6 +78,7 @@ void sys_shbuf_create(trapframe_t* tf);
 void sys_shbuf_get(trapframe_t* tf);
 void sys_shbuf_free(trapframe_t* tf);
 void sys_ptrace(trapframe_t* tf);
+void sys_vdso_get(trapframe_t* tf);
 
 void sys_none(trapframe_t* tf);
 
@@ -0,0 +1,25 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef _KERNEL_TASKING_FUTEX_H
+#define _KERNEL_TASKING_FUTEX_H
+
+#include <libkern/bits/futex.h>
+#include <libkern/bits/time.h>
+#include <libkern/types.h>
+
+#define FUTEX_WAKE_ALL (0x7fffffff)
+
+struct thread;
+
+int futex_init();
+int futex_wait(uint32_t __user* uaddr, uint32_t val, const timespec_t* timeout);
+int futex_wake(uint32_t __user* uaddr, int count);
+void futex_cancel_wait(struct thread* thread);
+
+#endif // _KERNEL_TASKING_FUTEX_H
@@ -82,6 +82,7 @@ int proc_free_locked(proc_t* p);
 
 struct thread* proc_alloc_thread();
 struct thread* proc_create_thread(proc_t* p);
+int proc_thread_die(proc_t* p, struct thread* thread);
 void proc_kill_all_threads(proc_t* p);
 void proc_kill_all_threads_except(proc_t* p, struct thread* gthread);
 
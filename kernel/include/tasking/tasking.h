@@ -34,6 +34,7 @@ proc_t* tasking_get_proc(pid_t pid);
  */
 
 void switch_uthreads(thread_t* p);
+void switch_thread_pointer(thread_t* thread);
 
 /**
  * TASK LOADING FUNCTIONS
@@ -62,6 +63,7 @@ pid_t tasking_get_proc_count();
 void tasking_fork();
 int tasking_exec(const char __user* path, const char __user** argv, const char __user** env);
 void tasking_exit(int exit_code);
+void tasking_exit_thread(uint32_t __user* clear_tid);
 int tasking_waitpid(int pid, int* status, int options);
 int tasking_signal(thread_t* thread, int signo);
 
@@ -44,6 +44,7 @@ enum BLOCKER_REASON {
     BLOCKER_SELECT,
     BLOCKER_DUMPING,
     BLOCKER_STOP, // Just waiting for signal which will continue the thread.
+    BLOCKER_FUTEX,
 };
 
 struct blocker_join {
@@ -73,6 +74,19 @@ struct blocker_select {
 };
 typedef struct blocker_select blocker_select_t;
 
+struct vm_address_space;
+struct blocker_futex {
+    struct vm_address_space* vm_aspace;
+    uintptr_t uaddr;
+    bool woken;
+
+    bool is_until_time_set;
+    timespec_t until;
+
+    struct thread* next; // Next waiter in the futex hash bucket.
+};
+typedef struct blocker_futex blocker_futex_t;
+
 struct proc;
 struct thread {
     struct proc* process;
@@ -83,6 +97,7 @@ struct thread {
     kmemzone_t kstack;
     context_t* context; // context of kernel's registers
     trapframe_t* tf;
+    uintptr_t tls; // User thread pointer, see thread_set_tls().
 #ifdef FPU_ENABLED
     fpu_state_t* fpu_state;
 #endif
@@ -101,6 +116,7 @@ struct thread {
         blocker_rw_t rw;
         blocker_sleep_t sleep;
         blocker_select_t select;
+        blocker_futex_t futex;
     } blocker_data;
 
     /* Stat data */
@@ -137,6 +153,7 @@ int thread_setup_main(struct proc* p, thread_t* thread);
 int thread_setup(struct proc* p, thread_t* thread);
 int thread_setup_kstack(thread_t* thread);
 int thread_copy_of(thread_t* thread, thread_t* from_thread);
+void thread_set_tls(thread_t* thread, uintptr_t tls);
 
 int thread_fill_up_stack(thread_t* thread, int argc, char** argv, int envc, char** envp);
 
@@ -162,6 +179,7 @@ int init_read_blocker(thread_t* thread, file_descriptor_t* bfd);
 int init_write_blocker(thread_t* thread, file_descriptor_t* bfd);
 int init_sleep_blocker(thread_t* thread, timespec_t ts);
 int init_select_blocker(thread_t* thread, int nfds, fd_set_t* readfds, fd_set_t* writefds, fd_set_t* exceptfds, timeval_t* timeout);
+int init_futex_blocker(thread_t* thread, const timespec_t* until);
 
 /**
  * DEBUG FUNCTIONS
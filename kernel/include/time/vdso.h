@@ -0,0 +1,19 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef _KERNEL_TIME_VDSO_H
+#define _KERNEL_TIME_VDSO_H
+
+#include <libkern/bits/vdso.h>
+#include <libkern/types.h>
+
+int vdso_init();
+void vdso_update_time();
+uintptr_t vdso_user_time_data();
+
+#endif // _KERNEL_TIME_VDSO_H
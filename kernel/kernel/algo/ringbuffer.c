@@ -49,11 +49,13 @@ ssize_t ringbuffer_space_to_read(ringbuffer_t* buf)
 
 ssize_t ringbuffer_space_to_write(ringbuffer_t* buf)
 {
+    // One byte is always kept free, otherwise a full buffer would have
+    // start == end and look empty.
     size_t res = buf->zone.len - buf->end + buf->start;
     if (buf->start > buf->end) {
         res = buf->start - buf->end;
     }
-    return res;
+    return res - 1;
 }
 
 /**
@@ -147,6 +149,7 @@ size_t ringbuffer_read_user(ringbuffer_t* rbuf, uint8_t __user* buf, size_t siz)
 size_t ringbuffer_write(ringbuffer_t* rbuf, const uint8_t* buf, size_t siz)
 {
     size_t i = 0;
+    siz = min(siz, (size_t)ringbuffer_space_to_write(rbuf));
     if (rbuf->end >= rbuf->start) {
         size_t todo = min(siz - i, rbuf->zone.len - rbuf->end);
         memcpy(&rbuf->zone.ptr[rbuf->end], &buf[i], todo);
@@ -167,6 +170,7 @@ size_t ringbuffer_write(ringbuffer_t* rbuf, const uint8_t* buf, size_t siz)
 size_t ringbuffer_write_user(ringbuffer_t* rbuf, const uint8_t __user* buf, size_t siz)
 {
     size_t i = 0;
+    siz = min(siz, (size_t)ringbuffer_space_to_write(rbuf));
     if (rbuf->end >= rbuf->start) {
         size_t todo = min(siz - i, rbuf->zone.len - rbuf->end);
         umem_copy_from_user(&rbuf->zone.ptr[rbuf->end], &buf[i], todo);
@@ -16,9 +16,11 @@
 #include <libkern/libkern.h>
 #include <libkern/log.h>
 #include <libkern/types.h>
+#include <libkern/umem.h>
 #include <mem/kmalloc.h>
 #include <mem/kmemzone.h>
 #include <mem/vmm.h>
+#include <platform/generic/system.h>
 #include <tasking/tasking.h>
 
 // #define DEBUG_VIRTIO_GPU
@@ -26,26 +28,29 @@
 static int gpus_count = 0;
 static gpu_dev_t gpu_dev;
 
-#define ADD_TO_QUEUE(dev, wt)                     \
-    dev.queue_desc.descs->entities[dev.idx] = wt; \
-    dev.idx = (dev.idx + 1) % VIRTIO_RING_SIZE
+#define ADD_TO_QUEUE(queue, wt)                            \
+    (queue)->queue_desc.descs->entities[(queue)->idx] = wt; \
+    (queue)->idx = ((queue)->idx + 1) % VIRTIO_RING_SIZE;   \
+    (queue)->free_descs--
 
-#define SET_AS_AVAIL(dev, hd)                                                      \
-    dev.queue_desc.avail->ring[dev.queue_desc.avail->idx % VIRTIO_RING_SIZE] = hd; \
-    dev.queue_desc.avail->idx++
+#define SET_AS_AVAIL(queue, hd)                                                                     \
+    (queue)->queue_desc.avail->ring[(queue)->queue_desc.avail->idx % VIRTIO_RING_SIZE] = hd; \
+    (queue)->queue_desc.avail->idx++
 
-#define PUSH_REQUEST(req, resp)                                 \
+#define PUSH_REQUEST(queue, req, resp)                          \
     virtio_alloc_result_t alloc_result;                         \
     int err = virtio_alloc_request(&req, &resp, &alloc_result); \
     if (err) {                                                  \
         log_warn("Error in virtio_alloc_request");              \
         return err;                                             \
     }                                                           \
+    system_disable_interrupts();                                \
+    _virtiogpu_queue_reserve(queue, 2);                         \
     virtio_desc_t desc_sso = {                                  \
         .addr = (uintptr_t)alloc_result.req_paddr,              \
         .len = sizeof(req),                                     \
         .flags = VIRTIO_DESC_F_NEXT,                            \
-        .next = (gpu_dev.idx + 1) % VIRTIO_RING_SIZE,           \
+        .next = ((queue)->idx + 1) % VIRTIO_RING_SIZE,          \
     };                                                          \
     virtio_desc_t desc_sso_resp = {                             \
         .addr = (uintptr_t)alloc_result.resp_paddr,             \
@@ -53,29 +58,32 @@ static gpu_dev_t gpu_dev;
         .flags = VIRTIO_DESC_F_WRITE,                           \
         .next = 0,                                              \
     };                                                          \
-    uint32_t head = gpu_dev.idx;                                \
-    ADD_TO_QUEUE(gpu_dev, desc_sso);                            \
-    ADD_TO_QUEUE(gpu_dev, desc_sso_resp);                       \
-    SET_AS_AVAIL(gpu_dev, head)
+    uint32_t head = (queue)->idx;                               \
+    ADD_TO_QUEUE(queue, desc_sso);                              \
+    ADD_TO_QUEUE(queue, desc_sso_resp);                         \
+    SET_AS_AVAIL(queue, head);                                  \
+    system_enable_interrupts()
 
-#define PUSH_MEM_REQUEST(req, mem, resp)                                  \
+#define PUSH_MEM_REQUEST(queue, req, mem, resp)                           \
     virtio_alloc_result_t alloc_result;                                   \
     int err = virtio_alloc_mem_request(&req, &mem, &resp, &alloc_result); \
     if (err) {                                                            \
         log_warn("Error in virtio_alloc_mem_request");                    \
         return err;                                                       \
     }                                                                     \
+    system_disable_interrupts();                                          \
+    _virtiogpu_queue_reserve(queue, 3);                                   \
     virtio_desc_t desc_ab = {                                             \
         .addr = (uintptr_t)alloc_result.req_paddr,                        \
         .len = sizeof(req),                                               \
         .flags = VIRTIO_DESC_F_NEXT,                                      \
-        .next = (gpu_dev.idx + 1) % VIRTIO_RING_SIZE,                     \
+        .next = ((queue)->idx + 1) % VIRTIO_RING_SIZE,                    \
     };                                                                    \
     virtio_desc_t desc_ab_mementry = {                                    \
         .addr = (uintptr_t)alloc_result.mem_paddr,                        \
         .len = sizeof(mem),                                               \
         .flags = VIRTIO_DESC_F_NEXT,                                      \
-        .next = (gpu_dev.idx + 2) % VIRTIO_RING_SIZE,                     \
+        .next = ((queue)->idx + 2) % VIRTIO_RING_SIZE,                    \
     };                                                                    \
     virtio_desc_t desc_ab_resp = {                                        \
         .addr = (uintptr_t)alloc_result.resp_paddr,                       \
@@ -83,13 +91,82 @@ static gpu_dev_t gpu_dev;
         .flags = VIRTIO_DESC_F_WRITE,                                     \
         .next = 0,                                                        \
     };                                                                    \
-    uint32_t head = gpu_dev.idx;                                          \
-    ADD_TO_QUEUE(gpu_dev, desc_ab);                                       \
-    ADD_TO_QUEUE(gpu_dev, desc_ab_mementry);                              \
-    ADD_TO_QUEUE(gpu_dev, desc_ab_resp);                                  \
-    SET_AS_AVAIL(gpu_dev, head)
+    uint32_t head = (queue)->idx;                                         \
+    ADD_TO_QUEUE(queue, desc_ab);                                         \
+    ADD_TO_QUEUE(queue, desc_ab_mementry);                                \
+    ADD_TO_QUEUE(queue, desc_ab_resp);                                    \
+    SET_AS_AVAIL(queue, head);                                            \
+    system_enable_interrupts()
+
+// Cursor commands have no response.
+#define PUSH_CURSOR_REQUEST(queue, req)                       \
+    virtio_alloc_result_t alloc_result;                       \
+    int err = virtio_alloc_raw(&req, &alloc_result);          \
+    if (err) {                                                \
+        log_warn("Error in virtio_alloc_raw");                \
+        return err;                                           \
+    }                                                         \
+    system_disable_interrupts();                              \
+    _virtiogpu_queue_reserve(queue, 1);                       \
+    virtio_desc_t desc_cursor = {                             \
+        .addr = (uintptr_t)alloc_result.req_paddr,            \
+        .len = sizeof(req),                                   \
+        .flags = 0,                                           \
+        .next = 0,                                            \
+    };                                                        \
+    uint32_t head = (queue)->idx;                             \
+    ADD_TO_QUEUE(queue, desc_cursor);                         \
+    SET_AS_AVAIL(queue, head);                                \
+    system_enable_interrupts()
+
+// Returns descriptors of the completed requests to the queue. Must be
+// called with interrupts disabled.
+static void _virtiogpu_queue_reclaim(gpu_queue_t* queue)
+{
+    volatile uint16_t* used_idx = &queue->queue_desc.used->idx;
+    while (queue->ack_used_idx != *used_idx) {
+        int id = queue->queue_desc.used->ring[queue->ack_used_idx % VIRTIO_RING_SIZE].id;
+        virtio_free_paddr((void*)(uintptr_t)queue->queue_desc.descs->entities[id].addr);
+        for (;;) {
+            queue->free_descs++;
+            if (!TEST_FLAG(queue->queue_desc.descs->entities[id].flags, VIRTIO_DESC_F_NEXT)) {
+                break;
+            }
+            id = queue->queue_desc.descs->entities[id].next;
+        }
+        queue->ack_used_idx++;
+    }
+}
+
+// Requests are completed asynchronously, so the ring could be full of
+// requests in flight. In this case the device is kicked and polled until
+// it frees enough descriptors. Must be called with interrupts disabled.
+static void _virtiogpu_queue_reserve(gpu_queue_t* queue, uint32_t count)
+{
+    _virtiogpu_queue_reclaim(queue);
+    if (queue->free_descs >= count) {
+        return;
+    }
+
+    gpu_dev.registers->queue_notify = queue->id;
+    while (queue->free_descs < count) {
+        _virtiogpu_queue_reclaim(queue);
+    }
+}
+
+static void _virtiogpu_queue_notify(gpu_queue_t* queue)
+{
+    gpu_dev.registers->queue_notify = queue->id;
+}
+
+static void _virtiogpu_queue_wait_idle(gpu_queue_t* queue)
+{
+    system_disable_interrupts();
+    _virtiogpu_queue_reserve(queue, VIRTIO_RING_SIZE);
+    system_enable_interrupts();
+}
 
-static int _virtiogpu_dev_create_2d(int bind_resource_id)
+static int _virtiogpu_dev_create_2d(int bind_resource_id, uint32_t width, uint32_t height)
 {
     gpu_resource_create_2d_t req = {
         .hdr = {
@@ -101,15 +178,15 @@ static int _virtiogpu_dev_create_2d(int bind_resource_id)
         },
         .resource_id = bind_resource_id,
         .format = GPU_FORMAT_R8G8B8A8Unorm,
-        .width = gpu_dev.width,
-        .height = gpu_dev.height,
+        .width = width,
+        .height = height,
     };
     gpu_ctrl_header_t resp = {};
-    PUSH_REQUEST(req, resp);
+    PUSH_REQUEST(&gpu_dev.controlq, req, resp);
     return 0;
 }
 
-static int _virtiogpu_dev_attach_backing(int bind_resource_id, uint64_t framebuffer_addr)
+static int _virtiogpu_dev_attach_backing(int bind_resource_id, uint64_t backing_addr, uint32_t backing_len)
 {
     gpu_attach_backing_t req = {
         .hdr = {
@@ -123,12 +200,12 @@ static int _virtiogpu_dev_attach_backing(int bind_resource_id, uint64_t framebuf
         .nr_entries = 1,
     };
     gpu_mem_entry_t mem = {
-        .addr = framebuffer_addr,
-        .length = gpu_dev.width * gpu_dev.height * 4,
+        .addr = backing_addr,
+        .length = backing_len,
         .padding = 0,
     };
     gpu_ctrl_header_t resp = {};
-    PUSH_MEM_REQUEST(req, mem, resp);
+    PUSH_MEM_REQUEST(&gpu_dev.controlq, req, mem, resp);
     return 0;
 }
 
@@ -152,11 +229,11 @@ static int _virtiogpu_dev_set_scanout(int bind_resource_id)
         .scanout_id = 0,
     };
     gpu_ctrl_header_t resp = {};
-    PUSH_REQUEST(req, resp);
+    PUSH_REQUEST(&gpu_dev.controlq, req, resp);
     return 0;
 }
 
-static int _virtiogpu_dev_transfer_to_host_2d(int bind_resource_id)
+static int _virtiogpu_dev_transfer_to_host_2d(int bind_resource_id, gpu_rect_t r, uint32_t stride)
 {
     gpu_transfer_to_host_2d_t req = {
         .hdr = {
@@ -166,22 +243,17 @@ static int _virtiogpu_dev_transfer_to_host_2d(int bind_resource_id)
             .ctx_id = 0,
             .padding = 0,
         },
-        .r = {
-            .x = 0,
-            .y = 0,
-            .width = gpu_dev.width,
-            .height = gpu_dev.height,
-        },
-        .offset = 0,
+        .r = r,
+        .offset = ((uint64_t)r.y * stride + r.x) * 4,
         .resource_id = bind_resource_id,
         .padding = 0,
     };
     gpu_ctrl_header_t resp = {};
-    PUSH_REQUEST(req, resp);
+    PUSH_REQUEST(&gpu_dev.controlq, req, resp);
     return 0;
 }
 
-static int _virtiogpu_dev_resource_flush(int bind_resource_id)
+static int _virtiogpu_dev_resource_flush(int bind_resource_id, gpu_rect_t r)
 {
     gpu_resource_flush_t req = {
         .hdr = {
@@ -191,53 +263,200 @@ static int _virtiogpu_dev_resource_flush(int bind_resource_id)
             .ctx_id = 0,
             .padding = 0,
         },
-        .r = {
-            .x = 0,
-            .y = 0,
-            .width = gpu_dev.width,
-            .height = gpu_dev.height,
-        },
+        .r = r,
         .resource_id = bind_resource_id,
         .padding = 0,
     };
     gpu_ctrl_header_t resp = {};
-    PUSH_REQUEST(req, resp);
+    PUSH_REQUEST(&gpu_dev.controlq, req, resp);
+    return 0;
+}
+
+static int _virtiogpu_dev_update_cursor(int bind_resource_id, uint32_t hot_x, uint32_t hot_y)
+{
+    gpu_update_cursor_t req = {
+        .hdr = {
+            .ctrl_type = CmdUpdateCursor,
+            .flags = 0,
+            .fence_id = 0,
+            .ctx_id = 0,
+            .padding = 0,
+        },
+        .pos = gpu_dev.cursor_pos,
+        .resource_id = bind_resource_id,
+        .hot_x = hot_x,
+        .hot_y = hot_y,
+        .padding = 0,
+    };
+    PUSH_CURSOR_REQUEST(&gpu_dev.cursorq, req);
     return 0;
 }
 
+static int _virtiogpu_dev_move_cursor()
+{
+    gpu_update_cursor_t req = {
+        .hdr = {
+            .ctrl_type = CmdMoveCursor,
+            .flags = 0,
+            .fence_id = 0,
+            .ctx_id = 0,
+            .padding = 0,
+        },
+        .pos = gpu_dev.cursor_pos,
+        .resource_id = 0,
+        .hot_x = 0,
+        .hot_y = 0,
+        .padding = 0,
+    };
+    PUSH_CURSOR_REQUEST(&gpu_dev.cursorq, req);
+    return 0;
+}
+
+static inline gpu_rect_t _virtiogpu_screen_rect()
+{
+    gpu_rect_t r = {
+        .x = 0,
+        .y = 0,
+        .width = gpu_dev.width,
+        .height = gpu_dev.height,
+    };
+    return r;
+}
+
 static void _virtiogpu_dev_init()
 {
-    _virtiogpu_dev_create_2d(1);
-    _virtiogpu_dev_attach_backing(1, gpu_dev.fb_desc.paddr);
+    size_t fb_size = gpu_dev.width * gpu_dev.height * 4;
+    _virtiogpu_dev_create_2d(GpuFirstFramebufferResource, gpu_dev.width, gpu_dev.height);
+    _virtiogpu_dev_attach_backing(GpuFirstFramebufferResource, gpu_dev.fb_desc.paddr, fb_size);
+
+    _virtiogpu_dev_create_2d(GpuFirstFramebufferResource + 1, gpu_dev.width, gpu_dev.height);
+    _virtiogpu_dev_attach_backing(GpuFirstFramebufferResource + 1, gpu_dev.fb_desc.paddr + fb_size, fb_size);
+
+    _virtiogpu_dev_create_2d(GpuCursorResource, BGA_CURSOR_SIZE, BGA_CURSOR_SIZE);
+    _virtiogpu_dev_attach_backing(GpuCursorResource, gpu_dev.cursor_desc.paddr, BGA_CURSOR_SIZE * BGA_CURSOR_SIZE * 4);
+
+    _virtiogpu_dev_transfer_to_host_2d(GpuFirstFramebufferResource, _virtiogpu_screen_rect(), gpu_dev.width);
+    _virtiogpu_dev_set_scanout(GpuFirstFramebufferResource);
+    _virtiogpu_dev_resource_flush(GpuFirstFramebufferResource, _virtiogpu_screen_rect());
+
+    _virtiogpu_queue_notify(&gpu_dev.controlq);
+}
+
+static bool _virtiogpu_clip_rect(const bga_rect_t* rect, gpu_rect_t* res)
+{
+    if (rect->x >= gpu_dev.width || rect->y >= gpu_dev.height) {
+        return false;
+    }
 
-    _virtiogpu_dev_create_2d(2);
-    _virtiogpu_dev_attach_backing(2, gpu_dev.fb_desc.paddr + gpu_dev.width * gpu_dev.height * 4);
+    res->x = rect->x;
+    res->y = rect->y;
+    res->width = min(rect->width, gpu_dev.width - rect->x);
+    res->height = min(rect->height, gpu_dev.height - rect->y);
+    return res->width && res->height;
+}
 
-    _virtiogpu_dev_set_scanout(1);
-    _virtiogpu_dev_transfer_to_host_2d(1);
+// Only damaged rects are transferred to the host copy of the buffer, which
+// is shown after that. Requests are not waited for, descriptors are freed
+// by the interrupt handler.
+static void _virtiogpu_flip_screen(int fb, const bga_rect_t* rects, size_t rects_count)
+{
+    int resource_id = GpuFirstFramebufferResource + fb;
+    for (size_t i = 0; i < rects_count; i++) {
+        gpu_rect_t r;
+        if (_virtiogpu_clip_rect(&rects[i], &r)) {
+            _virtiogpu_dev_transfer_to_host_2d(resource_id, r, gpu_dev.width);
+        }
+    }
 
-    _virtiogpu_dev_resource_flush(1);
+    if (gpu_dev.current_fb != fb) {
+        _virtiogpu_dev_set_scanout(resource_id);
+        gpu_dev.current_fb = fb;
+    }
 
-    gpu_dev.registers->queue_notify = 0;
+    for (size_t i = 0; i < rects_count; i++) {
+        gpu_rect_t r;
+        if (_virtiogpu_clip_rect(&rects[i], &r)) {
+            _virtiogpu_dev_resource_flush(resource_id, r);
+        }
+    }
+    _virtiogpu_queue_notify(&gpu_dev.controlq);
 }
 
-static int __res = 1;
-static void _virtiogpu_flip_screen()
+static int _virtiogpu_set_cursor(const bga_cursor_t* cursor)
 {
-    _virtiogpu_dev_set_scanout(1 + gpu_dev.current_fb);
-    _virtiogpu_dev_transfer_to_host_2d(1 + gpu_dev.current_fb);
-    _virtiogpu_dev_resource_flush(1 + gpu_dev.current_fb);
-    gpu_dev.registers->queue_notify = 0;
-    gpu_dev.current_fb = 1 - gpu_dev.current_fb;
+    if (!cursor->pixels) {
+        _virtiogpu_dev_update_cursor(0, 0, 0);
+        _virtiogpu_queue_notify(&gpu_dev.cursorq);
+        return 0;
+    }
+
+    if (cursor->width > BGA_CURSOR_SIZE || cursor->height > BGA_CURSOR_SIZE) {
+        return -EINVAL;
+    }
+
+    // The image must reach the host before the cursor queue refers to it.
+    _virtiogpu_queue_wait_idle(&gpu_dev.controlq);
+
+    uint32_t* image = (uint32_t*)gpu_dev.cursor_desc.ptr;
+    memset(image, 0, BGA_CURSOR_SIZE * BGA_CURSOR_SIZE * 4);
+    for (uint32_t y = 0; y < cursor->height; y++) {
+        umem_copy_from_user(&image[y * BGA_CURSOR_SIZE], &cursor->pixels[y * cursor->width], cursor->width * 4);
+    }
+
+    gpu_rect_t r = {
+        .x = 0,
+        .y = 0,
+        .width = BGA_CURSOR_SIZE,
+        .height = BGA_CURSOR_SIZE,
+    };
+    _virtiogpu_dev_transfer_to_host_2d(GpuCursorResource, r, BGA_CURSOR_SIZE);
+    _virtiogpu_queue_wait_idle(&gpu_dev.controlq);
+
+    _virtiogpu_dev_update_cursor(GpuCursorResource, cursor->hot_x, cursor->hot_y);
+    _virtiogpu_queue_notify(&gpu_dev.cursorq);
+    return 0;
+}
+
+static int _virtiogpu_move_cursor(uint32_t x, uint32_t y)
+{
+    gpu_dev.cursor_pos.x = x;
+    gpu_dev.cursor_pos.y = y;
+    _virtiogpu_dev_move_cursor();
+    _virtiogpu_queue_notify(&gpu_dev.cursorq);
+    return 0;
 }
 
 void virtiogpu_int_handler(irq_line_t line)
 {
-    while (gpu_dev.ack_used_idx != gpu_dev.queue_desc.used->idx) {
-        int id = gpu_dev.queue_desc.used->ring[gpu_dev.ack_used_idx % VIRTIO_RING_SIZE].id;
-        virtio_free_paddr((void*)(uintptr_t)gpu_dev.queue_desc.descs->entities[id].addr);
-        gpu_dev.ack_used_idx++;
+    _virtiogpu_queue_reclaim(&gpu_dev.controlq);
+    _virtiogpu_queue_reclaim(&gpu_dev.cursorq);
+}
+
+static int _virtiogpu_init_queue(volatile virtio_mmio_registers_t* registers, uint32_t id, gpu_queue_t* result)
+{
+    registers->queue_sel = id;
+    uint32_t qnmax = registers->queue_num_max;
+    registers->queue_num = VIRTIO_RING_SIZE;
+    if (VIRTIO_RING_SIZE > qnmax) {
+#ifdef DEBUG_VIRTIO_GPU
+        log("VIRTIO_GPU: Ring cannot be inited.");
+#endif
+        return 1;
     }
+
+    int err = virtio_alloc_queue(&result->queue_desc);
+    if (err) {
+        return err;
+    }
+
+    registers->guest_page_size = VMM_PAGE_SIZE;
+    registers->queue_pfn = result->queue_desc.paddr / VMM_PAGE_SIZE;
+
+    result->id = id;
+    result->idx = 0;
+    result->ack_used_idx = 0;
+    result->free_descs = VIRTIO_RING_SIZE;
+    return 0;
 }
 
 int virtiogpu_init(device_t* dev)
@@ -273,25 +492,16 @@ int virtiogpu_init(device_t* dev)
         return 1;
     }
 
-    uint32_t qnmax = registers->queue_num_max;
-    registers->queue_num = VIRTIO_RING_SIZE;
-    if (VIRTIO_RING_SIZE > qnmax) {
-#ifdef DEBUG_VIRTIO_GPU
-        log("VIRTIO_GPU: Ring cannot be inited.");
-#endif
-        return 1;
+    int err = _virtiogpu_init_queue(registers, GpuControlQueue, &gpu_dev.controlq);
+    if (err) {
+        return err;
     }
 
-    virtio_queue_desc_t queue;
-    int err = virtio_alloc_queue(&queue);
+    err = _virtiogpu_init_queue(registers, GpuCursorQueue, &gpu_dev.cursorq);
     if (err) {
         return err;
     }
 
-    registers->queue_sel = 0;
-    registers->guest_page_size = VMM_PAGE_SIZE;
-    registers->queue_pfn = queue.paddr / VMM_PAGE_SIZE;
-
     status_bits |= VIRTIO_STATUS_DRIVER_OK;
     registers->status = status_bits;
 
@@ -310,14 +520,20 @@ int virtiogpu_init(device_t* dev)
         return err;
     }
 
-    gpu_dev.queue_desc = queue;
+    size_t cursor_alloc_size = ROUND_CEIL(BGA_CURSOR_SIZE * BGA_CURSOR_SIZE * 4, VMM_PAGE_SIZE);
+    virtio_buffer_desc_t cursor_buffer;
+    err = virtio_alloc_buffer(cursor_alloc_size, &cursor_buffer);
+    if (err) {
+        return err;
+    }
+
     gpu_dev.registers = registers;
-    gpu_dev.idx = 0;
-    gpu_dev.ack_used_idx = 0;
     gpu_dev.width = screen_width;
     gpu_dev.height = screen_height;
-    gpu_dev.current_fb = 1;
+    gpu_dev.current_fb = 0;
     gpu_dev.fb_desc = fb_buffer;
+    gpu_dev.cursor_desc = cursor_buffer;
+    gpu_dev.cursor_pos.scanout_id = 0;
     _virtiogpu_dev_init();
     return 0;
 }
@@ -331,9 +547,30 @@ static int _virtiogpu_ioctl(file_t* file, uintptr_t cmd, uintptr_t arg)
         return gpu_dev.width;
     case BGA_GET_SCALE:
         return 1;
-    case BGA_SWAP_BUFFERS:
-        _virtiogpu_flip_screen();
+    case BGA_SWAP_BUFFERS: {
+        bga_rect_t screen = { 0, 0, gpu_dev.width, gpu_dev.height };
+        _virtiogpu_flip_screen(arg & 1, &screen, 1);
+        return 0;
+    }
+    case BGA_SWAP_BUFFERS_DAMAGED: {
+        bga_swap_damaged_t damaged;
+        umem_copy_from_user(&damaged, (bga_swap_damaged_t __user*)arg, sizeof(damaged));
+        if (damaged.rects_count > BGA_MAX_DAMAGED_RECTS) {
+            return -EINVAL;
+        }
+        _virtiogpu_flip_screen(damaged.buffer & 1, damaged.rects, damaged.rects_count);
         return 0;
+    }
+    case BGA_SET_CURSOR: {
+        bga_cursor_t cursor;
+        umem_copy_from_user(&cursor, (bga_cursor_t __user*)arg, sizeof(cursor));
+        return _virtiogpu_set_cursor(&cursor);
+    }
+    case BGA_MOVE_CURSOR: {
+        bga_cursor_pos_t pos;
+        umem_copy_from_user(&pos, (bga_cursor_pos_t __user*)arg, sizeof(pos));
+        return _virtiogpu_move_cursor(pos.x, pos.y);
+    }
     default:
         return -EINVAL;
     }
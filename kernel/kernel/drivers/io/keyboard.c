@@ -136,6 +136,11 @@ void generic_emit_key_set1(uint32_t scancode)
         }
     }
 
+    // Readers take whole packets, so a packet which does not fit is dropped
+    // rather than stored partially.
+    if (ringbuffer_space_to_write(&gkeyboard_buffer) < (ssize_t)sizeof(kbd_packet_t)) {
+        return;
+    }
     ringbuffer_write(&gkeyboard_buffer, (uint8_t*)&packet, sizeof(kbd_packet_t));
 }
 
@@ -52,5 +52,10 @@ void generic_mouse_init()
 
 void generic_mouse_send_packet(mouse_packet_t* packet)
 {
+    // Readers take whole packets, so a packet which does not fit is dropped
+    // rather than stored partially.
+    if (ringbuffer_space_to_write(&gmouse_buffer) < (ssize_t)sizeof(mouse_packet_t)) {
+        return;
+    }
     ringbuffer_write(&gmouse_buffer, (uint8_t*)packet, sizeof(mouse_packet_t));
 }
\ No newline at end of file
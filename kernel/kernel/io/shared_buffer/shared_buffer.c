@@ -9,10 +9,13 @@
 #include <algo/bitmap.h>
 #include <io/shared_buffer/shared_buffer.h>
 #include <libkern/bits/errno.h>
+#include <libkern/bits/shared_buffer.h>
 #include <libkern/libkern.h>
 #include <libkern/lock.h>
 #include <libkern/log.h>
+#include <mem/bits/swap.h>
 #include <mem/kmemzone.h>
+#include <mem/memzone.h>
 #include <mem/vmm.h>
 #include <tasking/tasking.h>
 
@@ -24,6 +27,8 @@
 
 struct buffer_desc {
     uint8_t* data;
+    size_t len;
+    uint32_t flags;
     uid_t owner_uid;
 };
 typedef struct buffer_desc buffer_desc_t;
@@ -51,6 +56,17 @@ static inline int _shared_buffer_to_index(uintptr_t vaddr)
     return (vaddr - (uintptr_t)_shared_buffer_zone.start) / SHBUF_BLOCK_SIZE;
 }
 
+static int _shared_buffer_swap_page_mode(struct memzone* zone, uintptr_t vaddr)
+{
+    return SWAP_NOT_ALLOWED;
+}
+
+static vm_ops_t _shared_buffer_vm_ops = {
+    .load_page_content = NULL,
+    .restore_swapped_page = NULL,
+    .swap_page_mode = _shared_buffer_swap_page_mode,
+};
+
 static inline int _shared_buffer_alloc_id()
 {
     for (int i = 0; i < SHBUF_MAX_BUFFERS; i++) {
@@ -75,6 +91,29 @@ static void _shared_buffer_init_bitmap()
     bitmap_set_range(bitmap, _shared_buffer_to_index((uintptr_t)_shared_buffer_bitmap), blocks_needed);
 }
 
+/**
+ * Read-only buffers are not reachable from userspace through the shared
+ * buffer zone, so every process gets its own mapping of their pages with
+ * its own access rights. The pages stay owned by the shared buffer zone.
+ */
+static uintptr_t _shared_buffer_map_locked(int id, mmu_flags_t mmu_flags)
+{
+    uintptr_t start = (uintptr_t)&((shared_buffer_header_t*)buffer_descs[id].data)[-1];
+    size_t len = buffer_descs[id].len;
+    memzone_t* zone = memzone_new_random(RUNNING_THREAD->process->address_space, len);
+    if (!zone) {
+        return 0;
+    }
+
+    zone->type |= ZONE_TYPE_DEVICE;
+    zone->mmu_flags |= mmu_flags;
+    zone->ops = &_shared_buffer_vm_ops;
+    for (size_t offset = 0; offset < len; offset += VMM_PAGE_SIZE) {
+        vmm_map_page(zone->vaddr + offset, vmm_convert_kernel_vaddr_to_paddr(start + offset), zone->mmu_flags);
+    }
+    return zone->vaddr + sizeof(shared_buffer_header_t);
+}
+
 int shared_buffer_init()
 {
     _shared_buffer_zone = kmemzone_new(SHBUF_SPACE_SIZE);
@@ -83,7 +122,7 @@ int shared_buffer_init()
     return 0;
 }
 
-int shared_buffer_create(uintptr_t __user* res_buffer, size_t size)
+int shared_buffer_create(uintptr_t __user* res_buffer, size_t size, uint32_t flags)
 {
     spinlock_acquire(&_shared_buffer_lock);
     int buf_id = _shared_buffer_alloc_id();
@@ -102,13 +141,28 @@ int shared_buffer_create(uintptr_t __user* res_buffer, size_t size)
     }
 
     shared_buffer_header_t* space = (shared_buffer_header_t*)_shared_buffer_to_vaddr(start);
-    space->len = act_size;
     bitmap_set_range(bitmap, start, blocks_needed);
-    vmm_tune_pages((uintptr_t)space, act_size, MMU_FLAG_PERM_WRITE | MMU_FLAG_PERM_EXEC | MMU_FLAG_PERM_READ | MMU_FLAG_NONPRIV);
+    if (TEST_FLAG(flags, SHBUF_READONLY)) {
+        vmm_tune_pages((uintptr_t)space, act_size, MMU_FLAG_PERM_WRITE | MMU_FLAG_PERM_READ);
+    } else {
+        vmm_tune_pages((uintptr_t)space, act_size, MMU_FLAG_PERM_WRITE | MMU_FLAG_PERM_EXEC | MMU_FLAG_PERM_READ | MMU_FLAG_NONPRIV);
+    }
+    space->len = act_size;
 
     uintptr_t result_pointer = (uintptr_t)&space[1];
     buffer_descs[buf_id].data = (uint8_t*)result_pointer;
+    buffer_descs[buf_id].len = act_size;
+    buffer_descs[buf_id].flags = flags;
     buffer_descs[buf_id].owner_uid = RUNNING_THREAD->process->pid;
+    if (TEST_FLAG(flags, SHBUF_READONLY)) {
+        result_pointer = _shared_buffer_map_locked(buf_id, MMU_FLAG_PERM_WRITE | MMU_FLAG_PERM_READ);
+        if (!result_pointer) {
+            bitmap_unset_range(bitmap, start, blocks_needed);
+            buffer_descs[buf_id].data = NULL;
+            spinlock_release(&_shared_buffer_lock);
+            return -ENOMEM;
+        }
+    }
     umem_put_user(result_pointer, res_buffer);
 
 #ifdef SHARED_BUFFER_DEBUG
@@ -118,7 +172,7 @@ int shared_buffer_create(uintptr_t __user* res_buffer, size_t size)
     return buf_id;
 }
 
-int shared_buffer_get(int id, uintptr_t __user* res_buffer)
+int shared_buffer_get(int id, uintptr_t __user* res_buffer, uint32_t flags)
 {
     if (unlikely(id < 0 || SHBUF_MAX_BUFFERS <= id)) {
         return -EINVAL;
@@ -135,10 +189,25 @@ int shared_buffer_get(int id, uintptr_t __user* res_buffer)
         return -EPERM;
     }
 
+    bool is_owner = RUNNING_THREAD->process->pid == buffer_descs[id].owner_uid;
+    if (TEST_FLAG(buffer_descs[id].flags, SHBUF_READONLY) && !is_owner && !TEST_FLAG(flags, SHBUF_READONLY)) {
+        spinlock_release(&_shared_buffer_lock);
+        return -EPERM;
+    }
+
 #ifdef SHARED_BUFFER_DEBUG
     log("Buffer opened at %p %d", buffer_descs[id].data, id);
 #endif
     uintptr_t result_pointer = (uintptr_t)buffer_descs[id].data;
+    if (TEST_FLAG(flags, SHBUF_READONLY)) {
+        result_pointer = _shared_buffer_map_locked(id, MMU_FLAG_PERM_READ);
+    } else if (TEST_FLAG(buffer_descs[id].flags, SHBUF_READONLY)) {
+        result_pointer = _shared_buffer_map_locked(id, MMU_FLAG_PERM_WRITE | MMU_FLAG_PERM_READ);
+    }
+    if (!result_pointer) {
+        spinlock_release(&_shared_buffer_lock);
+        return -ENOMEM;
+    }
     umem_put_user(result_pointer, res_buffer);
     spinlock_release(&_shared_buffer_lock);
     return 0;
@@ -162,7 +231,7 @@ int shared_buffer_free(int id)
     }
 
     shared_buffer_header_t* sptr = (shared_buffer_header_t*)buffer_descs[id].data;
-    size_t blocks_to_delete = (sptr[-1].len + SHBUF_BLOCK_SIZE - 1) / SHBUF_BLOCK_SIZE;
+    size_t blocks_to_delete = (buffer_descs[id].len + SHBUF_BLOCK_SIZE - 1) / SHBUF_BLOCK_SIZE;
     bitmap_unset_range(bitmap, _shared_buffer_to_index((uintptr_t)&sptr[-1]), blocks_to_delete);
     buffer_descs[id].data = NULL;
     spinlock_release(&_shared_buffer_lock);
@@ -126,6 +126,8 @@ int pty_master_fstat(file_t* file, stat_t* stat)
     ASSERT(ptm);
 
     stat->st_dev = MKDEV(128, INODE2PTSNO(dentry->inode_indx));
+    // A reader with a buffer of st_blksize drains the whole buffer at once.
+    stat->st_blksize = ptm->buffer.ringbuffer.zone.len;
     return 0;
 }
 
@@ -160,6 +162,6 @@ int pty_master_alloc(file_descriptor_t* fd)
     dentry_put(&ptm->dentry);
 
     pty_slave_create(INODE2PTSNO(ptm->dentry.inode_indx), ptm);
-    ptm->buffer = sync_ringbuffer_create_std();
+    ptm->buffer = sync_ringbuffer_create(PTY_BUFFER_SIZE);
     return 0;
 }
\ No newline at end of file
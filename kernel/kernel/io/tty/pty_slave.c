@@ -39,7 +39,7 @@ bool pty_slave_can_write(file_t* file, size_t start)
     pty_slave_entry_t* pts = _pts_get(dentry);
     ASSERT(pts);
 
-    return sync_ringbuffer_space_to_write(&pts->ptm->buffer) >= 0;
+    return sync_ringbuffer_space_to_write(&pts->ptm->buffer) > 0;
 }
 
 int pty_slave_read(file_t* file, void __user* buf, size_t start, size_t len)
@@ -57,8 +57,9 @@ int pty_slave_write(file_t* file, void __user* buf, size_t start, size_t len)
     pty_slave_entry_t* pts = _pts_get(dentry);
     ASSERT(pts);
 
-    sync_ringbuffer_write_user(&pts->ptm->buffer, buf, len);
-    return len;
+    // Writers are blocked until there is space, so a full buffer leads to
+    // a short write instead of lost output.
+    return sync_ringbuffer_write_user(&pts->ptm->buffer, buf, len);
 }
 
 int pty_slave_ioctl(file_t* file, uintptr_t cmd, uintptr_t arg)
@@ -67,9 +67,11 @@ int tty_read(tty_entry_t* tty, file_t* file, void __user* buf, size_t start, siz
 int tty_write(tty_entry_t* tty, file_t* file, void __user* buf, size_t start, size_t len)
 {
     // TODO: Check line count correctly. Both read & write funcs.
-    sync_ringbuffer_write_user(&tty->buffer, buf, len);
-    tty->line_count++;
-    return len;
+    size_t written = sync_ringbuffer_write_user(&tty->buffer, buf, len);
+    if (written) {
+        tty->line_count++;
+    }
+    return written;
 }
 
 int tty_ioctl(tty_entry_t* tty, file_t* file, uintptr_t cmd, uintptr_t arg)
@@ -29,6 +29,7 @@
 #include <io/tty/tty.h>
 
 #include <time/time_manager.h>
+#include <time/vdso.h>
 
 #include <tasking/sched.h>
 #include <tasking/tasking.h>
@@ -89,6 +90,7 @@ void stage3(boot_args_t* boot_args)
     devman_install_drivers();
     devman_run();
     timeman_setup();
+    vdso_init();
     boot_cpu_finish(&__boot_cpu_setup_drivers);
 
     // mounting filesystems
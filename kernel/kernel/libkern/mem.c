@@ -8,39 +8,111 @@
 
 #include <libkern/libkern.h>
 
-#ifndef __arm__
-// TODO: Implement tuned memset for each arch.
-void* memset(void* dest, uint8_t fll, size_t nbytes)
+/**
+ * The kernel is built without SIMD (FPU state is not saved on kernel entry),
+ * so bulk routines work on machine words. On x86 large blocks are handled
+ * with string instructions, which are fast-pathed by modern CPUs.
+ */
+
+typedef uintptr_t __attribute__((__may_alias__)) word_t;
+#define WORD_SIZE (sizeof(word_t))
+#define WORD_ONES ((word_t)-1 / 0xff)
+#define REP_STRING_THRESHOLD (64)
+
+static inline void _copy_forward(uint8_t* dest, const uint8_t* src, size_t nbytes)
+{
+#if defined(__i386__) || defined(__x86_64__)
+    if (nbytes >= REP_STRING_THRESHOLD) {
+        size_t words = nbytes / WORD_SIZE;
+#ifdef __x86_64__
+        asm volatile("rep movsq"
+                     : "+D"(dest), "+S"(src), "+c"(words)
+                     :
+                     : "memory");
+#else
+        asm volatile("rep movsl"
+                     : "+D"(dest), "+S"(src), "+c"(words)
+                     :
+                     : "memory");
+#endif
+        nbytes &= WORD_SIZE - 1;
+    }
+#else
+    if (nbytes >= 2 * WORD_SIZE && !(((uintptr_t)dest ^ (uintptr_t)src) & (WORD_SIZE - 1))) {
+        while ((uintptr_t)dest & (WORD_SIZE - 1)) {
+            *dest++ = *src++;
+            nbytes--;
+        }
+        for (; nbytes >= WORD_SIZE; nbytes -= WORD_SIZE) {
+            *(word_t*)dest = *(const word_t*)src;
+            src += WORD_SIZE;
+            dest += WORD_SIZE;
+        }
+    }
+#endif
+
+    while (nbytes--) {
+        *dest++ = *src++;
+    }
+}
+
+static inline void _copy_backward(uint8_t* dest, const uint8_t* src, size_t nbytes)
 {
-    if (nbytes < 16) {
-        for (int i = 0; i < nbytes; i++) {
-            *((uint8_t*)dest + i) = fll;
+    dest += nbytes;
+    src += nbytes;
+
+    if (nbytes >= 2 * WORD_SIZE && !(((uintptr_t)dest ^ (uintptr_t)src) & (WORD_SIZE - 1))) {
+        while ((uintptr_t)dest & (WORD_SIZE - 1)) {
+            *--dest = *--src;
+            nbytes--;
+        }
+        for (; nbytes >= WORD_SIZE; nbytes -= WORD_SIZE) {
+            src -= WORD_SIZE;
+            dest -= WORD_SIZE;
+            *(word_t*)dest = *(const word_t*)src;
         }
-        return dest;
     }
 
-    uintptr_t destaddr = (uintptr_t)dest;
-    size_t aligment = (8 - (destaddr % 8)) % 8;
-    for (int i = 0; i < aligment; i++) {
-        *((uint8_t*)dest + i) = fll;
+    while (nbytes--) {
+        *--dest = *--src;
     }
+}
 
-    nbytes -= aligment;
-    uintptr_t destaddr_aligned = destaddr + aligment;
-    size_t words = nbytes / 8;
+#ifndef __arm__
+void* memset(void* dest, uint8_t fll, size_t nbytes)
+{
+    uint8_t* d = (uint8_t*)dest;
+    if (nbytes >= 2 * WORD_SIZE) {
+        while ((uintptr_t)d & (WORD_SIZE - 1)) {
+            *d++ = fll;
+            nbytes--;
+        }
 
-    uint64_t fll16 = (fll << 8) | fll;
-    uint64_t fll32 = (fll16 << 16) | fll16;
-    uint64_t fll64 = (fll32 << 32) | fll32;
-    uint64_t* destu64 = (uint64_t*)destaddr_aligned;
-    for (size_t i = 0; i < words; i++) {
-        destu64[i] = fll64;
+        word_t fllword = WORD_ONES * fll;
+#if defined(__i386__) || defined(__x86_64__)
+        size_t words = nbytes / WORD_SIZE;
+#ifdef __x86_64__
+        asm volatile("rep stosq"
+                     : "+D"(d), "+c"(words)
+                     : "a"(fllword)
+                     : "memory");
+#else
+        asm volatile("rep stosl"
+                     : "+D"(d), "+c"(words)
+                     : "a"(fllword)
+                     : "memory");
+#endif
+        nbytes &= WORD_SIZE - 1;
+#else
+        for (; nbytes >= WORD_SIZE; nbytes -= WORD_SIZE) {
+            *(word_t*)d = fllword;
+            d += WORD_SIZE;
+        }
+#endif
     }
 
-    uintptr_t destaddr_tail = (uintptr_t)&destu64[words];
-    size_t rembytes = nbytes - words * 8;
-    for (size_t i = 0; i < rembytes; i++) {
-        *((uint8_t*)destaddr_tail + i) = fll;
+    while (nbytes--) {
+        *d++ = fll;
     }
     return dest;
 }
@@ -48,22 +120,16 @@ void* memset(void* dest, uint8_t fll, size_t nbytes)
 
 void* memcpy(void* dest, const void* src, size_t nbytes)
 {
-    for (int i = 0; i < nbytes; ++i) {
-        *(char*)(dest + i) = *(char*)(src + i);
-    }
+    _copy_forward((uint8_t*)dest, (const uint8_t*)src, nbytes);
     return dest;
 }
 
 void* memmove(void* dest, const void* src, size_t nbytes)
 {
-    if (src > dest) {
-        for (int i = 0; i < nbytes; ++i) {
-            *((uint8_t*)dest + i) = *((uint8_t*)src + i);
-        }
+    if ((uintptr_t)dest - (uintptr_t)src >= nbytes) {
+        _copy_forward((uint8_t*)dest, (const uint8_t*)src, nbytes);
     } else {
-        for (int i = nbytes - 1; i >= 0; --i) {
-            *((uint8_t*)dest + i) = *((uint8_t*)src + i);
-        }
+        _copy_backward((uint8_t*)dest, (const uint8_t*)src, nbytes);
     }
     return dest;
 }
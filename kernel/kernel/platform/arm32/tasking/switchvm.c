@@ -22,7 +22,13 @@ void switch_uthreads(thread_t* thread)
     write_iciallu(0);
 #endif
     RUNNING_THREAD = thread;
+    switch_thread_pointer(thread);
     vmm_switch_address_space(thread->process->address_space);
     fpu_make_unavail();
     system_enable_interrupts();
+}
+
+void switch_thread_pointer(thread_t* thread)
+{
+    write_tpidruro(thread->tls);
 }
\ No newline at end of file
@@ -20,7 +20,13 @@ void switch_uthreads(thread_t* thread)
     system_disable_interrupts();
     RUNNING_THREAD = thread;
     write_tpidr((uintptr_t)thread);
+    switch_thread_pointer(thread);
     vmm_switch_address_space(thread->process->address_space);
     fpu_make_unavail();
     system_enable_interrupts();
+}
+
+void switch_thread_pointer(thread_t* thread)
+{
+    write_tpidrro_el0(thread->tls);
 }
\ No newline at end of file
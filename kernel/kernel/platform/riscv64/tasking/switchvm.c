@@ -19,6 +19,13 @@ void switch_uthreads(thread_t* thread)
 {
     system_disable_interrupts();
     RUNNING_THREAD = thread;
+    switch_thread_pointer(thread);
     vmm_switch_address_space(thread->process->address_space);
     system_enable_interrupts();
+}
+
+// tp is a general purpose register, trap_return loads it from the frame.
+void switch_thread_pointer(thread_t* thread)
+{
+    thread->tf->tp = thread->tls;
 }
\ No newline at end of file
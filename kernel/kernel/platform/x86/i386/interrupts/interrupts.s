@@ -58,6 +58,7 @@ global trap_return
 
 isr_common:
     cli
+    cld ; C code expects DF clear, user space may leave it set
     
     push ds
     push es
@@ -78,6 +79,7 @@ isr_common:
 
 irq_common:
     cli
+    cld ; C code expects DF clear, user space may leave it set
     
     push ds
     push es
@@ -98,6 +100,7 @@ irq_common:
 
 sys_common:
     cli
+    cld ; C code expects DF clear, user space may leave it set
     
     push ds
     push es
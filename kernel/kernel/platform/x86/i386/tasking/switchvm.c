@@ -23,8 +23,16 @@ void switch_uthreads(thread_t* thread)
     tss.ss0 = (GDT_SEG_KDATA << 3);
     tss.iomap_offset = sizeof(tss);
     RUNNING_THREAD = thread;
+    switch_thread_pointer(thread);
     fpu_make_unavail();
     set_ltr(GDT_SEG_TSS << 3);
     vmm_switch_address_space(thread->process->address_space);
     system_enable_interrupts();
+}
+
+// User threads run with gs selecting GDT_SEG_UTLS, trap_return reloads it
+// from the frame, so the new base is picked up on the way to user space.
+void switch_thread_pointer(thread_t* thread)
+{
+    gdt[GDT_SEG_UTLS] = GDT_SEG_DATA_DESC(GDT_SEGF_W, thread->tls, 0xffffffff, DPL_USER);
 }
\ No newline at end of file
@@ -128,6 +128,9 @@ void interrupts_setup()
         idt_element_setup(i, (void*)syscall, SYS);
     }
     idt_element_setup(SYSCALL_HANDLER_NO, (void*)syscall, USER);
+#ifdef __x86_64__
+    fast_syscall_setup();
+#endif
 
     init_irq_handlers();
     lidt(idt, sizeof(idt));
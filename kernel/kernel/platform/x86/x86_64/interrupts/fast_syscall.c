@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <platform/x86/gdt.h>
+#include <platform/x86/idt.h>
+#include <platform/x86/registers.h>
+
+#define MSR_EFER 0xc0000080
+#define MSR_STAR 0xc0000081
+#define MSR_LSTAR 0xc0000082
+#define MSR_FMASK 0xc0000084
+
+#define EFER_SCE 0x1
+
+#define RFLAGS_TF 0x100
+#define RFLAGS_IF 0x200
+#define RFLAGS_DF 0x400
+#define RFLAGS_AC 0x40000
+
+// User rsp is stashed here by syscall_entry before switching to the kernel stack.
+// Interrupts are masked on entry and x86 runs on a single cpu, so one slot is enough.
+uintptr_t syscall_entry_user_rsp;
+
+void fast_syscall_setup()
+{
+    // SYSCALL loads CS from STAR[47:32] and SS from STAR[47:32] + 8.
+    // SYSRET loads SS from STAR[63:48] + 8 and CS from STAR[63:48] + 16.
+    uint64_t kernel_base = (GDT_SEG_KCODE << 3);
+    uint64_t user_base = ((GDT_SEG_UDATA - 1) << 3) | DPL_USER;
+
+    write_msr(MSR_STAR, (user_base << 48) | (kernel_base << 32));
+    write_msr(MSR_LSTAR, (uintptr_t)syscall_entry);
+    write_msr(MSR_FMASK, RFLAGS_TF | RFLAGS_IF | RFLAGS_DF | RFLAGS_AC);
+    write_msr(MSR_EFER, read_msr(MSR_EFER) | EFER_SCE);
+}
@@ -50,15 +50,19 @@ global irq14
 global irq15
 
 global syscall
+global syscall_entry
 
 extern isr_handler
 extern irq_handler
 extern sys_handler
+extern tss
+extern syscall_entry_user_rsp
 
 global trap_return
 
 isr_common:
     cli
+    cld ; C code expects DF clear, user space may leave it set
     
     push fs
     push gs
@@ -79,7 +83,7 @@ isr_common:
     push r14
     push r15
 
-    mov ax, 0x23 ; SEG_UDATA | DPL_USER
+    mov ax, 0x1b ; SEG_UDATA | DPL_USER
     mov ds, ax
     mov es, ax
 
@@ -89,6 +93,7 @@ isr_common:
 
 irq_common:
     cli
+    cld ; C code expects DF clear, user space may leave it set
     
     push fs
     push gs
@@ -109,7 +114,7 @@ irq_common:
     push r14
     push r15
 
-    mov ax, 0x23 ; SEG_UDATA | DPL_USER
+    mov ax, 0x1b ; SEG_UDATA | DPL_USER
     mov ds, ax
     mov es, ax
 
@@ -119,6 +124,7 @@ irq_common:
 
 sys_common:
     cli
+    cld ; C code expects DF clear, user space may leave it set
     
     push fs
     push gs
@@ -139,7 +145,7 @@ sys_common:
     push r14
     push r15
 
-    mov ax, 0x23 ; SEG_UDATA | DPL_USER
+    mov ax, 0x1b ; SEG_UDATA | DPL_USER
     mov ds, ax
     mov es, ax
     
@@ -165,7 +171,7 @@ trap_return:
     pop rax
 
     pop gs
-    pop fs
+    add rsp, 0x8 ; fs is not reloaded, that would drop the FS base
     add rsp, 0x10
     sti
     iretq
@@ -459,3 +465,96 @@ syscall:
     push 0
     push 0x80
     jmp  sys_common
+
+
+; SYSCALL entry: the cpu saves user rip into rcx and rflags into r11,
+; masks IF via IA32_FMASK and does not switch the stack. The trapframe
+; is built at tss.rsp0 with the same layout as the interrupt path, so
+; the rest of the kernel (signals, fork, ptrace) sees no difference.
+%define TF_R11 0x20
+%define TF_RCX 0x60
+%define TF_RIP 0x98
+%define TF_CS 0xa0
+%define TF_RFLAGS 0xa8
+%define TF_SS 0xb8
+
+%define USER_CS 0x23 ; SEG_UCODE | DPL_USER
+%define USER_SS 0x1b ; SEG_UDATA | DPL_USER
+
+; rflags bits which SYSRET can't restore properly (TF, RF, NT).
+%define SYSRET_BAD_RFLAGS 0x14100
+
+syscall_entry:
+    mov [rel syscall_entry_user_rsp], rsp
+    mov rsp, [rel tss + 4] ; tss.rsp0
+
+    push USER_SS
+    push qword [rel syscall_entry_user_rsp]
+    push r11
+    push USER_CS
+    push rcx
+    push 0
+    push 0x80
+
+    push fs
+    push gs
+
+    push rax
+    push rbx
+    push rcx
+    push rdx
+    push rsi
+    push rdi
+    push rbp
+    push r8
+    push r9
+    push r10
+    push r11
+    push r12
+    push r13
+    push r14
+    push r15
+
+    mov rdi, rsp
+    call sys_handler
+    cli
+
+    ; SYSRET restores rip from rcx and rflags from r11, so if the frame was
+    ; changed in a way it can't express (sigreturn, ptrace, exec), use iretq.
+    mov rcx, [rsp + TF_RIP]
+    cmp rcx, [rsp + TF_RCX]
+    jne trap_return
+    mov r11, [rsp + TF_RFLAGS]
+    cmp r11, [rsp + TF_R11]
+    jne trap_return
+    test r11, SYSRET_BAD_RFLAGS
+    jnz trap_return
+    cmp qword [rsp + TF_CS], USER_CS
+    jne trap_return
+    cmp qword [rsp + TF_SS], USER_SS
+    jne trap_return
+    ; SYSRET to a non-canonical address faults in ring 0.
+    mov rax, rcx
+    shr rax, 47
+    jnz trap_return
+
+    pop r15
+    pop r14
+    pop r13
+    pop r12
+    add rsp, 8 ; r11 holds rflags
+    pop r10
+    pop r9
+    pop r8
+    pop rbp
+    pop rdi
+    pop rsi
+    pop rdx
+    add rsp, 8 ; rcx holds rip
+    pop rbx
+    pop rax
+
+    ; gs, fs, int_no, err, rip, cs, rflags
+    add rsp, 0x38
+    mov rsp, [rsp]
+    o64 sysret
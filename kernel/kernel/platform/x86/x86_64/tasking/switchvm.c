@@ -10,9 +10,12 @@
 #include <platform/generic/system.h>
 #include <platform/x86/fpu/fpu.h>
 #include <platform/x86/gdt.h>
+#include <platform/x86/registers.h>
 #include <platform/x86/tasking/switchvm.h>
 #include <platform/x86/tasking/tss.h>
 
+#define MSR_FS_BASE 0xc0000100
+
 /* switching the page dir and tss to the current proc */
 void switch_uthreads(thread_t* thread)
 {
@@ -29,6 +32,7 @@ void switch_uthreads(thread_t* thread)
     tss.rsp0 = esp0;
     tss.iomap_offset = sizeof(tss);
     RUNNING_THREAD = thread;
+    switch_thread_pointer(thread);
 
     fpu_make_unavail();
 
@@ -36,4 +40,10 @@ void switch_uthreads(thread_t* thread)
 
     vmm_switch_address_space(thread->process->address_space);
     system_enable_interrupts();
+}
+
+// The kernel never reloads fs, so the base survives until the next switch.
+void switch_thread_pointer(thread_t* thread)
+{
+    write_msr(MSR_FS_BASE, thread->tls);
 }
\ No newline at end of file
@@ -57,6 +57,7 @@ static const void* syscalls[] = {
     [SYS_SETPGID] = sys_setpgid,
     [SYS_GETPGID] = sys_getpgid,
     [SYS_PTHREAD_CREATE] = sys_create_thread,
+    [SYS_FUTEX] = sys_futex,
     [SYS_NANOSLEEP] = sys_sleep,
     [SYS_PTRACE] = sys_ptrace,
     [SYS_SELECT] = sys_select,
@@ -71,6 +72,9 @@ static const void* syscalls[] = {
     [SYS_SHBUF_CREATE] = sys_shbuf_create,
     [SYS_SHBUF_GET] = sys_shbuf_get,
     [SYS_SHBUF_FREE] = sys_shbuf_free,
+    [SYS_VDSO_GET] = sys_vdso_get,
+    [SYS_PTHREAD_EXIT] = sys_pthread_exit,
+    [SYS_SET_TLS] = sys_set_tls,
 };
 
 #if defined(__i386__) || defined(__x86_64__)
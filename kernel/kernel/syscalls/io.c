@@ -114,14 +114,16 @@ void sys_shbuf_create(trapframe_t* tf)
 {
     uintptr_t __user* buffer = (uintptr_t __user*)SYSCALL_VAR1(tf);
     size_t size = SYSCALL_VAR2(tf);
-    return_with_val(shared_buffer_create(buffer, size));
+    uint32_t flags = SYSCALL_VAR3(tf);
+    return_with_val(shared_buffer_create(buffer, size, flags));
 }
 
 void sys_shbuf_get(trapframe_t* tf)
 {
     int id = SYSCALL_VAR1(tf);
     uintptr_t __user* buffer = (uintptr_t __user*)SYSCALL_VAR2(tf);
-    return_with_val(shared_buffer_get(id, buffer));
+    uint32_t flags = SYSCALL_VAR3(tf);
+    return_with_val(shared_buffer_get(id, buffer, flags));
 }
 
 void sys_shbuf_free(trapframe_t* tf)
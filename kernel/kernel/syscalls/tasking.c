@@ -13,6 +13,7 @@
 #include <platform/generic/syscalls/params.h>
 #include <syscalls/handlers.h>
 #include <syscalls/wrapper.h>
+#include <tasking/futex.h>
 #include <tasking/sched.h>
 #include <tasking/tasking.h>
 
@@ -103,12 +104,63 @@ void sys_create_thread(trapframe_t* tf)
     umem_get_user(&kparams, params);
     set_instruction_pointer(thread->tf, kparams.entry_point);
     uintptr_t esp = kparams.stack_start + kparams.stack_size;
+
+#ifdef __i386__
+    // cdecl: the argument goes right above a (never used) return address.
+    esp -= 2 * sizeof(uintptr_t);
+    umem_put_user(kparams.arg, (uintptr_t __user*)(esp + sizeof(uintptr_t)));
+    umem_put_user(0, (uintptr_t __user*)esp);
+#elif __x86_64__
+    // Keep the ABI stack alignment as if entry_point was called.
+    esp -= sizeof(uintptr_t);
+    umem_put_user(0, (uintptr_t __user*)esp);
+    thread->tf->rdi = kparams.arg;
+#elif __arm__
+    thread->tf->r[0] = kparams.arg;
+#elif __aarch64__
+    thread->tf->x[0] = kparams.arg;
+#elif defined(__riscv) && (__riscv_xlen == 64)
+    thread->tf->a0 = kparams.arg;
+#endif
     set_stack_pointer(thread->tf, esp);
     set_frame_pointer(thread->tf, esp);
 
     return_with_val(thread->tid);
 }
 
+void sys_pthread_exit(trapframe_t* tf)
+{
+    tasking_exit_thread((uint32_t __user*)SYSCALL_VAR1(tf));
+}
+
+void sys_set_tls(trapframe_t* tf)
+{
+    thread_set_tls(RUNNING_THREAD, (uintptr_t)SYSCALL_VAR1(tf));
+    return_with_val(0);
+}
+
+void sys_futex(trapframe_t* tf)
+{
+    uint32_t __user* uaddr = (uint32_t __user*)SYSCALL_VAR1(tf);
+    int op = SYSCALL_VAR2(tf);
+    uint32_t val = SYSCALL_VAR3(tf);
+    timespec_t __user* utimeout = (timespec_t __user*)SYSCALL_VAR4(tf);
+
+    switch (op) {
+    case FUTEX_WAIT:
+        if (utimeout) {
+            timespec_t ktimeout;
+            umem_copy_from_user(&ktimeout, utimeout, sizeof(timespec_t));
+            return_with_val(futex_wait(uaddr, val, &ktimeout));
+        }
+        return_with_val(futex_wait(uaddr, val, NULL));
+    case FUTEX_WAKE:
+        return_with_val(futex_wake(uaddr, (int)val));
+    default:
+        return_with_val(-EINVAL);
+    }
+}
+
 void sys_sched_yield(trapframe_t* tf)
 {
     resched();
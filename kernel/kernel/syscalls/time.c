@@ -15,6 +15,7 @@
 #include <syscalls/handlers.h>
 #include <tasking/tasking.h>
 #include <time/time_manager.h>
+#include <time/vdso.h>
 
 void sys_clock_gettime(trapframe_t* tf)
 {
@@ -89,4 +90,17 @@ void sys_sleep(trapframe_t* tf)
         umem_put_user(krem, urem);
     }
     return_with_val(0);
-}
\ No newline at end of file
+}
+
+void sys_vdso_get(trapframe_t* tf)
+{
+    uintptr_t __user* u_addr = (uintptr_t __user*)SYSCALL_VAR1(tf);
+
+    uintptr_t kaddr = vdso_user_time_data();
+    if (!kaddr) {
+        return_with_val(-ENOSYS);
+    }
+
+    umem_put_user(kaddr, u_addr);
+    return_with_val(0);
+}
@@ -186,3 +186,40 @@ int init_select_blocker(thread_t* thread, int nfds, fd_set_t* readfds, fd_set_t*
     resched();
     return 0;
 }
+
+bool should_unblock_futex_block(thread_t* thread)
+{
+    if (__atomic_load_n(&thread->blocker_data.futex.woken, __ATOMIC_ACQUIRE)) {
+        return true;
+    }
+
+    if (thread->blocker_data.futex.is_until_time_set) {
+        timespec_t ts = timeman_timespec_since_epoch();
+        return timespec_cmp(&thread->blocker_data.futex.until, &ts) <= 0;
+    }
+    return false;
+}
+
+/**
+ * The thread should be already queued into a futex bucket, see futex_wait().
+ */
+int init_futex_blocker(thread_t* thread, const timespec_t* until)
+{
+    thread->blocker_data.futex.is_until_time_set = false;
+    if (until) {
+        thread->blocker_data.futex.until = *until;
+        thread->blocker_data.futex.is_until_time_set = true;
+    }
+
+    if (should_unblock_futex_block(thread)) {
+        return 0;
+    }
+
+    thread->status = THREAD_STATUS_BLOCKED;
+    thread->blocker.reason = BLOCKER_FUTEX;
+    thread->blocker.should_unblock = should_unblock_futex_block;
+    thread->blocker.should_unblock_for_signal = true;
+    sched_dequeue(thread);
+    resched();
+    return 0;
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <libkern/bits/errno.h>
+#include <libkern/libkern.h>
+#include <libkern/lock.h>
+#include <libkern/log.h>
+#include <libkern/time.h>
+#include <libkern/umem.h>
+#include <mem/vmm.h>
+#include <tasking/futex.h>
+#include <tasking/tasking.h>
+#include <time/time_manager.h>
+
+// #define FUTEX_DEBUG
+
+#define FUTEX_HASH_SIZE 64
+
+/**
+ * Waiters are kept in a hash of singly linked wait queues keyed on the
+ * address space and the user address of the futex word. Futexes are
+ * process-private, so the virtual address is enough to identify them.
+ */
+struct futex_bucket {
+    spinlock_t lock;
+    thread_t* head;
+};
+typedef struct futex_bucket futex_bucket_t;
+
+static futex_bucket_t _futex_buckets[FUTEX_HASH_SIZE];
+
+static inline futex_bucket_t* _futex_bucket(vm_address_space_t* vm_aspace, uintptr_t uaddr)
+{
+    uintptr_t key = (uaddr >> 2) ^ ((uintptr_t)vm_aspace >> 4);
+    key ^= key >> 7;
+    return &_futex_buckets[key % FUTEX_HASH_SIZE];
+}
+
+static inline bool _futex_matches(thread_t* thread, vm_address_space_t* vm_aspace, uintptr_t uaddr)
+{
+    return thread->blocker_data.futex.vm_aspace == vm_aspace && thread->blocker_data.futex.uaddr == uaddr;
+}
+
+static void _futex_remove_locked(futex_bucket_t* bucket, thread_t* thread)
+{
+    thread_t** it = &bucket->head;
+    while (*it) {
+        if (*it == thread) {
+            *it = thread->blocker_data.futex.next;
+            thread->blocker_data.futex.next = NULL;
+            return;
+        }
+        it = &(*it)->blocker_data.futex.next;
+    }
+}
+
+int futex_init()
+{
+    for (int i = 0; i < FUTEX_HASH_SIZE; i++) {
+        spinlock_init(&_futex_buckets[i].lock);
+        _futex_buckets[i].head = NULL;
+    }
+    return 0;
+}
+
+int futex_wait(uint32_t __user* uaddr, uint32_t val, const timespec_t* timeout)
+{
+    uintptr_t addr = (uintptr_t)uaddr;
+    if (!addr || (addr & (sizeof(uint32_t) - 1)) || !IS_USER_VADDR(addr)) {
+        return -EINVAL;
+    }
+
+    thread_t* thread = RUNNING_THREAD;
+    vm_address_space_t* vm_aspace = thread->process->address_space;
+    futex_bucket_t* bucket = _futex_bucket(vm_aspace, addr);
+
+    timespec_t until;
+    if (timeout) {
+        until = timeman_timespec_since_epoch();
+        timespec_add_nsec(&until, timeout->tv_nsec);
+        until.tv_sec += timeout->tv_sec;
+    }
+
+    spinlock_acquire(&bucket->lock);
+    thread->blocker_data.futex.vm_aspace = vm_aspace;
+    thread->blocker_data.futex.uaddr = addr;
+    thread->blocker_data.futex.woken = false;
+    thread->blocker_data.futex.next = bucket->head;
+    bucket->head = thread;
+    spinlock_release(&bucket->lock);
+
+    // Reading the word might fault, so it is done without the bucket lock,
+    // but only after the thread is queued: a waker which changes the word
+    // and then calls futex_wake() either finds us queued or its change is
+    // seen here.
+    uint32_t cur_val;
+    umem_get_user(&cur_val, uaddr);
+    if (cur_val != val) {
+        spinlock_acquire(&bucket->lock);
+        _futex_remove_locked(bucket, thread);
+        spinlock_release(&bucket->lock);
+        // A wake which has already dequeued us must not be lost.
+        if (__atomic_load_n(&thread->blocker_data.futex.woken, __ATOMIC_ACQUIRE)) {
+            return 0;
+        }
+        return -EAGAIN;
+    }
+
+#ifdef FUTEX_DEBUG
+    log("futex: %d waits on %zx", thread->tid, addr);
+#endif
+
+    init_futex_blocker(thread, timeout ? &until : NULL);
+
+    if (__atomic_load_n(&thread->blocker_data.futex.woken, __ATOMIC_ACQUIRE)) {
+        return 0;
+    }
+
+    // Unblocked by a timeout or a signal, the waker has not dequeued us.
+    spinlock_acquire(&bucket->lock);
+    _futex_remove_locked(bucket, thread);
+    spinlock_release(&bucket->lock);
+
+    if (thread->blocker_data.futex.woken) {
+        return 0;
+    }
+    if (thread->blocker_data.futex.is_until_time_set) {
+        timespec_t ts = timeman_timespec_since_epoch();
+        if (timespec_cmp(&thread->blocker_data.futex.until, &ts) <= 0) {
+            return -ETIMEDOUT;
+        }
+    }
+    return -EINTR;
+}
+
+int futex_wake(uint32_t __user* uaddr, int count)
+{
+    uintptr_t addr = (uintptr_t)uaddr;
+    if (!addr || (addr & (sizeof(uint32_t) - 1)) || !IS_USER_VADDR(addr)) {
+        return -EINVAL;
+    }
+
+    vm_address_space_t* vm_aspace = RUNNING_THREAD->process->address_space;
+    futex_bucket_t* bucket = _futex_bucket(vm_aspace, addr);
+
+    int woken = 0;
+    spinlock_acquire(&bucket->lock);
+    thread_t** it = &bucket->head;
+    while (*it && woken < count) {
+        thread_t* thread = *it;
+        if (!_futex_matches(thread, vm_aspace, addr)) {
+            it = &thread->blocker_data.futex.next;
+            continue;
+        }
+
+        *it = thread->blocker_data.futex.next;
+        thread->blocker_data.futex.next = NULL;
+        __atomic_store_n(&thread->blocker_data.futex.woken, true, __ATOMIC_RELEASE);
+        woken++;
+    }
+    spinlock_release(&bucket->lock);
+
+#ifdef FUTEX_DEBUG
+    log("futex: woke %d on %zx", woken, addr);
+#endif
+    return woken;
+}
+
+/**
+ * Drops a dying thread from its wait queue, so the slot could be reused.
+ */
+void futex_cancel_wait(thread_t* thread)
+{
+    if (thread->blocker.reason != BLOCKER_FUTEX) {
+        return;
+    }
+
+    futex_bucket_t* bucket = _futex_bucket(thread->blocker_data.futex.vm_aspace, thread->blocker_data.futex.uaddr);
+    spinlock_acquire(&bucket->lock);
+    _futex_remove_locked(bucket, thread);
+    spinlock_release(&bucket->lock);
+    thread->blocker.reason = BLOCKER_INVALID;
+}
@@ -285,6 +285,7 @@ static int proc_load_locked(proc_t* p, thread_t* main_thread, const char* path)
 success:
     // Clearing proc
     proc_kill_all_threads_except_locked(p, p->main_thread);
+    thread_set_tls(p->main_thread, 0);
     p->pid = p->main_thread->tid;
     if (p->proc_file) {
         file_put(p->proc_file);
@@ -420,6 +421,31 @@ thread_t* proc_create_thread(proc_t* p)
     return thread;
 }
 
+/**
+ * Kills the thread unless it is the last one alive in the process,
+ * in which case -EBUSY is returned and the process should exit instead.
+ */
+int proc_thread_die(proc_t* p, thread_t* gthread)
+{
+    spinlock_acquire(&p->lock);
+    int alive_threads = 0;
+    foreach_thread(p)
+    {
+        if (thread != gthread && thread->status != THREAD_STATUS_DYING) {
+            alive_threads++;
+        }
+    }
+
+    if (!alive_threads) {
+        spinlock_release(&p->lock);
+        return -EBUSY;
+    }
+
+    thread_die(gthread);
+    spinlock_release(&p->lock);
+    return 0;
+}
+
 static void proc_kill_all_threads_except_locked(proc_t* p, thread_t* gthread)
 {
     foreach_thread(p)
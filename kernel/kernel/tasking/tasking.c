@@ -16,6 +16,7 @@
 #include <platform/generic/system.h>
 #include <tasking/cpu.h>
 #include <tasking/dump.h>
+#include <tasking/futex.h>
 #include <tasking/sched.h>
 #include <tasking/tasking.h>
 #include <tasking/thread.h>
@@ -171,6 +172,7 @@ void tasking_init()
     proc_init_storage();
     swapfile_init();
     signal_init();
+    futex_init();
     dump_prepare_kernel_data();
 }
 
@@ -383,6 +385,26 @@ void tasking_exit(int exit_code)
     resched();
 }
 
+void tasking_exit_thread(uint32_t __user* clear_tid)
+{
+    thread_t* thread = RUNNING_THREAD;
+    proc_t* p = thread->process;
+
+    // Joiners wait on this word, see pthread_join().
+    uintptr_t clear_tid_addr = (uintptr_t)clear_tid;
+    if (clear_tid_addr && !(clear_tid_addr & (sizeof(uint32_t) - 1)) && IS_USER_VADDR(clear_tid_addr)) {
+        umem_put_user(0, clear_tid);
+        futex_wake(clear_tid, FUTEX_WAKE_ALL);
+    }
+
+    if (proc_thread_die(p, thread) < 0) {
+        // The last thread exits, so does the process.
+        tasking_exit(0);
+        return;
+    }
+    resched();
+}
+
 int tasking_signal(thread_t* thread, int signo)
 {
     if (thread->status == THREAD_STATUS_INVALID || thread->status == THREAD_STATUS_DYING) {
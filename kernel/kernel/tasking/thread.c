@@ -11,6 +11,7 @@
 #include <libkern/libkern.h>
 #include <libkern/log.h>
 #include <mem/kmalloc.h>
+#include <tasking/futex.h>
 #include <tasking/proc.h>
 #include <tasking/sched.h>
 #include <tasking/tasking.h>
@@ -57,6 +58,7 @@ int thread_setup_main(proc_t* p, thread_t* thread)
     thread->process = p;
     thread->tid = p->pid;
     thread->last_cpu = LAST_CPU_NOT_SET;
+    thread->tls = 0;
 
     /* setting signal handlers to 0 */
     thread->signals_mask = 0xffffffff; /* for now all signals are legal */
@@ -84,6 +86,7 @@ int thread_setup(proc_t* p, thread_t* thread)
     thread->process = p;
     thread->tid = proc_alloc_pid();
     thread->last_cpu = LAST_CPU_NOT_SET;
+    thread->tls = 0;
 
     /* setting signal handlers to 0 */
     thread->signals_mask = 0xffffffff; /* for now all signals are legal */
@@ -103,6 +106,7 @@ int thread_setup(proc_t* p, thread_t* thread)
 int thread_copy_of(thread_t* thread, thread_t* from_thread)
 {
     memcpy(thread->tf, from_thread->tf, sizeof(trapframe_t));
+    thread->tls = from_thread->tls;
     memcpy(thread->signal_handlers, from_thread->signal_handlers, sizeof(from_thread->signal_handlers));
 #ifdef FPU_ENABLED
     // FPUs reinitilaztion for each implements a lazy-switch, this
@@ -116,6 +120,19 @@ int thread_copy_of(thread_t* thread, thread_t* from_thread)
     return 0;
 }
 
+/**
+ * The thread pointer is a register user space reads to find its thread
+ * descriptor. The running thread gets it loaded right away, others get it
+ * when they are switched to.
+ */
+void thread_set_tls(thread_t* thread, uintptr_t tls)
+{
+    thread->tls = tls;
+    if (thread == RUNNING_THREAD) {
+        switch_thread_pointer(thread);
+    }
+}
+
 /**
  * STACK FUNCTIONS
  */
@@ -292,6 +309,9 @@ int thread_die(thread_t* thread)
         return -EINVAL;
     }
 
+    if (thread->status == THREAD_STATUS_BLOCKED) {
+        futex_cancel_wait(thread);
+    }
     thread->status = THREAD_STATUS_DYING;
     sched_dequeue(thread);
     return 0;
@@ -9,6 +9,7 @@
 #include <drivers/driver_manager.h>
 #include <libkern/log.h>
 #include <time/time_manager.h>
+#include <time/vdso.h>
 
 // #define TIME_MANAGER_DEBUG
 
@@ -100,6 +101,8 @@ void timeman_timer_tick()
         atomic_add(&time_since_epoch, 1);
         atomic_store(&ticks_since_second, 0);
     }
+
+    vdso_update_time();
 }
 
 time_t timeman_seconds_since_epoch()
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <libkern/bits/errno.h>
+#include <libkern/libkern.h>
+#include <libkern/log.h>
+#include <mem/kmemzone.h>
+#include <mem/vmm.h>
+#include <time/time_manager.h>
+#include <time/vdso.h>
+
+// #define VDSO_DEBUG
+
+/**
+ * The time page is backed by a single physical page which is mapped twice
+ * in the kernel memory: a writable alias used by the timer tick and a
+ * read-only non-privileged alias which is visible from every address space.
+ */
+static kmemzone_t _vdso_kernel_zone;
+static kmemzone_t _vdso_user_zone;
+static vdso_time_data_t* _vdso_time_data = NULL;
+
+static inline uint64_t _vdso_read_cycles()
+{
+#if defined(__i386__) || defined(__x86_64__)
+    uint32_t lo, hi;
+    asm volatile("rdtsc"
+                 : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+#else
+    // No counter which user space is allowed to read, so cycles_mult stays
+    // 0 and readers get the time at tick resolution.
+    return 0;
+#endif
+}
+
+int vdso_init()
+{
+    _vdso_kernel_zone = kmemzone_new(VMM_PAGE_SIZE);
+    _vdso_user_zone = kmemzone_new(VMM_PAGE_SIZE);
+    if (!_vdso_kernel_zone.start || !_vdso_user_zone.start) {
+        return -ENOMEM;
+    }
+
+    vmm_ensure_writing_to_active_address_space(_vdso_kernel_zone.start, VMM_PAGE_SIZE);
+    uintptr_t paddr = vmm_convert_kernel_vaddr_to_paddr(_vdso_kernel_zone.start);
+    if (paddr == VMM_INVALID_PADDR) {
+        return -EFAULT;
+    }
+    vmm_map_page(_vdso_user_zone.start, paddr, MMU_FLAG_PERM_READ | MMU_FLAG_NONPRIV);
+
+    vdso_time_data_t* vd = (vdso_time_data_t*)_vdso_kernel_zone.ptr;
+    memset(vd, 0, sizeof(vdso_time_data_t));
+    vd->ticks_per_second = timeman_ticks_per_second();
+    vd->nsec_per_tick = 1000000000 / timeman_ticks_per_second();
+    vd->secs_since_boot = timeman_seconds_since_boot();
+    vd->secs_since_epoch = timeman_seconds_since_epoch();
+    vd->ticks_since_second = timeman_get_ticks_from_last_second();
+
+#ifdef VDSO_DEBUG
+    log("vdso: time data at %p (user alias %p)", _vdso_kernel_zone.start, _vdso_user_zone.start);
+#endif
+
+    __atomic_store_n(&_vdso_time_data, vd, __ATOMIC_RELEASE);
+    return 0;
+}
+
+/**
+ * Called from the timer tick on the boot cpu only, so there is a single
+ * writer and the seqlock does not need an extra lock.
+ */
+void vdso_update_time()
+{
+    vdso_time_data_t* vd = __atomic_load_n(&_vdso_time_data, __ATOMIC_ACQUIRE);
+    if (!vd) {
+        return;
+    }
+
+    uint64_t cycles = _vdso_read_cycles();
+
+    __atomic_store_n(&vd->seq, vd->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    if (cycles && vd->cycles_at_tick && cycles > vd->cycles_at_tick) {
+        uint64_t cpt = cycles - vd->cycles_at_tick;
+        // Ticks might be delivered late, so smoothing the counter rate.
+        if (vd->cycles_per_tick) {
+            cpt = (vd->cycles_per_tick * 3 + cpt) / 4;
+        }
+        vd->cycles_per_tick = cpt;
+        vd->cycles_mult = ((uint64_t)vd->nsec_per_tick << VDSO_CYCLES_SHIFT) / cpt;
+    }
+    vd->cycles_at_tick = cycles;
+    vd->secs_since_boot = timeman_seconds_since_boot();
+    vd->secs_since_epoch = timeman_seconds_since_epoch();
+    vd->ticks_since_second = timeman_get_ticks_from_last_second();
+
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&vd->seq, vd->seq + 1, __ATOMIC_RELAXED);
+}
+
+uintptr_t vdso_user_time_data()
+{
+    if (!_vdso_time_data) {
+        return 0;
+    }
+    return _vdso_user_zone.start;
+}
@@ -2,59 +2,155 @@
 // See .ipc file
 
 #pragma once
+#include <cstring>
 #include <libg/Rect.h>
 #include <libipc/ClientConnection.h>
-#include <libipc/Encoder.h>
 #include <libipc/ServerConnection.h>
 #include <libipc/StringEncoder.h>
 #include <libipc/VectorEncoder.h>
+#include <libipc/Wire.h>
 #include <new>
 
 class GreetMessage : public Message {
 public:
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0xa8b1a7b5;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
     GreetMessage(message_key_t key)
         : m_key(key)
     {
     }
+    explicit GreetMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+    {
+    }
     int id() const override { return 1; }
     int reply_id() const override { return 2; }
     int key() const override { return m_key; }
     int decoder_magic() const override { return 320; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.header = { 320, 1, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
 };
 
 class GreetMessageReply : public Message {
 public:
-    GreetMessageReply(message_key_t key, uint32_t connection_id)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<uint32_t>::Slot connection_id;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x4b6f3891;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<uint32_t>::View connection_id() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->connection_id); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    GreetMessageReply(message_key_t key,uint32_t connection_id)
         : m_key(key)
         , m_connection_id(connection_id)
     {
     }
+    explicit GreetMessageReply(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_connection_id(LIPC::Wire<uint32_t>::materialize(view.connection_id()))
+    {
+    }
     int id() const override { return 2; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
     int decoder_magic() const override { return 320; }
     uint32_t connection_id() const { return m_connection_id; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.connection_id = LIPC::Wire<uint32_t>::encode(m_connection_id, buf, tail);
+        layout.header = { 320, 2, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_connection_id);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     uint32_t m_connection_id;
@@ -62,7 +158,62 @@ private:
 
 class CreateWindowMessage : public Message {
 public:
-    CreateWindowMessage(message_key_t key, int type, uint32_t width, uint32_t height, int buffer_id, LIPC::StringEncoder title, LIPC::StringEncoder icon_path, LIPC::StringEncoder bundle_id, uint32_t color, uint32_t menubar_style)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot type;
+        LIPC::Wire<uint32_t>::Slot width;
+        LIPC::Wire<uint32_t>::Slot height;
+        LIPC::Wire<int>::Slot buffer_id;
+        LIPC::Wire<LIPC::StringEncoder>::Slot title;
+        LIPC::Wire<LIPC::StringEncoder>::Slot icon_path;
+        LIPC::Wire<LIPC::StringEncoder>::Slot bundle_id;
+        LIPC::Wire<uint32_t>::Slot color;
+        LIPC::Wire<uint32_t>::Slot menubar_style;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0xe2fe8aa9;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return LIPC::Wire<LIPC::StringEncoder>::validate(msg, layout->header.size, layout->title)
+                && LIPC::Wire<LIPC::StringEncoder>::validate(msg, layout->header.size, layout->icon_path)
+                && LIPC::Wire<LIPC::StringEncoder>::validate(msg, layout->header.size, layout->bundle_id);
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View type() const { return LIPC::Wire<int>::view(m_msg, layout()->type); }
+        LIPC::Wire<uint32_t>::View width() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->width); }
+        LIPC::Wire<uint32_t>::View height() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->height); }
+        LIPC::Wire<int>::View buffer_id() const { return LIPC::Wire<int>::view(m_msg, layout()->buffer_id); }
+        LIPC::Wire<LIPC::StringEncoder>::View title() const { return LIPC::Wire<LIPC::StringEncoder>::view(m_msg, layout()->title); }
+        LIPC::Wire<LIPC::StringEncoder>::View icon_path() const { return LIPC::Wire<LIPC::StringEncoder>::view(m_msg, layout()->icon_path); }
+        LIPC::Wire<LIPC::StringEncoder>::View bundle_id() const { return LIPC::Wire<LIPC::StringEncoder>::view(m_msg, layout()->bundle_id); }
+        LIPC::Wire<uint32_t>::View color() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->color); }
+        LIPC::Wire<uint32_t>::View menubar_style() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->menubar_style); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    CreateWindowMessage(message_key_t key,int type,uint32_t width,uint32_t height,int buffer_id,LIPC::StringEncoder title,LIPC::StringEncoder icon_path,LIPC::StringEncoder bundle_id,uint32_t color,uint32_t menubar_style)
         : m_key(key)
         , m_type(type)
         , m_width(width)
@@ -75,6 +226,19 @@ public:
         , m_menubar_style(menubar_style)
     {
     }
+    explicit CreateWindowMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_type(LIPC::Wire<int>::materialize(view.type()))
+        , m_width(LIPC::Wire<uint32_t>::materialize(view.width()))
+        , m_height(LIPC::Wire<uint32_t>::materialize(view.height()))
+        , m_buffer_id(LIPC::Wire<int>::materialize(view.buffer_id()))
+        , m_title(LIPC::Wire<LIPC::StringEncoder>::materialize(view.title()))
+        , m_icon_path(LIPC::Wire<LIPC::StringEncoder>::materialize(view.icon_path()))
+        , m_bundle_id(LIPC::Wire<LIPC::StringEncoder>::materialize(view.bundle_id()))
+        , m_color(LIPC::Wire<uint32_t>::materialize(view.color()))
+        , m_menubar_style(LIPC::Wire<uint32_t>::materialize(view.menubar_style()))
+    {
+    }
     int id() const override { return 3; }
     int reply_id() const override { return 4; }
     int key() const override { return m_key; }
@@ -88,24 +252,31 @@ public:
     LIPC::StringEncoder& bundle_id() { return m_bundle_id; }
     uint32_t color() const { return m_color; }
     uint32_t menubar_style() const { return m_menubar_style; }
+    size_t encoded_size() const override { return fixed_size + LIPC::Wire<LIPC::StringEncoder>::tail_size(m_title) + LIPC::Wire<LIPC::StringEncoder>::tail_size(m_icon_path) + LIPC::Wire<LIPC::StringEncoder>::tail_size(m_bundle_id); }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.type = LIPC::Wire<int>::encode(m_type, buf, tail);
+        layout.width = LIPC::Wire<uint32_t>::encode(m_width, buf, tail);
+        layout.height = LIPC::Wire<uint32_t>::encode(m_height, buf, tail);
+        layout.buffer_id = LIPC::Wire<int>::encode(m_buffer_id, buf, tail);
+        layout.title = LIPC::Wire<LIPC::StringEncoder>::encode(m_title, buf, tail);
+        layout.icon_path = LIPC::Wire<LIPC::StringEncoder>::encode(m_icon_path, buf, tail);
+        layout.bundle_id = LIPC::Wire<LIPC::StringEncoder>::encode(m_bundle_id, buf, tail);
+        layout.color = LIPC::Wire<uint32_t>::encode(m_color, buf, tail);
+        layout.menubar_style = LIPC::Wire<uint32_t>::encode(m_menubar_style, buf, tail);
+        layout.header = { 320, 3, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_type);
-        Encoder::append(buffer, m_width);
-        Encoder::append(buffer, m_height);
-        Encoder::append(buffer, m_buffer_id);
-        Encoder::append(buffer, m_title);
-        Encoder::append(buffer, m_icon_path);
-        Encoder::append(buffer, m_bundle_id);
-        Encoder::append(buffer, m_color);
-        Encoder::append(buffer, m_menubar_style);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     int m_type;
@@ -121,26 +292,75 @@ private:
 
 class CreateWindowMessageReply : public Message {
 public:
-    CreateWindowMessageReply(message_key_t key, uint32_t window_id)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<uint32_t>::Slot window_id;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0xd61feef0;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<uint32_t>::View window_id() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->window_id); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    CreateWindowMessageReply(message_key_t key,uint32_t window_id)
         : m_key(key)
         , m_window_id(window_id)
     {
     }
+    explicit CreateWindowMessageReply(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_window_id(LIPC::Wire<uint32_t>::materialize(view.window_id()))
+    {
+    }
     int id() const override { return 4; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
     int decoder_magic() const override { return 320; }
     uint32_t window_id() const { return m_window_id; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.window_id = LIPC::Wire<uint32_t>::encode(m_window_id, buf, tail);
+        layout.header = { 320, 4, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_window_id);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     uint32_t m_window_id;
@@ -148,26 +368,75 @@ private:
 
 class DestroyWindowMessage : public Message {
 public:
-    DestroyWindowMessage(message_key_t key, uint32_t window_id)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<uint32_t>::Slot window_id;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x51b27dc6;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<uint32_t>::View window_id() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->window_id); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    DestroyWindowMessage(message_key_t key,uint32_t window_id)
         : m_key(key)
         , m_window_id(window_id)
     {
     }
+    explicit DestroyWindowMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_window_id(LIPC::Wire<uint32_t>::materialize(view.window_id()))
+    {
+    }
     int id() const override { return 5; }
     int reply_id() const override { return 6; }
     int key() const override { return m_key; }
     int decoder_magic() const override { return 320; }
     uint32_t window_id() const { return m_window_id; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.window_id = LIPC::Wire<uint32_t>::encode(m_window_id, buf, tail);
+        layout.header = { 320, 5, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_window_id);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     uint32_t m_window_id;
@@ -175,26 +444,75 @@ private:
 
 class DestroyWindowMessageReply : public Message {
 public:
-    DestroyWindowMessageReply(message_key_t key, uint32_t status)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<uint32_t>::Slot status;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x93faf208;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<uint32_t>::View status() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->status); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    DestroyWindowMessageReply(message_key_t key,uint32_t status)
         : m_key(key)
         , m_status(status)
     {
     }
+    explicit DestroyWindowMessageReply(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_status(LIPC::Wire<uint32_t>::materialize(view.status()))
+    {
+    }
     int id() const override { return 6; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
     int decoder_magic() const override { return 320; }
     uint32_t status() const { return m_status; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.status = LIPC::Wire<uint32_t>::encode(m_status, buf, tail);
+        layout.header = { 320, 6, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_status);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     uint32_t m_status;
@@ -202,7 +520,50 @@ private:
 
 class SetBufferMessage : public Message {
 public:
-    SetBufferMessage(message_key_t key, uint32_t window_id, int buffer_id, int format, LG::Rect bounds)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<uint32_t>::Slot window_id;
+        LIPC::Wire<int>::Slot buffer_id;
+        LIPC::Wire<int>::Slot format;
+        LIPC::Wire<LG::Rect>::Slot bounds;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x5ede46c0;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<uint32_t>::View window_id() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->window_id); }
+        LIPC::Wire<int>::View buffer_id() const { return LIPC::Wire<int>::view(m_msg, layout()->buffer_id); }
+        LIPC::Wire<int>::View format() const { return LIPC::Wire<int>::view(m_msg, layout()->format); }
+        LIPC::Wire<LG::Rect>::View bounds() const { return LIPC::Wire<LG::Rect>::view(m_msg, layout()->bounds); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    SetBufferMessage(message_key_t key,uint32_t window_id,int buffer_id,int format,LG::Rect bounds)
         : m_key(key)
         , m_window_id(window_id)
         , m_buffer_id(buffer_id)
@@ -210,6 +571,14 @@ public:
         , m_bounds(bounds)
     {
     }
+    explicit SetBufferMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_window_id(LIPC::Wire<uint32_t>::materialize(view.window_id()))
+        , m_buffer_id(LIPC::Wire<int>::materialize(view.buffer_id()))
+        , m_format(LIPC::Wire<int>::materialize(view.format()))
+        , m_bounds(LIPC::Wire<LG::Rect>::materialize(view.bounds()))
+    {
+    }
     int id() const override { return 7; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
@@ -218,19 +587,26 @@ public:
     int buffer_id() const { return m_buffer_id; }
     int format() const { return m_format; }
     LG::Rect& bounds() { return m_bounds; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.window_id = LIPC::Wire<uint32_t>::encode(m_window_id, buf, tail);
+        layout.buffer_id = LIPC::Wire<int>::encode(m_buffer_id, buf, tail);
+        layout.format = LIPC::Wire<int>::encode(m_format, buf, tail);
+        layout.bounds = LIPC::Wire<LG::Rect>::encode(m_bounds, buf, tail);
+        layout.header = { 320, 7, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_window_id);
-        Encoder::append(buffer, m_buffer_id);
-        Encoder::append(buffer, m_format);
-        Encoder::append(buffer, m_bounds);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     uint32_t m_window_id;
@@ -241,13 +617,61 @@ private:
 
 class SetBarStyleMessage : public Message {
 public:
-    SetBarStyleMessage(message_key_t key, uint32_t window_id, uint32_t color, uint32_t menubar_style)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<uint32_t>::Slot window_id;
+        LIPC::Wire<uint32_t>::Slot color;
+        LIPC::Wire<uint32_t>::Slot menubar_style;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x531b84ea;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<uint32_t>::View window_id() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->window_id); }
+        LIPC::Wire<uint32_t>::View color() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->color); }
+        LIPC::Wire<uint32_t>::View menubar_style() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->menubar_style); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    SetBarStyleMessage(message_key_t key,uint32_t window_id,uint32_t color,uint32_t menubar_style)
         : m_key(key)
         , m_window_id(window_id)
         , m_color(color)
         , m_menubar_style(menubar_style)
     {
     }
+    explicit SetBarStyleMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_window_id(LIPC::Wire<uint32_t>::materialize(view.window_id()))
+        , m_color(LIPC::Wire<uint32_t>::materialize(view.color()))
+        , m_menubar_style(LIPC::Wire<uint32_t>::materialize(view.menubar_style()))
+    {
+    }
     int id() const override { return 8; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
@@ -255,18 +679,25 @@ public:
     uint32_t window_id() const { return m_window_id; }
     uint32_t color() const { return m_color; }
     uint32_t menubar_style() const { return m_menubar_style; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.window_id = LIPC::Wire<uint32_t>::encode(m_window_id, buf, tail);
+        layout.color = LIPC::Wire<uint32_t>::encode(m_color, buf, tail);
+        layout.menubar_style = LIPC::Wire<uint32_t>::encode(m_menubar_style, buf, tail);
+        layout.header = { 320, 8, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_window_id);
-        Encoder::append(buffer, m_color);
-        Encoder::append(buffer, m_menubar_style);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     uint32_t m_window_id;
@@ -276,29 +707,81 @@ private:
 
 class SetTitleMessage : public Message {
 public:
-    SetTitleMessage(message_key_t key, uint32_t window_id, LIPC::StringEncoder title)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<uint32_t>::Slot window_id;
+        LIPC::Wire<LIPC::StringEncoder>::Slot title;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x2c41f954;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return LIPC::Wire<LIPC::StringEncoder>::validate(msg, layout->header.size, layout->title);
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<uint32_t>::View window_id() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->window_id); }
+        LIPC::Wire<LIPC::StringEncoder>::View title() const { return LIPC::Wire<LIPC::StringEncoder>::view(m_msg, layout()->title); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    SetTitleMessage(message_key_t key,uint32_t window_id,LIPC::StringEncoder title)
         : m_key(key)
         , m_window_id(window_id)
         , m_title(title)
     {
     }
+    explicit SetTitleMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_window_id(LIPC::Wire<uint32_t>::materialize(view.window_id()))
+        , m_title(LIPC::Wire<LIPC::StringEncoder>::materialize(view.title()))
+    {
+    }
     int id() const override { return 9; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
     int decoder_magic() const override { return 320; }
     uint32_t window_id() const { return m_window_id; }
     LIPC::StringEncoder& title() { return m_title; }
+    size_t encoded_size() const override { return fixed_size + LIPC::Wire<LIPC::StringEncoder>::tail_size(m_title); }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.window_id = LIPC::Wire<uint32_t>::encode(m_window_id, buf, tail);
+        layout.title = LIPC::Wire<LIPC::StringEncoder>::encode(m_title, buf, tail);
+        layout.header = { 320, 9, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_window_id);
-        Encoder::append(buffer, m_title);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     uint32_t m_window_id;
@@ -307,29 +790,81 @@ private:
 
 class InvalidateMessage : public Message {
 public:
-    InvalidateMessage(message_key_t key, uint32_t window_id, LG::Rect rect)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<uint32_t>::Slot window_id;
+        LIPC::Wire<LG::Rect>::Slot rect;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x4310b8a5;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<uint32_t>::View window_id() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->window_id); }
+        LIPC::Wire<LG::Rect>::View rect() const { return LIPC::Wire<LG::Rect>::view(m_msg, layout()->rect); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    InvalidateMessage(message_key_t key,uint32_t window_id,LG::Rect rect)
         : m_key(key)
         , m_window_id(window_id)
         , m_rect(rect)
     {
     }
+    explicit InvalidateMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_window_id(LIPC::Wire<uint32_t>::materialize(view.window_id()))
+        , m_rect(LIPC::Wire<LG::Rect>::materialize(view.rect()))
+    {
+    }
     int id() const override { return 10; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
     int decoder_magic() const override { return 320; }
     uint32_t window_id() const { return m_window_id; }
     LG::Rect& rect() { return m_rect; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.window_id = LIPC::Wire<uint32_t>::encode(m_window_id, buf, tail);
+        layout.rect = LIPC::Wire<LG::Rect>::encode(m_rect, buf, tail);
+        layout.header = { 320, 10, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_window_id);
-        Encoder::append(buffer, m_rect);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     uint32_t m_window_id;
@@ -338,29 +873,81 @@ private:
 
 class AskBringToFrontMessage : public Message {
 public:
-    AskBringToFrontMessage(message_key_t key, uint32_t window_id, uint32_t target_window_id)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<uint32_t>::Slot window_id;
+        LIPC::Wire<uint32_t>::Slot target_window_id;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x395349ea;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<uint32_t>::View window_id() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->window_id); }
+        LIPC::Wire<uint32_t>::View target_window_id() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->target_window_id); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    AskBringToFrontMessage(message_key_t key,uint32_t window_id,uint32_t target_window_id)
         : m_key(key)
         , m_window_id(window_id)
         , m_target_window_id(target_window_id)
     {
     }
+    explicit AskBringToFrontMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_window_id(LIPC::Wire<uint32_t>::materialize(view.window_id()))
+        , m_target_window_id(LIPC::Wire<uint32_t>::materialize(view.target_window_id()))
+    {
+    }
     int id() const override { return 11; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
     int decoder_magic() const override { return 320; }
     uint32_t window_id() const { return m_window_id; }
     uint32_t target_window_id() const { return m_target_window_id; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.window_id = LIPC::Wire<uint32_t>::encode(m_window_id, buf, tail);
+        layout.target_window_id = LIPC::Wire<uint32_t>::encode(m_target_window_id, buf, tail);
+        layout.header = { 320, 11, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_window_id);
-        Encoder::append(buffer, m_target_window_id);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     uint32_t m_window_id;
@@ -369,29 +956,81 @@ private:
 
 class MenuBarCreateMenuMessage : public Message {
 public:
-    MenuBarCreateMenuMessage(message_key_t key, uint32_t window_id, LIPC::StringEncoder title)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<uint32_t>::Slot window_id;
+        LIPC::Wire<LIPC::StringEncoder>::Slot title;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x10fbe343;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return LIPC::Wire<LIPC::StringEncoder>::validate(msg, layout->header.size, layout->title);
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<uint32_t>::View window_id() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->window_id); }
+        LIPC::Wire<LIPC::StringEncoder>::View title() const { return LIPC::Wire<LIPC::StringEncoder>::view(m_msg, layout()->title); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    MenuBarCreateMenuMessage(message_key_t key,uint32_t window_id,LIPC::StringEncoder title)
         : m_key(key)
         , m_window_id(window_id)
         , m_title(title)
     {
     }
+    explicit MenuBarCreateMenuMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_window_id(LIPC::Wire<uint32_t>::materialize(view.window_id()))
+        , m_title(LIPC::Wire<LIPC::StringEncoder>::materialize(view.title()))
+    {
+    }
     int id() const override { return 12; }
     int reply_id() const override { return 13; }
     int key() const override { return m_key; }
     int decoder_magic() const override { return 320; }
     uint32_t window_id() const { return m_window_id; }
     LIPC::StringEncoder& title() { return m_title; }
+    size_t encoded_size() const override { return fixed_size + LIPC::Wire<LIPC::StringEncoder>::tail_size(m_title); }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.window_id = LIPC::Wire<uint32_t>::encode(m_window_id, buf, tail);
+        layout.title = LIPC::Wire<LIPC::StringEncoder>::encode(m_title, buf, tail);
+        layout.header = { 320, 12, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_window_id);
-        Encoder::append(buffer, m_title);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     uint32_t m_window_id;
@@ -400,29 +1039,81 @@ private:
 
 class MenuBarCreateMenuMessageReply : public Message {
 public:
-    MenuBarCreateMenuMessageReply(message_key_t key, int status, int menu_id)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot status;
+        LIPC::Wire<int>::Slot menu_id;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x88c89b9e;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View status() const { return LIPC::Wire<int>::view(m_msg, layout()->status); }
+        LIPC::Wire<int>::View menu_id() const { return LIPC::Wire<int>::view(m_msg, layout()->menu_id); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    MenuBarCreateMenuMessageReply(message_key_t key,int status,int menu_id)
         : m_key(key)
         , m_status(status)
         , m_menu_id(menu_id)
     {
     }
+    explicit MenuBarCreateMenuMessageReply(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_status(LIPC::Wire<int>::materialize(view.status()))
+        , m_menu_id(LIPC::Wire<int>::materialize(view.menu_id()))
+    {
+    }
     int id() const override { return 13; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
     int decoder_magic() const override { return 320; }
     int status() const { return m_status; }
     int menu_id() const { return m_menu_id; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.status = LIPC::Wire<int>::encode(m_status, buf, tail);
+        layout.menu_id = LIPC::Wire<int>::encode(m_menu_id, buf, tail);
+        layout.header = { 320, 13, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_status);
-        Encoder::append(buffer, m_menu_id);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     int m_status;
@@ -431,7 +1122,50 @@ private:
 
 class MenuBarCreateItemMessage : public Message {
 public:
-    MenuBarCreateItemMessage(message_key_t key, uint32_t window_id, int menu_id, int item_id, LIPC::StringEncoder title)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<uint32_t>::Slot window_id;
+        LIPC::Wire<int>::Slot menu_id;
+        LIPC::Wire<int>::Slot item_id;
+        LIPC::Wire<LIPC::StringEncoder>::Slot title;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x8f153bef;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return LIPC::Wire<LIPC::StringEncoder>::validate(msg, layout->header.size, layout->title);
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<uint32_t>::View window_id() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->window_id); }
+        LIPC::Wire<int>::View menu_id() const { return LIPC::Wire<int>::view(m_msg, layout()->menu_id); }
+        LIPC::Wire<int>::View item_id() const { return LIPC::Wire<int>::view(m_msg, layout()->item_id); }
+        LIPC::Wire<LIPC::StringEncoder>::View title() const { return LIPC::Wire<LIPC::StringEncoder>::view(m_msg, layout()->title); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    MenuBarCreateItemMessage(message_key_t key,uint32_t window_id,int menu_id,int item_id,LIPC::StringEncoder title)
         : m_key(key)
         , m_window_id(window_id)
         , m_menu_id(menu_id)
@@ -439,6 +1173,14 @@ public:
         , m_title(title)
     {
     }
+    explicit MenuBarCreateItemMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_window_id(LIPC::Wire<uint32_t>::materialize(view.window_id()))
+        , m_menu_id(LIPC::Wire<int>::materialize(view.menu_id()))
+        , m_item_id(LIPC::Wire<int>::materialize(view.item_id()))
+        , m_title(LIPC::Wire<LIPC::StringEncoder>::materialize(view.title()))
+    {
+    }
     int id() const override { return 14; }
     int reply_id() const override { return 15; }
     int key() const override { return m_key; }
@@ -447,19 +1189,26 @@ public:
     int menu_id() const { return m_menu_id; }
     int item_id() const { return m_item_id; }
     LIPC::StringEncoder& title() { return m_title; }
+    size_t encoded_size() const override { return fixed_size + LIPC::Wire<LIPC::StringEncoder>::tail_size(m_title); }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.window_id = LIPC::Wire<uint32_t>::encode(m_window_id, buf, tail);
+        layout.menu_id = LIPC::Wire<int>::encode(m_menu_id, buf, tail);
+        layout.item_id = LIPC::Wire<int>::encode(m_item_id, buf, tail);
+        layout.title = LIPC::Wire<LIPC::StringEncoder>::encode(m_title, buf, tail);
+        layout.header = { 320, 14, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_window_id);
-        Encoder::append(buffer, m_menu_id);
-        Encoder::append(buffer, m_item_id);
-        Encoder::append(buffer, m_title);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     uint32_t m_window_id;
@@ -470,26 +1219,75 @@ private:
 
 class MenuBarCreateItemMessageReply : public Message {
 public:
-    MenuBarCreateItemMessageReply(message_key_t key, int status)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot status;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x3bdfa4a2;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View status() const { return LIPC::Wire<int>::view(m_msg, layout()->status); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    MenuBarCreateItemMessageReply(message_key_t key,int status)
         : m_key(key)
         , m_status(status)
     {
     }
+    explicit MenuBarCreateItemMessageReply(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_status(LIPC::Wire<int>::materialize(view.status()))
+    {
+    }
     int id() const override { return 15; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
     int decoder_magic() const override { return 320; }
     int status() const { return m_status; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.status = LIPC::Wire<int>::encode(m_status, buf, tail);
+        layout.header = { 320, 15, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_status);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     int m_status;
@@ -497,13 +1295,61 @@ private:
 
 class PopupShowMenuMessage : public Message {
 public:
-    PopupShowMenuMessage(message_key_t key, uint32_t window_id, LG::Point<int> point, LIPC::VectorEncoder<LIPC::StringEncoder> data)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<uint32_t>::Slot window_id;
+        LIPC::Wire<LG::Point<int>>::Slot point;
+        LIPC::Wire<LIPC::VectorEncoder<LIPC::StringEncoder>>::Slot data;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0xb15eb20d;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return LIPC::Wire<LIPC::VectorEncoder<LIPC::StringEncoder>>::validate(msg, layout->header.size, layout->data);
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<uint32_t>::View window_id() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->window_id); }
+        LIPC::Wire<LG::Point<int>>::View point() const { return LIPC::Wire<LG::Point<int>>::view(m_msg, layout()->point); }
+        LIPC::Wire<LIPC::VectorEncoder<LIPC::StringEncoder>>::View data() const { return LIPC::Wire<LIPC::VectorEncoder<LIPC::StringEncoder>>::view(m_msg, layout()->data); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    PopupShowMenuMessage(message_key_t key,uint32_t window_id,LG::Point<int> point,LIPC::VectorEncoder<LIPC::StringEncoder> data)
         : m_key(key)
         , m_window_id(window_id)
         , m_point(point)
         , m_data(data)
     {
     }
+    explicit PopupShowMenuMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_window_id(LIPC::Wire<uint32_t>::materialize(view.window_id()))
+        , m_point(LIPC::Wire<LG::Point<int>>::materialize(view.point()))
+        , m_data(LIPC::Wire<LIPC::VectorEncoder<LIPC::StringEncoder>>::materialize(view.data()))
+    {
+    }
     int id() const override { return 16; }
     int reply_id() const override { return 17; }
     int key() const override { return m_key; }
@@ -511,18 +1357,25 @@ public:
     uint32_t window_id() const { return m_window_id; }
     LG::Point<int>& point() { return m_point; }
     LIPC::VectorEncoder<LIPC::StringEncoder>& data() { return m_data; }
+    size_t encoded_size() const override { return fixed_size + LIPC::Wire<LIPC::VectorEncoder<LIPC::StringEncoder>>::tail_size(m_data); }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.window_id = LIPC::Wire<uint32_t>::encode(m_window_id, buf, tail);
+        layout.point = LIPC::Wire<LG::Point<int>>::encode(m_point, buf, tail);
+        layout.data = LIPC::Wire<LIPC::VectorEncoder<LIPC::StringEncoder>>::encode(m_data, buf, tail);
+        layout.header = { 320, 16, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_window_id);
-        Encoder::append(buffer, m_point);
-        Encoder::append(buffer, m_data);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     uint32_t m_window_id;
@@ -532,150 +1385,577 @@ private:
 
 class PopupShowMenuMessageReply : public Message {
 public:
-    PopupShowMenuMessageReply(message_key_t key, int status, int menu_id)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot status;
+        LIPC::Wire<int>::Slot menu_id;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x78ab7628;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View status() const { return LIPC::Wire<int>::view(m_msg, layout()->status); }
+        LIPC::Wire<int>::View menu_id() const { return LIPC::Wire<int>::view(m_msg, layout()->menu_id); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    PopupShowMenuMessageReply(message_key_t key,int status,int menu_id)
         : m_key(key)
         , m_status(status)
         , m_menu_id(menu_id)
     {
     }
+    explicit PopupShowMenuMessageReply(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_status(LIPC::Wire<int>::materialize(view.status()))
+        , m_menu_id(LIPC::Wire<int>::materialize(view.menu_id()))
+    {
+    }
     int id() const override { return 17; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
     int decoder_magic() const override { return 320; }
     int status() const { return m_status; }
     int menu_id() const { return m_menu_id; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.status = LIPC::Wire<int>::encode(m_status, buf, tail);
+        layout.menu_id = LIPC::Wire<int>::encode(m_menu_id, buf, tail);
+        layout.header = { 320, 17, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_status);
-        Encoder::append(buffer, m_menu_id);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     int m_status;
     int m_menu_id;
 };
 
+class GetGlyphAtlasMessage : public Message {
+public:
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot font;
+        LIPC::Wire<uint32_t>::Slot font_size;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x9a70156b;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View font() const { return LIPC::Wire<int>::view(m_msg, layout()->font); }
+        LIPC::Wire<uint32_t>::View font_size() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->font_size); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    GetGlyphAtlasMessage(message_key_t key,int font,uint32_t font_size)
+        : m_key(key)
+        , m_font(font)
+        , m_font_size(font_size)
+    {
+    }
+    explicit GetGlyphAtlasMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_font(LIPC::Wire<int>::materialize(view.font()))
+        , m_font_size(LIPC::Wire<uint32_t>::materialize(view.font_size()))
+    {
+    }
+    int id() const override { return 18; }
+    int reply_id() const override { return 19; }
+    int key() const override { return m_key; }
+    int decoder_magic() const override { return 320; }
+    int font() const { return m_font; }
+    uint32_t font_size() const { return m_font_size; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.font = LIPC::Wire<int>::encode(m_font, buf, tail);
+        layout.font_size = LIPC::Wire<uint32_t>::encode(m_font_size, buf, tail);
+        layout.header = { 320, 18, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
+    EncodedMessage encode() const override
+    {
+        EncodedMessage buffer;
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
+        return buffer;
+    }
+private:
+    message_key_t m_key;
+    int m_font;
+    uint32_t m_font_size;
+};
+
+class GetGlyphAtlasMessageReply : public Message {
+public:
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot buffer_id;
+        LIPC::Wire<uint32_t>::Slot atlas_size;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x266a5292;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View buffer_id() const { return LIPC::Wire<int>::view(m_msg, layout()->buffer_id); }
+        LIPC::Wire<uint32_t>::View atlas_size() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->atlas_size); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    GetGlyphAtlasMessageReply(message_key_t key,int buffer_id,uint32_t atlas_size)
+        : m_key(key)
+        , m_buffer_id(buffer_id)
+        , m_atlas_size(atlas_size)
+    {
+    }
+    explicit GetGlyphAtlasMessageReply(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_buffer_id(LIPC::Wire<int>::materialize(view.buffer_id()))
+        , m_atlas_size(LIPC::Wire<uint32_t>::materialize(view.atlas_size()))
+    {
+    }
+    int id() const override { return 19; }
+    int reply_id() const override { return -1; }
+    int key() const override { return m_key; }
+    int decoder_magic() const override { return 320; }
+    int buffer_id() const { return m_buffer_id; }
+    uint32_t atlas_size() const { return m_atlas_size; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.buffer_id = LIPC::Wire<int>::encode(m_buffer_id, buf, tail);
+        layout.atlas_size = LIPC::Wire<uint32_t>::encode(m_atlas_size, buf, tail);
+        layout.header = { 320, 19, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
+    EncodedMessage encode() const override
+    {
+        EncodedMessage buffer;
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
+        return buffer;
+    }
+private:
+    message_key_t m_key;
+    int m_buffer_id;
+    uint32_t m_atlas_size;
+};
+
+class GetSharedImageMessage : public Message {
+public:
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<LIPC::StringEncoder>::Slot path;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x87c6a4cf;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return LIPC::Wire<LIPC::StringEncoder>::validate(msg, layout->header.size, layout->path);
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<LIPC::StringEncoder>::View path() const { return LIPC::Wire<LIPC::StringEncoder>::view(m_msg, layout()->path); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    GetSharedImageMessage(message_key_t key,LIPC::StringEncoder path)
+        : m_key(key)
+        , m_path(path)
+    {
+    }
+    explicit GetSharedImageMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_path(LIPC::Wire<LIPC::StringEncoder>::materialize(view.path()))
+    {
+    }
+    int id() const override { return 20; }
+    int reply_id() const override { return 21; }
+    int key() const override { return m_key; }
+    int decoder_magic() const override { return 320; }
+    LIPC::StringEncoder& path() { return m_path; }
+    size_t encoded_size() const override { return fixed_size + LIPC::Wire<LIPC::StringEncoder>::tail_size(m_path); }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.path = LIPC::Wire<LIPC::StringEncoder>::encode(m_path, buf, tail);
+        layout.header = { 320, 20, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
+    EncodedMessage encode() const override
+    {
+        EncodedMessage buffer;
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
+        return buffer;
+    }
+private:
+    message_key_t m_key;
+    LIPC::StringEncoder m_path;
+};
+
+class GetSharedImageMessageReply : public Message {
+public:
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot buffer_id;
+        LIPC::Wire<uint32_t>::Slot offset;
+        LIPC::Wire<uint32_t>::Slot width;
+        LIPC::Wire<uint32_t>::Slot height;
+        LIPC::Wire<int>::Slot format;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x3a43f1d4;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View buffer_id() const { return LIPC::Wire<int>::view(m_msg, layout()->buffer_id); }
+        LIPC::Wire<uint32_t>::View offset() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->offset); }
+        LIPC::Wire<uint32_t>::View width() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->width); }
+        LIPC::Wire<uint32_t>::View height() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->height); }
+        LIPC::Wire<int>::View format() const { return LIPC::Wire<int>::view(m_msg, layout()->format); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    GetSharedImageMessageReply(message_key_t key,int buffer_id,uint32_t offset,uint32_t width,uint32_t height,int format)
+        : m_key(key)
+        , m_buffer_id(buffer_id)
+        , m_offset(offset)
+        , m_width(width)
+        , m_height(height)
+        , m_format(format)
+    {
+    }
+    explicit GetSharedImageMessageReply(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_buffer_id(LIPC::Wire<int>::materialize(view.buffer_id()))
+        , m_offset(LIPC::Wire<uint32_t>::materialize(view.offset()))
+        , m_width(LIPC::Wire<uint32_t>::materialize(view.width()))
+        , m_height(LIPC::Wire<uint32_t>::materialize(view.height()))
+        , m_format(LIPC::Wire<int>::materialize(view.format()))
+    {
+    }
+    int id() const override { return 21; }
+    int reply_id() const override { return -1; }
+    int key() const override { return m_key; }
+    int decoder_magic() const override { return 320; }
+    int buffer_id() const { return m_buffer_id; }
+    uint32_t offset() const { return m_offset; }
+    uint32_t width() const { return m_width; }
+    uint32_t height() const { return m_height; }
+    int format() const { return m_format; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.buffer_id = LIPC::Wire<int>::encode(m_buffer_id, buf, tail);
+        layout.offset = LIPC::Wire<uint32_t>::encode(m_offset, buf, tail);
+        layout.width = LIPC::Wire<uint32_t>::encode(m_width, buf, tail);
+        layout.height = LIPC::Wire<uint32_t>::encode(m_height, buf, tail);
+        layout.format = LIPC::Wire<int>::encode(m_format, buf, tail);
+        layout.header = { 320, 21, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
+    EncodedMessage encode() const override
+    {
+        EncodedMessage buffer;
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
+        return buffer;
+    }
+private:
+    message_key_t m_key;
+    int m_buffer_id;
+    uint32_t m_offset;
+    uint32_t m_width;
+    uint32_t m_height;
+    int m_format;
+};
+
 class BaseWindowServerDecoder : public MessageDecoder {
 public:
-    BaseWindowServerDecoder() { }
+    BaseWindowServerDecoder() {}
     int magic() const { return 320; }
     std::unique_ptr<Message> decode(const char* buf, size_t size, size_t& decoded_msg_len) override
     {
-        int msg_id, decoder_magic;
-        size_t saved_dml = decoded_msg_len;
-        Encoder::decode(buf, decoded_msg_len, decoder_magic);
-        Encoder::decode(buf, decoded_msg_len, msg_id);
-        if (magic() != decoder_magic) {
-            decoded_msg_len = saved_dml;
+        const uint8_t* msg = (const uint8_t*)buf;
+        LIPC::MessageHeader header;
+        if (size < sizeof(header)) {
+            return nullptr;
+        }
+        memcpy(&header, msg, sizeof(header));
+        if (magic() != header.decoder_magic) {
             return nullptr;
         }
-        message_key_t secret_key;
-        Encoder::decode(buf, decoded_msg_len, secret_key);
-
-        uint32_t var_connection_id;
-        int var_type;
-        uint32_t var_width;
-        uint32_t var_height;
-        int var_buffer_id;
-        LIPC::StringEncoder var_title;
-        LIPC::StringEncoder var_icon_path;
-        LIPC::StringEncoder var_bundle_id;
-        uint32_t var_color;
-        uint32_t var_menubar_style;
-        uint32_t var_window_id;
-        uint32_t var_status;
-        int var_format;
-        LG::Rect var_bounds;
-        LG::Rect var_rect;
-        uint32_t var_target_window_id;
-        int var_menu_id;
-        int var_item_id;
-        LG::Point<int> var_point;
-        LIPC::VectorEncoder<LIPC::StringEncoder> var_data;
-
-        switch (msg_id) {
+
+        switch (header.id) {
         case 1:
-            return new GreetMessage(secret_key);
+            if (!GreetMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new GreetMessage(GreetMessage::View(msg));
         case 2:
-            Encoder::decode(buf, decoded_msg_len, var_connection_id);
-            return new GreetMessageReply(secret_key, var_connection_id);
+            if (!GreetMessageReply::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new GreetMessageReply(GreetMessageReply::View(msg));
         case 3:
-            Encoder::decode(buf, decoded_msg_len, var_type);
-            Encoder::decode(buf, decoded_msg_len, var_width);
-            Encoder::decode(buf, decoded_msg_len, var_height);
-            Encoder::decode(buf, decoded_msg_len, var_buffer_id);
-            Encoder::decode(buf, decoded_msg_len, var_title);
-            Encoder::decode(buf, decoded_msg_len, var_icon_path);
-            Encoder::decode(buf, decoded_msg_len, var_bundle_id);
-            Encoder::decode(buf, decoded_msg_len, var_color);
-            Encoder::decode(buf, decoded_msg_len, var_menubar_style);
-            return new CreateWindowMessage(secret_key, var_type, var_width, var_height, var_buffer_id, var_title, var_icon_path, var_bundle_id, var_color, var_menubar_style);
+            if (!CreateWindowMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new CreateWindowMessage(CreateWindowMessage::View(msg));
         case 4:
-            Encoder::decode(buf, decoded_msg_len, var_window_id);
-            return new CreateWindowMessageReply(secret_key, var_window_id);
+            if (!CreateWindowMessageReply::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new CreateWindowMessageReply(CreateWindowMessageReply::View(msg));
         case 5:
-            Encoder::decode(buf, decoded_msg_len, var_window_id);
-            return new DestroyWindowMessage(secret_key, var_window_id);
+            if (!DestroyWindowMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new DestroyWindowMessage(DestroyWindowMessage::View(msg));
         case 6:
-            Encoder::decode(buf, decoded_msg_len, var_status);
-            return new DestroyWindowMessageReply(secret_key, var_status);
+            if (!DestroyWindowMessageReply::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new DestroyWindowMessageReply(DestroyWindowMessageReply::View(msg));
         case 7:
-            Encoder::decode(buf, decoded_msg_len, var_window_id);
-            Encoder::decode(buf, decoded_msg_len, var_buffer_id);
-            Encoder::decode(buf, decoded_msg_len, var_format);
-            Encoder::decode(buf, decoded_msg_len, var_bounds);
-            return new SetBufferMessage(secret_key, var_window_id, var_buffer_id, var_format, var_bounds);
+            if (!SetBufferMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new SetBufferMessage(SetBufferMessage::View(msg));
         case 8:
-            Encoder::decode(buf, decoded_msg_len, var_window_id);
-            Encoder::decode(buf, decoded_msg_len, var_color);
-            Encoder::decode(buf, decoded_msg_len, var_menubar_style);
-            return new SetBarStyleMessage(secret_key, var_window_id, var_color, var_menubar_style);
+            if (!SetBarStyleMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new SetBarStyleMessage(SetBarStyleMessage::View(msg));
         case 9:
-            Encoder::decode(buf, decoded_msg_len, var_window_id);
-            Encoder::decode(buf, decoded_msg_len, var_title);
-            return new SetTitleMessage(secret_key, var_window_id, var_title);
+            if (!SetTitleMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new SetTitleMessage(SetTitleMessage::View(msg));
         case 10:
-            Encoder::decode(buf, decoded_msg_len, var_window_id);
-            Encoder::decode(buf, decoded_msg_len, var_rect);
-            return new InvalidateMessage(secret_key, var_window_id, var_rect);
+            if (!InvalidateMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new InvalidateMessage(InvalidateMessage::View(msg));
         case 11:
-            Encoder::decode(buf, decoded_msg_len, var_window_id);
-            Encoder::decode(buf, decoded_msg_len, var_target_window_id);
-            return new AskBringToFrontMessage(secret_key, var_window_id, var_target_window_id);
+            if (!AskBringToFrontMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new AskBringToFrontMessage(AskBringToFrontMessage::View(msg));
         case 12:
-            Encoder::decode(buf, decoded_msg_len, var_window_id);
-            Encoder::decode(buf, decoded_msg_len, var_title);
-            return new MenuBarCreateMenuMessage(secret_key, var_window_id, var_title);
+            if (!MenuBarCreateMenuMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new MenuBarCreateMenuMessage(MenuBarCreateMenuMessage::View(msg));
         case 13:
-            Encoder::decode(buf, decoded_msg_len, var_status);
-            Encoder::decode(buf, decoded_msg_len, var_menu_id);
-            return new MenuBarCreateMenuMessageReply(secret_key, var_status, var_menu_id);
+            if (!MenuBarCreateMenuMessageReply::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new MenuBarCreateMenuMessageReply(MenuBarCreateMenuMessageReply::View(msg));
         case 14:
-            Encoder::decode(buf, decoded_msg_len, var_window_id);
-            Encoder::decode(buf, decoded_msg_len, var_menu_id);
-            Encoder::decode(buf, decoded_msg_len, var_item_id);
-            Encoder::decode(buf, decoded_msg_len, var_title);
-            return new MenuBarCreateItemMessage(secret_key, var_window_id, var_menu_id, var_item_id, var_title);
+            if (!MenuBarCreateItemMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new MenuBarCreateItemMessage(MenuBarCreateItemMessage::View(msg));
         case 15:
-            Encoder::decode(buf, decoded_msg_len, var_status);
-            return new MenuBarCreateItemMessageReply(secret_key, var_status);
+            if (!MenuBarCreateItemMessageReply::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new MenuBarCreateItemMessageReply(MenuBarCreateItemMessageReply::View(msg));
         case 16:
-            Encoder::decode(buf, decoded_msg_len, var_window_id);
-            Encoder::decode(buf, decoded_msg_len, var_point);
-            Encoder::decode(buf, decoded_msg_len, var_data);
-            return new PopupShowMenuMessage(secret_key, var_window_id, var_point, var_data);
+            if (!PopupShowMenuMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new PopupShowMenuMessage(PopupShowMenuMessage::View(msg));
         case 17:
-            Encoder::decode(buf, decoded_msg_len, var_status);
-            Encoder::decode(buf, decoded_msg_len, var_menu_id);
-            return new PopupShowMenuMessageReply(secret_key, var_status, var_menu_id);
+            if (!PopupShowMenuMessageReply::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new PopupShowMenuMessageReply(PopupShowMenuMessageReply::View(msg));
+        case 18:
+            if (!GetGlyphAtlasMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new GetGlyphAtlasMessage(GetGlyphAtlasMessage::View(msg));
+        case 19:
+            if (!GetGlyphAtlasMessageReply::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new GetGlyphAtlasMessageReply(GetGlyphAtlasMessageReply::View(msg));
+        case 20:
+            if (!GetSharedImageMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new GetSharedImageMessage(GetSharedImageMessage::View(msg));
+        case 21:
+            if (!GetSharedImageMessageReply::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new GetSharedImageMessageReply(GetSharedImageMessageReply::View(msg));
         default:
-            decoded_msg_len = saved_dml;
             return nullptr;
         }
     }
@@ -685,8 +1965,8 @@ public:
         if (magic() != msg.decoder_magic()) {
             return nullptr;
         }
-
-        switch (msg.id()) {
+        
+        switch(msg.id()) {
         case 1:
             return handle(static_cast<GreetMessage&>(msg));
         case 3:
@@ -709,11 +1989,15 @@ public:
             return handle(static_cast<MenuBarCreateItemMessage&>(msg));
         case 16:
             return handle(static_cast<PopupShowMenuMessage&>(msg));
+        case 18:
+            return handle(static_cast<GetGlyphAtlasMessage&>(msg));
+        case 20:
+            return handle(static_cast<GetSharedImageMessage&>(msg));
         default:
             return nullptr;
         }
     }
-
+    
     virtual std::unique_ptr<Message> handle(GreetMessage& msg) { return nullptr; }
     virtual std::unique_ptr<Message> handle(CreateWindowMessage& msg) { return nullptr; }
     virtual std::unique_ptr<Message> handle(DestroyWindowMessage& msg) { return nullptr; }
@@ -725,17 +2009,67 @@ public:
     virtual std::unique_ptr<Message> handle(MenuBarCreateMenuMessage& msg) { return nullptr; }
     virtual std::unique_ptr<Message> handle(MenuBarCreateItemMessage& msg) { return nullptr; }
     virtual std::unique_ptr<Message> handle(PopupShowMenuMessage& msg) { return nullptr; }
+    virtual std::unique_ptr<Message> handle(GetGlyphAtlasMessage& msg) { return nullptr; }
+    virtual std::unique_ptr<Message> handle(GetSharedImageMessage& msg) { return nullptr; }
 };
 
 class MouseMoveMessage : public Message {
 public:
-    MouseMoveMessage(message_key_t key, int win_id, uint32_t x, uint32_t y)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot win_id;
+        LIPC::Wire<uint32_t>::Slot x;
+        LIPC::Wire<uint32_t>::Slot y;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x514926d7;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View win_id() const { return LIPC::Wire<int>::view(m_msg, layout()->win_id); }
+        LIPC::Wire<uint32_t>::View x() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->x); }
+        LIPC::Wire<uint32_t>::View y() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->y); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    MouseMoveMessage(message_key_t key,int win_id,uint32_t x,uint32_t y)
         : m_key(key)
         , m_win_id(win_id)
         , m_x(x)
         , m_y(y)
     {
     }
+    explicit MouseMoveMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_win_id(LIPC::Wire<int>::materialize(view.win_id()))
+        , m_x(LIPC::Wire<uint32_t>::materialize(view.x()))
+        , m_y(LIPC::Wire<uint32_t>::materialize(view.y()))
+    {
+    }
     int id() const override { return 1; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
@@ -743,18 +2077,25 @@ public:
     int win_id() const { return m_win_id; }
     uint32_t x() const { return m_x; }
     uint32_t y() const { return m_y; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.win_id = LIPC::Wire<int>::encode(m_win_id, buf, tail);
+        layout.x = LIPC::Wire<uint32_t>::encode(m_x, buf, tail);
+        layout.y = LIPC::Wire<uint32_t>::encode(m_y, buf, tail);
+        layout.header = { 737, 1, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_win_id);
-        Encoder::append(buffer, m_x);
-        Encoder::append(buffer, m_y);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     int m_win_id;
@@ -764,7 +2105,50 @@ private:
 
 class MouseActionMessage : public Message {
 public:
-    MouseActionMessage(message_key_t key, int win_id, int type, uint32_t x, uint32_t y)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot win_id;
+        LIPC::Wire<int>::Slot type;
+        LIPC::Wire<uint32_t>::Slot x;
+        LIPC::Wire<uint32_t>::Slot y;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0xa54bfd28;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View win_id() const { return LIPC::Wire<int>::view(m_msg, layout()->win_id); }
+        LIPC::Wire<int>::View type() const { return LIPC::Wire<int>::view(m_msg, layout()->type); }
+        LIPC::Wire<uint32_t>::View x() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->x); }
+        LIPC::Wire<uint32_t>::View y() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->y); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    MouseActionMessage(message_key_t key,int win_id,int type,uint32_t x,uint32_t y)
         : m_key(key)
         , m_win_id(win_id)
         , m_type(type)
@@ -772,6 +2156,14 @@ public:
         , m_y(y)
     {
     }
+    explicit MouseActionMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_win_id(LIPC::Wire<int>::materialize(view.win_id()))
+        , m_type(LIPC::Wire<int>::materialize(view.type()))
+        , m_x(LIPC::Wire<uint32_t>::materialize(view.x()))
+        , m_y(LIPC::Wire<uint32_t>::materialize(view.y()))
+    {
+    }
     int id() const override { return 2; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
@@ -780,19 +2172,26 @@ public:
     int type() const { return m_type; }
     uint32_t x() const { return m_x; }
     uint32_t y() const { return m_y; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.win_id = LIPC::Wire<int>::encode(m_win_id, buf, tail);
+        layout.type = LIPC::Wire<int>::encode(m_type, buf, tail);
+        layout.x = LIPC::Wire<uint32_t>::encode(m_x, buf, tail);
+        layout.y = LIPC::Wire<uint32_t>::encode(m_y, buf, tail);
+        layout.header = { 737, 2, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_win_id);
-        Encoder::append(buffer, m_type);
-        Encoder::append(buffer, m_x);
-        Encoder::append(buffer, m_y);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     int m_win_id;
@@ -803,13 +2202,61 @@ private:
 
 class MouseLeaveMessage : public Message {
 public:
-    MouseLeaveMessage(message_key_t key, int win_id, uint32_t x, uint32_t y)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot win_id;
+        LIPC::Wire<uint32_t>::Slot x;
+        LIPC::Wire<uint32_t>::Slot y;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0xb43be4d1;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View win_id() const { return LIPC::Wire<int>::view(m_msg, layout()->win_id); }
+        LIPC::Wire<uint32_t>::View x() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->x); }
+        LIPC::Wire<uint32_t>::View y() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->y); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    MouseLeaveMessage(message_key_t key,int win_id,uint32_t x,uint32_t y)
         : m_key(key)
         , m_win_id(win_id)
         , m_x(x)
         , m_y(y)
     {
     }
+    explicit MouseLeaveMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_win_id(LIPC::Wire<int>::materialize(view.win_id()))
+        , m_x(LIPC::Wire<uint32_t>::materialize(view.x()))
+        , m_y(LIPC::Wire<uint32_t>::materialize(view.y()))
+    {
+    }
     int id() const override { return 3; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
@@ -817,18 +2264,25 @@ public:
     int win_id() const { return m_win_id; }
     uint32_t x() const { return m_x; }
     uint32_t y() const { return m_y; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.win_id = LIPC::Wire<int>::encode(m_win_id, buf, tail);
+        layout.x = LIPC::Wire<uint32_t>::encode(m_x, buf, tail);
+        layout.y = LIPC::Wire<uint32_t>::encode(m_y, buf, tail);
+        layout.header = { 737, 3, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_win_id);
-        Encoder::append(buffer, m_x);
-        Encoder::append(buffer, m_y);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     int m_win_id;
@@ -838,7 +2292,50 @@ private:
 
 class MouseWheelMessage : public Message {
 public:
-    MouseWheelMessage(message_key_t key, int win_id, int wheel_data, uint32_t x, uint32_t y)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot win_id;
+        LIPC::Wire<int>::Slot wheel_data;
+        LIPC::Wire<uint32_t>::Slot x;
+        LIPC::Wire<uint32_t>::Slot y;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0xde6fc9a7;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View win_id() const { return LIPC::Wire<int>::view(m_msg, layout()->win_id); }
+        LIPC::Wire<int>::View wheel_data() const { return LIPC::Wire<int>::view(m_msg, layout()->wheel_data); }
+        LIPC::Wire<uint32_t>::View x() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->x); }
+        LIPC::Wire<uint32_t>::View y() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->y); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    MouseWheelMessage(message_key_t key,int win_id,int wheel_data,uint32_t x,uint32_t y)
         : m_key(key)
         , m_win_id(win_id)
         , m_wheel_data(wheel_data)
@@ -846,6 +2343,14 @@ public:
         , m_y(y)
     {
     }
+    explicit MouseWheelMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_win_id(LIPC::Wire<int>::materialize(view.win_id()))
+        , m_wheel_data(LIPC::Wire<int>::materialize(view.wheel_data()))
+        , m_x(LIPC::Wire<uint32_t>::materialize(view.x()))
+        , m_y(LIPC::Wire<uint32_t>::materialize(view.y()))
+    {
+    }
     int id() const override { return 4; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
@@ -854,19 +2359,26 @@ public:
     int wheel_data() const { return m_wheel_data; }
     uint32_t x() const { return m_x; }
     uint32_t y() const { return m_y; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.win_id = LIPC::Wire<int>::encode(m_win_id, buf, tail);
+        layout.wheel_data = LIPC::Wire<int>::encode(m_wheel_data, buf, tail);
+        layout.x = LIPC::Wire<uint32_t>::encode(m_x, buf, tail);
+        layout.y = LIPC::Wire<uint32_t>::encode(m_y, buf, tail);
+        layout.header = { 737, 4, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_win_id);
-        Encoder::append(buffer, m_wheel_data);
-        Encoder::append(buffer, m_x);
-        Encoder::append(buffer, m_y);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     int m_win_id;
@@ -877,29 +2389,81 @@ private:
 
 class KeyboardMessage : public Message {
 public:
-    KeyboardMessage(message_key_t key, int win_id, uint32_t kbd_key)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot win_id;
+        LIPC::Wire<uint32_t>::Slot kbd_key;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0xb19a92f3;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View win_id() const { return LIPC::Wire<int>::view(m_msg, layout()->win_id); }
+        LIPC::Wire<uint32_t>::View kbd_key() const { return LIPC::Wire<uint32_t>::view(m_msg, layout()->kbd_key); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    KeyboardMessage(message_key_t key,int win_id,uint32_t kbd_key)
         : m_key(key)
         , m_win_id(win_id)
         , m_kbd_key(kbd_key)
     {
     }
+    explicit KeyboardMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_win_id(LIPC::Wire<int>::materialize(view.win_id()))
+        , m_kbd_key(LIPC::Wire<uint32_t>::materialize(view.kbd_key()))
+    {
+    }
     int id() const override { return 5; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
     int decoder_magic() const override { return 737; }
     int win_id() const { return m_win_id; }
     uint32_t kbd_key() const { return m_kbd_key; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.win_id = LIPC::Wire<int>::encode(m_win_id, buf, tail);
+        layout.kbd_key = LIPC::Wire<uint32_t>::encode(m_kbd_key, buf, tail);
+        layout.header = { 737, 5, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_win_id);
-        Encoder::append(buffer, m_kbd_key);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     int m_win_id;
@@ -908,26 +2472,75 @@ private:
 
 class DisplayMessage : public Message {
 public:
-    DisplayMessage(message_key_t key, LG::Rect rect)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<LG::Rect>::Slot rect;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x54b34e1a;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<LG::Rect>::View rect() const { return LIPC::Wire<LG::Rect>::view(m_msg, layout()->rect); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    DisplayMessage(message_key_t key,LG::Rect rect)
         : m_key(key)
         , m_rect(rect)
     {
     }
+    explicit DisplayMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_rect(LIPC::Wire<LG::Rect>::materialize(view.rect()))
+    {
+    }
     int id() const override { return 6; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
     int decoder_magic() const override { return 737; }
     LG::Rect& rect() { return m_rect; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.rect = LIPC::Wire<LG::Rect>::encode(m_rect, buf, tail);
+        layout.header = { 737, 6, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_rect);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     LG::Rect m_rect;
@@ -935,26 +2548,75 @@ private:
 
 class WindowCloseRequestMessage : public Message {
 public:
-    WindowCloseRequestMessage(message_key_t key, int win_id)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot win_id;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x9d933b7c;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View win_id() const { return LIPC::Wire<int>::view(m_msg, layout()->win_id); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    WindowCloseRequestMessage(message_key_t key,int win_id)
         : m_key(key)
         , m_win_id(win_id)
     {
     }
+    explicit WindowCloseRequestMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_win_id(LIPC::Wire<int>::materialize(view.win_id()))
+    {
+    }
     int id() const override { return 7; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
     int decoder_magic() const override { return 737; }
     int win_id() const { return m_win_id; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.win_id = LIPC::Wire<int>::encode(m_win_id, buf, tail);
+        layout.header = { 737, 7, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_win_id);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     int m_win_id;
@@ -962,29 +2624,81 @@ private:
 
 class ResizeMessage : public Message {
 public:
-    ResizeMessage(message_key_t key, int win_id, LG::Rect rect)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot win_id;
+        LIPC::Wire<LG::Rect>::Slot rect;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x697780f1;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View win_id() const { return LIPC::Wire<int>::view(m_msg, layout()->win_id); }
+        LIPC::Wire<LG::Rect>::View rect() const { return LIPC::Wire<LG::Rect>::view(m_msg, layout()->rect); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    ResizeMessage(message_key_t key,int win_id,LG::Rect rect)
         : m_key(key)
         , m_win_id(win_id)
         , m_rect(rect)
     {
     }
+    explicit ResizeMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_win_id(LIPC::Wire<int>::materialize(view.win_id()))
+        , m_rect(LIPC::Wire<LG::Rect>::materialize(view.rect()))
+    {
+    }
     int id() const override { return 8; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
     int decoder_magic() const override { return 737; }
     int win_id() const { return m_win_id; }
     LG::Rect& rect() { return m_rect; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.win_id = LIPC::Wire<int>::encode(m_win_id, buf, tail);
+        layout.rect = LIPC::Wire<LG::Rect>::encode(m_rect, buf, tail);
+        layout.header = { 737, 8, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_win_id);
-        Encoder::append(buffer, m_rect);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     int m_win_id;
@@ -993,26 +2707,75 @@ private:
 
 class DisconnectMessage : public Message {
 public:
-    DisconnectMessage(message_key_t key, int reason)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot reason;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x4bce2958;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View reason() const { return LIPC::Wire<int>::view(m_msg, layout()->reason); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    DisconnectMessage(message_key_t key,int reason)
         : m_key(key)
         , m_reason(reason)
     {
     }
+    explicit DisconnectMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_reason(LIPC::Wire<int>::materialize(view.reason()))
+    {
+    }
     int id() const override { return 9; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
     int decoder_magic() const override { return 737; }
     int reason() const { return m_reason; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.reason = LIPC::Wire<int>::encode(m_reason, buf, tail);
+        layout.header = { 737, 9, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_reason);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     int m_reason;
@@ -1020,13 +2783,61 @@ private:
 
 class MenuBarActionMessage : public Message {
 public:
-    MenuBarActionMessage(message_key_t key, int win_id, int menu_id, int item_id)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot win_id;
+        LIPC::Wire<int>::Slot menu_id;
+        LIPC::Wire<int>::Slot item_id;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x36d189b7;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View win_id() const { return LIPC::Wire<int>::view(m_msg, layout()->win_id); }
+        LIPC::Wire<int>::View menu_id() const { return LIPC::Wire<int>::view(m_msg, layout()->menu_id); }
+        LIPC::Wire<int>::View item_id() const { return LIPC::Wire<int>::view(m_msg, layout()->item_id); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    MenuBarActionMessage(message_key_t key,int win_id,int menu_id,int item_id)
         : m_key(key)
         , m_win_id(win_id)
         , m_menu_id(menu_id)
         , m_item_id(item_id)
     {
     }
+    explicit MenuBarActionMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_win_id(LIPC::Wire<int>::materialize(view.win_id()))
+        , m_menu_id(LIPC::Wire<int>::materialize(view.menu_id()))
+        , m_item_id(LIPC::Wire<int>::materialize(view.item_id()))
+    {
+    }
     int id() const override { return 10; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
@@ -1034,18 +2845,25 @@ public:
     int win_id() const { return m_win_id; }
     int menu_id() const { return m_menu_id; }
     int item_id() const { return m_item_id; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.win_id = LIPC::Wire<int>::encode(m_win_id, buf, tail);
+        layout.menu_id = LIPC::Wire<int>::encode(m_menu_id, buf, tail);
+        layout.item_id = LIPC::Wire<int>::encode(m_item_id, buf, tail);
+        layout.header = { 737, 10, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_win_id);
-        Encoder::append(buffer, m_menu_id);
-        Encoder::append(buffer, m_item_id);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     int m_win_id;
@@ -1055,13 +2873,61 @@ private:
 
 class PopupActionMessage : public Message {
 public:
-    PopupActionMessage(message_key_t key, int win_id, int menu_id, int item_id)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot win_id;
+        LIPC::Wire<int>::Slot menu_id;
+        LIPC::Wire<int>::Slot item_id;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0x3893ef46;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View win_id() const { return LIPC::Wire<int>::view(m_msg, layout()->win_id); }
+        LIPC::Wire<int>::View menu_id() const { return LIPC::Wire<int>::view(m_msg, layout()->menu_id); }
+        LIPC::Wire<int>::View item_id() const { return LIPC::Wire<int>::view(m_msg, layout()->item_id); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    PopupActionMessage(message_key_t key,int win_id,int menu_id,int item_id)
         : m_key(key)
         , m_win_id(win_id)
         , m_menu_id(menu_id)
         , m_item_id(item_id)
     {
     }
+    explicit PopupActionMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_win_id(LIPC::Wire<int>::materialize(view.win_id()))
+        , m_menu_id(LIPC::Wire<int>::materialize(view.menu_id()))
+        , m_item_id(LIPC::Wire<int>::materialize(view.item_id()))
+    {
+    }
     int id() const override { return 11; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
@@ -1069,18 +2935,25 @@ public:
     int win_id() const { return m_win_id; }
     int menu_id() const { return m_menu_id; }
     int item_id() const { return m_item_id; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.win_id = LIPC::Wire<int>::encode(m_win_id, buf, tail);
+        layout.menu_id = LIPC::Wire<int>::encode(m_menu_id, buf, tail);
+        layout.item_id = LIPC::Wire<int>::encode(m_item_id, buf, tail);
+        layout.header = { 737, 11, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_win_id);
-        Encoder::append(buffer, m_menu_id);
-        Encoder::append(buffer, m_item_id);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     int m_win_id;
@@ -1090,7 +2963,53 @@ private:
 
 class NotifyWindowCreateMessage : public Message {
 public:
-    NotifyWindowCreateMessage(message_key_t key, int win_id, LIPC::StringEncoder bundle_id, LIPC::StringEncoder icon_path, int changed_window_id, int changed_window_type)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot win_id;
+        LIPC::Wire<LIPC::StringEncoder>::Slot bundle_id;
+        LIPC::Wire<LIPC::StringEncoder>::Slot icon_path;
+        LIPC::Wire<int>::Slot changed_window_id;
+        LIPC::Wire<int>::Slot changed_window_type;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0xd8fe7acd;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return LIPC::Wire<LIPC::StringEncoder>::validate(msg, layout->header.size, layout->bundle_id)
+                && LIPC::Wire<LIPC::StringEncoder>::validate(msg, layout->header.size, layout->icon_path);
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View win_id() const { return LIPC::Wire<int>::view(m_msg, layout()->win_id); }
+        LIPC::Wire<LIPC::StringEncoder>::View bundle_id() const { return LIPC::Wire<LIPC::StringEncoder>::view(m_msg, layout()->bundle_id); }
+        LIPC::Wire<LIPC::StringEncoder>::View icon_path() const { return LIPC::Wire<LIPC::StringEncoder>::view(m_msg, layout()->icon_path); }
+        LIPC::Wire<int>::View changed_window_id() const { return LIPC::Wire<int>::view(m_msg, layout()->changed_window_id); }
+        LIPC::Wire<int>::View changed_window_type() const { return LIPC::Wire<int>::view(m_msg, layout()->changed_window_type); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    NotifyWindowCreateMessage(message_key_t key,int win_id,LIPC::StringEncoder bundle_id,LIPC::StringEncoder icon_path,int changed_window_id,int changed_window_type)
         : m_key(key)
         , m_win_id(win_id)
         , m_bundle_id(bundle_id)
@@ -1099,6 +3018,15 @@ public:
         , m_changed_window_type(changed_window_type)
     {
     }
+    explicit NotifyWindowCreateMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_win_id(LIPC::Wire<int>::materialize(view.win_id()))
+        , m_bundle_id(LIPC::Wire<LIPC::StringEncoder>::materialize(view.bundle_id()))
+        , m_icon_path(LIPC::Wire<LIPC::StringEncoder>::materialize(view.icon_path()))
+        , m_changed_window_id(LIPC::Wire<int>::materialize(view.changed_window_id()))
+        , m_changed_window_type(LIPC::Wire<int>::materialize(view.changed_window_type()))
+    {
+    }
     int id() const override { return 12; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
@@ -1108,20 +3036,27 @@ public:
     LIPC::StringEncoder& icon_path() { return m_icon_path; }
     int changed_window_id() const { return m_changed_window_id; }
     int changed_window_type() const { return m_changed_window_type; }
+    size_t encoded_size() const override { return fixed_size + LIPC::Wire<LIPC::StringEncoder>::tail_size(m_bundle_id) + LIPC::Wire<LIPC::StringEncoder>::tail_size(m_icon_path); }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.win_id = LIPC::Wire<int>::encode(m_win_id, buf, tail);
+        layout.bundle_id = LIPC::Wire<LIPC::StringEncoder>::encode(m_bundle_id, buf, tail);
+        layout.icon_path = LIPC::Wire<LIPC::StringEncoder>::encode(m_icon_path, buf, tail);
+        layout.changed_window_id = LIPC::Wire<int>::encode(m_changed_window_id, buf, tail);
+        layout.changed_window_type = LIPC::Wire<int>::encode(m_changed_window_type, buf, tail);
+        layout.header = { 737, 12, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_win_id);
-        Encoder::append(buffer, m_bundle_id);
-        Encoder::append(buffer, m_icon_path);
-        Encoder::append(buffer, m_changed_window_id);
-        Encoder::append(buffer, m_changed_window_type);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     int m_win_id;
@@ -1133,13 +3068,61 @@ private:
 
 class NotifyWindowStatusChangedMessage : public Message {
 public:
-    NotifyWindowStatusChangedMessage(message_key_t key, int win_id, int changed_window_id, int type)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot win_id;
+        LIPC::Wire<int>::Slot changed_window_id;
+        LIPC::Wire<int>::Slot type;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0xf97b37d8;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return true;
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View win_id() const { return LIPC::Wire<int>::view(m_msg, layout()->win_id); }
+        LIPC::Wire<int>::View changed_window_id() const { return LIPC::Wire<int>::view(m_msg, layout()->changed_window_id); }
+        LIPC::Wire<int>::View type() const { return LIPC::Wire<int>::view(m_msg, layout()->type); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    NotifyWindowStatusChangedMessage(message_key_t key,int win_id,int changed_window_id,int type)
         : m_key(key)
         , m_win_id(win_id)
         , m_changed_window_id(changed_window_id)
         , m_type(type)
     {
     }
+    explicit NotifyWindowStatusChangedMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_win_id(LIPC::Wire<int>::materialize(view.win_id()))
+        , m_changed_window_id(LIPC::Wire<int>::materialize(view.changed_window_id()))
+        , m_type(LIPC::Wire<int>::materialize(view.type()))
+    {
+    }
     int id() const override { return 13; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
@@ -1147,18 +3130,25 @@ public:
     int win_id() const { return m_win_id; }
     int changed_window_id() const { return m_changed_window_id; }
     int type() const { return m_type; }
+    size_t encoded_size() const override { return fixed_size; }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.win_id = LIPC::Wire<int>::encode(m_win_id, buf, tail);
+        layout.changed_window_id = LIPC::Wire<int>::encode(m_changed_window_id, buf, tail);
+        layout.type = LIPC::Wire<int>::encode(m_type, buf, tail);
+        layout.header = { 737, 13, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_win_id);
-        Encoder::append(buffer, m_changed_window_id);
-        Encoder::append(buffer, m_type);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     int m_win_id;
@@ -1168,13 +3158,61 @@ private:
 
 class NotifyWindowTitleChangedMessage : public Message {
 public:
-    NotifyWindowTitleChangedMessage(message_key_t key, int win_id, int changed_window_id, LIPC::StringEncoder title)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot win_id;
+        LIPC::Wire<int>::Slot changed_window_id;
+        LIPC::Wire<LIPC::StringEncoder>::Slot title;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0xe4f89f9f;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return LIPC::Wire<LIPC::StringEncoder>::validate(msg, layout->header.size, layout->title);
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View win_id() const { return LIPC::Wire<int>::view(m_msg, layout()->win_id); }
+        LIPC::Wire<int>::View changed_window_id() const { return LIPC::Wire<int>::view(m_msg, layout()->changed_window_id); }
+        LIPC::Wire<LIPC::StringEncoder>::View title() const { return LIPC::Wire<LIPC::StringEncoder>::view(m_msg, layout()->title); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    NotifyWindowTitleChangedMessage(message_key_t key,int win_id,int changed_window_id,LIPC::StringEncoder title)
         : m_key(key)
         , m_win_id(win_id)
         , m_changed_window_id(changed_window_id)
         , m_title(title)
     {
     }
+    explicit NotifyWindowTitleChangedMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_win_id(LIPC::Wire<int>::materialize(view.win_id()))
+        , m_changed_window_id(LIPC::Wire<int>::materialize(view.changed_window_id()))
+        , m_title(LIPC::Wire<LIPC::StringEncoder>::materialize(view.title()))
+    {
+    }
     int id() const override { return 14; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
@@ -1182,18 +3220,25 @@ public:
     int win_id() const { return m_win_id; }
     int changed_window_id() const { return m_changed_window_id; }
     LIPC::StringEncoder& title() { return m_title; }
+    size_t encoded_size() const override { return fixed_size + LIPC::Wire<LIPC::StringEncoder>::tail_size(m_title); }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.win_id = LIPC::Wire<int>::encode(m_win_id, buf, tail);
+        layout.changed_window_id = LIPC::Wire<int>::encode(m_changed_window_id, buf, tail);
+        layout.title = LIPC::Wire<LIPC::StringEncoder>::encode(m_title, buf, tail);
+        layout.header = { 737, 14, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_win_id);
-        Encoder::append(buffer, m_changed_window_id);
-        Encoder::append(buffer, m_title);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     int m_win_id;
@@ -1203,13 +3248,61 @@ private:
 
 class NotifyWindowIconChangedMessage : public Message {
 public:
-    NotifyWindowIconChangedMessage(message_key_t key, int win_id, int changed_window_id, LIPC::StringEncoder icon_path)
+    struct [[gnu::packed]] Layout {
+        LIPC::MessageHeader header;
+        LIPC::Wire<message_key_t>::Slot key;
+        LIPC::Wire<int>::Slot win_id;
+        LIPC::Wire<int>::Slot changed_window_id;
+        LIPC::Wire<LIPC::StringEncoder>::Slot icon_path;
+    };
+    static constexpr size_t fixed_size = sizeof(Layout);
+    static constexpr uint32_t layout_version = 0xee060d91;
+
+    // Reads the encoded message in place, valid while the buffer is alive.
+    class View {
+    public:
+        explicit View(const uint8_t* msg)
+            : m_msg(msg)
+        {
+        }
+
+        static bool validate(const uint8_t* msg, size_t size)
+        {
+            const Layout* layout = (const Layout*)msg;
+            if (size < fixed_size || layout->header.layout_version != layout_version) {
+                return false;
+            }
+            if (layout->header.size < fixed_size || layout->header.size > size) {
+                return false;
+            }
+            return LIPC::Wire<LIPC::StringEncoder>::validate(msg, layout->header.size, layout->icon_path);
+        }
+
+        size_t size() const { return layout()->header.size; }
+        LIPC::Wire<message_key_t>::View key() const { return LIPC::Wire<message_key_t>::view(m_msg, layout()->key); }
+        LIPC::Wire<int>::View win_id() const { return LIPC::Wire<int>::view(m_msg, layout()->win_id); }
+        LIPC::Wire<int>::View changed_window_id() const { return LIPC::Wire<int>::view(m_msg, layout()->changed_window_id); }
+        LIPC::Wire<LIPC::StringEncoder>::View icon_path() const { return LIPC::Wire<LIPC::StringEncoder>::view(m_msg, layout()->icon_path); }
+
+    private:
+        const Layout* layout() const { return (const Layout*)m_msg; }
+        const uint8_t* m_msg;
+    };
+
+    NotifyWindowIconChangedMessage(message_key_t key,int win_id,int changed_window_id,LIPC::StringEncoder icon_path)
         : m_key(key)
         , m_win_id(win_id)
         , m_changed_window_id(changed_window_id)
         , m_icon_path(icon_path)
     {
     }
+    explicit NotifyWindowIconChangedMessage(const View& view)
+        : m_key(LIPC::Wire<message_key_t>::materialize(view.key()))
+        , m_win_id(LIPC::Wire<int>::materialize(view.win_id()))
+        , m_changed_window_id(LIPC::Wire<int>::materialize(view.changed_window_id()))
+        , m_icon_path(LIPC::Wire<LIPC::StringEncoder>::materialize(view.icon_path()))
+    {
+    }
     int id() const override { return 15; }
     int reply_id() const override { return -1; }
     int key() const override { return m_key; }
@@ -1217,18 +3310,25 @@ public:
     int win_id() const { return m_win_id; }
     int changed_window_id() const { return m_changed_window_id; }
     LIPC::StringEncoder& icon_path() { return m_icon_path; }
+    size_t encoded_size() const override { return fixed_size + LIPC::Wire<LIPC::StringEncoder>::tail_size(m_icon_path); }
+    void encode_to(uint8_t* buf) const override
+    {
+        Layout layout;
+        size_t tail = fixed_size;
+        layout.key = LIPC::Wire<message_key_t>::encode(m_key, buf, tail);
+        layout.win_id = LIPC::Wire<int>::encode(m_win_id, buf, tail);
+        layout.changed_window_id = LIPC::Wire<int>::encode(m_changed_window_id, buf, tail);
+        layout.icon_path = LIPC::Wire<LIPC::StringEncoder>::encode(m_icon_path, buf, tail);
+        layout.header = { 737, 15, (uint32_t)tail, layout_version };
+        memcpy(buf, &layout, sizeof(layout));
+    }
     EncodedMessage encode() const override
     {
         EncodedMessage buffer;
-        Encoder::append(buffer, decoder_magic());
-        Encoder::append(buffer, id());
-        Encoder::append(buffer, key());
-        Encoder::append(buffer, m_win_id);
-        Encoder::append(buffer, m_changed_window_id);
-        Encoder::append(buffer, m_icon_path);
+        buffer.resize(encoded_size());
+        encode_to(buffer.data());
         return buffer;
     }
-
 private:
     message_key_t m_key;
     int m_win_id;
@@ -1238,111 +3338,112 @@ private:
 
 class BaseWindowClientDecoder : public MessageDecoder {
 public:
-    BaseWindowClientDecoder() { }
+    BaseWindowClientDecoder() {}
     int magic() const { return 737; }
     std::unique_ptr<Message> decode(const char* buf, size_t size, size_t& decoded_msg_len) override
     {
-        int msg_id, decoder_magic;
-        size_t saved_dml = decoded_msg_len;
-        Encoder::decode(buf, decoded_msg_len, decoder_magic);
-        Encoder::decode(buf, decoded_msg_len, msg_id);
-        if (magic() != decoder_magic) {
-            decoded_msg_len = saved_dml;
+        const uint8_t* msg = (const uint8_t*)buf;
+        LIPC::MessageHeader header;
+        if (size < sizeof(header)) {
+            return nullptr;
+        }
+        memcpy(&header, msg, sizeof(header));
+        if (magic() != header.decoder_magic) {
             return nullptr;
         }
-        message_key_t secret_key;
-        Encoder::decode(buf, decoded_msg_len, secret_key);
-
-        int var_win_id;
-        uint32_t var_x;
-        uint32_t var_y;
-        int var_type;
-        int var_wheel_data;
-        uint32_t var_kbd_key;
-        LG::Rect var_rect;
-        int var_reason;
-        int var_menu_id;
-        int var_item_id;
-        LIPC::StringEncoder var_bundle_id;
-        LIPC::StringEncoder var_icon_path;
-        int var_changed_window_id;
-        int var_changed_window_type;
-        LIPC::StringEncoder var_title;
-
-        switch (msg_id) {
+
+        switch (header.id) {
         case 1:
-            Encoder::decode(buf, decoded_msg_len, var_win_id);
-            Encoder::decode(buf, decoded_msg_len, var_x);
-            Encoder::decode(buf, decoded_msg_len, var_y);
-            return new MouseMoveMessage(secret_key, var_win_id, var_x, var_y);
+            if (!MouseMoveMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new MouseMoveMessage(MouseMoveMessage::View(msg));
         case 2:
-            Encoder::decode(buf, decoded_msg_len, var_win_id);
-            Encoder::decode(buf, decoded_msg_len, var_type);
-            Encoder::decode(buf, decoded_msg_len, var_x);
-            Encoder::decode(buf, decoded_msg_len, var_y);
-            return new MouseActionMessage(secret_key, var_win_id, var_type, var_x, var_y);
+            if (!MouseActionMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new MouseActionMessage(MouseActionMessage::View(msg));
         case 3:
-            Encoder::decode(buf, decoded_msg_len, var_win_id);
-            Encoder::decode(buf, decoded_msg_len, var_x);
-            Encoder::decode(buf, decoded_msg_len, var_y);
-            return new MouseLeaveMessage(secret_key, var_win_id, var_x, var_y);
+            if (!MouseLeaveMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new MouseLeaveMessage(MouseLeaveMessage::View(msg));
         case 4:
-            Encoder::decode(buf, decoded_msg_len, var_win_id);
-            Encoder::decode(buf, decoded_msg_len, var_wheel_data);
-            Encoder::decode(buf, decoded_msg_len, var_x);
-            Encoder::decode(buf, decoded_msg_len, var_y);
-            return new MouseWheelMessage(secret_key, var_win_id, var_wheel_data, var_x, var_y);
+            if (!MouseWheelMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new MouseWheelMessage(MouseWheelMessage::View(msg));
         case 5:
-            Encoder::decode(buf, decoded_msg_len, var_win_id);
-            Encoder::decode(buf, decoded_msg_len, var_kbd_key);
-            return new KeyboardMessage(secret_key, var_win_id, var_kbd_key);
+            if (!KeyboardMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new KeyboardMessage(KeyboardMessage::View(msg));
         case 6:
-            Encoder::decode(buf, decoded_msg_len, var_rect);
-            return new DisplayMessage(secret_key, var_rect);
+            if (!DisplayMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new DisplayMessage(DisplayMessage::View(msg));
         case 7:
-            Encoder::decode(buf, decoded_msg_len, var_win_id);
-            return new WindowCloseRequestMessage(secret_key, var_win_id);
+            if (!WindowCloseRequestMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new WindowCloseRequestMessage(WindowCloseRequestMessage::View(msg));
         case 8:
-            Encoder::decode(buf, decoded_msg_len, var_win_id);
-            Encoder::decode(buf, decoded_msg_len, var_rect);
-            return new ResizeMessage(secret_key, var_win_id, var_rect);
+            if (!ResizeMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new ResizeMessage(ResizeMessage::View(msg));
         case 9:
-            Encoder::decode(buf, decoded_msg_len, var_reason);
-            return new DisconnectMessage(secret_key, var_reason);
+            if (!DisconnectMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new DisconnectMessage(DisconnectMessage::View(msg));
         case 10:
-            Encoder::decode(buf, decoded_msg_len, var_win_id);
-            Encoder::decode(buf, decoded_msg_len, var_menu_id);
-            Encoder::decode(buf, decoded_msg_len, var_item_id);
-            return new MenuBarActionMessage(secret_key, var_win_id, var_menu_id, var_item_id);
+            if (!MenuBarActionMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new MenuBarActionMessage(MenuBarActionMessage::View(msg));
         case 11:
-            Encoder::decode(buf, decoded_msg_len, var_win_id);
-            Encoder::decode(buf, decoded_msg_len, var_menu_id);
-            Encoder::decode(buf, decoded_msg_len, var_item_id);
-            return new PopupActionMessage(secret_key, var_win_id, var_menu_id, var_item_id);
+            if (!PopupActionMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new PopupActionMessage(PopupActionMessage::View(msg));
         case 12:
-            Encoder::decode(buf, decoded_msg_len, var_win_id);
-            Encoder::decode(buf, decoded_msg_len, var_bundle_id);
-            Encoder::decode(buf, decoded_msg_len, var_icon_path);
-            Encoder::decode(buf, decoded_msg_len, var_changed_window_id);
-            Encoder::decode(buf, decoded_msg_len, var_changed_window_type);
-            return new NotifyWindowCreateMessage(secret_key, var_win_id, var_bundle_id, var_icon_path, var_changed_window_id, var_changed_window_type);
+            if (!NotifyWindowCreateMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new NotifyWindowCreateMessage(NotifyWindowCreateMessage::View(msg));
         case 13:
-            Encoder::decode(buf, decoded_msg_len, var_win_id);
-            Encoder::decode(buf, decoded_msg_len, var_changed_window_id);
-            Encoder::decode(buf, decoded_msg_len, var_type);
-            return new NotifyWindowStatusChangedMessage(secret_key, var_win_id, var_changed_window_id, var_type);
+            if (!NotifyWindowStatusChangedMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new NotifyWindowStatusChangedMessage(NotifyWindowStatusChangedMessage::View(msg));
         case 14:
-            Encoder::decode(buf, decoded_msg_len, var_win_id);
-            Encoder::decode(buf, decoded_msg_len, var_changed_window_id);
-            Encoder::decode(buf, decoded_msg_len, var_title);
-            return new NotifyWindowTitleChangedMessage(secret_key, var_win_id, var_changed_window_id, var_title);
+            if (!NotifyWindowTitleChangedMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new NotifyWindowTitleChangedMessage(NotifyWindowTitleChangedMessage::View(msg));
         case 15:
-            Encoder::decode(buf, decoded_msg_len, var_win_id);
-            Encoder::decode(buf, decoded_msg_len, var_changed_window_id);
-            Encoder::decode(buf, decoded_msg_len, var_icon_path);
-            return new NotifyWindowIconChangedMessage(secret_key, var_win_id, var_changed_window_id, var_icon_path);
+            if (!NotifyWindowIconChangedMessage::View::validate(msg, size)) {
+                return nullptr;
+            }
+            decoded_msg_len += header.size;
+            return new NotifyWindowIconChangedMessage(NotifyWindowIconChangedMessage::View(msg));
         default:
-            decoded_msg_len = saved_dml;
             return nullptr;
         }
     }
@@ -1352,8 +3453,8 @@ public:
         if (magic() != msg.decoder_magic()) {
             return nullptr;
         }
-
-        switch (msg.id()) {
+        
+        switch(msg.id()) {
         case 1:
             return handle(static_cast<MouseMoveMessage&>(msg));
         case 2:
@@ -1388,7 +3489,7 @@ public:
             return nullptr;
         }
     }
-
+    
     virtual std::unique_ptr<Message> handle(MouseMoveMessage& msg) { return nullptr; }
     virtual std::unique_ptr<Message> handle(MouseActionMessage& msg) { return nullptr; }
     virtual std::unique_ptr<Message> handle(MouseLeaveMessage& msg) { return nullptr; }
@@ -1405,3 +3506,4 @@ public:
     virtual std::unique_ptr<Message> handle(NotifyWindowTitleChangedMessage& msg) { return nullptr; }
     virtual std::unique_ptr<Message> handle(NotifyWindowIconChangedMessage& msg) { return nullptr; }
 };
+
@@ -0,0 +1,7 @@
+#ifndef _LIBC_BITS_FUTEX_H
+#define _LIBC_BITS_FUTEX_H
+
+#define FUTEX_WAIT 0
+#define FUTEX_WAKE 1
+
+#endif // _LIBC_BITS_FUTEX_H
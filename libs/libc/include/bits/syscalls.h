@@ -393,6 +393,9 @@ enum __sysid {
     SYS_SHBUF_GET,
     SYS_SHBUF_FREE,
     SYS_PTHREAD_CREATE,
+    SYS_VDSO_GET,
+    SYS_PTHREAD_EXIT,
+    SYS_SET_TLS,
 };
 #elif __arm__
 enum __sysid {
@@ -757,6 +760,9 @@ enum __sysid {
     SYS_PTHREAD_CREATE,
     SYS_MMAP,
     SYS_WAITPID,
+    SYS_VDSO_GET,
+    SYS_PTHREAD_EXIT,
+    SYS_SET_TLS,
 };
 #elif __aarch64__
 enum __sysid {
@@ -1121,6 +1127,9 @@ enum __sysid {
     SYS_PTHREAD_CREATE,
     SYS_MMAP,
     SYS_WAITPID,
+    SYS_VDSO_GET,
+    SYS_PTHREAD_EXIT,
+    SYS_SET_TLS,
 };
 #endif
 
@@ -0,0 +1,32 @@
+#ifndef _LIBC_BITS_VDSO_H
+#define _LIBC_BITS_VDSO_H
+
+#include <stdint.h>
+#include <sys/cdefs.h>
+#include <sys/types.h>
+
+__BEGIN_DECLS
+
+#define VDSO_CYCLES_SHIFT 24
+
+/**
+ * The time page is maintained by the kernel and mapped read-only into
+ * every process. Readers use @seq as a seqlock: an odd value means that
+ * an update is in progress, a changed value means the read must be retried.
+ */
+struct vdso_time_data {
+    uint32_t seq;
+    uint32_t ticks_per_second;
+    uint32_t nsec_per_tick;
+    time_t secs_since_boot;
+    time_t secs_since_epoch;
+    time_t ticks_since_second;
+    uint64_t cycles_at_tick;
+    uint64_t cycles_per_tick;
+    uint64_t cycles_mult; // nsec per cycle << VDSO_CYCLES_SHIFT, 0 if no user-readable counter.
+};
+typedef struct vdso_time_data vdso_time_data_t;
+
+__END_DECLS
+
+#endif // _LIBC_BITS_VDSO_H
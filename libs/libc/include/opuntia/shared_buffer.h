@@ -1,6 +1,7 @@
 #ifndef _LIBC_SYS_SHARED_BUFFER_H
 #define _LIBC_SYS_SHARED_BUFFER_H
 
+#include <bits/shared_buffer.h>
 #include <bits/sys/select.h>
 #include <bits/time.h>
 #include <stddef.h>
@@ -9,8 +10,8 @@
 
 __BEGIN_DECLS
 
-int shared_buffer_create(uint8_t** buffer, size_t size);
-int shared_buffer_get(int id, uint8_t** buffer);
+int shared_buffer_create(uint8_t** buffer, size_t size, uint32_t flags);
+int shared_buffer_get(int id, uint8_t** buffer, uint32_t flags);
 int shared_buffer_free(int id);
 
 __END_DECLS
@@ -2,14 +2,139 @@
 #define _LIBC_PTHREAD_H
 
 #include <bits/thread.h>
+#include <bits/time.h>
+#include <stddef.h>
 #include <sys/_structs.h>
 #include <sys/cdefs.h>
 #include <sys/types.h>
 
 __BEGIN_DECLS
 
-int pthread_create(void* func);
+#define PTHREAD_KEYS_MAX 32
+#define PTHREAD_STACK_MIN (16 * 1024)
+#define PTHREAD_STACK_DEFAULT (64 * 1024)
+
+#define PTHREAD_CREATE_JOINABLE 0
+#define PTHREAD_CREATE_DETACHED 1
+
+#define PTHREAD_MUTEX_NORMAL 0
+#define PTHREAD_MUTEX_RECURSIVE 1
+#define PTHREAD_MUTEX_ERRORCHECK 2
+#define PTHREAD_MUTEX_DEFAULT PTHREAD_MUTEX_NORMAL
+
+struct __pthread;
+typedef struct __pthread* pthread_t;
+
+struct pthread_attr {
+    size_t stack_size;
+    int detach_state;
+};
+typedef struct pthread_attr pthread_attr_t;
+
+struct pthread_mutexattr {
+    int type;
+};
+typedef struct pthread_mutexattr pthread_mutexattr_t;
+
+// state: 0 - unlocked, 1 - locked, 2 - locked and there might be waiters.
+struct pthread_mutex {
+    uint32_t state;
+    int type;
+    pthread_t owner;
+    uint32_t recursion;
+};
+typedef struct pthread_mutex pthread_mutex_t;
+#define PTHREAD_MUTEX_INITIALIZER \
+    {                             \
+        0, PTHREAD_MUTEX_NORMAL   \
+    }
+
+struct pthread_condattr {
+    int unused;
+};
+typedef struct pthread_condattr pthread_condattr_t;
+
+struct pthread_cond {
+    uint32_t seq;
+};
+typedef struct pthread_cond pthread_cond_t;
+#define PTHREAD_COND_INITIALIZER \
+    {                            \
+        0                        \
+    }
+
+struct pthread_rwlockattr {
+    int unused;
+};
+typedef struct pthread_rwlockattr pthread_rwlockattr_t;
+
+struct pthread_rwlock {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int readers;
+    int writer;
+    int waiting_writers;
+};
+typedef struct pthread_rwlock pthread_rwlock_t;
+#define PTHREAD_RWLOCK_INITIALIZER                           \
+    {                                                        \
+        PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER \
+    }
+
+typedef uint32_t pthread_key_t;
+
+struct pthread_once {
+    uint32_t state;
+};
+typedef struct pthread_once pthread_once_t;
+#define PTHREAD_ONCE_INIT \
+    {                     \
+        0                 \
+    }
+
+int pthread_attr_init(pthread_attr_t* attr);
+int pthread_attr_destroy(pthread_attr_t* attr);
+int pthread_attr_setstacksize(pthread_attr_t* attr, size_t stacksize);
+int pthread_attr_getstacksize(const pthread_attr_t* attr, size_t* stacksize);
+int pthread_attr_setdetachstate(pthread_attr_t* attr, int detachstate);
+int pthread_attr_getdetachstate(const pthread_attr_t* attr, int* detachstate);
+
+int pthread_create(pthread_t* thread, const pthread_attr_t* attr, void* (*start_routine)(void*), void* arg);
+int pthread_join(pthread_t thread, void** retval);
+int pthread_detach(pthread_t thread);
+void pthread_exit(void* retval) __attribute__((noreturn));
+pthread_t pthread_self();
+int pthread_equal(pthread_t t1, pthread_t t2);
+
+int pthread_mutexattr_init(pthread_mutexattr_t* attr);
+int pthread_mutexattr_destroy(pthread_mutexattr_t* attr);
+int pthread_mutexattr_settype(pthread_mutexattr_t* attr, int type);
+int pthread_mutex_init(pthread_mutex_t* mutex, const pthread_mutexattr_t* attr);
+int pthread_mutex_destroy(pthread_mutex_t* mutex);
+int pthread_mutex_lock(pthread_mutex_t* mutex);
+int pthread_mutex_trylock(pthread_mutex_t* mutex);
+int pthread_mutex_unlock(pthread_mutex_t* mutex);
+
+int pthread_cond_init(pthread_cond_t* cond, const pthread_condattr_t* attr);
+int pthread_cond_destroy(pthread_cond_t* cond);
+int pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex);
+int pthread_cond_timedwait(pthread_cond_t* cond, pthread_mutex_t* mutex, const struct timespec* abstime);
+int pthread_cond_signal(pthread_cond_t* cond);
+int pthread_cond_broadcast(pthread_cond_t* cond);
+
+int pthread_rwlock_init(pthread_rwlock_t* rwlock, const pthread_rwlockattr_t* attr);
+int pthread_rwlock_destroy(pthread_rwlock_t* rwlock);
+int pthread_rwlock_rdlock(pthread_rwlock_t* rwlock);
+int pthread_rwlock_wrlock(pthread_rwlock_t* rwlock);
+int pthread_rwlock_unlock(pthread_rwlock_t* rwlock);
+
+int pthread_key_create(pthread_key_t* key, void (*destructor)(void*));
+int pthread_key_delete(pthread_key_t key);
+void* pthread_getspecific(pthread_key_t key);
+int pthread_setspecific(pthread_key_t key, const void* value);
+
+int pthread_once(pthread_once_t* once_control, void (*init_routine)());
 
 __END_DECLS
 
-#endif /* _LIBC_PTHREAD_H */
\ No newline at end of file
+#endif /* _LIBC_PTHREAD_H */
@@ -24,11 +24,11 @@ static inline intptr_t _syscall_impl(sysid_t sysid, intptr_t p1, intptr_t p2, in
         movq %4, %%rdx;\
         movq %5, %%r10;\
         movq %6, %%r8;\
-        int $0x80;\
+        syscall;\
         movq %%rax, %0;"
         : "=r"(ret)
         : "r"(sysid), "r"((intptr_t)(p1)), "r"((intptr_t)(p2)), "r"((intptr_t)(p3)), "r"((intptr_t)(p4)), "r"((intptr_t)(p5))
-        : "memory", "rax", "rdi", "rsi", "rdx", "r10", "r8");
+        : "memory", "rax", "rdi", "rsi", "rdx", "r10", "r8", "rcx", "r11");
 #elif __arm__
     asm volatile(
         "mov r7, %1;\
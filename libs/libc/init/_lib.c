@@ -5,10 +5,14 @@ int __environ_malloced = 0;
 extern int _stdio_init();
 extern int _stdio_deinit();
 extern int _malloc_init();
+extern void _vdso_init();
+extern void _pthread_init();
 
 void _libc_init(int argc, char* argv[], char* envp[])
 {
     environ = envp;
+    _pthread_init();
+    _vdso_init();
     _malloc_init();
     _stdio_init();
     extern void (*__init_array_start[])(int, char**, char**) __attribute__((visibility("hidden")));
@@ -1,108 +1,137 @@
 #include "malloc.h"
-#include <assert.h>
+#include <errno.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/mman.h>
 
-#define ALIGNMENT (4)
-#define DEVIDE_SPACE_BOUNDARY (32)
+#define ROUND_UP(x, align) (((x) + (align)-1) & ~((size_t)(align)-1))
 
-static malloc_header_t* memory[MALLOC_MAX_ALLOCATED_BLOCKS];
-static size_t allocated_blocks = 0;
+// Anything bigger would wrap around when rounded up to whole pages.
+#define MALLOC_MAX_SIZE ((size_t)-1 - MALLOC_PAGE_SIZE - sizeof(malloc_header_t))
 
-static int _alloc_new_block(size_t sz);
+static malloc_arena_t arenas[MALLOC_ARENAS];
+static uint32_t next_arena = 0;
 
-static int _alloc_new_block(size_t sz)
+/**
+ * The cache is created on the first allocation of a thread. New threads are
+ * given arenas round-robin, so they start spread over all of them.
+ */
+static malloc_thread_cache_t* _malloc_thread_cache()
 {
-    // TODO: This should be expendable.
-    assert(allocated_blocks < MALLOC_MAX_ALLOCATED_BLOCKS);
+    malloc_thread_cache_t** slot = (malloc_thread_cache_t**)_pthread_malloc_slot();
+    if (*slot) {
+        return *slot;
+    }
 
-    sz += sizeof(malloc_header_t);
+    uint32_t arena_id = __atomic_fetch_add(&next_arena, 1, __ATOMIC_RELAXED) % MALLOC_ARENAS;
+    malloc_arena_t* arena = &arenas[arena_id];
+    pthread_mutex_lock(&arena->lock);
+    malloc_thread_cache_t* cache = slab_alloc(arena, sizeof(malloc_thread_cache_t));
+    pthread_mutex_unlock(&arena->lock);
+    if (!cache) {
+        return NULL;
+    }
 
-    // This reduces system calls for the small memory allocations.
-    size_t allocated_sz = sz > MALLOC_DEFAULT_BLOCK_SIZE ? sz : MALLOC_DEFAULT_BLOCK_SIZE;
+    memset(cache, 0, sizeof(malloc_thread_cache_t));
+    cache->arena = arena_id;
+    *slot = cache;
+    return cache;
+}
 
-    intptr_t ret = (intptr_t)mmap(NULL, allocated_sz, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, 0, 0);
-    if (ret < 0) {
-        return -1;
+/**
+ * A thread sticks to its arena. If that one is busy, the thread moves to
+ * the next free arena and stays there.
+ */
+static malloc_arena_t* _malloc_lock_arena(malloc_thread_cache_t* cache)
+{
+    size_t preferred = cache ? cache->arena : 0;
+    for (size_t i = 0; i < MALLOC_ARENAS; i++) {
+        size_t id = (preferred + i) % MALLOC_ARENAS;
+        if (pthread_mutex_trylock(&arenas[id].lock) == 0) {
+            if (cache) {
+                cache->arena = id;
+            }
+            return &arenas[id];
+        }
     }
-    memory[allocated_blocks] = (void*)ret;
-    memory[allocated_blocks]->flags = 0;
-    memory[allocated_blocks]->next = 0;
-    memory[allocated_blocks]->prev = 0;
-    memory[allocated_blocks]->size = allocated_sz - sizeof(malloc_header_t);
 
-    allocated_blocks++;
-    return 0;
+    pthread_mutex_lock(&arenas[preferred].lock);
+    return &arenas[preferred];
 }
 
-static inline char _malloc_need_to_divide_space(malloc_header_t* space, size_t alloc_size)
+static inline malloc_header_t* _tcache_pop(malloc_thread_cache_t* cache, uint32_t size_class)
 {
-    return alloc_size + DEVIDE_SPACE_BOUNDARY <= space->size;
+    malloc_header_t* chunk = cache->bins[size_class];
+    if (chunk) {
+        cache->bins[size_class] = *(malloc_header_t**)&chunk[1];
+        cache->count[size_class]--;
+    }
+    return chunk;
 }
 
-static inline char _malloc_can_fit_allocation(malloc_header_t* space, size_t alloc_size)
+static inline bool _tcache_push(malloc_thread_cache_t* cache, malloc_header_t* chunk)
 {
-    uint32_t add[] = { 0, sizeof(malloc_header_t) };
-    return space->size >= (alloc_size + add[_malloc_need_to_divide_space(space, alloc_size)]);
+    uint32_t size_class = chunk->span->size_class;
+    if (chunk->size > MALLOC_TCACHE_MAX_SIZE || cache->count[size_class] >= MALLOC_TCACHE_COUNT) {
+        return false;
+    }
+
+    *(malloc_header_t**)&chunk[1] = cache->bins[size_class];
+    cache->bins[size_class] = chunk;
+    cache->count[size_class]++;
+    return true;
 }
 
-void* malloc(size_t sz)
+static void* _malloc_large(size_t sz)
 {
-    if (!sz) {
+    size_t map_size = ROUND_UP(sz + sizeof(malloc_header_t), MALLOC_PAGE_SIZE);
+    intptr_t ret = (intptr_t)mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, 0, 0);
+    if (ret < 0) {
         return NULL;
     }
-    sz += (ALIGNMENT - 1);
-    sz &= ~(uint32_t)(ALIGNMENT - 1);
 
-    void* res = slab_alloc(sz);
-    if (res) {
-        return res;
-    }
+    malloc_header_t* header = (malloc_header_t*)ret;
+    header->size = map_size - sizeof(malloc_header_t);
+    header->flags = FLAG_LARGE | FLAG_ALLOCATED;
+    header->span = NULL;
+    return (void*)&header[1];
+}
 
-    // Iterating over allocated by mmap blocks to find a first fit memory chunk.
-    malloc_header_t* first_fit = NULL;
-    for (size_t i = 0; i < allocated_blocks; i++) {
-        malloc_header_t* cur_block = memory[i];
-        while (cur_block->next && !(block_is_free(cur_block) && _malloc_can_fit_allocation(cur_block, sz))) {
-            cur_block = cur_block->next;
-        }
-        if (block_is_free(cur_block) && _malloc_can_fit_allocation(cur_block, sz)) {
-            first_fit = cur_block;
-            break;
-        }
-    }
+static inline void _free_large(malloc_header_t* mem_header)
+{
+    munmap(mem_header, mem_header->size + sizeof(malloc_header_t));
+}
 
-    if (!first_fit) {
-        int err = _alloc_new_block(sz);
-        if (err) {
-            return NULL;
-        }
-        first_fit = memory[allocated_blocks - 1];
+void* malloc(size_t sz)
+{
+    if (!sz) {
+        return NULL;
     }
+    if (sz > MALLOC_MAX_SIZE) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    sz = ROUND_UP(sz, MALLOC_ALIGNMENT);
 
-    malloc_header_t* copy_next = first_fit->next;
-    size_t copy_size = first_fit->size;
-
-    first_fit->flags |= FLAG_ALLOCATED;
-    if (_malloc_need_to_divide_space(first_fit, sz)) {
-        first_fit->size = sz;
-        first_fit->next = (malloc_header_t*)((uintptr_t)first_fit + sz + sizeof(malloc_header_t));
-
-        // Adjust the firstfit chunk.
-        first_fit->next->flags = 0;
-        first_fit->next->size = copy_size - sz - sizeof(malloc_header_t);
-        first_fit->next->next = copy_next;
-        first_fit->next->prev = first_fit;
+    if (sz > MALLOC_SMALL_MAX) {
+        return _malloc_large(sz);
+    }
 
-        if (first_fit->next->next) {
-            first_fit->next->next->prev = first_fit->next;
+    malloc_thread_cache_t* cache = _malloc_thread_cache();
+    if (cache && sz <= MALLOC_TCACHE_MAX_SIZE) {
+        malloc_header_t* chunk = _tcache_pop(cache, slab_size_class(sz));
+        if (chunk) {
+            block_set_flags(chunk, FLAG_ALLOCATED);
+            return (void*)&chunk[1];
         }
     }
 
-    return (void*)&((malloc_header_t*)first_fit)[1];
+    malloc_arena_t* arena = _malloc_lock_arena(cache);
+    void* res = slab_alloc(arena, sz);
+    pthread_mutex_unlock(&arena->lock);
+    return res;
 }
 
 void free(void* mem)
@@ -112,35 +141,61 @@ void free(void* mem)
     }
 
     malloc_header_t* mem_header = &((malloc_header_t*)mem)[-1];
+    if (!block_is_allocated(mem_header)) {
+        return;
+    }
 
-    if (block_is_slab(mem_header)) {
-        return slab_free(mem_header);
+    if (block_is_large(mem_header)) {
+        return _free_large(mem_header);
     }
 
-    block_rem_flags(mem_header, FLAG_ALLOCATED);
-    while (mem_header->prev && block_is_free(mem_header->prev)) {
-        mem_header = mem_header->prev;
+    malloc_thread_cache_t* cache = *(malloc_thread_cache_t**)_pthread_malloc_slot();
+    if (cache) {
+        block_rem_flags(mem_header, FLAG_ALLOCATED);
+        if (_tcache_push(cache, mem_header)) {
+            return;
+        }
     }
+    slab_free(mem_header);
+}
 
-    // Trying to glue the freed chunk with its neighbours.
-    while (mem_header->next && block_is_free(mem_header->next)) {
-        mem_header->size += mem_header->next->size + sizeof(malloc_header_t);
+/**
+ * Called by an exiting thread, gives its cached chunks back to the arenas.
+ */
+void _malloc_thread_exit()
+{
+    malloc_thread_cache_t** slot = (malloc_thread_cache_t**)_pthread_malloc_slot();
+    malloc_thread_cache_t* cache = *slot;
+    if (!cache) {
+        return;
+    }
 
-        if (mem_header->next->next) {
-            mem_header->next->next->prev = mem_header;
+    *slot = NULL;
+    for (uint32_t size_class = 0; size_class < MALLOC_TCACHE_CLASSES; size_class++) {
+        malloc_header_t* chunk;
+        while ((chunk = _tcache_pop(cache, size_class))) {
+            slab_free(chunk);
         }
-        mem_header->next = mem_header->next->next;
     }
+    slab_free(&((malloc_header_t*)cache)[-1]);
 }
 
 void* calloc(size_t num, size_t size)
 {
-    void* mem = malloc(num * size);
+    size_t total = num * size;
+    if (size && total / size != num) {
+        return NULL;
+    }
+
+    void* mem = malloc(total);
     if (!mem) {
         return NULL;
     }
 
-    memset(mem, 0, num * size);
+    // Fresh mappings are already zeroed by the kernel.
+    if (!block_is_large(&((malloc_header_t*)mem)[-1])) {
+        memset(mem, 0, total);
+    }
     return mem;
 }
 
@@ -149,24 +204,51 @@ void* realloc(void* ptr, size_t new_size)
     if (!ptr) {
         return malloc(new_size);
     }
+    if (!new_size) {
+        free(ptr);
+        return NULL;
+    }
 
-    size_t old_size = ((malloc_header_t*)ptr)[-1].size;
-    if (old_size == new_size) {
+    malloc_header_t* mem_header = &((malloc_header_t*)ptr)[-1];
+    size_t old_size = mem_header->size;
+
+    if (block_is_large(mem_header)) {
+        if (new_size <= old_size) {
+            // Give the tail pages back, but keep small blocks in the slabs.
+            size_t keep = ROUND_UP(new_size + sizeof(malloc_header_t), MALLOC_PAGE_SIZE);
+            size_t mapped = old_size + sizeof(malloc_header_t);
+            if (new_size > MALLOC_SMALL_MAX && keep < mapped) {
+                munmap((void*)((uintptr_t)mem_header + keep), mapped - keep);
+                mem_header->size = keep - sizeof(malloc_header_t);
+            }
+            if (new_size > MALLOC_SMALL_MAX) {
+                return ptr;
+            }
+        }
+    } else if (new_size <= old_size && new_size > old_size / 2) {
         return ptr;
     }
 
-    uint8_t* new_area = malloc(new_size);
+    // Growing blocks get headroom, so a sequence of reallocs is amortized.
+    size_t alloc_size = new_size;
+    if (new_size > old_size && new_size > MALLOC_SMALL_MAX && new_size <= MALLOC_MAX_SIZE - new_size / 4) {
+        alloc_size = new_size + new_size / 4;
+    }
+
+    uint8_t* new_area = malloc(alloc_size);
     if (!new_area) {
         return NULL;
     }
 
     memcpy(new_area, ptr, new_size < old_size ? new_size : old_size);
     free(ptr);
-
     return new_area;
 }
 
 void _malloc_init()
 {
+    for (int i = 0; i < MALLOC_ARENAS; i++) {
+        pthread_mutex_init(&arenas[i].lock, NULL);
+    }
     _slab_init();
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef _LIBC_MALLOC_MALLOC_H
 #define _LIBC_MALLOC_MALLOC_H
 
+#include <pthread.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -9,19 +10,76 @@
 
 __BEGIN_DECLS
 
-#define MALLOC_DEFAULT_BLOCK_SIZE 4096
-#define MALLOC_MAX_ALLOCATED_BLOCKS 256
+#define MALLOC_PAGE_SIZE 4096
+#define MALLOC_ALIGNMENT (2 * sizeof(void*))
+
+// Small allocations are served from spans of a single size class,
+// everything above MALLOC_SMALL_MAX goes directly to mmap.
+#define MALLOC_SPAN_SIZE (64 * 1024)
+#define MALLOC_SMALL_MAX (8 * 1024)
+#define MALLOC_SIZE_CLASSES 32
+
+// Threads are spread over several arenas to keep the locks uncontended.
+#define MALLOC_ARENAS 8
+// Fully free spans kept per class before being returned to the system.
+#define MALLOC_CACHED_EMPTY_SPANS 1
+
+// Freed chunks up to MALLOC_TCACHE_MAX_SIZE, which are the first
+// MALLOC_TCACHE_CLASSES size classes, are kept in a per-thread cache.
+#define MALLOC_TCACHE_MAX_SIZE 1024
+#define MALLOC_TCACHE_CLASSES 20
+#define MALLOC_TCACHE_COUNT 8
 
 #define FLAG_ALLOCATED (0x1)
 #define FLAG_SLAB (0x2)
+#define FLAG_LARGE (0x4)
+
+struct __malloc_span;
+
+/**
+ * Precedes every chunk handed out by malloc(). For slab chunks size is the
+ * size of the class, for large ones it is the usable size of the mapping.
+ */
 struct __malloc_header {
     size_t size;
     uint32_t flags;
-    struct __malloc_header* next;
-    struct __malloc_header* prev;
-};
+    struct __malloc_span* span;
+} __attribute__((aligned(MALLOC_ALIGNMENT)));
 typedef struct __malloc_header malloc_header_t;
 
+struct __malloc_arena;
+
+struct __malloc_span {
+    struct __malloc_arena* arena;
+    struct __malloc_span* next;
+    struct __malloc_span* prev;
+    malloc_header_t* free_list;
+    uintptr_t bump; // Chunks are carved lazily, so untouched pages stay unbacked.
+    uintptr_t end;
+    uint32_t size_class;
+    uint32_t used;
+    uint32_t capacity;
+} __attribute__((aligned(MALLOC_ALIGNMENT)));
+typedef struct __malloc_span malloc_span_t;
+
+struct __malloc_arena {
+    pthread_mutex_t lock;
+    malloc_span_t* partial[MALLOC_SIZE_CLASSES];
+    uint32_t empty_spans[MALLOC_SIZE_CLASSES];
+};
+typedef struct __malloc_arena malloc_arena_t;
+
+/**
+ * Hangs off the thread descriptor. Cached chunks stay allocated in their
+ * spans and are linked through their first word.
+ */
+struct __malloc_thread_cache {
+    uint32_t arena; // The arena the thread sticks to.
+    uint32_t count[MALLOC_TCACHE_CLASSES];
+    malloc_header_t* bins[MALLOC_TCACHE_CLASSES];
+};
+typedef struct __malloc_thread_cache malloc_thread_cache_t;
+
 static inline bool block_has_flags(malloc_header_t* block, uint32_t flags)
 {
     return ((block->flags & flags) == flags);
@@ -42,25 +100,31 @@ static inline bool block_is_allocated(malloc_header_t* block)
     return block_has_flags(block, FLAG_ALLOCATED);
 }
 
-static inline bool block_is_free(malloc_header_t* block)
+static inline bool block_is_slab(malloc_header_t* block)
 {
-    return !block_has_flags(block, FLAG_ALLOCATED);
+    return block_has_flags(block, FLAG_SLAB);
 }
 
-static inline bool block_is_slab(malloc_header_t* block)
+static inline bool block_is_large(malloc_header_t* block)
 {
-    return block_has_flags(block, FLAG_SLAB);
+    return block_has_flags(block, FLAG_LARGE);
 }
 
 void _malloc_init();
+void _malloc_thread_exit();
 void _slab_init();
 
+// Slot of the calling thread's descriptor which keeps its malloc state.
+void** _pthread_malloc_slot();
+
 void* malloc(size_t);
 void free(void*);
 void* calloc(size_t, size_t);
 void* realloc(void*, size_t);
 
-void* slab_alloc(size_t);
+uint32_t slab_size_class(size_t size);
+size_t slab_size_of_class(uint32_t size_class);
+void* slab_alloc(malloc_arena_t* arena, size_t);
 void slab_free(malloc_header_t* mem_header);
 
 __END_DECLS
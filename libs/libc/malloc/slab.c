@@ -3,77 +3,154 @@
 #include <string.h>
 #include <sys/mman.h>
 
-// Fast allocator for sizes 16, 32, 48, 64 bytes
+// Size classes are 16 bytes apart up to 128 bytes and then go in four
+// steps per power of two up to MALLOC_SMALL_MAX, which bounds the internal
+// fragmentation by 25%.
 
-malloc_header_t* free_blocks[5];
+#define SLAB_LINEAR_CLASSES 8
+#define SLAB_LINEAR_MAX 128
+#define SPAN_HEADER_SIZE ((sizeof(malloc_span_t) + MALLOC_ALIGNMENT - 1) & ~(MALLOC_ALIGNMENT - 1))
 
-void prepare_free_blocks(size_t size)
+static inline uint32_t _slab_size_class(size_t size)
 {
-    int block_id = size >> 4;
-    const size_t alloc_size = MALLOC_DEFAULT_BLOCK_SIZE;
-    intptr_t ret = (intptr_t)mmap(NULL, alloc_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, 0, 0);
-    if (ret < 0) {
-        free_blocks[block_id] = NULL;
-        return;
+    if (size <= SLAB_LINEAR_MAX) {
+        return (size + 15) / 16 - 1;
     }
 
-    void* raw_area = (void*)ret;
-    const size_t sizeof_block_with_header = size + sizeof(malloc_header_t);
-    size_t passed = 0;
+    uint32_t log = 8 * sizeof(unsigned long) - 1 - __builtin_clzl(size - 1);
+    return SLAB_LINEAR_CLASSES + (log - 7) * 4 + ((size - 1) >> (log - 2)) - 4;
+}
 
-    free_blocks[block_id] = (malloc_header_t*)raw_area;
-    malloc_header_t* prev_header = NULL;
+uint32_t slab_size_class(size_t size)
+{
+    return _slab_size_class(size);
+}
 
-    while (passed + sizeof_block_with_header <= alloc_size) {
-        malloc_header_t* current = (malloc_header_t*)raw_area;
+size_t slab_size_of_class(uint32_t size_class)
+{
+    if (size_class < SLAB_LINEAR_CLASSES) {
+        return (size_class + 1) * 16;
+    }
 
-        current->flags = FLAG_SLAB | FLAG_ALLOCATED;
-        current->next = NULL;
-        current->prev = prev_header;
-        current->size = size;
+    uint32_t group = (size_class - SLAB_LINEAR_CLASSES) / 4;
+    uint32_t step = (size_class - SLAB_LINEAR_CLASSES) % 4;
+    return (SLAB_LINEAR_MAX << group) + (step + 1) * (32 << group);
+}
 
-        prev_header = current;
-        raw_area += sizeof_block_with_header;
-        passed += sizeof_block_with_header;
+static inline void _slab_list_remove(malloc_arena_t* arena, malloc_span_t* span)
+{
+    if (span->prev) {
+        span->prev->next = span->next;
+    } else {
+        arena->partial[span->size_class] = span->next;
     }
+    if (span->next) {
+        span->next->prev = span->prev;
+    }
+    span->next = NULL;
+    span->prev = NULL;
+}
 
-    malloc_header_t* next_header = NULL;
-    while (prev_header) {
-        prev_header->next = next_header;
-        prev_header = prev_header->prev;
+static inline void _slab_list_push(malloc_arena_t* arena, malloc_span_t* span)
+{
+    span->prev = NULL;
+    span->next = arena->partial[span->size_class];
+    if (span->next) {
+        span->next->prev = span;
+    }
+    arena->partial[span->size_class] = span;
+}
+
+static malloc_span_t* _slab_new_span(malloc_arena_t* arena, uint32_t size_class)
+{
+    intptr_t ret = (intptr_t)mmap(NULL, MALLOC_SPAN_SIZE, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, 0, 0);
+    if (ret < 0) {
+        return NULL;
     }
+
+    const size_t chunk_size = slab_size_of_class(size_class) + sizeof(malloc_header_t);
+    malloc_span_t* span = (malloc_span_t*)ret;
+    span->arena = arena;
+    span->free_list = NULL;
+    span->bump = (uintptr_t)ret + SPAN_HEADER_SIZE;
+    span->end = (uintptr_t)ret + MALLOC_SPAN_SIZE;
+    span->size_class = size_class;
+    span->used = 0;
+    span->capacity = (MALLOC_SPAN_SIZE - SPAN_HEADER_SIZE) / chunk_size;
+    _slab_list_push(arena, span);
+    arena->empty_spans[size_class]++;
+    return span;
 }
 
 void _slab_init()
 {
-    prepare_free_blocks(16);
-    prepare_free_blocks(32);
-    prepare_free_blocks(48);
-    prepare_free_blocks(64);
 }
 
-void* slab_alloc(size_t size)
+/**
+ * The arena must be locked by the caller.
+ */
+void* slab_alloc(malloc_arena_t* arena, size_t size)
 {
-    if (size > 64) {
+    if (size > MALLOC_SMALL_MAX) {
         return NULL;
     }
-    int block_id = ((size + 15) >> 4);
-    malloc_header_t* zone = free_blocks[block_id];
-    if (!zone) {
-        return NULL;
+
+    uint32_t size_class = _slab_size_class(size);
+    malloc_span_t* span = arena->partial[size_class];
+    if (!span) {
+        span = _slab_new_span(arena, size_class);
+        if (!span) {
+            return NULL;
+        }
+    }
+
+    malloc_header_t* chunk = span->free_list;
+    if (chunk) {
+        span->free_list = (malloc_header_t*)chunk->span;
+    } else {
+        chunk = (malloc_header_t*)span->bump;
+        span->bump += slab_size_of_class(size_class) + sizeof(malloc_header_t);
     }
 
-    free_blocks[block_id] = zone->next;
-    return (void*)&((malloc_header_t*)zone)[1];
+    if (!span->used) {
+        arena->empty_spans[size_class]--;
+    }
+    span->used++;
+    if (span->used == span->capacity) {
+        _slab_list_remove(arena, span);
+    }
+
+    chunk->size = slab_size_of_class(size_class);
+    chunk->flags = FLAG_SLAB | FLAG_ALLOCATED;
+    chunk->span = span;
+    return (void*)&chunk[1];
 }
 
 void slab_free(malloc_header_t* mem_header)
 {
-    malloc_header_t* next = free_blocks[((mem_header->size) >> 4)];
-    free_blocks[((mem_header->size) >> 4)] = mem_header;
-    mem_header->next = next;
-    mem_header->prev = NULL;
-    if (next) {
-        next->prev = mem_header;
+    malloc_span_t* span = mem_header->span;
+    malloc_arena_t* arena = span->arena;
+    uint32_t size_class = span->size_class;
+
+    pthread_mutex_lock(&arena->lock);
+    block_rem_flags(mem_header, FLAG_ALLOCATED);
+    // Free chunks are linked through their span field.
+    mem_header->span = (malloc_span_t*)span->free_list;
+    span->free_list = mem_header;
+
+    if (span->used == span->capacity) {
+        _slab_list_push(arena, span);
     }
-}
\ No newline at end of file
+    span->used--;
+
+    if (!span->used) {
+        if (arena->empty_spans[size_class] >= MALLOC_CACHED_EMPTY_SPANS) {
+            _slab_list_remove(arena, span);
+            pthread_mutex_unlock(&arena->lock);
+            munmap(span, MALLOC_SPAN_SIZE);
+            return;
+        }
+        arena->empty_spans[size_class]++;
+    }
+    pthread_mutex_unlock(&arena->lock);
+}
@@ -1,3 +1,4 @@
+#include "../time/vdso.h"
 #include <sys/time.h>
 #include <sysdep.h>
 
@@ -9,6 +10,11 @@ int nanosleep(const timespec_t* req, timespec_t* rem)
 
 int gettimeofday(timeval_t* tv, timezone_t* tz)
 {
+    if (__vdso_gettimeofday(tv, tz) == 0) {
+        set_errno(0);
+        return 0;
+    }
+
     int res = DO_SYSCALL_2(SYS_GETTIMEOFDAY, tv, tz);
     RETURN_WITH_ERRNO(res, res, -1);
 }
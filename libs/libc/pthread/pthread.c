@@ -1,15 +1,614 @@
+#include <bits/futex.h>
+#include <errno.h>
 #include <pthread.h>
 #include <stdint.h>
+#include <string.h>
 #include <sys/mman.h>
 #include <sysdep.h>
+#include <time.h>
+#include <unistd.h>
 
-int pthread_create(void* func)
+#define FUTEX_WAKE_ALL (0x7fffffff)
+#define PTHREAD_DESTRUCTOR_ITERATIONS 4
+
+/**
+ * A thread descriptor is placed at the bottom of its own stack mapping,
+ * the main thread uses a static one. Each thread registers its descriptor
+ * as the thread pointer, so pthread_self() is a single register read.
+ */
+struct __pthread {
+    struct __pthread* self; // x86 reads it through the segment base.
+    pid_t tid;
+    uint32_t alive; // Cleared and futex-woken by the kernel on exit.
+    uint32_t detached;
+    void* (*start_routine)(void*);
+    void* arg;
+    void* retval;
+    uintptr_t stack_start;
+    size_t map_size;
+    void* specific[PTHREAD_KEYS_MAX];
+    void* malloc_cache;
+    struct __pthread* next;
+};
+
+static struct __pthread _main_thread = { .self = &_main_thread, .alive = 1 };
+static struct __pthread* _threads = NULL;
+static pthread_mutex_t _threads_lock = PTHREAD_MUTEX_INITIALIZER;
+
+extern void _malloc_thread_exit();
+
+static uint32_t _keys_used[PTHREAD_KEYS_MAX];
+static void (*_keys_destructor[PTHREAD_KEYS_MAX])(void*);
+
+static inline int _futex_wait(uint32_t* uaddr, uint32_t val, const timespec_t* timeout)
+{
+    return DO_SYSCALL_4(SYS_FUTEX, uaddr, FUTEX_WAIT, val, timeout);
+}
+
+static inline int _futex_wake(uint32_t* uaddr, int count)
+{
+    return DO_SYSCALL_4(SYS_FUTEX, uaddr, FUTEX_WAKE, count, NULL);
+}
+
+/**
+ * Attributes
+ */
+
+int pthread_attr_init(pthread_attr_t* attr)
+{
+    attr->stack_size = PTHREAD_STACK_DEFAULT;
+    attr->detach_state = PTHREAD_CREATE_JOINABLE;
+    return 0;
+}
+
+int pthread_attr_destroy(pthread_attr_t* attr)
+{
+    return 0;
+}
+
+int pthread_attr_setstacksize(pthread_attr_t* attr, size_t stacksize)
+{
+    if (stacksize < PTHREAD_STACK_MIN) {
+        return EINVAL;
+    }
+    attr->stack_size = stacksize;
+    return 0;
+}
+
+int pthread_attr_getstacksize(const pthread_attr_t* attr, size_t* stacksize)
+{
+    *stacksize = attr->stack_size;
+    return 0;
+}
+
+int pthread_attr_setdetachstate(pthread_attr_t* attr, int detachstate)
+{
+    if (detachstate != PTHREAD_CREATE_JOINABLE && detachstate != PTHREAD_CREATE_DETACHED) {
+        return EINVAL;
+    }
+    attr->detach_state = detachstate;
+    return 0;
+}
+
+int pthread_attr_getdetachstate(const pthread_attr_t* attr, int* detachstate)
+{
+    *detachstate = attr->detach_state;
+    return 0;
+}
+
+/**
+ * Threads
+ */
+
+static void _pthread_unlink_locked(struct __pthread* thread)
+{
+    struct __pthread** it = &_threads;
+    while (*it) {
+        if (*it == thread) {
+            *it = thread->next;
+            return;
+        }
+        it = &(*it)->next;
+    }
+}
+
+// Stacks of detached threads can't be freed by themselves, they are
+// collected here once the kernel reports the thread is gone.
+static void _pthread_reap_detached()
+{
+    for (;;) {
+        struct __pthread* victim = NULL;
+        pthread_mutex_lock(&_threads_lock);
+        for (struct __pthread* it = _threads; it; it = it->next) {
+            if (it->detached && !__atomic_load_n(&it->alive, __ATOMIC_ACQUIRE)) {
+                victim = it;
+                break;
+            }
+        }
+        if (victim) {
+            _pthread_unlink_locked(victim);
+        }
+        pthread_mutex_unlock(&_threads_lock);
+
+        if (!victim) {
+            return;
+        }
+        munmap((void*)victim->stack_start, victim->map_size);
+    }
+}
+
+static inline void _pthread_set_thread_pointer(struct __pthread* self)
+{
+    DO_SYSCALL_1(SYS_SET_TLS, self);
+}
+
+static inline struct __pthread* _pthread_thread_pointer()
+{
+    struct __pthread* self;
+#if defined(__i386__)
+    asm("movl %%gs:0, %0"
+        : "=r"(self));
+#elif defined(__x86_64__)
+    asm("movq %%fs:0, %0"
+        : "=r"(self));
+#elif defined(__arm__)
+    asm("mrc p15, 0, %0, c13, c0, 3"
+        : "=r"(self));
+#elif defined(__aarch64__)
+    asm("mrs %0, tpidrro_el0"
+        : "=r"(self));
+#elif defined(__riscv)
+    asm("mv %0, tp"
+        : "=r"(self));
+#endif
+    return self;
+}
+
+void _pthread_init()
 {
-    intptr_t start = (intptr_t)mmap(NULL, 4096, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_STACK | MAP_PRIVATE, 0, 0);
+    _pthread_set_thread_pointer(&_main_thread);
+}
+
+static void _pthread_start(struct __pthread* self)
+{
+    _pthread_set_thread_pointer(self);
+    pthread_exit(self->start_routine(self->arg));
+}
+
+int pthread_create(pthread_t* thread, const pthread_attr_t* attr, void* (*start_routine)(void*), void* arg)
+{
+    pthread_attr_t default_attr;
+    if (!attr) {
+        pthread_attr_init(&default_attr);
+        attr = &default_attr;
+    }
+
+    _pthread_reap_detached();
+
+    size_t map_size = (attr->stack_size + sizeof(struct __pthread) + 4095) & ~(size_t)4095;
+    intptr_t start = (intptr_t)mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_STACK | MAP_PRIVATE, 0, 0);
+    if (start < 0) {
+        return EAGAIN;
+    }
+
+    struct __pthread* new_thread = (struct __pthread*)start;
+    memset(new_thread, 0, sizeof(struct __pthread));
+    new_thread->self = new_thread;
+    new_thread->alive = 1;
+    new_thread->detached = (attr->detach_state == PTHREAD_CREATE_DETACHED);
+    new_thread->start_routine = start_routine;
+    new_thread->arg = arg;
+    new_thread->stack_start = start;
+    new_thread->map_size = map_size;
+
+    pthread_mutex_lock(&_threads_lock);
+    new_thread->next = _threads;
+    _threads = new_thread;
+    pthread_mutex_unlock(&_threads_lock);
+
+    uintptr_t stack_bottom = (start + sizeof(struct __pthread) + 15) & ~(uintptr_t)15;
     thread_create_params_t params;
-    params.stack_start = start;
-    params.stack_size = 4096;
-    params.entry_point = (intptr_t)func;
+    params.stack_start = stack_bottom;
+    params.stack_size = (start + map_size - stack_bottom) & ~(uintptr_t)15;
+    params.entry_point = (uintptr_t)_pthread_start;
+    params.arg = (uintptr_t)new_thread;
     int res = DO_SYSCALL_1(SYS_PTHREAD_CREATE, &params);
-    RETURN_WITH_ERRNO(res, 0, res);
-}
\ No newline at end of file
+    if (res < 0) {
+        pthread_mutex_lock(&_threads_lock);
+        _pthread_unlink_locked(new_thread);
+        pthread_mutex_unlock(&_threads_lock);
+        munmap((void*)start, map_size);
+        return EAGAIN;
+    }
+
+    new_thread->tid = res;
+    *thread = new_thread;
+    return 0;
+}
+
+int pthread_join(pthread_t thread, void** retval)
+{
+    if (thread == pthread_self()) {
+        return EDEADLK;
+    }
+    if (thread == &_main_thread || thread->detached) {
+        return EINVAL;
+    }
+
+    uint32_t alive;
+    while ((alive = __atomic_load_n(&thread->alive, __ATOMIC_ACQUIRE)) != 0) {
+        _futex_wait(&thread->alive, alive, NULL);
+    }
+
+    if (retval) {
+        *retval = thread->retval;
+    }
+
+    pthread_mutex_lock(&_threads_lock);
+    _pthread_unlink_locked(thread);
+    pthread_mutex_unlock(&_threads_lock);
+    munmap((void*)thread->stack_start, thread->map_size);
+    return 0;
+}
+
+int pthread_detach(pthread_t thread)
+{
+    if (thread == &_main_thread) {
+        return EINVAL;
+    }
+    __atomic_store_n(&thread->detached, 1, __ATOMIC_RELEASE);
+    _pthread_reap_detached();
+    return 0;
+}
+
+static void _pthread_run_destructors(struct __pthread* self)
+{
+    for (int iter = 0; iter < PTHREAD_DESTRUCTOR_ITERATIONS; iter++) {
+        int called = 0;
+        for (int key = 0; key < PTHREAD_KEYS_MAX; key++) {
+            void* value = self->specific[key];
+            void (*destructor)(void*) = _keys_destructor[key];
+            if (!value || !destructor || !_keys_used[key]) {
+                continue;
+            }
+            self->specific[key] = NULL;
+            destructor(value);
+            called = 1;
+        }
+        if (!called) {
+            return;
+        }
+    }
+}
+
+void pthread_exit(void* retval)
+{
+    struct __pthread* self = pthread_self();
+    _pthread_run_destructors(self);
+    _malloc_thread_exit();
+    self->retval = retval;
+    for (;;) {
+        DO_SYSCALL_1(SYS_PTHREAD_EXIT, &self->alive);
+    }
+}
+
+pthread_t pthread_self()
+{
+    return _pthread_thread_pointer();
+}
+
+void** _pthread_malloc_slot()
+{
+    return &_pthread_thread_pointer()->malloc_cache;
+}
+
+int pthread_equal(pthread_t t1, pthread_t t2)
+{
+    return t1 == t2;
+}
+
+/**
+ * Mutexes
+ */
+
+int pthread_mutexattr_init(pthread_mutexattr_t* attr)
+{
+    attr->type = PTHREAD_MUTEX_DEFAULT;
+    return 0;
+}
+
+int pthread_mutexattr_destroy(pthread_mutexattr_t* attr)
+{
+    return 0;
+}
+
+int pthread_mutexattr_settype(pthread_mutexattr_t* attr, int type)
+{
+    if (type != PTHREAD_MUTEX_NORMAL && type != PTHREAD_MUTEX_RECURSIVE && type != PTHREAD_MUTEX_ERRORCHECK) {
+        return EINVAL;
+    }
+    attr->type = type;
+    return 0;
+}
+
+int pthread_mutex_init(pthread_mutex_t* mutex, const pthread_mutexattr_t* attr)
+{
+    mutex->state = 0;
+    mutex->type = attr ? attr->type : PTHREAD_MUTEX_DEFAULT;
+    mutex->owner = NULL;
+    mutex->recursion = 0;
+    return 0;
+}
+
+int pthread_mutex_destroy(pthread_mutex_t* mutex)
+{
+    return 0;
+}
+
+static inline int _mutex_try_acquire(pthread_mutex_t* mutex)
+{
+    uint32_t expected = 0;
+    return __atomic_compare_exchange_n(&mutex->state, &expected, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+// The owner is tracked only for the types which need it, so the normal
+// mutex never pays for pthread_self().
+static int _mutex_owned_by_self(pthread_mutex_t* mutex, pthread_t* self)
+{
+    if (mutex->type == PTHREAD_MUTEX_NORMAL) {
+        return 0;
+    }
+    *self = pthread_self();
+    return mutex->owner == *self && __atomic_load_n(&mutex->state, __ATOMIC_RELAXED);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    pthread_t self = NULL;
+    if (_mutex_owned_by_self(mutex, &self)) {
+        if (mutex->type == PTHREAD_MUTEX_ERRORCHECK) {
+            return EDEADLK;
+        }
+        mutex->recursion++;
+        return 0;
+    }
+
+    if (!_mutex_try_acquire(mutex)) {
+        // Mark the mutex as contended, so the unlocker knows to wake us up.
+        while (__atomic_exchange_n(&mutex->state, 2, __ATOMIC_ACQUIRE) != 0) {
+            _futex_wait(&mutex->state, 2, NULL);
+        }
+    }
+
+    mutex->owner = self;
+    mutex->recursion = 1;
+    return 0;
+}
+
+int pthread_mutex_trylock(pthread_mutex_t* mutex)
+{
+    pthread_t self = NULL;
+    if (_mutex_owned_by_self(mutex, &self)) {
+        if (mutex->type == PTHREAD_MUTEX_RECURSIVE) {
+            mutex->recursion++;
+            return 0;
+        }
+        return EBUSY;
+    }
+
+    if (!_mutex_try_acquire(mutex)) {
+        return EBUSY;
+    }
+
+    mutex->owner = self;
+    mutex->recursion = 1;
+    return 0;
+}
+
+int pthread_mutex_unlock(pthread_mutex_t* mutex)
+{
+    if (mutex->type != PTHREAD_MUTEX_NORMAL) {
+        if (mutex->owner != pthread_self()) {
+            return EPERM;
+        }
+        if (--mutex->recursion) {
+            return 0;
+        }
+    }
+
+    mutex->owner = NULL;
+    if (__atomic_exchange_n(&mutex->state, 0, __ATOMIC_RELEASE) == 2) {
+        _futex_wake(&mutex->state, 1);
+    }
+    return 0;
+}
+
+/**
+ * Condition variables
+ */
+
+int pthread_cond_init(pthread_cond_t* cond, const pthread_condattr_t* attr)
+{
+    cond->seq = 0;
+    return 0;
+}
+
+int pthread_cond_destroy(pthread_cond_t* cond)
+{
+    return 0;
+}
+
+static int _cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex, const timespec_t* timeout)
+{
+    uint32_t seq = __atomic_load_n(&cond->seq, __ATOMIC_ACQUIRE);
+    uint32_t recursion = mutex->recursion;
+    mutex->recursion = 1;
+    pthread_mutex_unlock(mutex);
+
+    int res = _futex_wait(&cond->seq, seq, timeout);
+
+    // The mutex could have other waiters, so it is reacquired as contended.
+    while (__atomic_exchange_n(&mutex->state, 2, __ATOMIC_ACQUIRE) != 0) {
+        _futex_wait(&mutex->state, 2, NULL);
+    }
+    if (mutex->type != PTHREAD_MUTEX_NORMAL) {
+        mutex->owner = pthread_self();
+    }
+    mutex->recursion = recursion;
+    return res == -ETIMEDOUT ? ETIMEDOUT : 0;
+}
+
+int pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex)
+{
+    return _cond_wait(cond, mutex, NULL);
+}
+
+int pthread_cond_timedwait(pthread_cond_t* cond, pthread_mutex_t* mutex, const struct timespec* abstime)
+{
+    timespec_t now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    timespec_t timeout;
+    timeout.tv_sec = abstime->tv_sec - now.tv_sec;
+    timeout.tv_nsec = abstime->tv_nsec - now.tv_nsec;
+    if (timeout.tv_nsec < 0) {
+        timeout.tv_sec--;
+        timeout.tv_nsec += 1000000000;
+    }
+    if (timeout.tv_sec < 0) {
+        return ETIMEDOUT;
+    }
+    return _cond_wait(cond, mutex, &timeout);
+}
+
+int pthread_cond_signal(pthread_cond_t* cond)
+{
+    __atomic_add_fetch(&cond->seq, 1, __ATOMIC_RELEASE);
+    _futex_wake(&cond->seq, 1);
+    return 0;
+}
+
+int pthread_cond_broadcast(pthread_cond_t* cond)
+{
+    __atomic_add_fetch(&cond->seq, 1, __ATOMIC_RELEASE);
+    _futex_wake(&cond->seq, FUTEX_WAKE_ALL);
+    return 0;
+}
+
+/**
+ * Read-write locks
+ */
+
+int pthread_rwlock_init(pthread_rwlock_t* rwlock, const pthread_rwlockattr_t* attr)
+{
+    pthread_mutex_init(&rwlock->lock, NULL);
+    pthread_cond_init(&rwlock->cond, NULL);
+    rwlock->readers = 0;
+    rwlock->writer = 0;
+    rwlock->waiting_writers = 0;
+    return 0;
+}
+
+int pthread_rwlock_destroy(pthread_rwlock_t* rwlock)
+{
+    return 0;
+}
+
+int pthread_rwlock_rdlock(pthread_rwlock_t* rwlock)
+{
+    pthread_mutex_lock(&rwlock->lock);
+    // Writers are preferred, otherwise a stream of readers starves them.
+    while (rwlock->writer || rwlock->waiting_writers) {
+        pthread_cond_wait(&rwlock->cond, &rwlock->lock);
+    }
+    rwlock->readers++;
+    pthread_mutex_unlock(&rwlock->lock);
+    return 0;
+}
+
+int pthread_rwlock_wrlock(pthread_rwlock_t* rwlock)
+{
+    pthread_mutex_lock(&rwlock->lock);
+    rwlock->waiting_writers++;
+    while (rwlock->writer || rwlock->readers) {
+        pthread_cond_wait(&rwlock->cond, &rwlock->lock);
+    }
+    rwlock->waiting_writers--;
+    rwlock->writer = 1;
+    pthread_mutex_unlock(&rwlock->lock);
+    return 0;
+}
+
+int pthread_rwlock_unlock(pthread_rwlock_t* rwlock)
+{
+    pthread_mutex_lock(&rwlock->lock);
+    if (rwlock->writer) {
+        rwlock->writer = 0;
+    } else if (rwlock->readers) {
+        rwlock->readers--;
+    }
+    pthread_cond_broadcast(&rwlock->cond);
+    pthread_mutex_unlock(&rwlock->lock);
+    return 0;
+}
+
+/**
+ * Thread-specific data
+ */
+
+int pthread_key_create(pthread_key_t* key, void (*destructor)(void*))
+{
+    for (pthread_key_t i = 0; i < PTHREAD_KEYS_MAX; i++) {
+        uint32_t expected = 0;
+        if (__atomic_compare_exchange_n(&_keys_used[i], &expected, 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            _keys_destructor[i] = destructor;
+            *key = i;
+            return 0;
+        }
+    }
+    return EAGAIN;
+}
+
+int pthread_key_delete(pthread_key_t key)
+{
+    if (key >= PTHREAD_KEYS_MAX) {
+        return EINVAL;
+    }
+    _keys_destructor[key] = NULL;
+    __atomic_store_n(&_keys_used[key], 0, __ATOMIC_RELEASE);
+    return 0;
+}
+
+void* pthread_getspecific(pthread_key_t key)
+{
+    if (key >= PTHREAD_KEYS_MAX) {
+        return NULL;
+    }
+    return pthread_self()->specific[key];
+}
+
+int pthread_setspecific(pthread_key_t key, const void* value)
+{
+    if (key >= PTHREAD_KEYS_MAX || !_keys_used[key]) {
+        return EINVAL;
+    }
+    pthread_self()->specific[key] = (void*)value;
+    return 0;
+}
+
+int pthread_once(pthread_once_t* once_control, void (*init_routine)())
+{
+    // 0 - not started, 1 - running, 2 - done.
+    uint32_t expected = 0;
+    if (__atomic_compare_exchange_n(&once_control->state, &expected, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+        init_routine();
+        __atomic_store_n(&once_control->state, 2, __ATOMIC_RELEASE);
+        _futex_wake(&once_control->state, FUTEX_WAKE_ALL);
+        return 0;
+    }
+
+    while ((expected = __atomic_load_n(&once_control->state, __ATOMIC_ACQUIRE)) != 2) {
+        _futex_wait(&once_control->state, expected, NULL);
+    }
+    return 0;
+}
@@ -581,12 +581,17 @@ static size_t _do_system_read(char* ptr, size_t size, FILE* stream)
 
 static size_t _do_system_write(const void* ptr, size_t size, FILE* stream)
 {
-    ssize_t write_size = write(stream->_file, ptr, size);
+    size_t written = 0;
 
-    if (write_size < 0)
-        return 0;
+    /* Pipes and ptys could accept only a part of the data. */
+    while (written < size) {
+        ssize_t write_size = write(stream->_file, (const char*)ptr + written, size - written);
+        if (write_size <= 0)
+            break;
+        written += write_size;
+    }
 
-    return (size_t)write_size;
+    return written;
 }
 
 static size_t _fread_internal(char* ptr, size_t size, FILE* stream)
@@ -7,63 +7,197 @@
  * found in the LICENSE file.
  */
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 
-#ifndef __arm__
-void* memset(void* dest, int fill, size_t nbytes)
+/* Bulk routines work on vectors where the target has SIMD registers
+   available to user code (SSE2 on x86, NEON on arm) and fall back to
+   machine words otherwise. GCC vector extensions are used instead of
+   intrinsics, so the same code maps to SSE2 and NEON instructions.
+   Words and vectors are may_alias, since they access arbitrary data. */
+typedef uintptr_t __attribute__((__may_alias__)) word_t;
+#define WORD_SIZE (sizeof(word_t))
+#define WORD_ONES ((word_t)-1 / 0xff)
+#define WORD_HIGHS (WORD_ONES * 0x80)
+#define WORD_HAS_ZERO(x) (((x)-WORD_ONES) & ~(x)&WORD_HIGHS)
+
+#if defined(__SSE2__) || defined(__ARM_NEON)
+#define STRING_USE_VECTORS
+#define VEC_SIZE (16)
+typedef uint8_t vec_t __attribute__((vector_size(VEC_SIZE), __may_alias__));
+typedef uint8_t uvec_t __attribute__((vector_size(VEC_SIZE), __may_alias__, aligned(1)));
+typedef uint64_t vec64_t __attribute__((vector_size(VEC_SIZE)));
+
+static inline bool vec_any(vec_t mask)
 {
-    for (int i = 0; i < nbytes; ++i)
-        ((uint8_t*)dest)[i] = fill;
-
-    return dest;
+    vec64_t m = (vec64_t)mask;
+    return (m[0] | m[1]) != 0;
 }
-#endif //__arm__
+#endif
 
-void* memmove(void* dest, const void* src, size_t nbytes)
+static inline void _copy_forward(uint8_t* dest, const uint8_t* src, size_t nbytes)
 {
-    if (src > dest) {
-        memcpy(dest, src, nbytes);
-        return dest;
-    }
+#ifdef STRING_USE_VECTORS
+    if (nbytes >= 2 * VEC_SIZE) {
+        size_t head = (-(uintptr_t)dest) & (VEC_SIZE - 1);
+        nbytes -= head;
+        while (head--) {
+            *dest++ = *src++;
+        }
 
-    for (int i = nbytes - 1; i >= 0; --i)
-        ((uint8_t*)dest)[i] = ((uint8_t*)src)[i];
+        // All loads of a block go before the stores, so that memmove
+        // could use this for overlapping areas with dest below src.
+        for (; nbytes >= 4 * VEC_SIZE; nbytes -= 4 * VEC_SIZE) {
+            vec_t a = *(const uvec_t*)(src);
+            vec_t b = *(const uvec_t*)(src + VEC_SIZE);
+            vec_t c = *(const uvec_t*)(src + 2 * VEC_SIZE);
+            vec_t d = *(const uvec_t*)(src + 3 * VEC_SIZE);
+            *(vec_t*)(dest) = a;
+            *(vec_t*)(dest + VEC_SIZE) = b;
+            *(vec_t*)(dest + 2 * VEC_SIZE) = c;
+            *(vec_t*)(dest + 3 * VEC_SIZE) = d;
+            src += 4 * VEC_SIZE;
+            dest += 4 * VEC_SIZE;
+        }
+        for (; nbytes >= VEC_SIZE; nbytes -= VEC_SIZE) {
+            *(vec_t*)dest = *(const uvec_t*)src;
+            src += VEC_SIZE;
+            dest += VEC_SIZE;
+        }
+    }
+#else
+    // Without SIMD unaligned word access could be emulated or even trap,
+    // so words are used only when both pointers can be aligned together.
+    if (nbytes >= 2 * WORD_SIZE && !(((uintptr_t)dest ^ (uintptr_t)src) & (WORD_SIZE - 1))) {
+        while ((uintptr_t)dest & (WORD_SIZE - 1)) {
+            *dest++ = *src++;
+            nbytes--;
+        }
+        for (; nbytes >= WORD_SIZE; nbytes -= WORD_SIZE) {
+            *(word_t*)dest = *(const word_t*)src;
+            src += WORD_SIZE;
+            dest += WORD_SIZE;
+        }
+    }
+#endif
 
-    return dest;
+    while (nbytes--) {
+        *dest++ = *src++;
+    }
 }
 
-/* This optimized version of memcpy uses 32 bit chunks to copy over data on
-   the 32 bit architecture this library is built for. If this function gets
-   used on a 64 bit arch, be sure to use 8 byte chunks so each chunk fits
-   in a single register. The important part is this should be compiled with
-   atleast -O1 or -Os, because -O0 just makes this function too big for what
-   it does.
-
-   GCC does a better job at optimizing this if the pointers are restricted,
-   making the copying part have less instructions. Clang on the other hand
-   does not really change anything if the pointers are restricted or not. */
-void* memcpy(void* __restrict dest, const void* __restrict src, size_t nbytes)
+static inline void _copy_backward(uint8_t* dest, const uint8_t* src, size_t nbytes)
 {
-    size_t chunks, rest, i;
+    dest += nbytes;
+    src += nbytes;
+
+#ifdef STRING_USE_VECTORS
+    if (nbytes >= 2 * VEC_SIZE) {
+        size_t head = (uintptr_t)dest & (VEC_SIZE - 1);
+        nbytes -= head;
+        while (head--) {
+            *--dest = *--src;
+        }
 
-    rest = nbytes % 4;
-    chunks = (nbytes - rest) >> 2;
+        for (; nbytes >= 4 * VEC_SIZE; nbytes -= 4 * VEC_SIZE) {
+            src -= 4 * VEC_SIZE;
+            dest -= 4 * VEC_SIZE;
+            vec_t a = *(const uvec_t*)(src);
+            vec_t b = *(const uvec_t*)(src + VEC_SIZE);
+            vec_t c = *(const uvec_t*)(src + 2 * VEC_SIZE);
+            vec_t d = *(const uvec_t*)(src + 3 * VEC_SIZE);
+            *(vec_t*)(dest + 3 * VEC_SIZE) = d;
+            *(vec_t*)(dest + 2 * VEC_SIZE) = c;
+            *(vec_t*)(dest + VEC_SIZE) = b;
+            *(vec_t*)(dest) = a;
+        }
+        for (; nbytes >= VEC_SIZE; nbytes -= VEC_SIZE) {
+            src -= VEC_SIZE;
+            dest -= VEC_SIZE;
+            *(vec_t*)dest = *(const uvec_t*)src;
+        }
+    }
+#else
+    if (nbytes >= 2 * WORD_SIZE && !(((uintptr_t)dest ^ (uintptr_t)src) & (WORD_SIZE - 1))) {
+        while ((uintptr_t)dest & (WORD_SIZE - 1)) {
+            *--dest = *--src;
+            nbytes--;
+        }
+        for (; nbytes >= WORD_SIZE; nbytes -= WORD_SIZE) {
+            src -= WORD_SIZE;
+            dest -= WORD_SIZE;
+            *(word_t*)dest = *(const word_t*)src;
+        }
+    }
+#endif
 
-    if (!chunks)
-        goto skip_chunks;
+    while (nbytes--) {
+        *--dest = *--src;
+    }
+}
 
-    for (i = 0; i < chunks; i++)
-        ((uint32_t*)dest)[i] = ((uint32_t*)src)[i];
+#ifndef __arm__
+void* memset(void* dest, int fill, size_t nbytes)
+{
+    uint8_t* d = (uint8_t*)dest;
+    uint8_t c = (uint8_t)fill;
+
+#ifdef STRING_USE_VECTORS
+    if (nbytes >= 2 * VEC_SIZE) {
+        while ((uintptr_t)d & (VEC_SIZE - 1)) {
+            *d++ = c;
+            nbytes--;
+        }
 
-skip_chunks:
+        vec_t v = (vec_t) {} + c;
+        for (; nbytes >= 4 * VEC_SIZE; nbytes -= 4 * VEC_SIZE) {
+            *(vec_t*)(d) = v;
+            *(vec_t*)(d + VEC_SIZE) = v;
+            *(vec_t*)(d + 2 * VEC_SIZE) = v;
+            *(vec_t*)(d + 3 * VEC_SIZE) = v;
+            d += 4 * VEC_SIZE;
+        }
+        for (; nbytes >= VEC_SIZE; nbytes -= VEC_SIZE) {
+            *(vec_t*)d = v;
+            d += VEC_SIZE;
+        }
+    }
+#else
+    if (nbytes >= 2 * WORD_SIZE) {
+        while ((uintptr_t)d & (WORD_SIZE - 1)) {
+            *d++ = c;
+            nbytes--;
+        }
+
+        word_t w = WORD_ONES * c;
+        for (; nbytes >= WORD_SIZE; nbytes -= WORD_SIZE) {
+            *(word_t*)d = w;
+            d += WORD_SIZE;
+        }
+    }
+#endif
 
-    /* Multiplying chunks by 4 will give us the offset of the 'rest' bytes,
-       which were not copied over along with the 4 byte chunks. */
-    chunks <<= 2;
+    while (nbytes--) {
+        *d++ = c;
+    }
+    return dest;
+}
+#endif //__arm__
 
-    for (i = 0; i < rest; i++)
-        ((uint8_t*)dest)[chunks + i] = ((uint8_t*)src)[chunks + i];
+void* memmove(void* dest, const void* src, size_t nbytes)
+{
+    if ((uintptr_t)dest - (uintptr_t)src >= nbytes) {
+        // dest is below src or the areas do not overlap.
+        _copy_forward((uint8_t*)dest, (const uint8_t*)src, nbytes);
+    } else {
+        _copy_backward((uint8_t*)dest, (const uint8_t*)src, nbytes);
+    }
+    return dest;
+}
 
+void* memcpy(void* __restrict dest, const void* __restrict src, size_t nbytes)
+{
+    _copy_forward((uint8_t*)dest, (const uint8_t*)src, nbytes);
     return dest;
 }
 
@@ -94,11 +228,47 @@ int memcmp(const void* src1, const void* src2, size_t nbytes)
 
 void* memchr(const void* ptr, int c, size_t size)
 {
-    char ch = c;
-    const char* cptr = (const char*)ptr;
-    for (size_t i = 0; i < size; i++) {
-        if (cptr[i] == ch) {
-            return (char*)(cptr + i);
+    uint8_t ch = c;
+    const uint8_t* cptr = (const uint8_t*)ptr;
+
+#ifdef STRING_USE_VECTORS
+    while (size && ((uintptr_t)cptr & (VEC_SIZE - 1))) {
+        if (*cptr == ch) {
+            return (void*)cptr;
+        }
+        cptr++;
+        size--;
+    }
+
+    vec_t v = (vec_t) {} + ch;
+    for (; size >= VEC_SIZE; size -= VEC_SIZE) {
+        if (vec_any((vec_t)(*(const vec_t*)cptr == v))) {
+            break;
+        }
+        cptr += VEC_SIZE;
+    }
+#else
+    while (size && ((uintptr_t)cptr & (WORD_SIZE - 1))) {
+        if (*cptr == ch) {
+            return (void*)cptr;
+        }
+        cptr++;
+        size--;
+    }
+
+    word_t w = WORD_ONES * ch;
+    for (; size >= WORD_SIZE; size -= WORD_SIZE) {
+        word_t x = *(const word_t*)cptr ^ w;
+        if (WORD_HAS_ZERO(x)) {
+            break;
+        }
+        cptr += WORD_SIZE;
+    }
+#endif
+
+    for (; size; size--, cptr++) {
+        if (*cptr == ch) {
+            return (void*)cptr;
         }
     }
     return NULL;
@@ -141,12 +311,41 @@ int strncmp(const char* a, const char* b, size_t num)
     return 0;
 }
 
+/* Aligned loads never cross a page boundary, so reading past the
+   terminator within the same vector or word is safe. */
 size_t strlen(const char* str)
 {
-    size_t i = 0;
-    while (str[i])
-        ++i;
-    return i;
+    const char* s = str;
+
+#ifdef STRING_USE_VECTORS
+    while ((uintptr_t)s & (VEC_SIZE - 1)) {
+        if (!*s) {
+            return s - str;
+        }
+        s++;
+    }
+
+    vec_t zero = {};
+    while (!vec_any((vec_t)(*(const vec_t*)s == zero))) {
+        s += VEC_SIZE;
+    }
+#else
+    while ((uintptr_t)s & (WORD_SIZE - 1)) {
+        if (!*s) {
+            return s - str;
+        }
+        s++;
+    }
+
+    while (!WORD_HAS_ZERO(*(const word_t*)s)) {
+        s += WORD_SIZE;
+    }
+#endif
+
+    while (*s) {
+        s++;
+    }
+    return s - str;
 }
 
 char* strcpy(char* dest, const char* src)
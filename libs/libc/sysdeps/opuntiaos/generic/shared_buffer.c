@@ -1,15 +1,15 @@
 #include <opuntia/shared_buffer.h>
 #include <sysdep.h>
 
-int shared_buffer_create(uint8_t** buffer, size_t size)
+int shared_buffer_create(uint8_t** buffer, size_t size, uint32_t flags)
 {
-    int res = DO_SYSCALL_2(SYS_SHBUF_CREATE, buffer, size);
+    int res = DO_SYSCALL_3(SYS_SHBUF_CREATE, buffer, size, flags);
     RETURN_WITH_ERRNO(res, res, res);
 }
 
-int shared_buffer_get(int id, uint8_t** buffer)
+int shared_buffer_get(int id, uint8_t** buffer, uint32_t flags)
 {
-    int res = DO_SYSCALL_2(SYS_SHBUF_GET, id, buffer);
+    int res = DO_SYSCALL_3(SYS_SHBUF_GET, id, buffer, flags);
     RETURN_WITH_ERRNO(res, res, res);
 }
 
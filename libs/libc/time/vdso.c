@@ -0,0 +1,133 @@
+#include "vdso.h"
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sysdep.h>
+
+static const vdso_time_data_t* __vdso_time_data = NULL;
+
+void _vdso_init()
+{
+    uintptr_t addr = 0;
+    int res = DO_SYSCALL_1(SYS_VDSO_GET, &addr);
+    if (res < 0 || !addr) {
+        return;
+    }
+    __vdso_time_data = (const vdso_time_data_t*)addr;
+}
+
+static inline uint64_t __vdso_read_cycles()
+{
+#if defined(__i386__) || defined(__x86_64__)
+    uint32_t lo, hi;
+    asm volatile("rdtsc"
+                 : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+#else
+    return 0;
+#endif
+}
+
+static inline uint32_t __vdso_read_begin(const vdso_time_data_t* vd)
+{
+    uint32_t seq;
+    while ((seq = __atomic_load_n(&vd->seq, __ATOMIC_ACQUIRE)) & 1) { }
+    return seq;
+}
+
+static inline int __vdso_read_retry(const vdso_time_data_t* vd, uint32_t seq)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&vd->seq, __ATOMIC_RELAXED) != seq;
+}
+
+static inline uint32_t __vdso_nsec_in_second(const vdso_time_data_t* vd)
+{
+    uint32_t nsec = vd->ticks_since_second * vd->nsec_per_tick;
+    if (!vd->cycles_mult) {
+        return nsec;
+    }
+
+    uint64_t now = __vdso_read_cycles();
+    if (now <= vd->cycles_at_tick) {
+        return nsec;
+    }
+
+    uint64_t delta = now - vd->cycles_at_tick;
+    if (delta > vd->cycles_per_tick) {
+        delta = vd->cycles_per_tick;
+    }
+
+    // Never step into the next tick, otherwise time could go backwards
+    // once the kernel publishes it.
+    uint32_t extra = (delta * vd->cycles_mult) >> VDSO_CYCLES_SHIFT;
+    if (extra >= vd->nsec_per_tick) {
+        extra = vd->nsec_per_tick - 1;
+    }
+    return nsec + extra;
+}
+
+static int __vdso_read_time(clockid_t clk_id, time_t* sec, uint32_t* nsec)
+{
+    const vdso_time_data_t* vd = __vdso_time_data;
+    if (!vd) {
+        return -ENOSYS;
+    }
+
+    uint32_t seq;
+    do {
+        seq = __vdso_read_begin(vd);
+        switch (clk_id) {
+        case CLOCK_MONOTONIC:
+            *sec = vd->secs_since_boot;
+            break;
+        case CLOCK_REALTIME:
+            *sec = vd->secs_since_epoch;
+            break;
+        default:
+            return -ENOSYS;
+        }
+        *nsec = __vdso_nsec_in_second(vd);
+    } while (__vdso_read_retry(vd, seq));
+
+    return 0;
+}
+
+int __vdso_clock_gettime(clockid_t clk_id, timespec_t* tp)
+{
+    if (!tp) {
+        return -ENOSYS;
+    }
+
+    time_t sec;
+    uint32_t nsec;
+    int err = __vdso_read_time(clk_id, &sec, &nsec);
+    if (err) {
+        return err;
+    }
+
+    tp->tv_sec = sec;
+    tp->tv_nsec = nsec;
+    return 0;
+}
+
+int __vdso_gettimeofday(timeval_t* tv, timezone_t* tz)
+{
+    // Let the kernel report errors for invalid arguments.
+    if (!tv || !tz) {
+        return -ENOSYS;
+    }
+
+    time_t sec;
+    uint32_t nsec;
+    int err = __vdso_read_time(CLOCK_REALTIME, &sec, &nsec);
+    if (err) {
+        return err;
+    }
+
+    tv->tv_sec = sec;
+    tv->tv_usec = nsec / 1000;
+    tz->tz_dsttime = DST_NONE;
+    tz->tz_minuteswest = 0;
+    return 0;
+}
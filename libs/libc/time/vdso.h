@@ -0,0 +1,18 @@
+#ifndef _LIBC_TIME_VDSO_H
+#define _LIBC_TIME_VDSO_H
+
+#include <bits/time.h>
+#include <bits/vdso.h>
+#include <sys/cdefs.h>
+
+__BEGIN_DECLS
+
+void _vdso_init();
+
+// Return -ENOSYS if the request can't be served from the time page.
+int __vdso_clock_gettime(clockid_t clk_id, timespec_t* tp);
+int __vdso_gettimeofday(timeval_t* tv, timezone_t* tz);
+
+__END_DECLS
+
+#endif // _LIBC_TIME_VDSO_H
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+namespace LFoundation {
+
+// Bump allocator for objects which die together. Memory is taken from
+// chunks and is freed all at once with the arena, destructors of objects
+// made in it are not called.
+class Arena {
+public:
+    Arena() = default;
+    ~Arena()
+    {
+        while (m_chunk) {
+            Chunk* next = m_chunk->next;
+            free(m_chunk);
+            m_chunk = next;
+        }
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t align = sizeof(void*))
+    {
+        uintptr_t ptr = m_chunk ? align_up(m_chunk->free_space(), align) : 0;
+        if (!m_chunk || ptr + size > m_chunk->end()) {
+            add_chunk(size + align);
+            ptr = align_up(m_chunk->free_space(), align);
+        }
+        m_chunk->used = ptr + size - m_chunk->begin();
+        return (void*)ptr;
+    }
+
+    template <class T, class... Args>
+    T* make(Args&&... args)
+    {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    template <class T>
+    T* allocate_array(size_t count)
+    {
+        return (T*)allocate(count * sizeof(T), alignof(T));
+    }
+
+private:
+    static constexpr size_t ChunkSize = 4096;
+
+    struct Chunk {
+        Chunk* next;
+        size_t size;
+        size_t used;
+
+        inline uintptr_t begin() const { return (uintptr_t)(this + 1); }
+        inline uintptr_t end() const { return begin() + size; }
+        inline uintptr_t free_space() const { return begin() + used; }
+    };
+
+    static inline uintptr_t align_up(uintptr_t ptr, size_t align) { return (ptr + align - 1) & ~(uintptr_t)(align - 1); }
+
+    void add_chunk(size_t min_size)
+    {
+        size_t size = min_size > ChunkSize ? min_size : ChunkSize;
+        Chunk* chunk = (Chunk*)malloc(sizeof(Chunk) + size);
+        chunk->next = m_chunk;
+        chunk->size = size;
+        chunk->used = 0;
+        m_chunk = chunk;
+    }
+
+    Chunk* m_chunk { nullptr };
+};
+
+} // namespace LFoundation
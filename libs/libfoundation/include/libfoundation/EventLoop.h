@@ -60,6 +60,17 @@ public:
         m_waiting_fds.push_back(FDWaiter(fd, on_read, on_write));
     }
 
+    // Waiters are dropped after the current pass, so it is safe
+    // to remove an fd from its own callback.
+    inline void remove(int fd)
+    {
+        for (auto& waiter : m_waiting_fds) {
+            if (waiter.fd() == fd) {
+                waiter.mark_invalid();
+            }
+        }
+    }
+
     inline void add(const Timer& timer)
     {
         m_timers.push_back(timer);
@@ -80,6 +91,7 @@ public:
 
 private:
     void pump();
+    void cleanup_fds();
     void cleanup_timers();
     void check_fds();
     void check_timers();
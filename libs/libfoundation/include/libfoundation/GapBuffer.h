@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+namespace LFoundation {
+
+// Array of trivially copyable elements with a gap at the place of the last
+// change. Insertions and removals next to each other only move the elements
+// between them, so typing in the middle of a large text costs as much as
+// typing at its end.
+template <typename T>
+class GapBuffer {
+public:
+    GapBuffer() = default;
+    ~GapBuffer() { free(m_data); }
+
+    GapBuffer(const GapBuffer&) = delete;
+    GapBuffer& operator=(const GapBuffer&) = delete;
+
+    inline size_t size() const { return m_capacity - gap_size(); }
+    inline size_t gap_position() const { return m_gap_start; }
+
+    inline T& operator[](size_t i) { return i < m_gap_start ? m_data[i] : m_data[i + gap_size()]; }
+    inline const T& operator[](size_t i) const { return i < m_gap_start ? m_data[i] : m_data[i + gap_size()]; }
+
+    void move_gap(size_t pos)
+    {
+        if (pos < m_gap_start) {
+            size_t len = m_gap_start - pos;
+            memmove(m_data + m_gap_end - len, m_data + pos, len * sizeof(T));
+            m_gap_start -= len;
+            m_gap_end -= len;
+        } else if (pos > m_gap_start) {
+            size_t len = pos - m_gap_start;
+            memmove(m_data + m_gap_start, m_data + m_gap_end, len * sizeof(T));
+            m_gap_start += len;
+            m_gap_end += len;
+        }
+    }
+
+    void insert(size_t pos, const T* data, size_t len)
+    {
+        reserve_gap(len);
+        move_gap(pos);
+        memcpy(m_data + m_gap_start, data, len * sizeof(T));
+        m_gap_start += len;
+    }
+
+    void insert(size_t pos, const T& value) { insert(pos, &value, 1); }
+
+    void insert_repeated(size_t pos, const T& value, size_t count)
+    {
+        reserve_gap(count);
+        move_gap(pos);
+        for (size_t i = 0; i < count; i++) {
+            m_data[m_gap_start++] = value;
+        }
+    }
+
+    void erase(size_t pos, size_t len)
+    {
+        move_gap(pos);
+        m_gap_end += len;
+    }
+
+    inline void clear()
+    {
+        m_gap_start = 0;
+        m_gap_end = m_capacity;
+    }
+
+    // Copies len elements starting at pos to dest.
+    void copy(size_t pos, size_t len, T* dest) const
+    {
+        if (pos < m_gap_start) {
+            size_t before_gap = m_gap_start - pos < len ? m_gap_start - pos : len;
+            memcpy(dest, m_data + pos, before_gap * sizeof(T));
+            dest += before_gap;
+            pos += before_gap;
+            len -= before_gap;
+        }
+        memcpy(dest, m_data + pos + gap_size(), len * sizeof(T));
+    }
+
+    void reserve(size_t capacity)
+    {
+        if (capacity > size()) {
+            reserve_gap(capacity - size());
+        }
+    }
+
+private:
+    static constexpr size_t MinGapSize = 64;
+
+    inline size_t gap_size() const { return m_gap_end - m_gap_start; }
+
+    void reserve_gap(size_t len)
+    {
+        if (gap_size() >= len) {
+            return;
+        }
+
+        size_t new_capacity = m_capacity * 2;
+        if (new_capacity < size() + len + MinGapSize) {
+            new_capacity = size() + len + MinGapSize;
+        }
+
+        T* new_data = (T*)malloc(new_capacity * sizeof(T));
+        size_t after_gap = m_capacity - m_gap_end;
+        memcpy(new_data, m_data, m_gap_start * sizeof(T));
+        memcpy(new_data + new_capacity - after_gap, m_data + m_gap_end, after_gap * sizeof(T));
+        free(m_data);
+
+        m_data = new_data;
+        m_gap_end = new_capacity - after_gap;
+        m_capacity = new_capacity;
+    }
+
+    T* m_data { nullptr };
+    size_t m_capacity { 0 };
+    size_t m_gap_start { 0 };
+    size_t m_gap_end { 0 };
+};
+
+} // namespace LFoundation
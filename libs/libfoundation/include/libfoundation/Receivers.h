@@ -51,6 +51,7 @@ public:
         , m_fd(fdw.m_fd)
         , m_on_read(fdw.m_on_read)
         , m_on_write(fdw.m_on_write)
+        , m_valid(fdw.m_valid)
     {
     }
 
@@ -59,6 +60,7 @@ public:
         m_fd = fdw.m_fd;
         m_on_read = fdw.m_on_read;
         m_on_write = fdw.m_on_write;
+        m_valid = fdw.m_valid;
         return *this;
     }
 
@@ -67,11 +69,16 @@ public:
         m_fd = fdw.m_fd;
         m_on_read = fdw.m_on_read;
         m_on_write = fdw.m_on_write;
+        m_valid = fdw.m_valid;
         return *this;
     }
 
     void receive_event(std::unique_ptr<Event> event) override
     {
+        // The waiter might be removed while its event was queued.
+        if (!m_valid) {
+            return;
+        }
         if (event->type() == Event::Type::FdWaiterRead) {
             m_on_read();
         } else if (event->type() == Event::Type::FdWaiterWrite) {
@@ -80,11 +87,15 @@ public:
     }
 
     inline int fd() const { return m_fd; }
+    inline bool valid() const { return m_valid; }
 
 private:
+    inline void mark_invalid() { m_valid = false; }
+
     int m_fd;
     std::function<void(void)> m_on_read;
     std::function<void(void)> m_on_write;
+    bool m_valid { true };
 };
 
 class TimerEvent final : public Event {
@@ -7,16 +7,16 @@ template <typename T>
 class SharedBuffer {
 public:
     SharedBuffer() = default;
-    SharedBuffer(size_t size)
+    SharedBuffer(size_t size, uint32_t flags = 0)
         : m_size(size)
     {
-        m_id = shared_buffer_create((uint8_t**)&m_data, m_size * sizeof(T));
+        m_id = shared_buffer_create((uint8_t**)&m_data, m_size * sizeof(T), flags);
     }
 
-    SharedBuffer(int id)
+    SharedBuffer(int id, uint32_t flags = 0)
         : m_id(id)
     {
-        if (shared_buffer_get(m_id, (uint8_t**)&m_data) != 0) {
+        if (shared_buffer_get(m_id, (uint8_t**)&m_data, flags) != 0) {
             m_id = -1;
         }
     }
@@ -25,16 +25,18 @@ public:
     {
     }
 
-    inline void create(size_t size)
+    // With SHBUF_READONLY other processes can only open the buffer read-only.
+    inline void create(size_t size, uint32_t flags = 0)
     {
         m_size = size;
-        m_id = shared_buffer_create((uint8_t**)&m_data, m_size * sizeof(T));
+        m_id = shared_buffer_create((uint8_t**)&m_data, m_size * sizeof(T), flags);
     }
 
-    inline void open(int id)
+    // With SHBUF_READONLY the buffer is mapped read-only.
+    inline void open(int id, uint32_t flags = 0)
     {
         m_id = id;
-        if (shared_buffer_get(m_id, (uint8_t**)&m_data) != 0) {
+        if (shared_buffer_get(m_id, (uint8_t**)&m_data, flags) != 0) {
             m_id = -1;
         }
     }
@@ -65,6 +67,7 @@ public:
 
     inline int id() const { return m_id; }
     inline T* data() { return m_data; }
+    inline const T* data() const { return m_data; }
 
 private:
     int m_id { -1 };
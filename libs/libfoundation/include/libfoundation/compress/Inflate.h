@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+
+namespace LFoundation {
+
+class InflateState;
+
+// Decoder of DEFLATE streams (RFC 1951), raw or wrapped in a zlib header.
+// Huffman codes are decoded with two-level lookup tables, a whole symbol
+// per lookup, and input is read through a 64-bit bit buffer, so a length
+// and distance pair needs one refill.
+//
+// The stream is decoded on demand into a sliding window, so a reader can
+// consume output piece by piece while memory stays bounded by the window.
+// Compressed data may come in several pieces, as PNG splits it in chunks.
+class Inflate {
+public:
+    enum Error {
+        InvalidData = -1,
+        TruncatedInput = -2,
+        OutputTooSmall = -3,
+    };
+
+    enum class Format {
+        Raw,
+        Zlib,
+    };
+
+    explicit Inflate(Format format = Format::Raw);
+    ~Inflate();
+
+    Inflate(const Inflate&) = delete;
+    Inflate& operator=(const Inflate&) = delete;
+
+    // Appends a piece of compressed data. Pieces are not copied, they should
+    // all be added before reading and stay valid while the stream is read.
+    void add_input(const uint8_t* data, size_t len);
+
+    // Reads up to len decompressed bytes. Returns the number of bytes read,
+    // which is less than len only at the end of the stream, or an Error.
+    ssize_t read(uint8_t* dest, size_t len);
+
+    // Decompresses a whole raw stream into dest.
+    // Returns the number of bytes written or an Error.
+    static ssize_t decompress(uint8_t* dest, size_t dest_len, const uint8_t* src, size_t src_len);
+
+private:
+    InflateState* m_state { nullptr };
+};
+
+} // namespace LFoundation
@@ -9,33 +9,33 @@
 #pragma once
 
 #include <cctype>
-#include <string>
-#include <unistd.h>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
 
 namespace LFoundation::Json {
 
+// Reads the input in place, tokens are returned as pointers into it.
 class Lexer {
 public:
     Lexer() = default;
-    Lexer(const std::string& filepath)
-        : m_text_data()
-        , m_pointer(0)
-    {
-        set_file(filepath);
-    }
-
     ~Lexer() = default;
 
-    int set_file(const std::string& filepath);
+    void set_data(const char* data, size_t size)
+    {
+        m_pointer = data;
+        m_end = data + size;
+    }
 
-    bool is_eof() const { return m_pointer >= m_text_data.size(); }
+    bool is_eof() const { return m_pointer >= m_end; }
+    const char* position() const { return m_pointer; }
 
     int lookup_char() const
     {
         if (is_eof()) {
             return EOF;
         }
-        return m_text_data[m_pointer];
+        return *m_pointer;
     }
 
     int next_char()
@@ -43,22 +43,49 @@ public:
         if (is_eof()) {
             return EOF;
         }
-        return m_text_data[m_pointer++];
+        return *m_pointer++;
     }
 
     void skip_spaces()
     {
-        while (std::isspace(lookup_char())) {
-            next_char();
+        while (!is_eof() && std::isspace((unsigned char)*m_pointer)) {
+            m_pointer++;
+        }
+    }
+
+    // Moves to the quote which closes a string, the opening one should be
+    // eaten already. Returns false if the input ends before it.
+    bool skip_string(bool& has_escapes)
+    {
+        has_escapes = false;
+        while (!is_eof()) {
+            char c = *m_pointer;
+            if (c == '\"') {
+                return true;
+            }
+            if (c == '\\') {
+                has_escapes = true;
+                m_pointer++;
+            }
+            m_pointer++;
         }
+        return false;
     }
 
-    bool eat_string(std::string& word)
+    void skip_number()
     {
-        // TODO: Fix stop at "
-        while (std::isprint(lookup_char()) && lookup_char() != '\"') {
-            word.push_back(next_char());
-        };
+        while (!is_eof() && is_number_char(*m_pointer)) {
+            m_pointer++;
+        }
+    }
+
+    bool eat_word(const char* word)
+    {
+        size_t len = strlen(word);
+        if ((size_t)(m_end - m_pointer) < len || memcmp(m_pointer, word, len) != 0) {
+            return false;
+        }
+        m_pointer += len;
         return true;
     }
 
@@ -69,8 +96,13 @@ public:
     }
 
 private:
-    int m_pointer;
-    std::string m_text_data;
+    static inline bool is_number_char(char c)
+    {
+        return std::isdigit((unsigned char)c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+    }
+
+    const char* m_pointer { nullptr };
+    const char* m_end { nullptr };
 };
 
-} // namespace LFoundation
\ No newline at end of file
+} // namespace LFoundation
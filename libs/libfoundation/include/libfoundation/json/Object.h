@@ -10,12 +10,15 @@
 
 #include <cassert>
 #include <cstddef>
-#include <map>
+#include <cstring>
+#include <libfoundation/Arena.h>
 #include <string>
-#include <vector>
+#include <string_view>
 
 namespace LFoundation::Json {
 
+// Objects live in the arena of the Parser which made them and point into
+// its input, they are valid as long as the parser is.
 class Object {
 public:
     enum Type {
@@ -36,7 +39,7 @@ public:
     {
     }
 
-    virtual ~Object() = default;
+    ~Object() = default;
 
     Type type() const { return m_type; }
     bool invalid() const { return type() == Type::Invalid; }
@@ -62,65 +65,117 @@ class StringObject : public Object {
 public:
     constexpr static Object::Type ObjType = Type::String;
 
-    StringObject()
+    // A string with escape sequences gets the arena to decode them into.
+    StringObject(const char* data, size_t size, Arena* unescape_arena)
         : Object(ObjType)
+        , m_data(data)
+        , m_size(size)
+        , m_unescape_arena(unescape_arena)
     {
     }
 
     ~StringObject() = default;
 
-    std::string& data() { return m_data; }
-    const std::string& data() const { return m_data; }
+    // Escape sequences are decoded on the first access.
+    std::string_view view()
+    {
+        if (m_unescape_arena) {
+            unescape();
+        }
+        return std::string_view(m_data, m_size);
+    }
+
+    std::string to_string()
+    {
+        auto data = view();
+        return std::string(data.data(), data.size());
+    }
 
 private:
-    std::string m_data;
+    void unescape();
+
+    const char* m_data;
+    size_t m_size;
+    Arena* m_unescape_arena;
 };
 
-class DictObject : public Object {
+class NumberObject : public Object {
 public:
-    constexpr static Object::Type ObjType = Type::Dict;
+    constexpr static Object::Type ObjType = Type::Number;
 
-    DictObject()
+    NumberObject(const char* data, size_t size)
         : Object(ObjType)
+        , m_data(data)
+        , m_size(size)
     {
     }
 
-    ~DictObject()
+    ~NumberObject() = default;
+
+    std::string_view view() const { return std::string_view(m_data, m_size); }
+
+    // The integer part of the number.
+    long to_int() const;
+
+private:
+    const char* m_data;
+    size_t m_size;
+};
+
+// Entries are kept in a flat array sorted by key, manifests and configs
+// have a few keys, so a binary search over it beats a tree of nodes.
+class DictObject : public Object {
+public:
+    constexpr static Object::Type ObjType = Type::Dict;
+
+    struct Entry {
+        const char* key;
+        size_t key_size;
+        Object* value;
+    };
+
+    DictObject(Entry* entries, size_t count)
+        : Object(ObjType)
+        , m_entries(entries)
+        , m_count(count)
     {
-        // TODO: Add iterators to map.
-        // for (auto it : m_data) {
-        // delete it.second;
-        // }
     }
 
-    std::map<std::string, Object*>& data() { return m_data; }
-    const std::map<std::string, Object*>& data() const { return m_data; }
+    ~DictObject() = default;
+
+    Object* get(const char* key, size_t key_size) const;
+    Object* get(const char* key) const { return get(key, strlen(key)); }
+
+    size_t size() const { return m_count; }
+    const Entry* begin() const { return m_entries; }
+    const Entry* end() const { return m_entries + m_count; }
 
 private:
-    std::map<std::string, Object*> m_data;
+    Entry* m_entries;
+    size_t m_count;
 };
 
 class ListObject : public Object {
 public:
     constexpr static Object::Type ObjType = Type::List;
 
-    ListObject()
+    ListObject(Object** items, size_t count)
         : Object(ObjType)
+        , m_items(items)
+        , m_count(count)
     {
     }
 
-    ~ListObject()
-    {
-        for (auto& i : m_data) {
-            delete i;
-        }
-    }
+    ~ListObject() = default;
 
-    std::vector<Object*>& data() { return m_data; }
-    const std::vector<Object*>& data() const { return m_data; }
+    size_t size() const { return m_count; }
+    Object* at(size_t i) const { return m_items[i]; }
+    Object* const* begin() const { return m_items; }
+    Object* const* end() const { return m_items + m_count; }
 
 private:
-    std::vector<Object*> m_data;
+    Object** m_items;
+    size_t m_count;
 };
 
 class NullObject : public Object {
@@ -141,15 +196,15 @@ class BoolObject : public Object {
 public:
     constexpr static Object::Type ObjType = Type::Bool;
 
-    BoolObject()
+    BoolObject(bool data)
         : Object(ObjType)
+        , m_data(data)
     {
     }
 
     ~BoolObject() = default;
 
-    bool& data() { return m_data; }
-    const bool& data() const { return m_data; }
+    bool data() const { return m_data; }
 
 private:
     bool m_data;
@@ -167,4 +222,4 @@ public:
     ~InvalidObject() = default;
 };
 
-} // namespace LFoundation
\ No newline at end of file
+} // namespace LFoundation
@@ -8,42 +8,58 @@
 
 #pragma once
 
+#include <libfoundation/Arena.h>
 #include <libfoundation/json/Lexer.h>
 #include <libfoundation/json/Object.h>
 #include <string>
+#include <vector>
 
 namespace LFoundation::Json {
 
+// Parses a document in one go. The file is mapped and strings point into
+// the mapping, objects are allocated in an arena of the parser, so the
+// parser owns the whole tree and frees it at once.
 class Parser {
 public:
-    Parser(const std::string& filepath)
-    {
-        int err = m_lexer.set_file(filepath);
-        if (err) {
-            m_root_object = new InvalidObject();
-        }
-    }
+    Parser(const std::string& filepath);
+    // The data is not copied and should outlive the parser.
+    Parser(const char* data, size_t size);
+    ~Parser();
 
-    ~Parser() = default;
+    Parser(const Parser&) = delete;
+    Parser& operator=(const Parser&) = delete;
 
     Object* object()
     {
         if (!m_root_object) {
-            m_root_object = parse_object();
+            m_root_object = parse_document();
         }
         return m_root_object;
     }
 
 private:
+    Object* parse_document();
     StringObject* parse_string();
     DictObject* parse_dict();
     ListObject* parse_list();
     BoolObject* parse_bool();
     NullObject* parse_null();
+    NumberObject* parse_number();
     Object* parse_object();
 
-    Object* m_root_object { nullptr };
+    Object* fail();
+
+    Arena m_arena;
     Lexer m_lexer;
+    void* m_mapping { nullptr };
+    size_t m_mapping_size { 0 };
+    bool m_failed { false };
+    Object* m_root_object { nullptr };
+
+    // Children of containers being parsed, they are moved to the arena
+    // once the container is closed.
+    std::vector<DictObject::Entry> m_entries;
+    std::vector<Object*> m_items;
 };
 
-} // namespace LFoundation
\ No newline at end of file
+} // namespace LFoundation
@@ -37,6 +37,9 @@ void EventLoop::check_fds()
     FD_ZERO(&writefds);
     int nfds = -1;
     for (int i = 0; i < m_waiting_fds.size(); i++) {
+        if (!m_waiting_fds[i].valid()) {
+            continue;
+        }
         if (m_waiting_fds[i].m_on_read) {
             FD_SET(m_waiting_fds[i].m_fd, &readfds);
         }
@@ -59,6 +62,9 @@ void EventLoop::check_fds()
     }
 
     for (int i = 0; i < m_waiting_fds.size(); i++) {
+        if (!m_waiting_fds[i].valid()) {
+            continue;
+        }
         if (m_waiting_fds[i].m_on_read) {
             if (FD_ISSET(m_waiting_fds[i].m_fd, &readfds)) {
                 m_event_queue.push_back(QueuedEvent(m_waiting_fds[i], new FDWaiterReadEvent()));
@@ -96,6 +102,23 @@ void EventLoop::check_timers()
     }
 }
 
+void EventLoop::cleanup_fds()
+{
+    size_t alive = 0;
+    for (size_t i = 0; i < m_waiting_fds.size(); i++) {
+        if (!m_waiting_fds[i].valid()) {
+            continue;
+        }
+        if (alive != i) {
+            m_waiting_fds[alive] = std::move(m_waiting_fds[i]);
+        }
+        alive++;
+    }
+    while (m_waiting_fds.size() > alive) {
+        m_waiting_fds.pop_back();
+    }
+}
+
 void EventLoop::cleanup_timers()
 {
     for (auto it = m_timers.begin(); it != m_timers.end();) {
@@ -118,6 +141,7 @@ void EventLoop::cleanup_timers()
         event.receiver.receive_event(std::move(event.event));
     }
 
+    cleanup_fds();
     cleanup_timers();
     if (!events_to_dispatch.size()) {
         sched_yield();
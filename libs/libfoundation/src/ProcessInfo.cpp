@@ -86,7 +86,7 @@ void ProcessInfo::parse_info_file()
     }
 
     auto* jdict_root = jobj_root->cast_to<LFoundation::Json::DictObject>();
-    m_bundle_id = jdict_root->data()["bundle_id"]->cast_to<LFoundation::Json::StringObject>()->data();
+    m_bundle_id = jdict_root->get("bundle_id")->cast_to<LFoundation::Json::StringObject>()->to_string();
 }
 
 } // namespace LFoundation
\ No newline at end of file
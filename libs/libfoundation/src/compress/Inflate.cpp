@@ -0,0 +1,680 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <cstring>
+#include <libfoundation/compress/Inflate.h>
+#include <vector>
+
+namespace LFoundation {
+
+static constexpr int MaxCodeLength = 15;
+static constexpr int MaxLitLenCodes = 288;
+static constexpr int MaxDistCodes = 32;
+static constexpr int PrecodeCodes = 19;
+
+// Codes longer than the primary table are resolved through subtables placed
+// after it. Sizes include the subtables and are checked while building.
+static constexpr int LitLenTableBits = 10;
+static constexpr int LitLenTableSize = 2048;
+static constexpr int DistTableBits = 8;
+static constexpr int DistTableSize = 768;
+static constexpr int PrecodeTableBits = 7;
+static constexpr int PrecodeTableSize = 1 << PrecodeTableBits;
+
+// Table entry: bits 0-7 hold the length of the codeword (for a subtable
+// pointer, the bits of the primary table), bits 8-11 the count of extra bits
+// (or subtable bits), bits 12-15 the kind and bits 16-31 the value.
+enum EntryKind : uint32_t {
+    Invalid = 0,
+    Literal = 1,
+    EndOfBlock = 2,
+    Base = 3, // Base of a length or a distance, followed by extra bits.
+    Subtable = 4,
+};
+
+static constexpr uint32_t make_entry(EntryKind kind, uint32_t value, uint32_t extra = 0)
+{
+    return (value << 16) | (kind << 12) | (extra << 8);
+}
+
+static inline uint32_t entry_bits(uint32_t entry) { return entry & 0xff; }
+static inline uint32_t entry_extra(uint32_t entry) { return (entry >> 8) & 0xf; }
+static inline uint32_t entry_kind(uint32_t entry) { return (entry >> 12) & 0xf; }
+static inline uint32_t entry_value(uint32_t entry) { return entry >> 16; }
+
+static const uint16_t s_length_base[] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t s_length_extra[] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const uint16_t s_dist_base[] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const uint8_t s_dist_extra[] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+static const uint8_t s_precode_order[PrecodeCodes] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+struct SymbolEntries {
+    uint32_t litlen[MaxLitLenCodes];
+    uint32_t dist[MaxDistCodes];
+    uint32_t precode[PrecodeCodes];
+
+    void init()
+    {
+        for (int i = 0; i < MaxLitLenCodes; i++) {
+            if (i < 256) {
+                litlen[i] = make_entry(Literal, i);
+            } else if (i == 256) {
+                litlen[i] = make_entry(EndOfBlock, 0);
+            } else if (i < 286) {
+                litlen[i] = make_entry(Base, s_length_base[i - 257], s_length_extra[i - 257]);
+            } else {
+                litlen[i] = make_entry(Invalid, 0);
+            }
+        }
+        for (int i = 0; i < MaxDistCodes; i++) {
+            dist[i] = i < 30 ? make_entry(Base, s_dist_base[i], s_dist_extra[i]) : make_entry(Invalid, 0);
+        }
+        for (int i = 0; i < PrecodeCodes; i++) {
+            precode[i] = make_entry(Literal, i);
+        }
+    }
+};
+
+static SymbolEntries s_entries;
+
+static inline uint32_t reverse_bits(uint32_t code, int len)
+{
+    uint32_t res = 0;
+    for (int i = 0; i < len; i++, code >>= 1) {
+        res = (res << 1) | (code & 1);
+    }
+    return res;
+}
+
+// Builds a decode table for canonical Huffman code lengths. Codewords are
+// stored LSB-first in the stream, so entries are indexed by reversed codes
+// and every entry of a short code is replicated over the unused bits.
+static bool build_table(const uint8_t* lens, int count, const uint32_t* entries, uint32_t* table, int table_bits, int table_size)
+{
+    uint16_t len_count[MaxCodeLength + 1] = {};
+    for (int i = 0; i < count; i++) {
+        len_count[lens[i]]++;
+    }
+
+    // Over-subscribed codes are invalid. As in zlib, an incomplete code is
+    // allowed only if it is a single code of length 1 (or no codes at all).
+    int left = 1;
+    int used = 0;
+    for (int len = 1; len <= MaxCodeLength; len++) {
+        left = (left << 1) - len_count[len];
+        if (left < 0) {
+            return false;
+        }
+        used += len_count[len];
+    }
+    if (left > 0 && used != len_count[1]) {
+        return false;
+    }
+
+    uint16_t offsets[MaxCodeLength + 2];
+    uint32_t next_code[MaxCodeLength + 1];
+    offsets[1] = 0;
+    next_code[0] = 0;
+    for (int len = 1; len <= MaxCodeLength; len++) {
+        offsets[len + 1] = offsets[len] + len_count[len];
+        next_code[len] = (next_code[len - 1] + (len == 1 ? 0 : len_count[len - 1])) << 1;
+    }
+
+    // Symbols in canonical order: by code length, then by value.
+    uint16_t sorted[MaxLitLenCodes];
+    uint32_t codes[MaxLitLenCodes];
+    for (int sym = 0; sym < count; sym++) {
+        if (lens[sym]) {
+            sorted[offsets[lens[sym]]++] = sym;
+        }
+    }
+    for (int i = 0; i < used; i++) {
+        codes[i] = next_code[lens[sorted[i]]]++;
+    }
+
+    const uint32_t primary_size = 1u << table_bits;
+    memset(table, 0, primary_size * sizeof(uint32_t));
+    uint32_t next_subtable = primary_size;
+
+    for (int i = 0; i < used; i++) {
+        int sym = sorted[i];
+        int len = lens[sym];
+        uint32_t code = codes[i];
+
+        if (len <= table_bits) {
+            uint32_t entry = entries[sym] | len;
+            for (uint32_t j = reverse_bits(code, len); j < primary_size; j += 1u << len) {
+                table[j] = entry;
+            }
+            continue;
+        }
+
+        uint32_t prefix = code >> (len - table_bits);
+        uint32_t& primary = table[reverse_bits(prefix, table_bits)];
+        if (entry_kind(primary) != Subtable) {
+            // Codes sharing a prefix are adjacent in canonical order, the
+            // last of them is the longest one and defines the subtable size.
+            int last = i;
+            while (last + 1 < used && (codes[last + 1] >> (lens[sorted[last + 1]] - table_bits)) == prefix) {
+                last++;
+            }
+            uint32_t sub_bits = lens[sorted[last]] - table_bits;
+            if (next_subtable + (1u << sub_bits) > (uint32_t)table_size) {
+                return false;
+            }
+            memset(&table[next_subtable], 0, (1u << sub_bits) * sizeof(uint32_t));
+            primary = make_entry(Subtable, next_subtable, sub_bits) | table_bits;
+            next_subtable += 1u << sub_bits;
+        }
+
+        int low_len = len - table_bits;
+        uint32_t* subtable = &table[entry_value(primary)];
+        uint32_t sub_size = 1u << entry_extra(primary);
+        uint32_t entry = entries[sym] | low_len;
+        for (uint32_t j = reverse_bits(code, low_len); j < sub_size; j += 1u << low_len) {
+            subtable[j] = entry;
+        }
+    }
+    return true;
+}
+
+struct FixedTables {
+    uint32_t litlen[LitLenTableSize];
+    uint32_t dist[DistTableSize];
+
+    void init()
+    {
+        uint8_t lens[MaxLitLenCodes];
+        for (int i = 0; i < MaxLitLenCodes; i++) {
+            lens[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+        }
+        build_table(lens, MaxLitLenCodes, s_entries.litlen, litlen, LitLenTableBits, LitLenTableSize);
+        for (int i = 0; i < MaxDistCodes; i++) {
+            lens[i] = 5;
+        }
+        build_table(lens, MaxDistCodes, s_entries.dist, dist, DistTableBits, DistTableSize);
+    }
+};
+
+static FixedTables s_fixed;
+static bool s_tables_ready = false;
+
+// Plain data filled on first use, so no static constructors are involved.
+static void init_tables()
+{
+    if (!s_tables_ready) {
+        s_entries.init();
+        s_fixed.init();
+        s_tables_ready = true;
+    }
+}
+
+static constexpr size_t MaxMatch = 258;
+static constexpr size_t MaxDistance = 32768;
+// History of MaxDistance bytes is kept when the window slides, the rest is
+// filled between slides. The tail leaves room for a match copied in words.
+static constexpr size_t WindowSize = 3 * MaxDistance;
+static constexpr size_t WindowTail = MaxMatch + 8;
+
+class InflateState {
+public:
+    enum Status {
+        Done = 0,
+        NeedsSpace = 1,
+    };
+
+    explicit InflateState(Inflate::Format format)
+        : m_format(format)
+    {
+    }
+
+    void add_input(const uint8_t* data, size_t len) { m_segments.push_back(Segment { data, len }); }
+    ssize_t read(uint8_t* dest, size_t len);
+
+private:
+    enum class Block {
+        None,
+        Stored,
+        Fixed,
+        Dynamic,
+    };
+
+    struct Segment {
+        const uint8_t* data;
+        size_t len;
+    };
+
+    // Moves to the next piece of input, returns false if there is none.
+    bool next_segment()
+    {
+        while (m_next_segment < m_segments.size()) {
+            const Segment& segment = m_segments[m_next_segment++];
+            if (segment.len) {
+                m_in = segment.data;
+                m_in_end = segment.data + segment.len;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Tops the bit buffer up to at least 56 bits, which covers a length code,
+    // a distance code and their extra bits. Past the end of input zero bytes
+    // are fed, they are accounted to detect truncated streams.
+    [[gnu::always_inline]] inline void refill()
+    {
+        if (m_in_end - m_in >= 8) {
+            uint64_t word;
+            memcpy(&word, m_in, sizeof(word));
+            m_bitbuf |= word << m_bitcount;
+            m_in += (63 - m_bitcount) >> 3;
+            m_bitcount |= 56;
+            return;
+        }
+        while (m_bitcount < 56) {
+            if (m_in < m_in_end || next_segment()) {
+                m_bitbuf |= (uint64_t)*m_in++ << m_bitcount;
+            } else {
+                m_overrun++;
+            }
+            m_bitcount += 8;
+        }
+    }
+
+    [[gnu::always_inline]] inline uint32_t peek(uint32_t count) const { return m_bitbuf & ((1ull << count) - 1); }
+    [[gnu::always_inline]] inline void consume(uint32_t count) { m_bitbuf >>= count, m_bitcount -= count; }
+    [[gnu::always_inline]] inline uint32_t take(uint32_t count)
+    {
+        uint32_t res = peek(count);
+        consume(count);
+        return res;
+    }
+
+    [[gnu::always_inline]] inline uint32_t decode(const uint32_t* table, uint32_t table_bits)
+    {
+        uint32_t entry = table[peek(table_bits)];
+        if (entry_kind(entry) == Subtable) {
+            consume(table_bits);
+            entry = table[entry_value(entry) + peek(entry_extra(entry))];
+        }
+        consume(entry_bits(entry));
+        return entry;
+    }
+
+    inline bool truncated() const { return m_overrun * 8 > m_bitcount; }
+
+    void slide_window();
+    ssize_t inflate_some();
+    ssize_t zlib_header();
+    ssize_t block_header();
+    ssize_t stored_block();
+    ssize_t dynamic_tables();
+    ssize_t huffman_block(const uint32_t* litlen, const uint32_t* dist);
+
+    Inflate::Format m_format;
+    bool m_header_read { false };
+    bool m_last_block { false };
+    Block m_block { Block::None };
+    size_t m_stored_left { 0 };
+    ssize_t m_error { 0 };
+
+    std::vector<Segment> m_segments;
+    size_t m_next_segment { 0 };
+    const uint8_t* m_in { nullptr };
+    const uint8_t* m_in_end { nullptr };
+
+    uint64_t m_bitbuf { 0 };
+    uint32_t m_bitcount { 0 };
+    size_t m_overrun { 0 };
+
+    // Output is produced at m_out and handed to the reader from m_read.
+    uint8_t* m_out { m_window };
+    uint8_t* m_read { m_window };
+
+    uint32_t m_litlen[LitLenTableSize];
+    uint32_t m_dist[DistTableSize];
+    uint8_t m_window[WindowSize];
+};
+
+void InflateState::slide_window()
+{
+    uint8_t* keep = m_out - m_window > (ssize_t)MaxDistance ? m_out - MaxDistance : m_window;
+    if (m_read < keep) {
+        keep = m_read;
+    }
+    if (keep == m_window) {
+        return;
+    }
+
+    size_t shift = keep - m_window;
+    memmove(m_window, keep, m_out - keep);
+    m_out -= shift;
+    m_read -= shift;
+}
+
+ssize_t InflateState::zlib_header()
+{
+    refill();
+    uint32_t cmf = take(8);
+    uint32_t flg = take(8);
+    if (truncated()) {
+        return Inflate::TruncatedInput;
+    }
+    // Deflate with up to a 32K window and no preset dictionary.
+    if ((cmf & 0xf) != 8 || (cmf >> 4) > 7 || (cmf * 256 + flg) % 31 || (flg & 0x20)) {
+        return Inflate::InvalidData;
+    }
+    return 0;
+}
+
+ssize_t InflateState::block_header()
+{
+    refill();
+    m_last_block = take(1);
+    uint32_t type = take(2);
+
+    if (type == 0) {
+        // Stored blocks start at a byte boundary.
+        consume(m_bitcount & 7);
+        uint32_t len = take(16);
+        uint32_t nlen = take(16);
+        if (truncated()) {
+            return Inflate::TruncatedInput;
+        }
+        if (len != (~nlen & 0xffff)) {
+            return Inflate::InvalidData;
+        }
+        m_stored_left = len;
+        m_block = Block::Stored;
+        return 0;
+    }
+    if (type == 1) {
+        m_block = Block::Fixed;
+        return 0;
+    }
+    if (type == 2) {
+        m_block = Block::Dynamic;
+        return dynamic_tables();
+    }
+    return Inflate::InvalidData;
+}
+
+ssize_t InflateState::stored_block()
+{
+    size_t len = m_stored_left;
+    if (len > (size_t)(m_window + WindowSize - m_out)) {
+        len = m_window + WindowSize - m_out;
+    }
+    m_stored_left -= len;
+
+    // Whole bytes left in the bit buffer go first.
+    while (len && m_bitcount >= 8) {
+        *m_out++ = take(8);
+        len--;
+    }
+    if (truncated()) {
+        return Inflate::TruncatedInput;
+    }
+    if (len) {
+        // Bits above m_bitcount may hold a copy of the next input byte.
+        m_bitbuf = 0;
+    }
+    while (len) {
+        if (m_in == m_in_end && !next_segment()) {
+            return Inflate::TruncatedInput;
+        }
+        size_t chunk = m_in_end - m_in < (ssize_t)len ? m_in_end - m_in : len;
+        memcpy(m_out, m_in, chunk);
+        m_out += chunk;
+        m_in += chunk;
+        len -= chunk;
+    }
+
+    return m_stored_left ? NeedsSpace : Done;
+}
+
+ssize_t InflateState::dynamic_tables()
+{
+    refill();
+    int nlen = take(5) + 257;
+    int ndist = take(5) + 1;
+    int ncode = take(4) + 4;
+    if (nlen > 286 || ndist > 30) {
+        return Inflate::InvalidData;
+    }
+
+    uint8_t lens[MaxLitLenCodes + MaxDistCodes] = {};
+    for (int i = 0; i < ncode; i++) {
+        refill();
+        lens[s_precode_order[i]] = take(3);
+    }
+
+    uint32_t precode[PrecodeTableSize];
+    if (!build_table(lens, PrecodeCodes, s_entries.precode, precode, PrecodeTableBits, PrecodeTableSize)) {
+        return Inflate::InvalidData;
+    }
+
+    // Both code lengths are read as one sequence, repeats may cross them.
+    memset(lens, 0, sizeof(lens));
+    int index = 0;
+    while (index < nlen + ndist) {
+        refill();
+        uint32_t entry = decode(precode, PrecodeTableBits);
+        if (entry_kind(entry) != Literal) {
+            return Inflate::InvalidData;
+        }
+
+        uint32_t sym = entry_value(entry);
+        if (sym < 16) {
+            lens[index++] = sym;
+            continue;
+        }
+
+        uint8_t len = 0;
+        int repeat;
+        if (sym == 16) {
+            if (index == 0) {
+                return Inflate::InvalidData;
+            }
+            len = lens[index - 1];
+            repeat = 3 + take(2);
+        } else if (sym == 17) {
+            repeat = 3 + take(3);
+        } else {
+            repeat = 11 + take(7);
+        }
+        if (index + repeat > nlen + ndist) {
+            return Inflate::InvalidData;
+        }
+        while (repeat--) {
+            lens[index++] = len;
+        }
+    }
+
+    if (truncated()) {
+        return Inflate::TruncatedInput;
+    }
+    // The end of block code must be present.
+    if (!lens[256]) {
+        return Inflate::InvalidData;
+    }
+    if (!build_table(lens, nlen, s_entries.litlen, m_litlen, LitLenTableBits, LitLenTableSize)) {
+        return Inflate::InvalidData;
+    }
+    if (!build_table(lens + nlen, ndist, s_entries.dist, m_dist, DistTableBits, DistTableSize)) {
+        return Inflate::InvalidData;
+    }
+    return 0;
+}
+
+ssize_t InflateState::huffman_block(const uint32_t* litlen, const uint32_t* dist)
+{
+    uint8_t* out = m_out;
+    // Every symbol fits before the limit, so literals and matches are
+    // written without checks and matches may be copied in words.
+    uint8_t* out_limit = m_window + WindowSize - WindowTail;
+
+    for (;;) {
+        if (out > out_limit) {
+            m_out = out;
+            return NeedsSpace;
+        }
+
+        refill();
+        uint32_t entry = decode(litlen, LitLenTableBits);
+
+        if (entry_kind(entry) == Literal) [[likely]] {
+            *out++ = entry_value(entry);
+            continue;
+        }
+
+        if (entry_kind(entry) != Base) {
+            if (entry_kind(entry) == EndOfBlock) {
+                break;
+            }
+            return Inflate::InvalidData;
+        }
+
+        size_t len = entry_value(entry) + take(entry_extra(entry));
+        entry = decode(dist, DistTableBits);
+        if (entry_kind(entry) != Base) {
+            return Inflate::InvalidData;
+        }
+        size_t distance = entry_value(entry) + take(entry_extra(entry));
+        if (distance > (size_t)(out - m_window)) {
+            return Inflate::InvalidData;
+        }
+
+        const uint8_t* src = out - distance;
+        if (distance >= 8) {
+            // May write up to 7 bytes past the match, which are overwritten
+            // later and stay within the window tail.
+            uint8_t* end = out + len;
+            do {
+                uint64_t word;
+                memcpy(&word, src, sizeof(word));
+                memcpy(out, &word, sizeof(word));
+                src += 8;
+                out += 8;
+            } while (out < end);
+            out = end;
+        } else {
+            while (len--) {
+                *out++ = *src++;
+            }
+        }
+    }
+
+    m_out = out;
+    return Done;
+}
+
+ssize_t InflateState::inflate_some()
+{
+    if (m_window + WindowSize - m_out < (ssize_t)WindowTail * 2) {
+        slide_window();
+    }
+
+    ssize_t res;
+    if (!m_header_read) {
+        m_header_read = true;
+        if (m_format == Inflate::Format::Zlib && (res = zlib_header())) {
+            return res;
+        }
+    }
+
+    if (m_block == Block::None) {
+        if ((res = block_header())) {
+            return res;
+        }
+    }
+
+    if (m_block == Block::Stored) {
+        res = stored_block();
+    } else {
+        res = huffman_block(m_block == Block::Fixed ? s_fixed.litlen : m_litlen, m_block == Block::Fixed ? s_fixed.dist : m_dist);
+    }
+
+    if (res < 0) {
+        return truncated() ? Inflate::TruncatedInput : res;
+    }
+    if (res == Done) {
+        m_block = Block::None;
+        if (truncated()) {
+            return Inflate::TruncatedInput;
+        }
+    }
+    return 0;
+}
+
+ssize_t InflateState::read(uint8_t* dest, size_t len)
+{
+    size_t done = 0;
+    while (done < len) {
+        if (m_read < m_out) {
+            size_t chunk = m_out - m_read < (ssize_t)(len - done) ? m_out - m_read : len - done;
+            memcpy(dest + done, m_read, chunk);
+            m_read += chunk;
+            done += chunk;
+            continue;
+        }
+
+        if (m_error || (m_block == Block::None && m_last_block)) {
+            break;
+        }
+        m_error = inflate_some();
+    }
+
+    // Data read before an error is returned first, the error comes next time.
+    if (!done && m_error) {
+        return m_error;
+    }
+    return done;
+}
+
+Inflate::Inflate(Format format)
+{
+    init_tables();
+    m_state = new InflateState(format);
+}
+
+Inflate::~Inflate()
+{
+    delete m_state;
+}
+
+void Inflate::add_input(const uint8_t* data, size_t len)
+{
+    m_state->add_input(data, len);
+}
+
+ssize_t Inflate::read(uint8_t* dest, size_t len)
+{
+    return m_state->read(dest, len);
+}
+
+ssize_t Inflate::decompress(uint8_t* dest, size_t dest_len, const uint8_t* src, size_t src_len)
+{
+    Inflate inflate;
+    inflate.add_input(src, src_len);
+
+    ssize_t res = inflate.read(dest, dest_len);
+    if (res < 0) {
+        return res;
+    }
+
+    // The stream should end here. A pending error is returned by this read.
+    uint8_t extra;
+    ssize_t more = inflate.read(&extra, 1);
+    if (more) {
+        return more < 0 ? more : OutputTooSmall;
+    }
+    return res;
+}
+
+} // namespace LFoundation
@@ -6,98 +6,434 @@
  * found in the LICENSE file.
  */
 
-#include <cassert>
+#include <fcntl.h>
 #include <libfoundation/json/Parser.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 namespace LFoundation::Json {
 
-StringObject* Parser::parse_string()
+static constexpr size_t SmallDictSize = 16;
+
+static int compare_keys(const char* a, size_t a_size, const char* b, size_t b_size)
 {
-    auto* res = new StringObject();
+    int res = memcmp(a, b, a_size < b_size ? a_size : b_size);
+    if (res) {
+        return res;
+    }
+    return a_size < b_size ? -1 : a_size > b_size;
+}
 
-    m_lexer.skip_spaces();
-    assert(m_lexer.eat_token('\"'));
-    m_lexer.eat_string(res->data());
-    assert(m_lexer.eat_token('\"'));
-    return res;
+static inline int compare_keys(const DictObject::Entry& a, const DictObject::Entry& b)
+{
+    return compare_keys(a.key, a.key_size, b.key, b.key_size);
 }
 
-DictObject* Parser::parse_dict()
+static void insertion_sort(DictObject::Entry* entries, size_t count)
 {
-    auto* res = new DictObject();
+    for (size_t i = 1; i < count; i++) {
+        DictObject::Entry entry = entries[i];
+        size_t j = i;
+        for (; j > 0 && compare_keys(entries[j - 1], entry) > 0; j--) {
+            entries[j] = entries[j - 1];
+        }
+        entries[j] = entry;
+    }
+}
 
-    m_lexer.skip_spaces();
-    assert(m_lexer.eat_token('{'));
-    for (;;) {
-        auto left = parse_string();
-        assert(m_lexer.eat_token(':'));
-        auto right_obj = parse_object();
-        res->data()[left->data()] = right_obj;
-
-        if (m_lexer.lookup_char() == ',') {
-            assert(m_lexer.eat_token(','));
+// Both sorts are stable, so entries with the same key stay in document order.
+static void merge_sort(DictObject::Entry* entries, DictObject::Entry* tmp, size_t count)
+{
+    if (count <= SmallDictSize) {
+        insertion_sort(entries, count);
+        return;
+    }
+
+    size_t half = count / 2;
+    merge_sort(entries, tmp, half);
+    merge_sort(entries + half, tmp, count - half);
+
+    size_t left = 0;
+    size_t right = half;
+    size_t out = 0;
+    while (left < half && right < count) {
+        if (compare_keys(entries[left], entries[right]) <= 0) {
+            tmp[out++] = entries[left++];
         } else {
+            tmp[out++] = entries[right++];
+        }
+    }
+    while (left < half) {
+        tmp[out++] = entries[left++];
+    }
+    while (right < count) {
+        tmp[out++] = entries[right++];
+    }
+    memcpy(entries, tmp, count * sizeof(DictObject::Entry));
+}
+
+static inline int hex_value(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+static bool parse_hex4(const char* data, uint32_t& code)
+{
+    code = 0;
+    for (int i = 0; i < 4; i++) {
+        int val = hex_value(data[i]);
+        if (val < 0) {
+            return false;
+        }
+        code = (code << 4) | val;
+    }
+    return true;
+}
+
+static size_t encode_utf8(uint32_t code, char* out)
+{
+    if (code < 0x80) {
+        out[0] = code;
+        return 1;
+    }
+    if (code < 0x800) {
+        out[0] = 0xc0 | (code >> 6);
+        out[1] = 0x80 | (code & 0x3f);
+        return 2;
+    }
+    if (code < 0x10000) {
+        out[0] = 0xe0 | (code >> 12);
+        out[1] = 0x80 | ((code >> 6) & 0x3f);
+        out[2] = 0x80 | (code & 0x3f);
+        return 3;
+    }
+    out[0] = 0xf0 | (code >> 18);
+    out[1] = 0x80 | ((code >> 12) & 0x3f);
+    out[2] = 0x80 | ((code >> 6) & 0x3f);
+    out[3] = 0x80 | (code & 0x3f);
+    return 4;
+}
+
+void StringObject::unescape()
+{
+    // Decoded text is never longer than the escaped one.
+    char* res = (char*)m_unescape_arena->allocate(m_size, 1);
+    size_t len = 0;
+
+    for (size_t i = 0; i < m_size; i++) {
+        char c = m_data[i];
+        if (c != '\\' || i + 1 == m_size) {
+            res[len++] = c;
+            continue;
+        }
+
+        c = m_data[++i];
+        switch (c) {
+        case 'b':
+            res[len++] = '\b';
+            break;
+        case 'f':
+            res[len++] = '\f';
+            break;
+        case 'n':
+            res[len++] = '\n';
+            break;
+        case 'r':
+            res[len++] = '\r';
+            break;
+        case 't':
+            res[len++] = '\t';
+            break;
+        case 'u': {
+            uint32_t code;
+            if (i + 4 >= m_size || !parse_hex4(&m_data[i + 1], code)) {
+                res[len++] = c;
+                break;
+            }
+            i += 4;
+
+            // Characters out of the BMP come as a surrogate pair.
+            uint32_t low;
+            if (code >= 0xd800 && code < 0xdc00 && i + 6 < m_size && m_data[i + 1] == '\\' && m_data[i + 2] == 'u'
+                && parse_hex4(&m_data[i + 3], low) && low >= 0xdc00 && low < 0xe000) {
+                code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                i += 6;
+            }
+            len += encode_utf8(code, &res[len]);
+            break;
+        }
+        default:
+            res[len++] = c;
             break;
         }
     }
-    assert(m_lexer.eat_token('}'));
-    return res;
+
+    m_data = res;
+    m_size = len;
+    m_unescape_arena = nullptr;
 }
 
-ListObject* Parser::parse_list()
+long NumberObject::to_int() const
 {
-    auto* res = new ListObject();
+    size_t i = 0;
+    bool negative = false;
+    if (i < m_size && (m_data[i] == '-' || m_data[i] == '+')) {
+        negative = m_data[i] == '-';
+        i++;
+    }
 
-    m_lexer.skip_spaces();
-    assert(m_lexer.eat_token('['));
-    for (;;) {
-        auto obj = parse_object();
-        res->data().push_back(obj);
+    long res = 0;
+    for (; i < m_size && m_data[i] >= '0' && m_data[i] <= '9'; i++) {
+        res = res * 10 + (m_data[i] - '0');
+    }
+    return negative ? -res : res;
+}
 
-        if (m_lexer.lookup_char() == ',') {
-            assert(m_lexer.eat_token(','));
+Object* DictObject::get(const char* key, size_t key_size) const
+{
+    size_t lo = 0;
+    size_t hi = m_count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        int cmp = compare_keys(m_entries[mid].key, m_entries[mid].key_size, key, key_size);
+        if (cmp == 0) {
+            return m_entries[mid].value;
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
         } else {
-            break;
+            hi = mid;
         }
     }
-    assert(m_lexer.eat_token(']'));
-    return res;
+    return nullptr;
 }
 
-BoolObject* Parser::parse_bool()
+Parser::Parser(const std::string& filepath)
+{
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        m_root_object = fail();
+        return;
+    }
+
+    stat_t stat;
+    if (fstat(fd, &stat) < 0 || stat.st_size == 0) {
+        close(fd);
+        m_root_object = fail();
+        return;
+    }
+
+    intptr_t mapping = (intptr_t)mmap(NULL, stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping < 0) {
+        m_root_object = fail();
+        return;
+    }
+
+    m_mapping = (void*)mapping;
+    m_mapping_size = stat.st_size;
+    m_lexer.set_data((const char*)m_mapping, m_mapping_size);
+}
+
+Parser::Parser(const char* data, size_t size)
 {
-    auto* res = new BoolObject();
+    m_lexer.set_data(data, size);
+}
+
+Parser::~Parser()
+{
+    if (m_mapping) {
+        munmap(m_mapping, m_mapping_size);
+    }
+}
 
+Object* Parser::fail()
+{
+    m_failed = true;
+    return m_arena.make<InvalidObject>();
+}
+
+Object* Parser::parse_document()
+{
+    Object* root = parse_object();
     m_lexer.skip_spaces();
+    if (m_failed || !m_lexer.is_eof()) {
+        return fail();
+    }
+    return root;
+}
 
-    std::string tmp;
-    m_lexer.eat_string(tmp);
+StringObject* Parser::parse_string()
+{
+    if (!m_lexer.eat_token('\"')) {
+        m_failed = true;
+        return nullptr;
+    }
+
+    const char* start = m_lexer.position();
+    bool has_escapes;
+    if (!m_lexer.skip_string(has_escapes)) {
+        m_failed = true;
+        return nullptr;
+    }
+    size_t size = m_lexer.position() - start;
+    m_lexer.next_char();
+
+    return m_arena.make<StringObject>(start, size, has_escapes ? &m_arena : nullptr);
+}
 
-    if (tmp == "true") {
-        res->data() = true;
-    } else if (tmp == "false") {
-        res->data() = false;
+DictObject* Parser::parse_dict()
+{
+    size_t first = m_entries.size();
+    m_lexer.eat_token('{');
+    m_lexer.skip_spaces();
+    if (m_lexer.lookup_char() == '}') {
+        m_lexer.next_char();
     } else {
-        assert(false);
+        for (;;) {
+            StringObject* key = parse_string();
+            if (m_failed || !m_lexer.eat_token(':')) {
+                m_failed = true;
+                break;
+            }
+
+            Object* value = parse_object();
+            if (m_failed) {
+                break;
+            }
+
+            // Keys are sorted by their text, so they are decoded right away.
+            auto key_data = key->view();
+            m_entries.push_back(DictObject::Entry { key_data.data(), key_data.size(), value });
+
+            m_lexer.skip_spaces();
+            int c = m_lexer.next_char();
+            if (c == '}') {
+                break;
+            }
+            if (c != ',') {
+                m_failed = true;
+                break;
+            }
+        }
+    }
+
+    if (m_failed) {
+        m_entries.resize(first);
+        return nullptr;
+    }
+
+    size_t count = m_entries.size() - first;
+    if (!count) {
+        return m_arena.make<DictObject>(nullptr, 0);
     }
 
-    return res;
+    auto* entries = m_arena.allocate_array<DictObject::Entry>(count);
+    memcpy(entries, &m_entries[first], count * sizeof(DictObject::Entry));
+    m_entries.resize(first);
+
+    DictObject::Entry* tmp = count > SmallDictSize ? m_arena.allocate_array<DictObject::Entry>(count) : nullptr;
+    merge_sort(entries, tmp, count);
+
+    // The last value of a repeated key wins.
+    size_t unique = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (unique && compare_keys(entries[unique - 1], entries[i]) == 0) {
+            entries[unique - 1] = entries[i];
+        } else {
+            entries[unique++] = entries[i];
+        }
+    }
+
+    return m_arena.make<DictObject>(entries, unique);
 }
 
-NullObject* Parser::parse_null()
+ListObject* Parser::parse_list()
 {
+    size_t first = m_items.size();
+    m_lexer.eat_token('[');
     m_lexer.skip_spaces();
-    std::string tmp;
-    m_lexer.eat_string(tmp);
-    assert(tmp == "null");
-    return new NullObject();
+    if (m_lexer.lookup_char() == ']') {
+        m_lexer.next_char();
+    } else {
+        for (;;) {
+            Object* obj = parse_object();
+            if (m_failed) {
+                break;
+            }
+            m_items.push_back(obj);
+
+            m_lexer.skip_spaces();
+            int c = m_lexer.next_char();
+            if (c == ']') {
+                break;
+            }
+            if (c != ',') {
+                m_failed = true;
+                break;
+            }
+        }
+    }
+
+    if (m_failed) {
+        m_items.resize(first);
+        return nullptr;
+    }
+
+    size_t count = m_items.size() - first;
+    if (!count) {
+        return m_arena.make<ListObject>(nullptr, 0);
+    }
+
+    auto* items = m_arena.allocate_array<Object*>(count);
+    memcpy(items, &m_items[first], count * sizeof(Object*));
+    m_items.resize(first);
+    return m_arena.make<ListObject>(items, count);
+}
+
+BoolObject* Parser::parse_bool()
+{
+    if (m_lexer.eat_word("true")) {
+        return m_arena.make<BoolObject>(true);
+    }
+    if (m_lexer.eat_word("false")) {
+        return m_arena.make<BoolObject>(false);
+    }
+    m_failed = true;
+    return nullptr;
+}
+
+NullObject* Parser::parse_null()
+{
+    if (!m_lexer.eat_word("null")) {
+        m_failed = true;
+        return nullptr;
+    }
+    return m_arena.make<NullObject>();
+}
+
+NumberObject* Parser::parse_number()
+{
+    const char* start = m_lexer.position();
+    m_lexer.skip_number();
+    return m_arena.make<NumberObject>(start, m_lexer.position() - start);
 }
 
 Object* Parser::parse_object()
 {
     m_lexer.skip_spaces();
-    switch (m_lexer.lookup_char()) {
+    int c = m_lexer.lookup_char();
+    switch (c) {
     case '{':
         return parse_dict();
     case '\"':
@@ -105,16 +441,17 @@ Object* Parser::parse_object()
     case '[':
         return parse_list();
     case 'n':
-        // Only null is expected to start with n
         return parse_null();
     case 't':
     case 'f':
-        // Only true or false is expected to start with n
         return parse_bool();
     default:
-        assert(false);
+        if (c == '-' || (c >= '0' && c <= '9')) {
+            return parse_number();
+        }
+        m_failed = true;
+        return nullptr;
     }
-    return new DictObject();
 }
 
-}
\ No newline at end of file
+} // namespace LFoundation
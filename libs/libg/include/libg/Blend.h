@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#pragma once
+
+#include <libg/Color.h>
+#include <sys/types.h>
+
+namespace LG {
+
+// Span kernels which Context uses to draw rows of pixels. All colors are
+// premultiplied, blending kernels match Color::blend_with bit for bit.
+struct BlendBackend {
+    const char* name;
+    void (*copy)(Color* dest, const Color* src, size_t count);
+    void (*fill)(Color* dest, Color color, size_t count);
+    void (*blend)(Color* dest, const Color* src, size_t count);
+    void (*blend_color)(Color* dest, Color color, size_t count);
+    // Blends color scaled by a coverage mask, as glyphs are drawn.
+    void (*blend_mask)(Color* dest, Color color, const uint8_t* mask, size_t count);
+};
+
+// Picks the fastest backend the CPU supports on the first call.
+const BlendBackend& blend_backend();
+const BlendBackend& scalar_blend_backend();
+
+} // namespace LG
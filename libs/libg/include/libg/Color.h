@@ -87,25 +87,64 @@ public:
         return clr;
     }
 
-    [[gnu::always_inline]] inline void mix_with(const Color& clr)
+    // Colors in bitmaps are premultiplied by alpha, while colors set by
+    // users (fill colors, style colors) are straight. premultiplied() turns
+    // the latter into the former before drawing.
+    inline Color premultiplied() const
     {
-        if (clr.is_opaque()) {
-            return;
+        uint32_t a = alpha();
+        Color res;
+        res.m_r = div255(m_r * a + 128);
+        res.m_g = div255(m_g * a + 128);
+        res.m_b = div255(m_b * a + 128);
+        res.m_opacity = m_opacity;
+        return res;
+    }
+
+    inline Color unpremultiplied() const
+    {
+        uint32_t a = alpha();
+        if (a == 0 || a == 255) {
+            return *this;
         }
 
-        if (clr.alpha() == 255 || is_opaque()) {
+        Color res;
+        res.m_r = min255((m_r * 255 + a / 2) / a);
+        res.m_g = min255((m_g * 255 + a / 2) / a);
+        res.m_b = min255((m_b * 255 + a / 2) / a);
+        res.m_opacity = m_opacity;
+        return res;
+    }
+
+    // Multiplies a premultiplied color by alpha, e.g. by a coverage value.
+    inline Color scaled(uint8_t alpha) const
+    {
+        Color res;
+        res.m_r = div255(m_r * alpha + 128);
+        res.m_g = div255(m_g * alpha + 128);
+        res.m_b = div255(m_b * alpha + 128);
+        res.m_opacity = 255 - div255(this->alpha() * alpha + 128);
+        return res;
+    }
+
+    // Source-over of a premultiplied color: dest = src + dest * (1 - src alpha).
+    // Since opacity is 1 - alpha, the opacity of the result is the product of
+    // both opacities.
+    [[gnu::always_inline]] inline void blend_with(const Color& clr)
+    {
+        if (clr.m_opacity == 0) {
             *this = clr;
             return;
         }
+        if (clr.m_opacity == 255) {
+            return;
+        }
 
-        size_t alpha_c = 255 * (alpha() + clr.alpha()) - alpha() * clr.alpha();
-        size_t alpha_of_me = alpha() * (255 - clr.alpha());
-        size_t alpha_of_it = 255 * clr.alpha();
-
-        m_r = (red() * alpha_of_me + clr.red() * alpha_of_it) / alpha_c;
-        m_g = (green() * alpha_of_me + clr.green() * alpha_of_it) / alpha_c;
-        m_b = (blue() * alpha_of_me + clr.blue() * alpha_of_it) / alpha_c;
-        m_opacity = 255 - (alpha_c / 255);
+        uint32_t op = clr.m_opacity;
+        m_r = clr.m_r + div255(m_r * op);
+        m_g = clr.m_g + div255(m_g * op);
+        m_b = clr.m_b + div255(m_b * op);
+        m_opacity = div255(m_opacity * op);
     }
 
     inline LG::Color darken(int percents) const
@@ -117,7 +156,12 @@ public:
         return LG::Color(r, g, b);
     }
 
+    // x / 255 rounded down for x < 65535, without a division.
+    [[gnu::always_inline]] static inline uint32_t div255(uint32_t x) { return (x + 1 + (x >> 8)) >> 8; }
+
 private:
+    static inline uint8_t min255(uint32_t x) { return x < 255 ? x : 255; }
+
     uint8_t m_b { 0 };
     uint8_t m_g { 0 };
     uint8_t m_r { 0 };
@@ -45,6 +45,8 @@ public:
     const Point<int>& draw_offset() const { return m_draw_offset; }
     void set_fill_color(const Color& clr) { m_color = clr; }
 
+    inline PixelBitmap& bitmap() const { return m_bitmap; }
+
     inline const Color& fill_color() const { return m_color; }
 
 private:
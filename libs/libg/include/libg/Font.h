@@ -11,23 +11,30 @@
 #include <libfreetype/freetype/freetype.h>
 #include <libg/Color.h>
 #include <libg/Glyph.h>
+#include <libg/GlyphAtlas.h>
 #include <libg/PixelBitmap.h>
 #include <libg/Rect.h>
 #include <sys/types.h>
+#include <vector>
 
 namespace LG {
 
 class FontCacher {
 public:
     FontCacher() = default;
-    ~FontCacher() = default;
+    ~FontCacher();
 
-    void cache(int ch, Glyph&& gl) { m_cache[ch] = std::move(gl); }
-    const Glyph& get(int ch) const { return m_cache[ch]; }
-    bool has(int ch) const { return !m_cache[ch].empty(); }
+    void cache(size_t ch, Glyph&& gl);
+    const Glyph& get(size_t ch) const { return m_pages[ch >> 8][ch & 0xff]; }
+    bool has(size_t ch) const
+    {
+        size_t page = ch >> 8;
+        return page < m_pages.size() && m_pages[page] && !m_pages[page][ch & 0xff].empty();
+    }
 
 private:
-    Glyph m_cache[256];
+    // Glyphs are kept in pages of 256 codepoints, allocated on first use.
+    std::vector<Glyph*> m_pages;
 };
 
 class Font {
@@ -36,10 +43,24 @@ public:
     static const int SystemTitleSize = 20;
     static const int SystemMaxSize = 36;
 
-    ~Font() = default;
+    enum class SystemFont {
+        Regular,
+        Bold,
+    };
+
+    // Returns an atlas of a system font which is shared by another process,
+    // an invalid atlas makes the font rasterize its glyphs itself.
+    typedef GlyphAtlas (*AtlasProvider)(SystemFont font, size_t size);
+
+    // A font owns its face and glyph cache, so it is shared by reference.
+    Font(const Font&) = delete;
+    Font& operator=(const Font&) = delete;
+    ~Font();
 
     static Font& system_font(int of_size = SystemDefaultSize);
     static Font& system_bold_font(int of_size = SystemDefaultSize);
+    static const char* system_font_path(SystemFont font);
+    static void set_atlas_provider(AtlasProvider provider);
     static Font* load_from_file(const char* path);
     static Font* load_from_file_ttf(const char* path, size_t size);
     static Font* load_from_mem(uint8_t* path);
@@ -48,7 +69,8 @@ public:
     inline const Glyph& glyph(size_t ch) const
     {
         if (!m_font_cache->has(ch)) {
-            m_font_cache->cache(ch, load_glyph(ch));
+            Glyph shared = m_atlas.has(ch) ? m_atlas.glyph(ch) : Glyph();
+            m_font_cache->cache(ch, shared.empty() ? load_glyph(ch) : std::move(shared));
         }
         return m_font_cache->get(ch);
     }
@@ -73,23 +95,28 @@ private:
 
     struct FreeTypeFontDesc final {
         FT_Face face;
+        const char* path;
         size_t height;
 
-        Glyph load_glyph(size_t ch) const;
+        bool load_face();
+        Glyph load_glyph(size_t ch);
     };
 
     Font(const SerenityOSFontDesc& font_desc, size_t font_size);
     Font(const FreeTypeFontDesc& font_desc, size_t font_size);
 
+    static Font* load_system_font(SystemFont font, size_t size);
+
     Glyph load_glyph(size_t ch) const;
 
     size_t m_font_size { 0 };
     size_t m_const_width { 0 }; // If const width is 0, width id calculated dynamicly for each glyph.
 
     FontCacher* m_font_cache { nullptr };
+    GlyphAtlas m_atlas;
 
     FontType m_font_type;
-    union {
+    mutable union {
         SerenityOSFontDesc serenity;
         FreeTypeFontDesc free_type;
     } m_font_desc;
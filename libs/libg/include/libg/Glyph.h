@@ -24,9 +24,11 @@ struct GlyphMetrics {
 };
 
 class Font;
+class GlyphAtlas;
 class Glyph {
 public:
     friend class Font;
+    friend class GlyphAtlas;
     enum class ConstDataMarker : int {}; // Pointer to the data is valid while thid glyph is valid.
 
     enum Type {
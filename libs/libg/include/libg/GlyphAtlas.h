@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#pragma once
+
+#include <libg/Glyph.h>
+#include <sys/types.h>
+
+namespace LG {
+
+class Font;
+
+// Glyphs of one font size rasterized once and laid out in a flat buffer,
+// so the buffer can be shared between processes. It starts with a header,
+// followed by an entry for each codepoint of the range and by the alpha
+// rows of glyphs, which Context draws from directly.
+class GlyphAtlas {
+public:
+    static constexpr uint32_t Magic = 0x4c544147; // "GATL"
+    static constexpr uint32_t FirstCodepoint = 0x20;
+    static constexpr uint32_t LastCodepoint = 0xff;
+
+    GlyphAtlas() = default;
+    explicit GlyphAtlas(const uint8_t* data, size_t size);
+
+    inline bool valid() const { return m_data; }
+    inline bool has(size_t ch) const { return m_data && FirstCodepoint <= ch && ch <= LastCodepoint; }
+    // Returns an empty glyph if the entry of ch points outside of the atlas.
+    Glyph glyph(size_t ch) const;
+
+    // Writes the atlas of font to buffer if it fits size and returns the
+    // size the atlas needs, so it is called once with no buffer to size it.
+    static size_t build(const Font& font, uint8_t* buffer, size_t size);
+
+private:
+    struct [[gnu::packed]] Header {
+        uint32_t magic;
+        uint32_t font_size;
+        uint32_t first_codepoint;
+        uint32_t last_codepoint;
+        uint32_t size;
+    };
+
+    struct [[gnu::packed]] Entry {
+        GlyphMetrics metrics;
+        uint8_t type;
+        uint32_t offset;
+    };
+
+    // Glyph rows start right after the entries.
+    static constexpr size_t EntriesEnd = sizeof(Header) + (LastCodepoint - FirstCodepoint + 1) * sizeof(Entry);
+
+    const uint8_t* m_data { nullptr };
+    size_t m_size { 0 };
+};
+
+} // namespace LG
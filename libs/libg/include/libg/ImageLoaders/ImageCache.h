@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#pragma once
+
+#include <libg/PixelBitmap.h>
+#include <string>
+
+namespace LG {
+
+// Loads images which are decoded once and shared between processes. The
+// window server keeps decoded images in shared memory keyed on path and
+// modification time, libui asks it for them. Without a provider or if it
+// can't share an image, the image is decoded locally.
+class ImageCache {
+public:
+    // Returns an empty bitmap if the image can't be shared.
+    typedef PixelBitmap (*Provider)(const std::string& path);
+
+    static void set_provider(Provider provider);
+
+    // A shared bitmap points right into the cache, so it is read-only.
+    static PixelBitmap load(const std::string& path);
+};
+
+} // namespace LG
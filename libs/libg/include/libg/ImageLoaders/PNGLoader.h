@@ -9,6 +9,7 @@
 #pragma once
 
 #include <libfoundation/ByteOrder.h>
+#include <libfoundation/compress/Inflate.h>
 #include <libg/Color.h>
 #include <libg/PixelBitmap.h>
 #include <libg/Rect.h>
@@ -75,56 +76,6 @@ namespace PNG {
         uint8_t* m_ptr { nullptr };
     };
 
-    class Scanline {
-    public:
-        Scanline() = default;
-        Scanline(int type, void* ptr)
-            : m_filter_type(type)
-            , m_ptr(ptr)
-        {
-        }
-        ~Scanline() = default;
-
-        void set(int type, void* ptr) { m_ptr = ptr; }
-        int filter_type() const { return m_filter_type; }
-        uint8_t* data() const { return (uint8_t*)m_ptr; }
-
-    private:
-        int m_filter_type { 0 };
-        void* m_ptr { nullptr };
-        size_t m_len { 0 };
-    };
-
-    class ScanlineKeeper {
-    public:
-        ScanlineKeeper() = default;
-        ~ScanlineKeeper() { invalidate(); }
-
-        inline void init(void* ptr) { m_ptr = ptr; }
-        inline void init(void* ptr, uint8_t color_length) { m_ptr = ptr, m_color_length = color_length; }
-
-        void invalidate()
-        {
-            if (m_ptr) {
-                free(m_ptr);
-                m_data.clear();
-                m_ptr = nullptr;
-            }
-        }
-
-        inline void add(Scanline&& el) { m_data.push_back(std::move(el)); }
-        inline void set_color_length(uint8_t color_length) { m_color_length = color_length; }
-        inline uint8_t color_length() const { return m_color_length; }
-
-        inline std::vector<Scanline>& scanlines() { return m_data; }
-        inline const std::vector<Scanline>& scanlines() const { return m_data; }
-
-    private:
-        uint8_t m_color_length { 0 };
-        void* m_ptr { nullptr };
-        std::vector<Scanline> m_data;
-    };
-
     class PNGLoader {
     public:
         PNGLoader() = default;
@@ -139,7 +90,8 @@ namespace PNG {
         bool check_header(const uint8_t* ptr) const;
 
         void proccess_stream(PixelBitmap& bitmap);
-        void process_compressed_data(PixelBitmap& bitmap);
+        bool process_compressed_data(PixelBitmap& bitmap);
+        size_t channels_count() const;
         bool read_chunk(PixelBitmap& bitmap);
         void read_IHDR(ChunkHeader& header, PixelBitmap& bitmap);
         void read_TEXT(ChunkHeader& header, PixelBitmap& bitmap);
@@ -148,14 +100,13 @@ namespace PNG {
         void read_gAMA(ChunkHeader& header, PixelBitmap& bitmap);
         void read_IDAT(ChunkHeader& header, PixelBitmap& bitmap);
 
-        uint8_t paeth_predictor(int a, int b, int c);
-        void unfilter_scanlines();
-        void copy_scanlines_to_bitmap(PixelBitmap& bitmap);
+        bool unfilter_scanline(uint8_t filter, uint8_t* scanline, const uint8_t* prev, size_t len, size_t bpp);
+        void copy_scanline_to_bitmap(const uint8_t* scanline, Color* dest);
 
-        std::vector<uint8_t> m_compressed_data;
         DataStreamer m_streamer;
         IHDRChunk m_ihdr_chunk;
-        ScanlineKeeper m_scanline_keeper;
+        // Valid while a stream is processed, IDAT chunks are fed to it.
+        LFoundation::Inflate* m_inflate { nullptr };
     };
 
 } // namespace PNG
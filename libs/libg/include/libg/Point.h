@@ -11,6 +11,7 @@
 #include <libipc/Decodable.h>
 #include <libipc/Encodable.h>
 #include <libipc/Encoder.h>
+#include <libipc/Wire.h>
 #include <sys/types.h>
 
 namespace LG {
@@ -87,4 +88,23 @@ private:
     T m_y {};
 };
 
-} // namespace LG
\ No newline at end of file
+} // namespace LG
+
+namespace LIPC {
+
+template <typename T>
+struct Wire<LG::Point<T>> {
+    struct [[gnu::packed]] Slot {
+        T x;
+        T y;
+    };
+    using View = LG::Point<T>;
+
+    static inline size_t tail_size(const LG::Point<T>&) { return 0; }
+    static inline Slot encode(const LG::Point<T>& val, uint8_t*, size_t&) { return { val.x(), val.y() }; }
+    static inline bool validate(const uint8_t*, size_t, Slot) { return true; }
+    static inline View view(const uint8_t*, Slot slot) { return View(slot.x, slot.y); }
+    static inline LG::Point<T> materialize(View view) { return view; }
+};
+
+} // namespace LIPC
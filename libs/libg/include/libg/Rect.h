@@ -14,6 +14,7 @@
 #include <libipc/Decodable.h>
 #include <libipc/Encodable.h>
 #include <libipc/Encoder.h>
+#include <libipc/Wire.h>
 #include <ostream>
 #include <sys/types.h>
 #include <utility>
@@ -168,4 +169,25 @@ std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>&
     return os;
 }
 
-} // namespace LG
\ No newline at end of file
+} // namespace LG
+
+namespace LIPC {
+
+template <>
+struct Wire<LG::Rect> {
+    struct [[gnu::packed]] Slot {
+        int32_t x;
+        int32_t y;
+        uint32_t width;
+        uint32_t height;
+    };
+    using View = LG::Rect;
+
+    static inline size_t tail_size(const LG::Rect&) { return 0; }
+    static inline Slot encode(const LG::Rect& val, uint8_t*, size_t&) { return { val.min_x(), val.min_y(), (uint32_t)val.width(), (uint32_t)val.height() }; }
+    static inline bool validate(const uint8_t*, size_t, Slot) { return true; }
+    static inline View view(const uint8_t*, Slot slot) { return View(slot.x, slot.y, slot.width, slot.height); }
+    static inline LG::Rect materialize(View view) { return view; }
+};
+
+} // namespace LIPC
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#pragma once
+#include <libg/Rect.h>
+#include <sys/types.h>
+#include <vector>
+
+namespace LG {
+
+// Set of pixels kept as y-x banded rectangles: boxes are sorted by y and
+// then by x, boxes of one band share their top and bottom and never touch,
+// neighbouring bands with the same spans are merged. This keeps the
+// representation canonical, so regions stay small while being combined.
+class Region {
+public:
+    // Half-open box: [x1, x2) x [y1, y2).
+    struct Box {
+        int x1;
+        int y1;
+        int x2;
+        int y2;
+    };
+
+    Region() = default;
+    Region(const Rect& rect);
+
+    inline bool empty() const { return m_boxes.empty(); }
+    inline size_t rect_count() const { return m_boxes.size(); }
+    inline void clear() { m_boxes.clear(); }
+    Rect bounds() const;
+    size_t square() const;
+
+    bool intersects(const Rect& rect) const;
+    bool contains(const Rect& rect) const;
+
+    void unite(const Region& other);
+    void intersect(const Region& other);
+    void subtract(const Region& other);
+
+    void unite(const Rect& rect);
+    void intersect(const Rect& rect);
+    void subtract(const Rect& rect);
+
+    template <typename Callback>
+    void for_each_rect(Callback callback) const
+    {
+        for (size_t i = 0; i < m_boxes.size(); i++) {
+            const Box& box = m_boxes[i];
+            callback(Rect(box.x1, box.y1, box.x2 - box.x1, box.y2 - box.y1));
+        }
+    }
+
+    // Tells if a pixel belongs to the result by its presence in the operands.
+    typedef bool (*Operation)(bool in_a, bool in_b);
+
+private:
+    void apply(const Region& other, Operation op);
+
+    std::vector<Box> m_boxes;
+};
+
+} // namespace LG
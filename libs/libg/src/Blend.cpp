@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <cstring>
+#include <libfoundation/Memory.h>
+#include <libg/Blend.h>
+
+namespace LG {
+
+static void scalar_copy(Color* dest, const Color* src, size_t count)
+{
+    LFoundation::fast_copy((uint32_t*)dest, (const uint32_t*)src, count);
+}
+
+static void scalar_fill(Color* dest, Color color, size_t count)
+{
+    LFoundation::fast_set((uint32_t*)dest, color.u32(), count);
+}
+
+static void scalar_blend(Color* dest, const Color* src, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        dest[i].blend_with(src[i]);
+    }
+}
+
+static void scalar_blend_color(Color* dest, Color color, size_t count)
+{
+    if (color.is_opaque()) {
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        dest[i].blend_with(color);
+    }
+}
+
+static void scalar_blend_mask(Color* dest, Color color, const uint8_t* mask, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        dest[i].blend_with(color.scaled(mask[i]));
+    }
+}
+
+static const BlendBackend s_scalar_backend = {
+    .name = "scalar",
+    .copy = scalar_copy,
+    .fill = scalar_fill,
+    .blend = scalar_blend,
+    .blend_color = scalar_blend_color,
+    .blend_mask = scalar_blend_mask,
+};
+
+// Vector kernels are written with GCC vector extensions, so the same code
+// maps to SSE2 and NEON. Plain x86 builds don't assume SSE2, the kernels
+// are built for it anyway and used only if the CPU has it.
+#if defined(__SSE2__) || defined(__ARM_NEON)
+#define BLEND_USE_VECTORS
+#define BLEND_VECTOR_TARGET
+#elif defined(__i386__)
+#define BLEND_USE_VECTORS
+#define BLEND_VECTOR_TARGET __attribute__((target("sse2")))
+#endif
+
+#ifdef BLEND_USE_VECTORS
+#define BLEND_VECTOR_INLINE BLEND_VECTOR_TARGET __attribute__((always_inline)) static inline
+
+typedef uint32_t u32x4 __attribute__((vector_size(16)));
+typedef uint32_t uu32x4 __attribute__((vector_size(16), __may_alias__, aligned(4)));
+typedef uint64_t u64x2 __attribute__((vector_size(16)));
+typedef uint8_t u8x16 __attribute__((vector_size(16)));
+typedef uint16_t u16x16 __attribute__((vector_size(32)));
+
+BLEND_VECTOR_INLINE bool vec_any(u32x4 v)
+{
+    u64x2 w = (u64x2)v;
+    return (w[0] | w[1]) != 0;
+}
+
+BLEND_VECTOR_INLINE u32x4 vec_load(const Color* ptr) { return *(const uu32x4*)ptr; }
+BLEND_VECTOR_INLINE void vec_store(Color* ptr, u32x4 v) { *(uu32x4*)ptr = v; }
+
+BLEND_VECTOR_INLINE u32x4 broadcast_bytes(u32x4 v)
+{
+    return v | (v << 8) | (v << 16) | (v << 24);
+}
+
+BLEND_VECTOR_INLINE u16x16 div255(u16x16 x)
+{
+    return (x + 1 + (x >> 8)) >> 8;
+}
+
+// Source-over of 4 premultiplied pixels, sop holds the opacity of every
+// source pixel: every byte of dest, opacity included, is multiplied by it,
+// then the color of the source is added.
+BLEND_VECTOR_INLINE u32x4 blend4(u32x4 dest, u32x4 src, u32x4 sop)
+{
+    u16x16 d16 = __builtin_convertvector((u8x16)dest, u16x16);
+    u16x16 o16 = __builtin_convertvector((u8x16)broadcast_bytes(sop), u16x16);
+    u32x4 res = (u32x4)__builtin_convertvector(div255(d16 * o16), u8x16);
+    return res + (src & 0x00ffffffu);
+}
+
+BLEND_VECTOR_TARGET static void vector_copy(Color* dest, const Color* src, size_t count)
+{
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        u32x4 a = vec_load(src + i);
+        u32x4 b = vec_load(src + i + 4);
+        u32x4 c = vec_load(src + i + 8);
+        u32x4 d = vec_load(src + i + 12);
+        vec_store(dest + i, a);
+        vec_store(dest + i + 4, b);
+        vec_store(dest + i + 8, c);
+        vec_store(dest + i + 12, d);
+    }
+    for (; i + 4 <= count; i += 4) {
+        vec_store(dest + i, vec_load(src + i));
+    }
+    for (; i < count; i++) {
+        dest[i] = src[i];
+    }
+}
+
+BLEND_VECTOR_TARGET static void vector_fill(Color* dest, Color color, size_t count)
+{
+    uint32_t c = color.u32();
+    u32x4 v = { c, c, c, c };
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        vec_store(dest + i, v);
+        vec_store(dest + i + 4, v);
+        vec_store(dest + i + 8, v);
+        vec_store(dest + i + 12, v);
+    }
+    for (; i + 4 <= count; i += 4) {
+        vec_store(dest + i, v);
+    }
+    for (; i < count; i++) {
+        dest[i] = color;
+    }
+}
+
+BLEND_VECTOR_TARGET static void vector_blend(Color* dest, const Color* src, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        u32x4 s = vec_load(src + i);
+        u32x4 sop = s >> 24;
+        if (!vec_any(sop)) {
+            vec_store(dest + i, s);
+        } else if (vec_any((u32x4)(sop != 255))) {
+            vec_store(dest + i, blend4(vec_load(dest + i), s, sop));
+        }
+    }
+    for (; i < count; i++) {
+        dest[i].blend_with(src[i]);
+    }
+}
+
+BLEND_VECTOR_TARGET static void vector_blend_color(Color* dest, Color color, size_t count)
+{
+    if (color.alpha() == 255) {
+        vector_fill(dest, color, count);
+        return;
+    }
+    if (color.is_opaque()) {
+        return;
+    }
+
+    uint32_t c = color.u32();
+    u32x4 s = { c, c, c, c };
+    u32x4 sop = s >> 24;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vec_store(dest + i, blend4(vec_load(dest + i), s, sop));
+    }
+    for (; i < count; i++) {
+        dest[i].blend_with(color);
+    }
+}
+
+BLEND_VECTOR_TARGET static void vector_blend_mask(Color* dest, Color color, const uint8_t* mask, size_t count)
+{
+    // The color is scaled with alpha in place of opacity, as Color::scaled does.
+    uint32_t c = (color.u32() & 0x00ffffff) | ((uint32_t)color.alpha() << 24);
+    u32x4 cv = { c, c, c, c };
+    u16x16 c16 = __builtin_convertvector((u8x16)cv, u16x16);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint32_t m;
+        memcpy(&m, mask + i, sizeof(m));
+        if (!m) {
+            continue;
+        }
+
+        u32x4 cov = { m & 0xff, (m >> 8) & 0xff, (m >> 16) & 0xff, m >> 24 };
+        u16x16 cov16 = __builtin_convertvector((u8x16)broadcast_bytes(cov), u16x16);
+        u32x4 s = (u32x4)__builtin_convertvector(div255(c16 * cov16 + 128), u8x16);
+        u32x4 sop = 255 - (s >> 24);
+        if (vec_any((u32x4)(sop != 255))) {
+            vec_store(dest + i, blend4(vec_load(dest + i), s, sop));
+        }
+    }
+    for (; i < count; i++) {
+        dest[i].blend_with(color.scaled(mask[i]));
+    }
+}
+
+static const BlendBackend s_vector_backend = {
+#if defined(__arm__) || defined(__aarch64__)
+    .name = "neon",
+#else
+    .name = "sse2",
+#endif
+    .copy = vector_copy,
+    .fill = vector_fill,
+    .blend = vector_blend,
+    .blend_color = vector_blend_color,
+    .blend_mask = vector_blend_mask,
+};
+#endif // BLEND_USE_VECTORS
+
+static bool cpu_has_vectors()
+{
+#if defined(__SSE2__) || defined(__ARM_NEON)
+    return true;
+#elif defined(__i386__)
+    uint32_t eax = 1, ebx, ecx, edx;
+    asm volatile("cpuid"
+                 : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+    return edx & (1 << 26);
+#else
+    return false;
+#endif
+}
+
+const BlendBackend& scalar_blend_backend()
+{
+    return s_scalar_backend;
+}
+
+const BlendBackend& blend_backend()
+{
+    static const BlendBackend* backend = nullptr;
+    if (!backend) {
+        backend = &s_scalar_backend;
+#ifdef BLEND_USE_VECTORS
+        if (cpu_has_vectors()) {
+            backend = &s_vector_backend;
+        }
+#endif
+    }
+    return *backend;
+}
+
+} // namespace LG
@@ -8,7 +8,7 @@
 
 #include <algorithm>
 #include <libfoundation/Math.h>
-#include <libfoundation/Memory.h>
+#include <libg/Blend.h>
 #include <libg/Context.h>
 
 namespace LG {
@@ -50,8 +50,9 @@ void Context::set(const Point<int>& start, const PixelBitmap& bitmap)
     int bitmap_x = min_x + offset_x;
     int bitmap_y = min_y + offset_y;
     int len_x = max_x - min_x + 1;
+    const auto& backend = blend_backend();
     for (int y = min_y; y <= max_y; y++, bitmap_y++) {
-        LFoundation::fast_copy((uint32_t*)&m_bitmap[y][min_x], (uint32_t*)&bitmap[bitmap_y][bitmap_x], len_x);
+        backend.copy(&m_bitmap[y][min_x], &bitmap[bitmap_y][bitmap_x], len_x);
     }
 }
 
@@ -73,8 +74,9 @@ void Context::set_with_bounds(const Rect& rect, const PixelBitmap& bitmap)
     int bitmap_x = min_x + offset_x + m_bitmap_offset.x();
     int bitmap_y = min_y + offset_y + m_bitmap_offset.y();
     int len_x = max_x - min_x + 1;
+    const auto& backend = blend_backend();
     for (int y = min_y; y <= max_y; y++, bitmap_y++) {
-        LFoundation::fast_copy((uint32_t*)&m_bitmap[y][min_x], (uint32_t*)&bitmap[bitmap_y][bitmap_x], len_x);
+        backend.copy(&m_bitmap[y][min_x], &bitmap[bitmap_y][bitmap_x], len_x);
     }
 }
 
@@ -97,12 +99,12 @@ void Context::draw(const Point<int>& start, const PixelBitmap& bitmap)
     int max_y = draw_bounds.max_y();
     int offset_x = -start.x() - m_draw_offset.x() + m_bitmap_offset.x();
     int offset_y = -start.y() - m_draw_offset.y() + m_bitmap_offset.y();
+    int bitmap_x = min_x + offset_x;
     int bitmap_y = min_y + offset_y;
+    int len_x = max_x - min_x + 1;
+    const auto& backend = blend_backend();
     for (int y = min_y; y <= max_y; y++, bitmap_y++) {
-        int bitmap_x = min_x + offset_x;
-        for (int x = min_x; x <= max_x; x++, bitmap_x++) {
-            m_bitmap[y][x].mix_with(bitmap[bitmap_y][bitmap_x]);
-        }
+        backend.blend(&m_bitmap[y][min_x], &bitmap[bitmap_y][bitmap_x], len_x);
     }
 }
 
@@ -126,12 +128,12 @@ void Context::draw_with_bounds(const Rect& rect, const PixelBitmap& bitmap)
     int max_y = draw_bounds.max_y();
     int offset_x = -rect.min_x() - m_draw_offset.x() + m_bitmap_offset.x();
     int offset_y = -rect.min_y() - m_draw_offset.y() + m_bitmap_offset.y();
+    int bitmap_x = min_x + offset_x;
     int bitmap_y = min_y + offset_y;
+    int len_x = max_x - min_x + 1;
+    const auto& backend = blend_backend();
     for (int y = min_y; y <= max_y; y++, bitmap_y++) {
-        int bitmap_x = min_x + offset_x;
-        for (int x = min_x; x <= max_x; x++, bitmap_x++) {
-            m_bitmap[y][x].mix_with(bitmap[bitmap_y][bitmap_x]);
-        }
+        backend.blend(&m_bitmap[y][min_x], &bitmap[bitmap_y][bitmap_x], len_x);
     }
 }
 
@@ -147,7 +149,7 @@ void Context::draw(const Point<int>& start, const Glyph& bitmap)
         return;
     }
 
-    auto color = fill_color();
+    auto color = fill_color().premultiplied();
     int min_x = draw_bounds.min_x();
     int min_y = draw_bounds.min_y();
     int max_x = draw_bounds.max_x();
@@ -167,15 +169,15 @@ void Context::draw(const Point<int>& start, const Glyph& bitmap)
             }
         }
         return;
-    case Glyph::Type::FreeType:
+    case Glyph::Type::FreeType: {
+        int bitmap_x = min_x + offset_x;
+        int len_x = max_x - min_x + 1;
+        const auto& backend = blend_backend();
         for (int y = min_y; y <= max_y; y++, bitmap_y++) {
-            int bitmap_x = min_x + offset_x;
-            for (int x = min_x; x <= max_x; x++, bitmap_x++) {
-                color.set_alpha((fill_color().alpha() * bitmap.alpha_at(bitmap_x, bitmap_y)) / 255);
-                m_bitmap[y][x].mix_with(color);
-            }
+            backend.blend_mask(&m_bitmap[y][min_x], color, &bitmap.data<uint8_t>()[bitmap_y * bitmap.width() + bitmap_x], len_x);
         }
         return;
+    }
     default:
         break;
     }
@@ -273,11 +275,10 @@ void Context::mix(const Rect& rect)
     int min_y = draw_bounds.min_y();
     int max_x = draw_bounds.max_x();
     int max_y = draw_bounds.max_y();
-    const auto& color = fill_color();
+    int len_x = max_x - min_x + 1;
+    const auto& backend = blend_backend();
     for (int y = min_y; y <= max_y; y++) {
-        for (int x = min_x; x <= max_x; x++) {
-            m_bitmap[y][x].mix_with(color);
-        }
+        backend.blend_color(&m_bitmap[y][min_x], fill_color().premultiplied(), len_x);
     }
 }
 
@@ -300,14 +301,14 @@ void Context::fill(const Rect& rect)
         return;
     }
 
-    auto color = fill_color().u32();
     int min_x = draw_bounds.min_x();
     int min_y = draw_bounds.min_y();
     int max_x = draw_bounds.max_x();
     int max_y = draw_bounds.max_y();
     int len_x = max_x - min_x + 1;
+    const auto& backend = blend_backend();
     for (int y = min_y; y <= max_y; y++) {
-        LFoundation::fast_set((uint32_t*)&m_bitmap[y][min_x], color, len_x);
+        backend.fill(&m_bitmap[y][min_x], fill_color(), len_x);
     }
 }
 
@@ -341,14 +342,11 @@ void Context::draw_rounded_helper(const Point<int>& start, size_t radius, const
             size_t y2 = (y - center.y()) * (y - center.y());
             size_t dist = x2 + y2;
             if (dist <= radius2) {
-                m_bitmap[y][x].mix_with(bitmap[bitmap_y][bitmap_x]);
+                m_bitmap[y][x].blend_with(bitmap[bitmap_y][bitmap_x]);
             } else {
-                auto color = bitmap[bitmap_y][bitmap_x];
                 float fdist = 0.6 - 0.4 * (LFoundation::fast_sqrt((float)(dist)) - radius);
                 fdist = std::max(std::min(fdist, 1.0f), 0.0f);
-                int alpha = int(color.alpha() * fdist);
-                color.set_alpha(alpha);
-                m_bitmap[y][x].mix_with(color);
+                m_bitmap[y][x].blend_with(bitmap[bitmap_y][bitmap_x].scaled(int(255 * fdist)));
             }
         }
     }
@@ -381,13 +379,13 @@ void Context::fill_rounded_helper(const Point<int>& start, size_t radius)
             size_t y2 = (y - center.y()) * (y - center.y());
             size_t dist = x2 + y2;
             if (dist <= radius2) {
-                m_bitmap[y][x].mix_with(fill_color());
+                m_bitmap[y][x].blend_with(fill_color().premultiplied());
             } else {
                 float fdist = 0.6 - 0.4 * (LFoundation::fast_sqrt((float)(dist)) - radius);
                 fdist = std::max(std::min(fdist, 1.0f), 0.0f);
                 int alpha = int(fill_color().alpha() * fdist);
                 color.set_alpha(alpha);
-                m_bitmap[y][x].mix_with(color);
+                m_bitmap[y][x].blend_with(color.premultiplied());
             }
         }
     }
@@ -430,7 +428,7 @@ void Context::shadow_rounded_helper(const Point<int>& start, size_t radius, cons
                     fdist = std::max(fdist, 0.0f);
                     int alpha = std_alpha * fdist;
                     color.set_alpha(alpha);
-                    m_bitmap[y][x].mix_with(color);
+                    m_bitmap[y][x].blend_with(color.premultiplied());
                 }
             }
         }
@@ -533,9 +531,7 @@ void Context::draw_shading(const Rect& rect, const Shading& shading)
         color.set_alpha(color.alpha() - skipped_steps * step);
 
         for (int y = min_y; y <= max_y; y++) {
-            for (int x = min_x; x <= max_x; x++) {
-                m_bitmap[y][x].mix_with(color);
-            }
+            blend_backend().blend_color(&m_bitmap[y][min_x], color.premultiplied(), max_x - min_x + 1);
             color.set_alpha(color.alpha() - step);
         }
         return;
@@ -546,9 +542,7 @@ void Context::draw_shading(const Rect& rect, const Shading& shading)
         color.set_alpha(color.alpha() - skipped_steps * step);
 
         for (int y = max_y; y >= min_y; y--) {
-            for (int x = min_x; x <= max_x; x++) {
-                m_bitmap[y][x].mix_with(color);
-            }
+            blend_backend().blend_color(&m_bitmap[y][min_x], color.premultiplied(), max_x - min_x + 1);
             color.set_alpha(color.alpha() - step);
         }
         return;
@@ -560,7 +554,7 @@ void Context::draw_shading(const Rect& rect, const Shading& shading)
 
         for (int x = min_x; x <= max_x; x++) {
             for (int y = min_y; y <= max_y; y++) {
-                m_bitmap[y][x].mix_with(color);
+                m_bitmap[y][x].blend_with(color.premultiplied());
             }
             color.set_alpha(color.alpha() - step);
         }
@@ -573,7 +567,7 @@ void Context::draw_shading(const Rect& rect, const Shading& shading)
 
         for (int x = max_x; x >= min_x; x--) {
             for (int y = min_y; y <= max_y; y++) {
-                m_bitmap[y][x].mix_with(color);
+                m_bitmap[y][x].blend_with(color.premultiplied());
             }
             color.set_alpha(color.alpha() - step);
         }
@@ -592,7 +586,7 @@ void Context::draw_shading(const Rect& rect, const Shading& shading)
         for (int y = max_y; y >= min_y; y--) {
             auto cur_color = color;
             for (int x = min_x; x <= end_x; x++) {
-                m_bitmap[y][x].mix_with(cur_color);
+                m_bitmap[y][x].blend_with(cur_color.premultiplied());
                 cur_color.set_alpha(cur_color.alpha() - step);
             }
             end_x--;
@@ -617,7 +611,7 @@ void Context::draw_shading(const Rect& rect, const Shading& shading)
         for (int y = min_y; y <= max_y; y++) {
             auto cur_color = color;
             for (int x = min_x; x <= end_x; x++) {
-                m_bitmap[y][x].mix_with(cur_color);
+                m_bitmap[y][x].blend_with(cur_color.premultiplied());
                 cur_color.set_alpha(cur_color.alpha() - step);
             }
             end_x--;
@@ -642,7 +636,7 @@ void Context::draw_shading(const Rect& rect, const Shading& shading)
         for (int y = max_y; y >= min_y; y--) {
             auto cur_color = color;
             for (int x = max_x; x >= end_x; x--) {
-                m_bitmap[y][x].mix_with(cur_color);
+                m_bitmap[y][x].blend_with(cur_color.premultiplied());
                 cur_color.set_alpha(cur_color.alpha() - step);
             }
             end_x++;
@@ -667,7 +661,7 @@ void Context::draw_shading(const Rect& rect, const Shading& shading)
         for (int y = min_y; y <= max_y; y++) {
             auto cur_color = color;
             for (int x = max_x; x >= end_x; x--) {
-                m_bitmap[y][x].mix_with(cur_color);
+                m_bitmap[y][x].blend_with(cur_color.premultiplied());
                 cur_color.set_alpha(cur_color.alpha() - step);
             }
             end_x++;
@@ -775,10 +769,10 @@ void Context::add_ellipse(const Rect& rect)
     dy = 2 * rx * rx * y;
 
     while (dx < dy) {
-        m_bitmap[y + yc][(int)x + xc] = fill_color();
-        m_bitmap[y + yc][(int)-x + xc] = fill_color();
-        m_bitmap[-y + yc][(int)x + xc] = fill_color();
-        m_bitmap[-y + yc][(int)-x + xc] = fill_color();
+        m_bitmap[y + yc][(int)x + xc] = fill_color().premultiplied();
+        m_bitmap[y + yc][(int)-x + xc] = fill_color().premultiplied();
+        m_bitmap[-y + yc][(int)x + xc] = fill_color().premultiplied();
+        m_bitmap[-y + yc][(int)-x + xc] = fill_color().premultiplied();
 
         x++;
         dx += 2 * ry * ry;
@@ -794,10 +788,10 @@ void Context::add_ellipse(const Rect& rect)
     d2 = ((ry * ry) * ((x + 0.5) * (x + 0.5))) + ((rx * rx) * ((y - 1) * (y - 1))) - (rx * rx * ry * ry);
 
     while (y >= 0) {
-        m_bitmap[y + yc][(int)x + xc] = fill_color();
-        m_bitmap[y + yc][(int)-x + xc] = fill_color();
-        m_bitmap[-y + yc][(int)x + xc] = fill_color();
-        m_bitmap[-y + yc][(int)-x + xc] = fill_color();
+        m_bitmap[y + yc][(int)x + xc] = fill_color().premultiplied();
+        m_bitmap[y + yc][(int)-x + xc] = fill_color().premultiplied();
+        m_bitmap[-y + yc][(int)x + xc] = fill_color().premultiplied();
+        m_bitmap[-y + yc][(int)-x + xc] = fill_color().premultiplied();
 
         y--;
         dy -= 2 * rx * rx;
@@ -35,11 +35,32 @@ struct [[gnu::packed]] FontFileHeader {
     char family[32];
 };
 
+static Font::AtlasProvider s_atlas_provider = nullptr;
+
+FontCacher::~FontCacher()
+{
+    for (size_t i = 0; i < m_pages.size(); i++) {
+        delete[] m_pages[i];
+    }
+}
+
+void FontCacher::cache(size_t ch, Glyph&& gl)
+{
+    size_t page = ch >> 8;
+    while (m_pages.size() <= page) {
+        m_pages.push_back(nullptr);
+    }
+    if (!m_pages[page]) {
+        m_pages[page] = new Glyph[256];
+    }
+    m_pages[page][ch & 0xff] = std::move(gl);
+}
+
 Font& Font::system_font(int size)
 {
     static Font* s_system_font_ptr[SystemMaxSize + 1];
     if (!s_system_font_ptr[size]) {
-        s_system_font_ptr[size] = Font::load_from_file_ttf("/res/fonts/system.font/truetype/regular.ttf", size);
+        s_system_font_ptr[size] = Font::load_system_font(SystemFont::Regular, size);
     }
     return *s_system_font_ptr[size];
 }
@@ -48,11 +69,56 @@ Font& Font::system_bold_font(int size)
 {
     static Font* s_system_font_ptr[SystemMaxSize + 1];
     if (!s_system_font_ptr[size]) {
-        s_system_font_ptr[size] = Font::load_from_file_ttf("/res/fonts/system.font/truetype/bold.ttf", size);
+        s_system_font_ptr[size] = Font::load_system_font(SystemFont::Bold, size);
     }
     return *s_system_font_ptr[size];
 }
 
+const char* Font::system_font_path(SystemFont font)
+{
+    switch (font) {
+    case SystemFont::Regular:
+        return "/res/fonts/system.font/truetype/regular.ttf";
+    case SystemFont::Bold:
+        return "/res/fonts/system.font/truetype/bold.ttf";
+    default:
+        std::abort();
+    }
+}
+
+void Font::set_atlas_provider(AtlasProvider provider)
+{
+    s_atlas_provider = provider;
+}
+
+Font* Font::load_system_font(SystemFont font, size_t size)
+{
+    if (s_atlas_provider) {
+        GlyphAtlas atlas = s_atlas_provider(font, size);
+        if (atlas.valid()) {
+            // FreeType is set up only once a glyph outside of the atlas is needed.
+            FreeTypeFontDesc desc = {
+                .face = nullptr,
+                .path = system_font_path(font),
+                .height = size,
+            };
+            auto* res = new Font(desc, size);
+            res->m_atlas = atlas;
+            return res;
+        }
+    }
+    return Font::load_from_file_ttf(system_font_path(font), size);
+}
+
+static FT_Library freetype_library()
+{
+    static FT_Library library = nullptr;
+    if (!library && FT_Init_FreeType(&library)) {
+        library = nullptr;
+    }
+    return library;
+}
+
 Font::Font(const SerenityOSFontDesc& desc, size_t font_size)
     : m_font_type(FontType::SerenityOS)
     , m_font_size(font_size)
@@ -72,6 +138,14 @@ Font::Font(const FreeTypeFontDesc& desc, size_t font_size)
     m_font_cache = new FontCacher();
 }
 
+Font::~Font()
+{
+    if (m_font_type == FontType::FreeType && m_font_desc.free_type.face) {
+        FT_Done_Face(m_font_desc.free_type.face);
+    }
+    delete m_font_cache;
+}
+
 Font* Font::load_from_file(const char* path)
 {
     int fd = open(path, O_RDONLY);
@@ -129,28 +203,14 @@ Font* Font::load_from_mem(uint8_t* font_data)
 
 Font* Font::load_from_file_ttf(const char* path, size_t size)
 {
-    FT_Library library;
-    FT_Face face;
-
-    int error = FT_Init_FreeType(&library);
-    if (error) {
-        return nullptr;
-    }
-
-    error = FT_New_Face(library, path, 0, &face);
-    if (error) {
-        return nullptr;
-    }
-
-    error = FT_Set_Pixel_Sizes(face, 0, size);
-    if (error) {
-        return nullptr;
-    }
-
     FreeTypeFontDesc desc = {
-        .face = face,
+        .face = nullptr,
+        .path = path,
         .height = size,
     };
+    if (!desc.load_face()) {
+        return nullptr;
+    }
     return new Font(desc, size);
 }
 
@@ -175,7 +235,29 @@ Glyph Font::SerenityOSFontDesc::load_glyph(size_t ch) const
     return Glyph(&raw_data[ch * height], metrics, Glyph::ConstDataMarker {});
 }
 
-Glyph Font::FreeTypeFontDesc::load_glyph(size_t ch) const
+bool Font::FreeTypeFontDesc::load_face()
+{
+    FT_Library library = freetype_library();
+    if (!library) {
+        return false;
+    }
+
+    int error = FT_New_Face(library, path, 0, &face);
+    if (error) {
+        face = nullptr;
+        return false;
+    }
+
+    error = FT_Set_Pixel_Sizes(face, 0, height);
+    if (error) {
+        FT_Done_Face(face);
+        face = nullptr;
+        return false;
+    }
+    return true;
+}
+
+Glyph Font::FreeTypeFontDesc::load_glyph(size_t ch)
 {
     if (ch == ' ') {
         size_t width = height / 2;
@@ -191,6 +273,10 @@ Glyph Font::FreeTypeFontDesc::load_glyph(size_t ch) const
         return Glyph(nullptr, metrics, Glyph::ConstDataMarker {});
     }
 
+    if (!face && !load_face()) {
+        return Glyph();
+    }
+
     FT_Load_Char(face, ch, FT_LOAD_RENDER);
     FT_GlyphSlot glyph = face->glyph;
     FT_Bitmap bitmap = glyph->bitmap;
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <cstring>
+#include <libg/Font.h>
+#include <libg/GlyphAtlas.h>
+
+namespace LG {
+
+static constexpr size_t GlyphCount = GlyphAtlas::LastCodepoint - GlyphAtlas::FirstCodepoint + 1;
+
+GlyphAtlas::GlyphAtlas(const uint8_t* data, size_t size)
+{
+    if (!data || size < EntriesEnd) {
+        return;
+    }
+
+    Header header;
+    memcpy(&header, data, sizeof(Header));
+    if (header.magic != Magic || header.first_codepoint != FirstCodepoint || header.last_codepoint != LastCodepoint || header.size > size) {
+        return;
+    }
+    m_data = data;
+    m_size = header.size;
+}
+
+Glyph GlyphAtlas::glyph(size_t ch) const
+{
+    Entry entry;
+    memcpy(&entry, m_data + sizeof(Header) + (ch - FirstCodepoint) * sizeof(Entry), sizeof(Entry));
+
+    // Any process can write to a shared atlas, so an entry is trusted only if
+    // its rows lie within the atlas. Others are returned empty.
+    size_t data_size = (size_t)entry.metrics.width * (size_t)entry.metrics.height;
+    Glyph res;
+    if (entry.type == Glyph::Type::FreeType) {
+        if (entry.offset < EntriesEnd || entry.offset > m_size || data_size > m_size - entry.offset) {
+            return res;
+        }
+        res.m_data = (void*)(m_data + entry.offset);
+    } else if (entry.type != Glyph::Type::PlainBitmap || data_size) {
+        return res;
+    }
+
+    res.m_metrics = entry.metrics;
+    res.m_type = (Glyph::Type)entry.type;
+    return res;
+}
+
+size_t GlyphAtlas::build(const Font& font, uint8_t* buffer, size_t size)
+{
+    size_t offset = sizeof(Header) + GlyphCount * sizeof(Entry);
+    for (size_t ch = FirstCodepoint; ch <= LastCodepoint; ch++) {
+        const Glyph& glyph = font.glyph(ch);
+
+        Entry entry = {
+            .metrics = glyph.m_metrics,
+            .type = (uint8_t)glyph.type(),
+            .offset = 0,
+        };
+
+        // Only FreeType glyphs have rasterized data, which is owned by the font.
+        size_t data_size = 0;
+        if (glyph.type() == Glyph::Type::FreeType && glyph.data<uint8_t>()) {
+            entry.offset = offset;
+            data_size = glyph.width() * glyph.height();
+        } else {
+            entry.type = Glyph::Type::PlainBitmap;
+        }
+
+        if (buffer && offset + data_size <= size) {
+            memcpy(buffer + sizeof(Header) + (ch - FirstCodepoint) * sizeof(Entry), &entry, sizeof(Entry));
+            if (data_size) {
+                memcpy(buffer + offset, glyph.data<uint8_t>(), data_size);
+            }
+        }
+        offset += data_size;
+    }
+
+    if (buffer && offset <= size) {
+        Header header = {
+            .magic = Magic,
+            .font_size = (uint32_t)font.size(),
+            .first_codepoint = FirstCodepoint,
+            .last_codepoint = LastCodepoint,
+            .size = (uint32_t)offset,
+        };
+        memcpy(buffer, &header, sizeof(Header));
+    }
+    return offset;
+}
+
+} // namespace LG
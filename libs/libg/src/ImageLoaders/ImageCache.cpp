@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <libg/ImageLoaders/ImageCache.h>
+#include <libg/ImageLoaders/PNGLoader.h>
+
+namespace LG {
+
+static ImageCache::Provider s_image_provider = nullptr;
+
+void ImageCache::set_provider(Provider provider)
+{
+    s_image_provider = provider;
+}
+
+PixelBitmap ImageCache::load(const std::string& path)
+{
+    if (s_image_provider) {
+        PixelBitmap bitmap = s_image_provider(path);
+        if (bitmap.width() && bitmap.height()) {
+            return bitmap;
+        }
+    }
+
+    PNG::PNGLoader loader;
+    return loader.load_from_file(path);
+}
+
+} // namespace LG
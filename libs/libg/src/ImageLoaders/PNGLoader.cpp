@@ -9,12 +9,12 @@
 #include <cstring>
 #include <fcntl.h>
 #include <libfoundation/Logger.h>
-#include <libfoundation/compress/puff.h>
+#include <libfoundation/compress/Inflate.h>
 #include <libg/ImageLoaders/PNGLoader.h>
-#include <memory>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <vector>
 
 // #define PNGLOADER_DEGUG
 
@@ -88,64 +88,68 @@ namespace PNG {
     // TODO: Currently support only comprssion type 0
     void PNGLoader::read_IDAT(ChunkHeader& header, PixelBitmap& bitmap)
     {
-        size_t buf_size = m_compressed_data.size();
-        m_compressed_data.resize(buf_size + header.len);
-        memcpy(&m_compressed_data.data()[buf_size], streamer().ptr(), header.len);
+        // Chunks are decompressed in place after all of them are read.
+        m_inflate->add_input(streamer().ptr(), header.len);
         streamer().skip(header.len);
     }
 
-    void PNGLoader::process_compressed_data(PixelBitmap& bitmap)
+    size_t PNGLoader::channels_count() const
     {
-        size_t datalen = m_compressed_data.size();
-        size_t destlen = 0;
-        int ret = puff(0, &destlen, m_compressed_data.data() + 2, &datalen);
-        uint8_t* unzipped_data = (uint8_t*)malloc(destlen);
-        puff(unzipped_data, &destlen, m_compressed_data.data() + 2, &datalen);
-        DataStreamer local_streamer(unzipped_data);
-        m_scanline_keeper.init(unzipped_data);
+        switch (m_ihdr_chunk.color_type) {
+        case 0: // Grayscale
+        case 3: // Indexed
+            return 1;
+        case 2: // RGB
+            return 3;
+        case 4: // Grayscale with alpha
+            return 2;
+        case 6: // RGBA
+            return 4;
+        default:
+            return 0;
+        }
+    }
 
-        if (m_ihdr_chunk.color_type == 2) {
-            m_scanline_keeper.set_color_length(3);
-            if (m_ihdr_chunk.depth == 8) {
-                for (int i = 0; i < m_ihdr_chunk.height; i++) {
-                    uint8_t scanline_filter;
-                    local_streamer.read(scanline_filter);
-
-                    if (scanline_filter > 4) {
-                        Logger::debug << "Invalid PNG filter: " << scanline_filter << std::endl;
-                        continue;
-                    }
-
-                    size_t len_of_scanline = (m_scanline_keeper.color_length() * m_ihdr_chunk.width * m_ihdr_chunk.depth + 7) / 8;
-                    m_scanline_keeper.add(Scanline(scanline_filter, local_streamer.ptr()));
-                    local_streamer.skip(len_of_scanline);
-                }
+    bool PNGLoader::process_compressed_data(PixelBitmap& bitmap)
+    {
+        if (m_ihdr_chunk.depth != 8 || (m_ihdr_chunk.color_type != 2 && m_ihdr_chunk.color_type != 6) || m_ihdr_chunk.interlace_method) {
+            Logger::debug << "PNGLoader: unsupported format" << std::endl;
+            return false;
+        }
+        bitmap.set_format(m_ihdr_chunk.color_type == 6 ? PixelBitmapFormat::RGBA : PixelBitmapFormat::RGB);
+
+        // Scanlines are inflated, unfiltered and converted one by one, only
+        // the previous one is kept as filters refer to it. Each of them is
+        // prefixed with a filter byte.
+        size_t bpp = channels_count();
+        size_t len = bpp * m_ihdr_chunk.width;
+        std::vector<uint8_t> buffer;
+        buffer.resize(2 * (len + 1));
+        memset(buffer.data(), 0, buffer.size());
+        uint8_t* prev = buffer.data();
+        uint8_t* cur = buffer.data() + len + 1;
+
+        for (int i = 0; i < m_ihdr_chunk.height; i++) {
+            ssize_t read = m_inflate->read(cur, len + 1);
+            if (read != (ssize_t)(len + 1)) {
+                Logger::debug << "PNGLoader: inflate failed: " << (int)read << std::endl;
+                return false;
             }
-        } else if (m_ihdr_chunk.color_type == 6) {
-            m_scanline_keeper.set_color_length(4);
-            if (m_ihdr_chunk.depth == 8) {
-                for (int i = 0; i < m_ihdr_chunk.height; i++) {
-                    uint8_t scanline_filter;
-                    local_streamer.read(scanline_filter);
-
-                    if (scanline_filter > 4) {
-                        Logger::debug << "Invalid PNG filter: " << scanline_filter << std::endl;
-                        continue;
-                    }
-
-                    size_t len_of_scanline = (m_scanline_keeper.color_length() * m_ihdr_chunk.width * m_ihdr_chunk.depth + 7) / 8;
-                    m_scanline_keeper.add(Scanline(scanline_filter, local_streamer.ptr()));
-                    local_streamer.skip(len_of_scanline);
-                }
+
+            if (!unfilter_scanline(cur[0], cur + 1, prev + 1, len, bpp)) {
+                Logger::debug << "Invalid PNG filter: " << cur[0] << std::endl;
+                return false;
             }
-        }
+            copy_scanline_to_bitmap(cur + 1, bitmap[i]);
 
-        unfilter_scanlines();
-        copy_scanlines_to_bitmap(bitmap);
-        m_scanline_keeper.invalidate();
+            uint8_t* tmp = prev;
+            prev = cur;
+            cur = tmp;
+        }
+        return true;
     }
 
-    uint8_t PNGLoader::paeth_predictor(int a, int b, int c)
+    static inline uint8_t paeth_predictor(int a, int b, int c)
     {
         int p = a + b - c;
         int pa = abs(p - a);
@@ -158,87 +162,185 @@ namespace PNG {
         return c;
     }
 
-    void PNGLoader::unfilter_scanlines()
+    static void unfilter_sub(uint8_t* scanline, size_t len, size_t bpp)
     {
-        for (int i = 0; i < m_ihdr_chunk.height; i++) {
-            if (m_scanline_keeper.scanlines()[i].filter_type() == 1) { // Sub
-                int width = m_ihdr_chunk.width * m_scanline_keeper.color_length();
-                for (int j = 0; j < width; j++) {
-                    int prev = 0;
-                    if (j >= m_scanline_keeper.color_length()) {
-                        prev = m_scanline_keeper.scanlines()[i].data()[j - m_scanline_keeper.color_length()];
-                    }
-                    m_scanline_keeper.scanlines()[i].data()[j] += prev;
-                }
-            } else if (m_scanline_keeper.scanlines()[i].filter_type() == 2) { // Up
-                int width = m_ihdr_chunk.width * m_scanline_keeper.color_length();
-                for (int j = 0; j < width; j++) {
-                    int prev = 0;
-                    if (i > 0) {
-                        prev = m_scanline_keeper.scanlines()[i - 1].data()[j];
-                    }
-                    m_scanline_keeper.scanlines()[i].data()[j] += prev;
-                }
-            } else if (m_scanline_keeper.scanlines()[i].filter_type() == 3) { // Average
-                int width = m_ihdr_chunk.width * m_scanline_keeper.color_length();
-                for (int j = 0; j < width; j++) {
-                    int prev = 0;
-                    int prior = 0;
-                    if (i > 0) {
-                        prior = m_scanline_keeper.scanlines()[i - 1].data()[j];
-                    }
-                    if (j >= m_scanline_keeper.color_length()) {
-                        prev = m_scanline_keeper.scanlines()[i].data()[j - m_scanline_keeper.color_length()];
-                    }
-                    m_scanline_keeper.scanlines()[i].data()[j] += (prev + prior) / 2;
-                }
-            } else if (m_scanline_keeper.scanlines()[i].filter_type() == 4) { // Paeth
-                int width = m_ihdr_chunk.width * m_scanline_keeper.color_length();
-                for (int j = 0; j < width; j++) {
-                    int a = 0;
-                    int b = 0;
-                    int c = 0;
-                    if (i > 0) {
-                        b = m_scanline_keeper.scanlines()[i - 1].data()[j];
-                    }
-                    if (j >= m_scanline_keeper.color_length()) {
-                        a = m_scanline_keeper.scanlines()[i].data()[j - m_scanline_keeper.color_length()];
-                        if (i > 0) {
-                            c = m_scanline_keeper.scanlines()[i - 1].data()[j - m_scanline_keeper.color_length()];
-                        }
-                    }
-                    m_scanline_keeper.scanlines()[i].data()[j] += paeth_predictor(a, b, c);
-                }
-            }
+        for (size_t j = bpp; j < len; j++) {
+            scanline[j] += scanline[j - bpp];
+        }
+    }
+
+    static void unfilter_up(uint8_t* scanline, const uint8_t* prev, size_t len)
+    {
+        for (size_t j = 0; j < len; j++) {
+            scanline[j] += prev[j];
         }
     }
 
-    void PNGLoader::copy_scanlines_to_bitmap(PixelBitmap& bitmap)
+    static void unfilter_average(uint8_t* scanline, const uint8_t* prev, size_t len, size_t bpp)
+    {
+        for (size_t j = 0; j < len; j++) {
+            int left = j >= bpp ? scanline[j - bpp] : 0;
+            scanline[j] += (left + prev[j]) / 2;
+        }
+    }
+
+    static void unfilter_paeth(uint8_t* scanline, const uint8_t* prev, size_t len, size_t bpp)
+    {
+        for (size_t j = 0; j < len; j++) {
+            int a = j >= bpp ? scanline[j - bpp] : 0;
+            int c = j >= bpp ? prev[j - bpp] : 0;
+            scanline[j] += paeth_predictor(a, prev[j], c);
+        }
+    }
+
+// Sub, Average and Paeth depend on the previous pixel, so vector kernels
+// process a pixel of 3 or 4 channels at a time, with 16-bit lanes for the
+// predictor math. GCC vector extensions map them to SSE2 and NEON.
+#if defined(__SSE2__) || defined(__ARM_NEON)
+#define PNG_USE_VECTORS
+
+    typedef int16_t i16x4 __attribute__((vector_size(8)));
+    typedef uint8_t u8x4 __attribute__((vector_size(4)));
+    typedef uint8_t u8x16 __attribute__((vector_size(16)));
+
+    template <size_t BPP>
+    [[gnu::always_inline]] static inline i16x4 load_pixel(const uint8_t* ptr)
+    {
+        u8x4 res = {};
+        memcpy(&res, ptr, BPP);
+        return __builtin_convertvector(res, i16x4);
+    }
+
+    template <size_t BPP>
+    [[gnu::always_inline]] static inline void store_pixel(uint8_t* ptr, i16x4 pixel)
+    {
+        u8x4 res = __builtin_convertvector(pixel, u8x4);
+        memcpy(ptr, &res, BPP);
+    }
+
+    [[gnu::always_inline]] static inline i16x4 vec_abs(i16x4 v)
+    {
+        i16x4 sign = v >> 15;
+        return (v ^ sign) - sign;
+    }
+
+    static void vector_unfilter_up(uint8_t* scanline, const uint8_t* prev, size_t len)
+    {
+        size_t j = 0;
+        for (; j + sizeof(u8x16) <= len; j += sizeof(u8x16)) {
+            u8x16 cur, above;
+            memcpy(&cur, scanline + j, sizeof(u8x16));
+            memcpy(&above, prev + j, sizeof(u8x16));
+            cur += above;
+            memcpy(scanline + j, &cur, sizeof(u8x16));
+        }
+        unfilter_up(scanline + j, prev + j, len - j);
+    }
+
+    template <size_t BPP>
+    static void vector_unfilter_sub(uint8_t* scanline, size_t len)
+    {
+        i16x4 a = {};
+        for (size_t j = 0; j < len; j += BPP) {
+            a = (load_pixel<BPP>(scanline + j) + a) & 0xff;
+            store_pixel<BPP>(scanline + j, a);
+        }
+    }
+
+    template <size_t BPP>
+    static void vector_unfilter_average(uint8_t* scanline, const uint8_t* prev, size_t len)
+    {
+        i16x4 a = {};
+        for (size_t j = 0; j < len; j += BPP) {
+            i16x4 b = load_pixel<BPP>(prev + j);
+            a = (load_pixel<BPP>(scanline + j) + ((a + b) >> 1)) & 0xff;
+            store_pixel<BPP>(scanline + j, a);
+        }
+    }
+
+    template <size_t BPP>
+    static void vector_unfilter_paeth(uint8_t* scanline, const uint8_t* prev, size_t len)
+    {
+        i16x4 a = {};
+        i16x4 c = {};
+        for (size_t j = 0; j < len; j += BPP) {
+            i16x4 b = load_pixel<BPP>(prev + j);
+            i16x4 pa = vec_abs(b - c);
+            i16x4 pb = vec_abs(a - c);
+            i16x4 pc = vec_abs(a + b - c - c);
+            i16x4 use_a = (pa <= pb) & (pa <= pc);
+            i16x4 use_b = ~use_a & (pb <= pc);
+            i16x4 pred = (use_a & a) | (use_b & b) | (~(use_a | use_b) & c);
+            a = (load_pixel<BPP>(scanline + j) + pred) & 0xff;
+            store_pixel<BPP>(scanline + j, a);
+            c = b;
+        }
+    }
+
+    template <size_t BPP>
+    static void vector_unfilter(uint8_t filter, uint8_t* scanline, const uint8_t* prev, size_t len)
+    {
+        switch (filter) {
+        case 1:
+            vector_unfilter_sub<BPP>(scanline, len);
+            break;
+        case 2:
+            vector_unfilter_up(scanline, prev, len);
+            break;
+        case 3:
+            vector_unfilter_average<BPP>(scanline, prev, len);
+            break;
+        case 4:
+            vector_unfilter_paeth<BPP>(scanline, prev, len);
+            break;
+        }
+    }
+#endif
+
+    bool PNGLoader::unfilter_scanline(uint8_t filter, uint8_t* scanline, const uint8_t* prev, size_t len, size_t bpp)
+    {
+        if (filter > 4) {
+            return false;
+        }
+
+#ifdef PNG_USE_VECTORS
+        if (bpp == 3) {
+            vector_unfilter<3>(filter, scanline, prev, len);
+            return true;
+        }
+        if (bpp == 4) {
+            vector_unfilter<4>(filter, scanline, prev, len);
+            return true;
+        }
+#endif
+
+        switch (filter) {
+        case 1:
+            unfilter_sub(scanline, len, bpp);
+            break;
+        case 2:
+            unfilter_up(scanline, prev, len);
+            break;
+        case 3:
+            unfilter_average(scanline, prev, len, bpp);
+            break;
+        case 4:
+            unfilter_paeth(scanline, prev, len, bpp);
+            break;
+        }
+        return true;
+    }
+
+    void PNGLoader::copy_scanline_to_bitmap(const uint8_t* scanline, Color* dest)
     {
         if (m_ihdr_chunk.color_type == 2) {
-            bitmap.set_format(PixelBitmapFormat::RGB);
-            for (int i = 0; i < m_ihdr_chunk.height; i++) {
-                auto& scanline = m_scanline_keeper.scanlines()[i];
-                for (int j = 0, bit = 0; j < m_ihdr_chunk.width; j++) {
-                    int r = scanline.data()[bit++];
-                    int g = scanline.data()[bit++];
-                    int b = scanline.data()[bit++];
-                    int alpha = 255;
-                    bitmap[i][j] = Color(r, g, b, alpha);
-                }
+            for (int j = 0; j < m_ihdr_chunk.width; j++, scanline += 3) {
+                dest[j] = Color(scanline[0], scanline[1], scanline[2], 255);
             }
         }
         if (m_ihdr_chunk.color_type == 6) {
-            bitmap.set_format(PixelBitmapFormat::RGBA);
-            for (int i = 0; i < m_ihdr_chunk.height; i++) {
-                auto& scanline = m_scanline_keeper.scanlines()[i];
-                for (int j = 0, bit = 0; j < m_ihdr_chunk.width; j++) {
-                    int r = scanline.data()[bit++];
-                    int g = scanline.data()[bit++];
-                    int b = scanline.data()[bit++];
-                    int alpha = scanline.data()[bit++];
-                    bitmap[i][j] = Color(r, g, b, alpha);
-                }
+            for (int j = 0; j < m_ihdr_chunk.width; j++, scanline += 4) {
+                dest[j] = Color(scanline[0], scanline[1], scanline[2], scanline[3]).premultiplied();
             }
         }
     }
@@ -282,9 +384,15 @@ namespace PNG {
 
     void PNGLoader::proccess_stream(PixelBitmap& bitmap)
     {
-        int len = 0;
+        LFoundation::Inflate inflate(LFoundation::Inflate::Format::Zlib);
+        m_inflate = &inflate;
         while (read_chunk(bitmap)) { }
-        process_compressed_data(bitmap);
+        // The bitmap is sized by IHDR already, a broken image must not come
+        // out as one of uninitialized pixels.
+        if (!process_compressed_data(bitmap)) {
+            bitmap.clear();
+        }
+        m_inflate = nullptr;
     }
 
     PixelBitmap PNGLoader::load_from_mem(const uint8_t* ptr)
@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <algorithm>
+#include <libg/Region.h>
+#include <limits.h>
+
+namespace LG {
+
+Region::Region(const Rect& rect)
+{
+    if (!rect.empty()) {
+        m_boxes.push_back({ rect.min_x(), rect.min_y(), rect.min_x() + (int)rect.width(), rect.min_y() + (int)rect.height() });
+    }
+}
+
+Rect Region::bounds() const
+{
+    if (empty()) {
+        return Rect(0, 0, 0, 0);
+    }
+
+    int x1 = INT_MAX;
+    int x2 = INT_MIN;
+    for (size_t i = 0; i < m_boxes.size(); i++) {
+        x1 = std::min(x1, m_boxes[i].x1);
+        x2 = std::max(x2, m_boxes[i].x2);
+    }
+    int y1 = m_boxes.front().y1;
+    int y2 = m_boxes.back().y2;
+    return Rect(x1, y1, x2 - x1, y2 - y1);
+}
+
+size_t Region::square() const
+{
+    size_t res = 0;
+    for (size_t i = 0; i < m_boxes.size(); i++) {
+        res += (size_t)(m_boxes[i].x2 - m_boxes[i].x1) * (m_boxes[i].y2 - m_boxes[i].y1);
+    }
+    return res;
+}
+
+bool Region::intersects(const Rect& rect) const
+{
+    if (rect.empty()) {
+        return false;
+    }
+
+    int x2 = rect.min_x() + (int)rect.width();
+    int y2 = rect.min_y() + (int)rect.height();
+    for (size_t i = 0; i < m_boxes.size(); i++) {
+        const Box& box = m_boxes[i];
+        if (box.y1 >= y2) {
+            return false;
+        }
+        if (box.y2 > rect.min_y() && box.x1 < x2 && box.x2 > rect.min_x()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Region::contains(const Rect& rect) const
+{
+    Region rest(rect);
+    rest.subtract(*this);
+    return rest.empty();
+}
+
+static bool union_op(bool in_a, bool in_b) { return in_a || in_b; }
+static bool intersection_op(bool in_a, bool in_b) { return in_a && in_b; }
+static bool difference_op(bool in_a, bool in_b) { return in_a && !in_b; }
+
+void Region::unite(const Region& other)
+{
+    if (other.empty()) {
+        return;
+    }
+    if (empty()) {
+        m_boxes = other.m_boxes;
+        return;
+    }
+    apply(other, union_op);
+}
+
+void Region::intersect(const Region& other)
+{
+    if (empty() || other.empty()) {
+        m_boxes.clear();
+        return;
+    }
+    apply(other, intersection_op);
+}
+
+void Region::subtract(const Region& other)
+{
+    if (empty() || other.empty()) {
+        return;
+    }
+    apply(other, difference_op);
+}
+
+void Region::unite(const Rect& rect)
+{
+    // Adding an area which is already covered by one box is a common case.
+    int x2 = rect.min_x() + (int)rect.width();
+    int y2 = rect.min_y() + (int)rect.height();
+    for (size_t i = 0; i < m_boxes.size(); i++) {
+        const Box& box = m_boxes[i];
+        if (box.x1 <= rect.min_x() && box.y1 <= rect.min_y() && x2 <= box.x2 && y2 <= box.y2) {
+            return;
+        }
+    }
+    unite(Region(rect));
+}
+
+void Region::intersect(const Rect& rect) { intersect(Region(rect)); }
+void Region::subtract(const Rect& rect) { subtract(Region(rect)); }
+
+// Combines the spans of two bands, which are sorted and don't touch, by
+// walking their edges from left to right.
+static void combine_band(const Region::Box* a, size_t a_cnt, const Region::Box* b, size_t b_cnt, Region::Operation op, int y1, int y2, std::vector<Region::Box>& out)
+{
+    size_t a_edge = 0;
+    size_t b_edge = 0;
+    bool in_a = false;
+    bool in_b = false;
+    bool in_res = false;
+    int res_x1 = 0;
+
+    while (a_edge < 2 * a_cnt || b_edge < 2 * b_cnt) {
+        int a_x = INT_MAX;
+        int b_x = INT_MAX;
+        if (a_edge < 2 * a_cnt) {
+            a_x = (a_edge & 1) ? a[a_edge / 2].x2 : a[a_edge / 2].x1;
+        }
+        if (b_edge < 2 * b_cnt) {
+            b_x = (b_edge & 1) ? b[b_edge / 2].x2 : b[b_edge / 2].x1;
+        }
+
+        int x = std::min(a_x, b_x);
+        if (a_x == x) {
+            in_a = !(a_edge & 1);
+            a_edge++;
+        }
+        if (b_x == x) {
+            in_b = !(b_edge & 1);
+            b_edge++;
+        }
+
+        bool in = op(in_a, in_b);
+        if (in && !in_res) {
+            res_x1 = x;
+        } else if (!in && in_res) {
+            out.push_back({ res_x1, y1, x, y2 });
+        }
+        in_res = in;
+    }
+}
+
+// Returns the index past the last box of the band starting at start.
+static inline size_t band_end(const std::vector<Region::Box>& boxes, size_t start)
+{
+    size_t end = start;
+    while (end < boxes.size() && boxes[end].y1 == boxes[start].y1) {
+        end++;
+    }
+    return end;
+}
+
+void Region::apply(const Region& other, Operation op)
+{
+    const std::vector<Box>& a = m_boxes;
+    const std::vector<Box>& b = other.m_boxes;
+
+    // Every top and bottom of both regions starts a new band of the result.
+    // Bands don't overlap, so the edges of each region are already sorted.
+    std::vector<int> ys;
+    size_t a_next = 0;
+    size_t b_next = 0;
+    bool a_bottom = false;
+    bool b_bottom = false;
+    while (a_next < a.size() || b_next < b.size()) {
+        int a_y = INT_MAX;
+        int b_y = INT_MAX;
+        if (a_next < a.size()) {
+            a_y = a_bottom ? a[a_next].y2 : a[a_next].y1;
+        }
+        if (b_next < b.size()) {
+            b_y = b_bottom ? b[b_next].y2 : b[b_next].y1;
+        }
+
+        if (a_y <= b_y) {
+            ys.push_back(a_y);
+            a_next = a_bottom ? band_end(a, a_next) : a_next;
+            a_bottom = !a_bottom;
+        } else {
+            ys.push_back(b_y);
+            b_next = b_bottom ? band_end(b, b_next) : b_next;
+            b_bottom = !b_bottom;
+        }
+    }
+
+    std::vector<Box> result;
+    size_t a_band = 0;
+    size_t b_band = 0;
+    size_t prev_band = 0;
+    size_t prev_band_end = 0;
+    for (size_t i = 0; i + 1 < ys.size(); i++) {
+        int y1 = ys[i];
+        int y2 = ys[i + 1];
+        if (y1 == y2) {
+            continue;
+        }
+
+        while (a_band < a.size() && a[a_band].y2 <= y1) {
+            a_band = band_end(a, a_band);
+        }
+        while (b_band < b.size() && b[b_band].y2 <= y1) {
+            b_band = band_end(b, b_band);
+        }
+
+        size_t a_cnt = 0;
+        size_t b_cnt = 0;
+        if (a_band < a.size() && a[a_band].y1 <= y1) {
+            a_cnt = band_end(a, a_band) - a_band;
+        }
+        if (b_band < b.size() && b[b_band].y1 <= y1) {
+            b_cnt = band_end(b, b_band) - b_band;
+        }
+
+        size_t band_start = result.size();
+        combine_band(a.data() + a_band, a_cnt, b.data() + b_band, b_cnt, op, y1, y2, result);
+        size_t band_cnt = result.size() - band_start;
+        if (!band_cnt) {
+            continue;
+        }
+
+        // Merge with the band above if it continues it with the same spans.
+        bool same = prev_band_end > prev_band && band_cnt == prev_band_end - prev_band && result[prev_band].y2 == y1;
+        for (size_t j = 0; same && j < band_cnt; j++) {
+            same = result[prev_band + j].x1 == result[band_start + j].x1 && result[prev_band + j].x2 == result[band_start + j].x2;
+        }
+
+        if (same) {
+            for (size_t j = prev_band; j < prev_band_end; j++) {
+                result[j].y2 = y2;
+            }
+            result.resize(band_start);
+        } else {
+            prev_band = band_start;
+            prev_band_end = result.size();
+        }
+    }
+
+    m_boxes = std::move(result);
+}
+
+} // namespace LG
@@ -8,6 +8,7 @@
 
 #pragma once
 #include <cstdlib>
+#include <cstring>
 #include <libfoundation/Event.h>
 #include <libfoundation/EventLoop.h>
 #include <libfoundation/EventReceiver.h>
@@ -15,6 +16,7 @@
 #include <libipc/DoubleSidedConnection.h>
 #include <libipc/Message.h>
 #include <libipc/MessageDecoder.h>
+#include <sched.h>
 #include <unistd.h>
 #include <vector>
 
@@ -31,16 +33,51 @@ public:
 
     void set_accepted_key(int key) { m_accepted_key = key; }
 
-    bool send_message(const Message& msg) const
+    // Messages are only queued here, the server is woken up by flush(),
+    // which runs once per event loop pass or right before a sync request.
+    bool send_message(const Message& msg)
     {
-        auto encoded_msg = msg.encode();
-        int wrote = write(m_connection.c2s_fd(), encoded_msg.data(), encoded_msg.size());
-        return wrote == encoded_msg.size();
+        auto& ring = m_connection.c2s_ring();
+        size_t size = msg.encoded_size();
+        EncodedMessage encoded_msg;
+        if (!size) {
+            encoded_msg = msg.encode();
+            size = encoded_msg.size();
+        }
+        if (size > ring.capacity() / 2) {
+            return false;
+        }
+
+        uint8_t* buf;
+        while (!(buf = ring.reserve(size))) {
+            // The ring is full, so the server has to catch up first.
+            m_doorbell_pending = true;
+            flush();
+            sched_yield();
+        }
+
+        if (encoded_msg.size()) {
+            memcpy(buf, encoded_msg.data(), size);
+        } else {
+            msg.encode_to(buf);
+        }
+        m_doorbell_pending |= ring.commit();
+        schedule_deferred_invoke();
+        return true;
+    }
+
+    void flush()
+    {
+        if (m_doorbell_pending) {
+            m_connection.ring_doorbell(m_connection.c2s_fd());
+            m_doorbell_pending = false;
+        }
     }
 
     std::unique_ptr<Message> send_sync(const Message& msg)
     {
         bool status = send_message(msg);
+        flush();
         return wait_for_answer(msg);
     }
 
@@ -58,42 +95,31 @@ public:
 
     void pump_messages()
     {
-        std::vector<char> buf;
-
-        char tmpbuf[1024];
-
-        int read_cnt;
-        while ((read_cnt = read(m_connection.s2c_fd(), tmpbuf, sizeof(tmpbuf)))) {
-            if (read_cnt <= 0) {
-                Logger::debug << getpid() << " :: ClientConnection read error" << std::endl;
-                return;
-            }
-            size_t buf_size = buf.size();
-            buf.resize(buf_size + read_cnt);
-            memcpy((uint8_t*)&buf.data()[buf_size], (uint8_t*)tmpbuf, read_cnt);
-            if (read_cnt < sizeof(tmpbuf)) {
-                break;
-            }
-        }
+        m_connection.drain_doorbell(m_connection.s2c_fd());
 
-        size_t msg_len = 0;
-        size_t buf_size = buf.size();
-        for (size_t i = 0; i < buf_size; i += msg_len) {
-            msg_len = 0;
-            if (auto response = m_client_decoder.decode((buf.data() + i), read_cnt - i, msg_len)) {
+        auto& ring = m_connection.s2c_ring();
+        size_t len;
+        while (const uint8_t* shared_record = ring.front(len)) {
+            const uint8_t* record = copy_record(shared_record, len);
+            size_t msg_len = 0;
+            if (auto response = m_client_decoder.decode((const char*)record, len, msg_len)) {
                 m_messages.push_back(std::move(response));
-            } else if (auto response = m_server_decoder.decode((buf.data() + i), read_cnt - i, msg_len)) {
+            } else if (auto response = m_server_decoder.decode((const char*)record, len, msg_len)) {
                 m_messages.push_back(std::move(response));
             } else {
                 Logger::debug << getpid() << " :: ClientConnection read error" << std::endl;
                 std::abort();
             }
+            ring.pop();
+        }
+
+        if (ring.is_corrupted()) {
+            Logger::debug << getpid() << " :: ClientConnection corrupted ring" << std::endl;
+            std::abort();
         }
 
         if (m_messages.size() > 0) {
-            // Note: We send an event to ourselves and use CallEvent to recognize the
-            // event as sign to start processing of messages.
-            LFoundation::EventLoop::the().add(*this, new LFoundation::CallEvent(nullptr));
+            schedule_deferred_invoke();
         }
     }
 
@@ -101,8 +127,10 @@ public:
     {
         switch (event->type()) {
         case LFoundation::Event::Type::DeferredInvoke: {
-            // Note: The event was sent from pump_messages() and callback of CallEvent is 0!
-            // Do NOT call callback here!
+            // Note: The event was sent from pump_messages() or send_message() and
+            // callback of CallEvent is 0! Do NOT call callback here!
+            m_deferred_invoke_scheduled = false;
+            flush();
             auto msg = std::move(m_messages);
             for (int i = 0; i < msg.size(); i++) {
                 if (msg[i] && msg[i]->decoder_magic() == m_client_decoder.magic() && msg[i]->key() == m_accepted_key) {
@@ -115,9 +143,34 @@ public:
     }
 
 private:
+    // The server side could rewrite a record while it is decoded, so it is
+    // validated and decoded from a private copy.
+    const uint8_t* copy_record(const uint8_t* record, size_t len)
+    {
+        if (m_record_buffer.size() < len) {
+            m_record_buffer.resize(len);
+        }
+        memcpy(m_record_buffer.data(), record, len);
+        return m_record_buffer.data();
+    }
+
+    void schedule_deferred_invoke()
+    {
+        if (m_deferred_invoke_scheduled) {
+            return;
+        }
+        // Note: We send an event to ourselves and use CallEvent to recognize the
+        // event as sign to flush queued messages and to process received ones.
+        m_deferred_invoke_scheduled = true;
+        LFoundation::EventLoop::the().add(*this, new LFoundation::CallEvent(nullptr));
+    }
+
     int m_accepted_key { -1 };
+    bool m_doorbell_pending { false };
+    bool m_deferred_invoke_scheduled { false };
     LIPC::DoubleSidedConnection m_connection;
     std::vector<std::unique_ptr<Message>> m_messages;
+    std::vector<uint8_t> m_record_buffer;
     ServerDecoder& m_server_decoder;
     ClientDecoder& m_client_decoder;
 };
\ No newline at end of file
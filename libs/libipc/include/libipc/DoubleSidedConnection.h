@@ -7,25 +7,68 @@
  */
 
 #pragma once
+#include <libipc/SharedRing.h>
+#include <unistd.h>
 
 namespace LIPC {
 
+// Messages travel through a pair of rings in memory shared by both sides,
+// the sockets are used only as doorbells to wake up the other side.
 class DoubleSidedConnection {
 public:
+    static constexpr size_t RingCapacity = 64 * 1024;
+    static constexpr size_t SharedMemorySize = 2 * SharedRing::memory_size(RingCapacity);
+
     DoubleSidedConnection(int server_to_clients_fd, int clients_to_server_fd)
         : m_clients_to_server_fd(clients_to_server_fd)
         , m_server_to_clients_fd(server_to_clients_fd)
     {
     }
 
+    DoubleSidedConnection(int server_to_clients_fd, int clients_to_server_fd, int shared_buffer_id, uint8_t* shared_memory)
+        : m_clients_to_server_fd(clients_to_server_fd)
+        , m_server_to_clients_fd(server_to_clients_fd)
+        , m_shared_buffer_id(shared_buffer_id)
+        , m_clients_to_server_ring(shared_memory, RingCapacity, false)
+        , m_server_to_clients_ring(shared_memory + SharedRing::memory_size(RingCapacity), RingCapacity, false)
+    {
+    }
+
+    static void init_shared_memory(uint8_t* shared_memory)
+    {
+        SharedRing(shared_memory, RingCapacity, true);
+        SharedRing(shared_memory + SharedRing::memory_size(RingCapacity), RingCapacity, true);
+    }
+
     ~DoubleSidedConnection() = default;
 
+    inline bool is_valid() const { return m_clients_to_server_fd >= 0 && m_server_to_clients_fd >= 0 && m_clients_to_server_ring.is_valid(); }
     inline int c2s_fd() const { return m_clients_to_server_fd; }
     inline int s2c_fd() const { return m_server_to_clients_fd; }
+    inline int shared_buffer_id() const { return m_shared_buffer_id; }
+
+    inline SharedRing& c2s_ring() { return m_clients_to_server_ring; }
+    inline SharedRing& s2c_ring() { return m_server_to_clients_ring; }
+
+    inline void ring_doorbell(int fd) const
+    {
+        char bell = 0;
+        write(fd, &bell, sizeof(bell));
+    }
+
+    // Doorbells carry no data, all of them are consumed at once.
+    inline void drain_doorbell(int fd) const
+    {
+        char bells[64];
+        while (read(fd, bells, sizeof(bells)) == sizeof(bells)) { }
+    }
 
 private:
     int m_clients_to_server_fd;
     int m_server_to_clients_fd;
+    int m_shared_buffer_id { -1 };
+    SharedRing m_clients_to_server_ring;
+    SharedRing m_server_to_clients_ring;
 };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#pragma once
+#include <libipc/DoubleSidedConnection.h>
+#include <opuntia/shared_buffer.h>
+#include <sched.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace LIPC {
+
+// A local socket is a single ring which every connected descriptor reads
+// in full, so one socket can't serve several clients privately. Instead a
+// client binds its own pair of sockets, named after its pid, and announces
+// the pid through the listener socket. The server accepts the client by
+// connecting to the pair, after that each side talks over private rings.
+// Messages themselves go through the rings in a shared buffer, which is
+// created by the client and announced together with the pid.
+class Listener {
+public:
+    struct Announce {
+        pid_t pid;
+        int shared_buffer_id;
+    };
+
+    explicit Listener(const std::string& path)
+        : m_path(path)
+        , m_fd(socket(PF_LOCAL, 0, 0))
+    {
+        if (m_fd >= 0 && bind(m_fd, m_path.c_str(), m_path.size() + 1) < 0) {
+            close(m_fd);
+            m_fd = -1;
+        }
+    }
+
+    inline bool is_valid() const { return m_fd >= 0; }
+    inline int fd() const { return m_fd; }
+
+    // Calls callback(announce) for every client announced since the last call.
+    template <typename Callback>
+    void accept_pending(Callback callback)
+    {
+        Announce announces[32];
+        int read_cnt;
+        while ((read_cnt = read(m_fd, (char*)announces, sizeof(announces))) > 0) {
+            for (int i = 0; i < read_cnt / (int)sizeof(Announce); i++) {
+                callback(announces[i]);
+            }
+            if (read_cnt < sizeof(announces)) {
+                break;
+            }
+        }
+    }
+
+    // Server side: maps the client's rings and connects to its channels.
+    DoubleSidedConnection accept(const Announce& announce) const
+    {
+        pid_t pid = announce.pid;
+        uint8_t* shared_memory = nullptr;
+        if (shared_buffer_get(announce.shared_buffer_id, &shared_memory, 0) < 0) {
+            return DoubleSidedConnection(-1, -1);
+        }
+
+        int c2s_fd = socket(PF_LOCAL, 0, 0);
+        int s2c_fd = socket(PF_LOCAL, 0, 0);
+        std::string c2s_path = channel_path(m_path, pid, "c2s");
+        std::string s2c_path = channel_path(m_path, pid, "s2c");
+        if (c2s_fd < 0 || s2c_fd < 0
+            || ::connect(c2s_fd, c2s_path.c_str(), c2s_path.size() + 1) < 0
+            || ::connect(s2c_fd, s2c_path.c_str(), s2c_path.size() + 1) < 0) {
+            close(c2s_fd);
+            close(s2c_fd);
+            return DoubleSidedConnection(-1, -1);
+        }
+
+        // A connected socket reads only data written after the connection,
+        // so the client waits for this ack before sending anything.
+        char ack = AckByte;
+        write(s2c_fd, &ack, sizeof(ack));
+        return DoubleSidedConnection(s2c_fd, c2s_fd, announce.shared_buffer_id, shared_memory);
+    }
+
+    // Server side: gives back everything accept() took for the client.
+    void release(pid_t pid, const DoubleSidedConnection& connection) const
+    {
+        close(connection.c2s_fd());
+        close(connection.s2c_fd());
+        shared_buffer_free(connection.shared_buffer_id());
+        unlink(channel_path(m_path, pid, "c2s").c_str());
+        unlink(channel_path(m_path, pid, "s2c").c_str());
+    }
+
+    // Client side: binds private channels and announces them to the listener.
+    static DoubleSidedConnection connect(const std::string& path)
+    {
+        Announce announce;
+        announce.pid = getpid();
+        pid_t pid = announce.pid;
+        uint8_t* shared_memory = nullptr;
+        announce.shared_buffer_id = shared_buffer_create(&shared_memory, DoubleSidedConnection::SharedMemorySize, 0);
+        if (announce.shared_buffer_id < 0) {
+            return DoubleSidedConnection(-1, -1);
+        }
+        // The rings are set up before the server could see them.
+        DoubleSidedConnection::init_shared_memory(shared_memory);
+
+        int c2s_fd = socket(PF_LOCAL, 0, 0);
+        int s2c_fd = socket(PF_LOCAL, 0, 0);
+        int listener_fd = socket(PF_LOCAL, 0, 0);
+        std::string c2s_path = channel_path(path, pid, "c2s");
+        std::string s2c_path = channel_path(path, pid, "s2c");
+        if (c2s_fd < 0 || s2c_fd < 0 || listener_fd < 0
+            || bind(c2s_fd, c2s_path.c_str(), c2s_path.size() + 1) < 0
+            || bind(s2c_fd, s2c_path.c_str(), s2c_path.size() + 1) < 0) {
+            goto fail;
+        }
+
+        // The server might be still starting, trying to connect for 100 times.
+        for (int i = 0; i < 100; i++) {
+            if (::connect(listener_fd, path.c_str(), path.size() + 1) == 0) {
+                int wrote = write(listener_fd, (char*)&announce, sizeof(announce));
+                close(listener_fd);
+                listener_fd = -1;
+                if (wrote < 0 || !wait_for_ack(s2c_fd)) {
+                    goto fail;
+                }
+                return DoubleSidedConnection(s2c_fd, c2s_fd, announce.shared_buffer_id, shared_memory);
+            }
+            sched_yield();
+        }
+
+    fail:
+        close(c2s_fd);
+        close(s2c_fd);
+        close(listener_fd);
+        shared_buffer_free(announce.shared_buffer_id);
+        return DoubleSidedConnection(-1, -1);
+    }
+
+    static std::string channel_path(const std::string& path, pid_t pid, const char* direction)
+    {
+        return path + "." + std::to_string(pid) + "." + direction;
+    }
+
+private:
+    static constexpr char AckByte = 0x06;
+    static constexpr time_t AckTimeoutSec = 2;
+
+    // The server might be dead or stuck, so the ack is waited for a bounded time.
+    static bool wait_for_ack(int fd)
+    {
+        timespec_t start, now;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        char ack;
+        for (;;) {
+            int read_cnt = read(fd, &ack, sizeof(ack));
+            if (read_cnt < 0) {
+                return false;
+            }
+            if (read_cnt == sizeof(ack)) {
+                return ack == AckByte;
+            }
+
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            if (now.tv_sec - start.tv_sec > AckTimeoutSec) {
+                return false;
+            }
+            sched_yield();
+        }
+    }
+
+    std::string m_path;
+    int m_fd;
+};
+
+} // namespace LIPC
@@ -23,4 +23,9 @@ public:
     virtual message_key_t key() const { return -1; }
     virtual int reply_id() const { return -1; } // -1 means that there is no reply.
     virtual EncodedMessage encode() const { return std::vector<uint8_t>(); }
+
+    // Messages which know their size up front are serialized right into the
+    // transport buffer. 0 means the size is unknown and encode() is used.
+    virtual size_t encoded_size() const { return 0; }
+    virtual void encode_to(uint8_t* buf) const { }
 };
\ No newline at end of file
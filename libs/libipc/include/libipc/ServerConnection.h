@@ -7,7 +7,7 @@
  */
 
 #pragma once
-#include <cstdlib>
+#include <cstring>
 #include <libfoundation/Logger.h>
 #include <libipc/DoubleSidedConnection.h>
 #include <libipc/Message.h>
@@ -24,51 +24,165 @@ public:
     {
     }
 
-    bool send_message(const Message& msg) const
+    // A client which lets this much pile up behind its ring is not reading
+    // its messages anymore and gets disconnected.
+    static constexpr size_t MaxOverflowSize = 4 * LIPC::DoubleSidedConnection::RingCapacity;
+
+    // A broken connection sends nothing more and should be dropped by the owner.
+    inline bool is_broken() const { return m_broken; }
+    inline const LIPC::DoubleSidedConnection& connection() const { return m_connection; }
+
+    // Messages are only queued here, the client is woken up by flush().
+    bool send_message(const Message& msg)
     {
+        if (m_broken) {
+            return false;
+        }
+        if (!has_overflow() && enqueue(msg)) {
+            return true;
+        }
+        if (m_connection.s2c_ring().is_corrupted()) {
+            Logger::debug << getpid() << " :: ServerConnection corrupted ring, dropping the client" << std::endl;
+            mark_broken();
+            return false;
+        }
+
+        // The server must not wait for a slow client, keeping the message
+        // until the client frees some space in the ring.
         auto encoded_msg = msg.encode();
-        int wrote = write(m_connection.s2c_fd(), encoded_msg.data(), encoded_msg.size());
-        return wrote == encoded_msg.size();
+        if (m_overflow_size + encoded_msg.size() > MaxOverflowSize) {
+            Logger::debug << getpid() << " :: ServerConnection overflow, dropping the client" << std::endl;
+            mark_broken();
+            return false;
+        }
+        m_overflow_size += encoded_msg.size();
+        m_overflow.push_back(std::move(encoded_msg));
+        return true;
     }
 
-    void pump_messages()
+    // Returns false if some messages are still waiting for space in the ring.
+    bool flush()
     {
-        std::vector<char> buf;
+        if (m_broken) {
+            return true;
+        }
 
-        char tmpbuf[1024];
+        while (has_overflow() && enqueue(m_overflow[m_overflow_start])) {
+            m_overflow_size -= m_overflow[m_overflow_start].size();
+            m_overflow_start++;
+        }
+        if (!has_overflow()) {
+            m_overflow.clear();
+            m_overflow_start = 0;
+        } else if (m_connection.s2c_ring().is_corrupted()) {
+            Logger::debug << getpid() << " :: ServerConnection corrupted ring, dropping the client" << std::endl;
+            mark_broken();
+            return true;
+        }
 
-        int read_cnt;
-        while ((read_cnt = read(m_connection.c2s_fd(), tmpbuf, sizeof(tmpbuf)))) {
-            if (read_cnt <= 0) {
-                Logger::debug << getpid() << " :: ServerConnection read error" << std::endl;
-                return;
-            }
-            size_t buf_size = buf.size();
-            buf.resize(buf_size + read_cnt);
-            memcpy(&buf.data()[buf_size], tmpbuf, read_cnt);
-            if (read_cnt < sizeof(tmpbuf)) {
-                break;
-            }
+        if (m_doorbell_pending) {
+            m_connection.ring_doorbell(m_connection.s2c_fd());
+            m_doorbell_pending = false;
+        }
+        return !has_overflow();
+    }
+
+    // A client which sends garbage is marked broken instead of taking
+    // the server down.
+    void pump_messages()
+    {
+        if (m_broken) {
+            return;
         }
+        m_connection.drain_doorbell(m_connection.c2s_fd());
 
-        size_t msg_len = 0;
-        size_t buf_size = buf.size();
-        for (int i = 0; i < buf_size; i += msg_len) {
-            msg_len = 0;
-            if (auto response = m_server_decoder.decode((buf.data() + i), read_cnt - i, msg_len)) {
+        auto& ring = m_connection.c2s_ring();
+        size_t len;
+        while (const uint8_t* shared_record = ring.front(len)) {
+            const uint8_t* record = copy_record(shared_record, len);
+            size_t msg_len = 0;
+            if (auto response = m_server_decoder.decode((const char*)record, len, msg_len)) {
+                ring.pop();
                 if (auto answer = m_server_decoder.handle(*response)) {
                     send_message(*answer);
                 }
-            } else if (auto response = m_client_decoder.decode((buf.data() + i), read_cnt - i, msg_len)) {
-
+            } else if (auto response = m_client_decoder.decode((const char*)record, len, msg_len)) {
+                ring.pop();
             } else {
-                std::abort();
+                Logger::debug << getpid() << " :: ServerConnection read error, dropping the client" << std::endl;
+                mark_broken();
+                return;
             }
         }
+
+        if (ring.is_corrupted()) {
+            Logger::debug << getpid() << " :: ServerConnection corrupted ring, dropping the client" << std::endl;
+            mark_broken();
+            return;
+        }
+
+        // Answers to the whole batch are delivered with a single wakeup.
+        flush();
     }
 
 private:
+    inline bool has_overflow() const { return m_overflow_start < m_overflow.size(); }
+
+    // The client can rewrite a record at any moment, so it is validated and
+    // decoded from a private copy, which stays the same between both reads.
+    const uint8_t* copy_record(const uint8_t* record, size_t len)
+    {
+        if (m_record_buffer.size() < len) {
+            m_record_buffer.resize(len);
+        }
+        memcpy(m_record_buffer.data(), record, len);
+        return m_record_buffer.data();
+    }
+
+    void mark_broken()
+    {
+        m_broken = true;
+        m_overflow.clear();
+        m_overflow_start = 0;
+        m_overflow_size = 0;
+    }
+
+    bool enqueue(const Message& msg)
+    {
+        auto& ring = m_connection.s2c_ring();
+        size_t size = msg.encoded_size();
+        if (!size) {
+            return enqueue(msg.encode());
+        }
+
+        uint8_t* buf = ring.reserve(size);
+        if (!buf) {
+            return false;
+        }
+        msg.encode_to(buf);
+        m_doorbell_pending |= ring.commit();
+        return true;
+    }
+
+    bool enqueue(const EncodedMessage& encoded_msg)
+    {
+        auto& ring = m_connection.s2c_ring();
+        uint8_t* buf = ring.reserve(encoded_msg.size());
+        if (!buf) {
+            return false;
+        }
+        memcpy(buf, encoded_msg.data(), encoded_msg.size());
+        m_doorbell_pending |= ring.commit();
+        return true;
+    }
+
     LIPC::DoubleSidedConnection m_connection;
+    bool m_doorbell_pending { false };
+    bool m_broken { false };
+    std::vector<EncodedMessage> m_overflow;
+    size_t m_overflow_start { 0 };
+    size_t m_overflow_size { 0 };
+    std::vector<uint8_t> m_record_buffer;
     ServerDecoder& m_server_decoder;
     ClientDecoder& m_client_decoder;
-};
\ No newline at end of file
+};
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+
+namespace LIPC {
+
+// Single-producer single-consumer ring of variable sized records, placed in
+// memory shared between two processes. head and tail are free running byte
+// counters; a record is a 32-bit length padded to RecordAlignment followed by
+// the payload, so the consumer can decode a message in place, right in the
+// shared memory.
+struct SharedRingHeader {
+    alignas(64) uint32_t head;
+    alignas(64) uint32_t tail;
+    uint32_t capacity;
+};
+
+class SharedRing {
+public:
+    static constexpr size_t RecordAlignment = 8;
+    static constexpr size_t RecordHeaderSize = RecordAlignment;
+    static constexpr uint32_t WrapMarker = 0xffffffff;
+
+    SharedRing() = default;
+
+    // capacity must be a power of two. Both sides pass the same capacity, it
+    // is never taken from the header, since the other side could change it.
+    SharedRing(uint8_t* memory, size_t capacity, bool initialize)
+        : m_header((SharedRingHeader*)memory)
+        , m_data(memory + header_size())
+        , m_capacity(capacity)
+    {
+        if (initialize) {
+            m_header->head = 0;
+            m_header->tail = 0;
+            m_header->capacity = capacity;
+        }
+    }
+
+    static constexpr size_t header_size() { return (sizeof(SharedRingHeader) + RecordAlignment - 1) & ~(RecordAlignment - 1); }
+    static constexpr size_t memory_size(size_t capacity) { return header_size() + capacity; }
+    inline size_t capacity() const { return m_capacity; }
+
+    inline bool is_valid() const { return m_header; }
+
+    // Set once the header or a record is found to point outside of the ring.
+    // Such a ring is never read or written again.
+    inline bool is_corrupted() const { return m_corrupted; }
+
+    /**
+     * Producer side
+     */
+
+    // Returns space for a payload of len bytes or nullptr if the ring is full.
+    // The record becomes visible to the consumer only after commit().
+    uint8_t* reserve(size_t len)
+    {
+        if (len > m_capacity - RecordHeaderSize) {
+            return nullptr;
+        }
+
+        uint32_t need = record_size(len);
+        uint32_t head = m_header->head;
+        uint32_t tail = __atomic_load_n(&m_header->tail, __ATOMIC_ACQUIRE);
+        if (!check_indices(head, tail)) {
+            return nullptr;
+        }
+
+        uint32_t pos = head & (m_capacity - 1);
+        uint32_t contiguous = m_capacity - pos;
+
+        // Records are never split, the tail of the ring is skipped instead.
+        uint32_t skip = need > contiguous ? contiguous : 0;
+        if (need + skip > m_capacity - (head - tail)) {
+            return nullptr;
+        }
+
+        if (skip) {
+            *(uint32_t*)(m_data + pos) = WrapMarker;
+            head += skip;
+            pos = 0;
+        }
+
+        *(uint32_t*)(m_data + pos) = len;
+        m_reserved_head = head + need;
+        return m_data + pos + RecordHeaderSize;
+    }
+
+    // Publishes the reserved record. Returns true if the ring was empty, so
+    // the consumer might be waiting and has to be notified.
+    bool commit()
+    {
+        uint32_t old_head = m_header->head;
+        __atomic_store_n(&m_header->head, m_reserved_head, __ATOMIC_SEQ_CST);
+        return __atomic_load_n(&m_header->tail, __ATOMIC_SEQ_CST) == old_head;
+    }
+
+    /**
+     * Consumer side
+     */
+
+    // Returns the oldest record or nullptr if the ring is empty or corrupted.
+    // The returned record lies within the ring, whatever the producer wrote.
+    const uint8_t* front(size_t& len)
+    {
+        uint32_t tail = m_header->tail;
+        for (;;) {
+            uint32_t head = __atomic_load_n(&m_header->head, __ATOMIC_SEQ_CST);
+            if (!check_indices(head, tail) || head == tail) {
+                return nullptr;
+            }
+
+            uint32_t pos = tail & (m_capacity - 1);
+            uint32_t contiguous = m_capacity - pos;
+            uint32_t used = head - tail;
+            uint32_t rec_len = *(uint32_t*)(m_data + pos);
+            if (rec_len == WrapMarker) {
+                if (!pos || used < contiguous) {
+                    m_corrupted = true;
+                    return nullptr;
+                }
+                tail += contiguous;
+                __atomic_store_n(&m_header->tail, tail, __ATOMIC_SEQ_CST);
+                continue;
+            }
+
+            if (rec_len > contiguous - RecordHeaderSize || record_size(rec_len) > used) {
+                m_corrupted = true;
+                return nullptr;
+            }
+
+            len = rec_len;
+            m_front_tail = tail + record_size(rec_len);
+            return m_data + pos + RecordHeaderSize;
+        }
+    }
+
+    void pop()
+    {
+        __atomic_store_n(&m_header->tail, m_front_tail, __ATOMIC_SEQ_CST);
+    }
+
+private:
+    static inline uint32_t record_size(size_t len) { return (RecordHeaderSize + len + RecordAlignment - 1) & ~(RecordAlignment - 1); }
+
+    // Records start at aligned offsets and the producer is never more than
+    // the capacity ahead of the consumer.
+    bool check_indices(uint32_t head, uint32_t tail)
+    {
+        if (m_corrupted || head - tail > m_capacity || ((head | tail) & (RecordAlignment - 1))) {
+            m_corrupted = true;
+            return false;
+        }
+        return true;
+    }
+
+    SharedRingHeader* m_header { nullptr };
+    uint8_t* m_data { nullptr };
+    uint32_t m_capacity { 0 };
+    uint32_t m_reserved_head { 0 };
+    uint32_t m_front_tail { 0 };
+    bool m_corrupted { false };
+};
+
+} // namespace LIPC
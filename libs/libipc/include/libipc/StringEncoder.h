@@ -11,7 +11,9 @@
 #include <libipc/Decodable.h>
 #include <libipc/Encodable.h>
 #include <libipc/Encoder.h>
+#include <libipc/Wire.h>
 #include <string>
+#include <string_view>
 #include <sys/types.h>
 
 namespace LIPC {
@@ -52,4 +54,24 @@ public:
 private:
     std::string m_str {};
 };
+
+template <>
+struct Wire<StringEncoder> {
+    using Slot = WireSpan;
+    using View = std::string_view;
+
+    static inline size_t tail_size(const StringEncoder& val) { return val.string().size(); }
+
+    static inline Slot encode(const StringEncoder& val, uint8_t* msg, size_t& tail)
+    {
+        Slot slot { (uint32_t)tail, (uint32_t)val.string().size() };
+        memcpy(msg + tail, val.string().data(), slot.length);
+        tail += slot.length;
+        return slot;
+    }
+
+    static inline bool validate(const uint8_t*, size_t size, Slot slot) { return wire_span_is_valid(size, slot, 1); }
+    static inline View view(const uint8_t* msg, Slot slot) { return View((const char*)msg + slot.offset, slot.length); }
+    static inline StringEncoder materialize(View view) { return StringEncoder(std::string(view.data(), view.size())); }
+};
 } // namespace LIPC
\ No newline at end of file
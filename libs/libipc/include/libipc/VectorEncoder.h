@@ -12,6 +12,7 @@
 #include <libipc/Decodable.h>
 #include <libipc/Encodable.h>
 #include <libipc/Encoder.h>
+#include <libipc/Wire.h>
 #include <sys/types.h>
 #include <vector>
 
@@ -60,4 +61,59 @@ public:
 private:
     std::vector<T> m_vec {};
 };
+
+// Slots of the elements go first, followed by their own tails.
+template <typename T>
+struct Wire<VectorEncoder<T>> {
+    using Slot = WireSpan;
+    using View = WireArray<T>;
+    using ElementSlot = typename Wire<T>::Slot;
+
+    static size_t tail_size(const VectorEncoder<T>& val)
+    {
+        const auto& vec = val.vector();
+        size_t res = vec.size() * sizeof(ElementSlot);
+        for (size_t i = 0; i < vec.size(); i++) {
+            res += Wire<T>::tail_size(vec[i]);
+        }
+        return res;
+    }
+
+    static Slot encode(const VectorEncoder<T>& val, uint8_t* msg, size_t& tail)
+    {
+        const auto& vec = val.vector();
+        Slot slot { (uint32_t)tail, (uint32_t)vec.size() };
+        tail += vec.size() * sizeof(ElementSlot);
+        for (size_t i = 0; i < vec.size(); i++) {
+            ElementSlot element_slot = Wire<T>::encode(vec[i], msg, tail);
+            memcpy(msg + slot.offset + i * sizeof(ElementSlot), &element_slot, sizeof(ElementSlot));
+        }
+        return slot;
+    }
+
+    static bool validate(const uint8_t* msg, size_t size, Slot slot)
+    {
+        if (!wire_span_is_valid(size, slot, sizeof(ElementSlot))) {
+            return false;
+        }
+        View arr(msg, slot);
+        for (size_t i = 0; i < arr.size(); i++) {
+            if (!Wire<T>::validate(msg, size, arr.slot(i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static inline View view(const uint8_t* msg, Slot slot) { return View(msg, slot); }
+
+    static VectorEncoder<T> materialize(View view)
+    {
+        std::vector<T> vec;
+        for (size_t i = 0; i < view.size(); i++) {
+            vec.push_back(Wire<T>::materialize(view[i]));
+        }
+        return VectorEncoder<T>(std::move(vec));
+    }
+};
 } // namespace LIPC
\ No newline at end of file
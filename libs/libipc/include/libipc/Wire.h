@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace LIPC {
+
+// Every generated message starts with the header. layout_version is a hash
+// of the message signature, so both sides must be built from the same .ipc.
+struct [[gnu::packed]] MessageHeader {
+    int32_t decoder_magic;
+    int32_t id;
+    uint32_t size;
+    uint32_t layout_version;
+};
+
+// Variable sized data lives after the fixed part of a message and is
+// referenced by its offset from the start of the message.
+struct [[gnu::packed]] WireSpan {
+    uint32_t offset;
+    uint32_t length;
+};
+
+/**
+ * Wire<T> describes how a parameter of type T is stored in a message:
+ *  Slot - what is placed into the fixed part of the message;
+ *  View - what is read back without copying;
+ *  tail_size(val) - bytes needed after the fixed part;
+ *  encode(val, msg, tail) - returns the slot, writes the tail at msg + tail;
+ *  validate(msg, size, slot) - checks that the slot points inside the message;
+ *  view(msg, slot) and materialize(view) - read the value back.
+ * Slots are passed by value, since packed fields can't be referenced.
+ */
+template <typename T>
+struct Wire;
+
+template <typename T>
+struct ScalarWire {
+    using Slot = T;
+    using View = T;
+
+    static inline size_t tail_size(T) { return 0; }
+    static inline Slot encode(T val, uint8_t*, size_t&) { return val; }
+    static inline bool validate(const uint8_t*, size_t, Slot) { return true; }
+    static inline View view(const uint8_t*, Slot slot) { return slot; }
+    static inline T materialize(View view) { return view; }
+};
+
+template <>
+struct Wire<int> : public ScalarWire<int> {
+};
+
+template <>
+struct Wire<unsigned int> : public ScalarWire<unsigned int> {
+};
+
+template <>
+struct Wire<bool> : public ScalarWire<bool> {
+};
+
+// Read-only array of wire slots, used to view vectors without copying.
+template <typename T>
+class WireArray {
+public:
+    using Slot = typename Wire<T>::Slot;
+
+    WireArray() = default;
+    WireArray(const uint8_t* msg, WireSpan span)
+        : m_msg(msg)
+        , m_span(span)
+    {
+    }
+
+    inline size_t size() const { return m_span.length; }
+    inline typename Wire<T>::View at(size_t i) const { return Wire<T>::view(m_msg, slot(i)); }
+    inline typename Wire<T>::View operator[](size_t i) const { return at(i); }
+
+    inline Slot slot(size_t i) const
+    {
+        Slot res;
+        memcpy(&res, m_msg + m_span.offset + i * sizeof(Slot), sizeof(Slot));
+        return res;
+    }
+
+private:
+    const uint8_t* m_msg { nullptr };
+    WireSpan m_span {};
+};
+
+static inline bool wire_span_is_valid(size_t size, WireSpan span, size_t element_size)
+{
+    return span.offset <= size && span.length <= (size - span.offset) / element_size;
+}
+
+} // namespace LIPC
@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef _LIBOBJC_CACHE_H
+#define _LIBOBJC_CACHE_H
+
+#include <libobjc/v1/decls.h>
+
+// Implementations already looked up for a class, kept in its disp_table.
+// It is an open addressing table keyed by the SEL pointer a message is sent
+// with, probed linearly from (sel >> 3) & mask. objc_msgSend probes it in
+// assembly, so the layout must not change.
+struct objc_cache_entry {
+    SEL sel;
+    IMP imp;
+};
+
+struct objc_cache {
+    uintptr_t mask;
+    uintptr_t occupied;
+    struct objc_cache_entry buckets[1]; // Variable len
+};
+
+IMP cache_lookup(Class cls, SEL sel);
+void cache_fill(Class cls, SEL sel, IMP imp);
+void cache_flush(Class cls);
+
+#endif // _LIBOBJC_CACHE_H
@@ -18,6 +18,9 @@ void class_resolve_all_unresolved();
 
 void class_table_init();
 void class_add_from_module(struct objc_symtab* symtab);
+void class_add_categories_from_module(struct objc_symtab* symtab);
+void class_attach_unattached_categories();
+void class_flush_all_caches();
 IMP class_get_implementation(Class cls, SEL sel);
 
 Class objc_getClass(const char* name);
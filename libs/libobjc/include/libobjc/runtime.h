@@ -17,6 +17,7 @@
 #define ROOT_CLASS "NSObject"
 
 OBJC_EXPORT void objc_msgSend(id reciever, SEL sel, ...);
+OBJC_EXPORT bool class_addMethod(Class cls, SEL name, IMP imp, const char* types);
 
 static inline Class object_getClass(id object)
 {
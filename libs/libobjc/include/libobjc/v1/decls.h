@@ -95,6 +95,14 @@ struct objc_protocol_list {
     struct objc_protocol* list[1]; // Variable len
 };
 
+struct objc_category {
+    const char* category_name;
+    const char* class_name;
+    struct objc_method_list* instance_methods;
+    struct objc_method_list* class_methods;
+    struct objc_protocol_list* protocols;
+};
+
 #define CLS_CLASS 0x1
 #define CLS_META 0x2
 #define CLS_INITIALIZED 0x4
@@ -111,7 +119,7 @@ struct objc_class final {
     long instance_size;
     struct objc_ivar_list* ivars;
     struct objc_method_list* methods;
-    void* disp_table;
+    void* disp_table; // struct objc_cache, objc_msgSend reads it
     struct objc_class* subclass_list; // TODO: Currently unresolved
     struct objc_class* sibling_class; // TODO: Currently unresolved
     struct objc_protocol_list* protocols;
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <libobjc/cache.h>
+#include <libobjc/class.h>
+#include <libobjc/memory.h>
+#include <pthread.h>
+#include <stddef.h>
+
+#define CACHE_INITIAL_SIZE 8
+
+// objc_msgSend probes caches without taking any lock. A published table is
+// only changed by adding complete buckets and is never freed, as a reader may
+// still be probing it. Retired tables are leaked: a growing cache retires less
+// than it ends up with, and caches are flushed only when methods are added.
+// Fills and flushes are serialized.
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// msgsend_*.S depend on these.
+static_assert(offsetof(struct objc_class, disp_table) == 8 * sizeof(void*));
+static_assert(offsetof(struct objc_cache, buckets) == 2 * sizeof(void*));
+static_assert(sizeof(struct objc_cache_entry) == 2 * sizeof(void*));
+
+static inline uintptr_t cache_hash(SEL sel)
+{
+    return (uintptr_t)sel >> 3;
+}
+
+static struct objc_cache* cache_alloc(uintptr_t size)
+{
+    size_t bytes = sizeof(struct objc_cache) + (size - 1) * sizeof(struct objc_cache_entry);
+    struct objc_cache* cache = (struct objc_cache*)objc_calloc(1, bytes);
+    cache->mask = size - 1;
+    return cache;
+}
+
+static void cache_insert(struct objc_cache* cache, SEL sel, IMP imp)
+{
+    uintptr_t i = cache_hash(sel) & cache->mask;
+    while (cache->buckets[i].sel && cache->buckets[i].sel != sel) {
+        i = (i + 1) & cache->mask;
+    }
+
+    if (cache->buckets[i].sel) {
+        return;
+    }
+
+    // The selector makes the bucket visible, so it goes last.
+    cache->occupied++;
+    cache->buckets[i].imp = imp;
+    __atomic_store_n(&cache->buckets[i].sel, sel, __ATOMIC_RELEASE);
+}
+
+IMP cache_lookup(Class cls, SEL sel)
+{
+    struct objc_cache* cache = (struct objc_cache*)__atomic_load_n(&cls->disp_table, __ATOMIC_ACQUIRE);
+    if (!cache) {
+        return nil_method;
+    }
+
+    uintptr_t i = cache_hash(sel) & cache->mask;
+    while (SEL bucket_sel = __atomic_load_n(&cache->buckets[i].sel, __ATOMIC_ACQUIRE)) {
+        if (bucket_sel == sel) {
+            return cache->buckets[i].imp;
+        }
+        i = (i + 1) & cache->mask;
+    }
+    return nil_method;
+}
+
+void cache_fill(Class cls, SEL sel, IMP imp)
+{
+    pthread_mutex_lock(&cache_lock);
+    struct objc_cache* cache = (struct objc_cache*)cls->disp_table;
+    if (!cache) {
+        cache = cache_alloc(CACHE_INITIAL_SIZE);
+        __atomic_store_n(&cls->disp_table, cache, __ATOMIC_RELEASE);
+    }
+
+    // Keep a quarter of buckets empty, so probes stay short and always
+    // reach an empty bucket.
+    uintptr_t size = cache->mask + 1;
+    if (4 * (cache->occupied + 1) > 3 * size) {
+        struct objc_cache* new_cache = cache_alloc(2 * size);
+        for (uintptr_t i = 0; i < size; i++) {
+            if (cache->buckets[i].sel) {
+                cache_insert(new_cache, cache->buckets[i].sel, cache->buckets[i].imp);
+            }
+        }
+        // The old table is retired, readers may still be probing it.
+        __atomic_store_n(&cls->disp_table, new_cache, __ATOMIC_RELEASE);
+        cache = new_cache;
+    }
+
+    cache_insert(cache, sel, imp);
+    pthread_mutex_unlock(&cache_lock);
+}
+
+void cache_flush(Class cls)
+{
+    // The table is retired, readers may still be probing it.
+    pthread_mutex_lock(&cache_lock);
+    __atomic_store_n(&cls->disp_table, DISPATCH_TABLE_NOT_INITIALIZED, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&cache_lock);
+}
@@ -7,6 +7,7 @@
  */
 
 #include <assert.h>
+#include <libobjc/cache.h>
 #include <libobjc/class.h>
 #include <libobjc/memory.h>
 #include <libobjc/module.h>
@@ -28,6 +29,9 @@ static int class_table_next_free = 0;
 static Class unresolved_classes[128];
 static int unresolved_classes_next = 0;
 
+static struct objc_category* unattached_categories[128];
+static int unattached_categories_next = 0;
+
 void class_table_init()
 {
 }
@@ -73,16 +77,10 @@ static inline void class_disp_table_preinit(Class cls)
     cls->disp_table = DISPATCH_TABLE_NOT_INITIALIZED;
 }
 
+// Selectors with the same name share the id, the selector passed here
+// should have it.
 static Method class_lookup_method_in_list(struct objc_method_list* objc_method_list, SEL sel)
 {
-    if (!objc_method_list) {
-        return (Method)NULL;
-    }
-
-    if (!selector_is_valid(sel)) {
-        sel = sel_registerTypedName((char*)sel->id, sel->types);
-    }
-
     while (objc_method_list) {
         for (int i = 0; i < objc_method_list->method_count; i++) {
             SEL method_name = objc_method_list->method_list[i].method_name;
@@ -98,10 +96,6 @@ static Method class_lookup_method_in_list(struct objc_method_list* objc_method_l
 
 static Method class_lookup_method_in_hierarchy(Class cls, SEL sel)
 {
-    if (!selector_is_valid(sel)) {
-        sel = sel_registerTypedName((char*)sel->id, sel->types);
-    }
-
     Method method;
     for (Class cli = cls; cli; cli = cli->superclass) {
         method = class_lookup_method_in_list(cli->methods, sel);
@@ -221,6 +215,85 @@ bool class_resolve_links(Class cls)
     return false;
 }
 
+void class_flush_all_caches()
+{
+    for (int i = 0; i < class_table_next_free; i++) {
+        cache_flush(class_tabel_storage[i].cls);
+        cache_flush(class_tabel_storage[i].cls->get_isa());
+    }
+}
+
+// Methods of the list are found before the ones the class has, as
+// categories override them. Caches of all classes are flushed, since
+// subclasses may have cached implementations of superclasses.
+static void class_add_method_list(Class cls, struct objc_method_list* method_list)
+{
+    method_list->method_next = cls->methods;
+    cls->methods = method_list;
+    class_flush_all_caches();
+}
+
+static bool class_attach_category(struct objc_category* category)
+{
+    Class cls = objc_getClass(category->class_name);
+    if (!cls) {
+        return false;
+    }
+
+    OBJC_DEBUGPRINT("Attaching category %s to %s\n", category->category_name, category->class_name);
+    if (category->instance_methods) {
+        selector_add_from_method_list(category->instance_methods);
+        class_add_method_list(cls, category->instance_methods);
+    }
+    if (category->class_methods) {
+        selector_add_from_method_list(category->class_methods);
+        class_add_method_list(cls->get_isa(), category->class_methods);
+    }
+    return true;
+}
+
+void class_attach_unattached_categories()
+{
+    int next = 0;
+    for (int i = 0; i < unattached_categories_next; i++) {
+        if (!class_attach_category(unattached_categories[i])) {
+            unattached_categories[next++] = unattached_categories[i];
+        }
+    }
+    unattached_categories_next = next;
+}
+
+void class_add_categories_from_module(struct objc_symtab* symtab)
+{
+    for (int i = 0; i < symtab->cat_def_cnt; i++) {
+        struct objc_category* category = (struct objc_category*)symtab->defs[symtab->cls_def_cnt + i];
+        if (!class_attach_category(category)) {
+            unattached_categories[unattached_categories_next++] = category;
+        }
+    }
+}
+
+OBJC_EXPORT bool class_addMethod(Class cls, SEL name, IMP imp, const char* types)
+{
+    if (!cls || !name || !imp) {
+        return false;
+    }
+
+    // As in other runtimes, a method the class has is not replaced.
+    SEL sel = sel_registerName((char*)name->id);
+    if (class_lookup_method_in_list(cls->methods, sel)) {
+        return false;
+    }
+
+    struct objc_method_list* method_list = (struct objc_method_list*)objc_malloc(sizeof(struct objc_method_list));
+    method_list->method_count = 1;
+    method_list->method_list[0].method_name = sel;
+    method_list->method_list[0].method_types = types;
+    method_list->method_list[0].method_imp = imp;
+    class_add_method_list(cls, method_list);
+    return true;
+}
+
 void class_resolve_all_unresolved()
 {
     for (int i = 0; i < unresolved_classes_next; i++) {
@@ -290,14 +363,20 @@ IMP class_get_implementation(Class cls, SEL sel)
     //     class_send_initialize(cls);
     // }
 
-    sel = sel_registerTypedName((char*)sel->id, sel->types);
-    Method method = class_lookup_method_in_hierarchy(cls, sel);
+    IMP imp = cache_lookup(cls, sel);
+    if (imp) {
+        return imp;
+    }
 
+    Method method = class_lookup_method_in_hierarchy(cls, sel_registerName((char*)sel->id));
     if (!method) {
         return nil_method;
     }
 
     // TODO: Message forwarding
 
+    // The cache is keyed by the selector the message was sent with, that is
+    // what objc_msgSend compares.
+    cache_fill(cls, sel, method->method_imp);
     return method->method_imp;
 }
\ No newline at end of file
@@ -36,4 +36,8 @@ OBJC_EXPORT void __objc_exec_class(struct objc_module* module)
     // TODO: Many things to init here.
 
     class_resolve_all_unresolved();
+
+    // Categories may come before their classes, these wait for them.
+    class_attach_unattached_categories();
+    class_add_categories_from_module(symtab);
 }
@@ -12,62 +12,100 @@
 #include <libobjc/selector.h>
 #include <string.h>
 
-static struct objc_selector* selector_pool_start;
-static struct objc_selector* selector_pool_next;
+// Selectors are unique by name, all selectors with the same name share its
+// id pointer, so comparing ids compares names. The table is open addressing
+// over name hashes.
+static SEL* selector_table;
+static size_t selector_table_mask;
+static size_t selector_table_count;
+
+#define SELECTOR_TABLE_INITIAL_SIZE 256
 
 #define CONST_DATA true
 #define VOLATILE_DATA false
 
-static SEL selector_table_add(const char* name, const char* types, bool const_data)
+static inline uint32_t selector_hash(const char* name)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (; *name; name++) {
+        hash = (hash ^ (uint8_t)*name) * 16777619u;
+    }
+    return hash;
+}
+
+static size_t selector_table_slot(const char* name, uint32_t hash)
+{
+    size_t i = hash & selector_table_mask;
+    while (selector_table[i] && strcmp(name, (char*)selector_table[i]->id) != 0) {
+        i = (i + 1) & selector_table_mask;
+    }
+    return i;
+}
+
+static void selector_table_grow()
 {
-    // Checking if we have this selector
-    for (struct objc_selector* cur_sel = selector_pool_start; cur_sel != selector_pool_next; cur_sel++) {
-        if (strcmp(name, (char*)cur_sel->id) == 0) {
-            if (cur_sel->types == 0 || types == 0) {
-                if (cur_sel->types == types) {
-                    return (SEL)cur_sel;
-                }
-            } else {
-                if (strcmp(types, cur_sel->types) == 0) {
-                    return (SEL)cur_sel;
-                }
-            }
+    SEL* old_table = selector_table;
+    size_t old_size = selector_table_mask + 1;
+
+    selector_table_mask = 2 * old_size - 1;
+    selector_table = (SEL*)objc_calloc(2 * old_size, sizeof(SEL));
+    for (size_t i = 0; i < old_size; i++) {
+        if (old_table[i]) {
+            const char* name = (char*)old_table[i]->id;
+            selector_table[selector_table_slot(name, selector_hash(name))] = old_table[i];
         }
     }
+    objc_free(old_table);
+}
 
-    SEL sel = (SEL)selector_pool_next++;
-    if (const_data) {
-        sel->id = (char*)name;
-        sel->types = types;
-    } else {
-        int name_len = strlen(name);
-        char* name_data = (char*)objc_malloc(name_len + 1);
-        memcpy(name_data, name, name_len);
-        name_data[name_len] = '\0';
-        sel->id = name_data;
-        sel->types = 0;
-
-        if (types) {
-            int types_len = strlen(types);
-            char* types_data = (char*)objc_malloc(types_len + 1);
-            memcpy(types_data, types, types_len);
-            types_data[types_len] = '\0';
-            sel->types = types_data;
+static const char* selector_copy_string(const char* str)
+{
+    int len = strlen(str);
+    char* data = (char*)objc_malloc(len + 1);
+    memcpy(data, str, len);
+    data[len] = '\0';
+    return data;
+}
+
+static SEL selector_table_add(const char* name, const char* types, bool const_data)
+{
+    uint32_t hash = selector_hash(name);
+    size_t slot = selector_table_slot(name, hash);
+    SEL sel = selector_table[slot];
+    if (sel) {
+        if (!sel->types && types) {
+            sel->types = const_data ? types : selector_copy_string(types);
         }
+        return sel;
+    }
+
+    sel = (SEL)objc_malloc(sizeof(struct objc_selector));
+    sel->id = const_data ? (char*)name : (char*)selector_copy_string(name);
+    sel->types = 0;
+    if (types) {
+        sel->types = const_data ? types : selector_copy_string(types);
     }
 
+    selector_table[slot] = sel;
+    selector_table_count++;
+    if (4 * selector_table_count > 3 * (selector_table_mask + 1)) {
+        selector_table_grow();
+    }
     return sel;
 }
 
 bool selector_is_valid(SEL sel)
 {
-    return (uintptr_t)selector_pool_start < (uintptr_t)sel && (uintptr_t)sel < (uintptr_t)selector_pool_next;
+    const char* name = (char*)sel->id;
+    return selector_table[selector_table_slot(name, selector_hash(name))] == sel;
 }
 
-// TODO: We currently do it really stupid
 void selector_table_init()
 {
-    selector_pool_start = selector_pool_next = (struct objc_selector*)objc_malloc(1024);
+    selector_table_mask = SELECTOR_TABLE_INITIAL_SIZE - 1;
+    selector_table = (SEL*)objc_calloc(SELECTOR_TABLE_INITIAL_SIZE, sizeof(SEL));
+    selector_table_count = 0;
 }
 
 void selector_add_from_module(struct objc_selector* selectors)
@@ -76,6 +114,10 @@ void selector_add_from_module(struct objc_selector* selectors)
         char* name = (char*)selectors[i].id;
         const char* types = selectors[i].types;
         SEL sel = selector_table_add(name, types, CONST_DATA);
+
+        // Messages are sent with these selectors, sharing the id lets
+        // method lookup compare them without going through the table.
+        selectors[i].id = sel->id;
     }
 }
 
@@ -36,8 +36,8 @@ public:
     void set_content_edge_insets(const EdgeInsets& ei) { m_content_edge_insets = ei, recalc_bounds(); }
     const EdgeInsets& content_edge_insets() const { return m_content_edge_insets; }
 
-    void set_font(const LG::Font& font) { m_font = font, recalc_bounds(); }
-    inline const LG::Font& font() const { return m_font; }
+    void set_font(const LG::Font& font) { m_font = &font, recalc_bounds(); }
+    inline const LG::Font& font() const { return *m_font; }
 
     void set_alignment(Text::Alignment alignment) { m_alignment = alignment; }
     Text::Alignment alignment() const { return m_alignment; }
@@ -63,7 +63,7 @@ private:
 
     std::string m_title {};
     LG::Color m_title_color { LG::Color::White };
-    LG::Font m_font { LG::Font::system_font() };
+    const LG::Font* m_font { &LG::Font::system_font() };
 
     Text::Alignment m_alignment { Text::Alignment::Left };
     EdgeInsets m_content_edge_insets { 12, 12, 12, 12 };
@@ -15,68 +15,112 @@
 #include <list>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace UI {
 
 // The CollectionView in UIKit is devided into sections where each section contains a number
-// of elements. This behavior is not implemented, instead of CollectionViewDataSource protocol
-// just a callback CollectionViewRowStreamer is used. It returns the whole line to be rendered.
-typedef std::function<View*(int)> CollectionViewRowStreamer;
+// of elements. This behavior is not implemented, a row is the whole line to be rendered.
+//
+// Only rows around the visible area have views. A row which goes out of it gives its view
+// back to the collection view, and view_for_row() gets it with dequeue_reusable_view() to
+// show another row, so memory and layout cost don't depend on the number of rows.
+struct CollectionViewDataSource {
+    std::function<size_t()> number_of_rows;
+    std::function<View*(size_t)> view_for_row;
+
+    // Height of a row which has not been shown yet. Optional, the average
+    // height of shown rows is used if it is not set.
+    std::function<size_t(size_t)> estimated_row_height;
+};
 
 class CollectionView : public ScrollView {
     UI_OBJECT();
 
 public:
-    ~CollectionView() = default;
+    ~CollectionView();
 
-    template <class T>
-    void set_data_source(T data_source) { m_data_source = data_source, prefetch_forward(); };
+    void set_data_source(const CollectionViewDataSource& data_source) { m_data_source = data_source, reload_data(); }
 
-    void reload_data() { prefetch_forward(); }
-    void invalidate_row(int id);
+    void reload_data();
+    void invalidate_row(size_t row);
 
-    virtual void display(const LG::Rect& rect) override;
-    virtual void mouse_entered(const LG::Point<int>& location) override;
-    virtual void mouse_exited() override;
-    virtual WheelEventResponse mouse_wheel_event(int wheel_data) override
+    // Returns a view with the same reuse_id which was given back by a row,
+    // or a new one constructed with args. Views not taken this way are
+    // deleted when their row goes away.
+    template <class T, class... Args>
+    T& dequeue_reusable_view(int reuse_id, Args&&... args)
     {
-        ScrollView::mouse_wheel_event(wheel_data);
-        if (wheel_data > 0) {
-            after_scroll_forward();
-            prefetch_forward();
-        } else {
-            after_scroll_backward();
+        m_dequeued_reuse_id = reuse_id;
+        for (size_t i = 0; i < m_reusable_views.size(); i++) {
+            if (m_reusable_views[i].reuse_id == reuse_id) {
+                View* view = m_reusable_views[i].view;
+                m_reusable_views[i] = m_reusable_views.back();
+                m_reusable_views.pop_back();
+                restore_subview(*view);
+                return *(T*)view;
+            }
         }
-
-        return WheelEventResponse::Handled;
+        return add_subview<T>(std::forward<Args>(args)...);
     }
 
+    virtual void display(const LG::Rect& rect) override;
+    virtual void mouse_entered(const LG::Point<int>& location) override;
+    virtual void mouse_exited() override;
+
 protected:
     CollectionView(View* superview, const LG::Rect&);
     CollectionView(View* superview, Window* window, const LG::Rect& frame);
 
+    virtual void did_scroll() override { layout_rows(); }
+
 private:
-    enum PrefetchStatus {
-        Success,
-        EndOfStream,
+    // Rows are laid out from this offset.
+    static constexpr int TopInset = 16;
+    // Rows are prepared within this distance above and below the visible area.
+    static constexpr int PrefetchMargin = 64;
+    static constexpr int DefaultRowHeight = 32;
+
+    struct Cell {
+        size_t row;
+        int y;
+        int height;
+        int reuse_id;
+        View* view;
     };
-    PrefetchStatus prefetch_row_forward(int id);
-    void prefetch_forward();
-    void after_scroll_forward();
-    void after_scroll_backward();
 
-    // Cache of views which precede the first on-screen view.
-    std::list<View*> m_preceding_views {};
-
-    // Cache of views which follow the last on-screen view.
-    std::list<View*> m_following_views {};
-    std::list<View*> m_views_on_screen {};
-
-    size_t m_first_onscreen_row_index { 0 };
-    size_t m_first_offscreen_row_index { 0 };
-    LG::Point<int> m_next_frame_origin { 0, 16 };
+    struct ReusableView {
+        int reuse_id;
+        View* view;
+    };
 
-    CollectionViewRowStreamer m_data_source;
+    void layout_rows();
+    bool materialize_row(size_t row, Cell& cell);
+    void recycle(const Cell& cell);
+    void recycle_all();
+    void place(const Cell& cell);
+    void set_row_height(size_t row, int height);
+    int row_height(size_t row);
+    int estimated_row_height(size_t row);
+    void update_content_size();
+
+    // Rows with views, in order.
+    std::list<Cell> m_cells {};
+    std::vector<ReusableView> m_reusable_views {};
+    int m_dequeued_reuse_id { -1 };
+
+    // Heights of rows which were shown, 0 for the others.
+    std::vector<int> m_row_heights {};
+    size_t m_row_count { 0 };
+    size_t m_measured_rows { 0 };
+    size_t m_measured_height { 0 };
+
+    // Position of the first row with a view, kept when there are no views,
+    // so layout could continue from it.
+    size_t m_first_row { 0 };
+    int m_first_row_y { TopInset };
+
+    CollectionViewDataSource m_data_source;
 };
 
-} // namespace UI
\ No newline at end of file
+} // namespace UI
@@ -10,7 +10,7 @@ class Window;
 class Connection {
 public:
     static Connection& the();
-    explicit Connection(const LIPC::DoubleSidedConnection&);
+    Connection();
 
     void greeting();
     int new_window(const Window& window);
@@ -18,7 +18,7 @@ public:
 
     template <class T>
     inline std::unique_ptr<T> send_sync_message(const Message& msg) { return std::unique_ptr<T>(m_connection_with_server.send_sync(msg)); }
-    inline bool send_async_message(const Message& msg) const { return m_connection_with_server.send_message(msg); }
+    inline bool send_async_message(const Message& msg) { return m_connection_with_server.send_message(msg); }
     inline void listen() { m_connection_with_server.pump_messages(); }
 
     // We use connection id as an unique key.
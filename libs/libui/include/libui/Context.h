@@ -39,8 +39,10 @@ public:
         set_draw_offset(frame.origin());
     }
 
+    // Relative contexts draw into the bitmap of the current one, which is
+    // a backing store while a retained view is rendered.
     Context(View& view, RelativeToCurrentContext)
-        : Context(view.window()->bitmap())
+        : Context(graphics_current_context().bitmap())
     {
         auto context_frame = view.frame();
         context_frame.offset_by(graphics_current_context().draw_offset());
@@ -49,7 +51,7 @@ public:
     }
 
     Context(View& view, const LG::Rect& frame, RelativeToCurrentContext)
-        : Context(view.window()->bitmap())
+        : Context(graphics_current_context().bitmap())
     {
         auto context_frame = frame;
         context_frame.offset_by(graphics_current_context().draw_offset());
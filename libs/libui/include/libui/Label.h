@@ -34,8 +34,8 @@ public:
     void set_alignment(Text::Alignment alignment) { m_alignment = alignment; }
     Text::Alignment alignment() const { return m_alignment; }
 
-    void set_font(const LG::Font& font) { m_font = font, set_needs_display(); }
-    inline const LG::Font& font() const { return m_font; }
+    void set_font(const LG::Font& font) { m_font = &font, set_needs_display(); }
+    inline const LG::Font& font() const { return *m_font; }
 
     inline size_t preferred_width() const { return text_width() + m_content_edge_insets.left() + m_content_edge_insets.right(); }
 
@@ -52,7 +52,7 @@ private:
 
     std::string m_text {};
     LG::Color m_text_color { LG::Color::Black };
-    LG::Font m_font { LG::Font::system_font() };
+    const LG::Font* m_font { &LG::Font::system_font() };
 
     Text::Alignment m_alignment { Text::Alignment::Left };
     EdgeInsets m_content_edge_insets {};
@@ -27,6 +27,8 @@ public:
     inline const LG::Point<int>& content_offset() const { return m_content_offset; }
     inline LG::Point<int>& content_offset() { return m_content_offset; }
 
+    void scroll_by(int n_x, int n_y) { do_scroll(n_x, n_y); }
+
     virtual std::optional<View*> subview_at(const LG::Point<int>& point) const override;
 
     virtual void display(const LG::Rect& rect) override;
@@ -40,6 +42,9 @@ protected:
 
     void display_scroll_indicators(LG::Context&);
 
+    // Called when the content offset changes, before the view is redrawn.
+    virtual void did_scroll() { }
+
     // The location of a subview relativly to its superview could
     // differ from it's frame() (e.g when scrolling), to determine
     // the right location we ask the superview to return it.
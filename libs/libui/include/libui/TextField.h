@@ -39,8 +39,8 @@ public:
     void set_content_edge_insets(const EdgeInsets& ei) { m_content_edge_insets = ei; }
     const EdgeInsets& content_edge_insets() const { return m_content_edge_insets; }
 
-    void set_font(const LG::Font& font) { m_font = font, set_needs_display(); }
-    inline const LG::Font& font() const { return m_font; }
+    void set_font(const LG::Font& font) { m_font = &font, set_needs_display(); }
+    inline const LG::Font& font() const { return *m_font; }
 
     virtual void display(const LG::Rect& rect) override;
     virtual void mouse_entered(const LG::Point<int>& location) override;
@@ -59,7 +59,7 @@ private:
     std::string m_text {};
     std::string m_placeholder_text {};
     LG::Color m_text_color { LG::Color::DarkSystemText };
-    LG::Font m_font { LG::Font::system_font() };
+    const LG::Font* m_font { &LG::Font::system_font() };
 
     Text::Alignment m_alignment { Text::Alignment::Left };
     EdgeInsets m_content_edge_insets { 12, 12, 12, 12 };
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#pragma once
+#include <libfoundation/GapBuffer.h>
+#include <string>
+
+namespace UI {
+
+// Text kept in a gap buffer together with an index of line starts.
+//
+// The index is a gap buffer as well, its gap stays at the line of the last
+// edit. Starts of lines before the gap are offsets from the beginning of the
+// text, starts of lines after it are offsets from the end of the text, so an
+// edit changes neither of them and costs as much as the distance from the
+// previous edit, not as the size of the text.
+class TextStorage {
+public:
+    TextStorage();
+    ~TextStorage() = default;
+
+    void set_text(const char* data, size_t len);
+    std::string text() const;
+
+    inline size_t size() const { return m_text.size(); }
+    inline char at(size_t offset) const { return m_text[offset]; }
+    inline void copy(size_t offset, size_t len, char* dest) const { m_text.copy(offset, len, dest); }
+
+    void insert(size_t offset, const char* data, size_t len);
+    void erase(size_t offset, size_t len);
+
+    inline size_t line_count() const { return m_line_starts.size(); }
+    size_t line_start(size_t line) const;
+    // Length of the line without its line break.
+    size_t line_length(size_t line) const;
+    size_t line_of(size_t offset) const;
+
+private:
+    void move_line_gap(size_t line);
+
+    LFoundation::GapBuffer<char> m_text;
+    LFoundation::GapBuffer<size_t> m_line_starts;
+};
+
+} // namespace UI
@@ -11,6 +11,7 @@
 #include <libui/Constants/Layout.h>
 #include <libui/EdgeInsets.h>
 #include <libui/ScrollView.h>
+#include <libui/TextStorage.h>
 #include <string>
 #include <utility>
 
@@ -22,15 +23,20 @@ class TextView : public ScrollView {
 public:
     ~TextView() = default;
 
-    void set_text(const std::string& text) { m_text = text, recalc_text_size(), set_needs_display(); }
-    void set_text(std::string&& text) { m_text = std::move(text), recalc_text_size(), set_needs_display(); }
-    const std::string& text() const { return m_text; }
+    void set_text(const std::string& text);
+    std::string text() const { return m_storage.text(); }
+    inline const TextStorage& storage() const { return m_storage; }
+
+    // Edits relayout only the lines they touch, the rest keep their
+    // measured widths.
+    void insert_text(size_t offset, const std::string& text);
+    void erase_text(size_t offset, size_t len);
 
     void set_text_color(const LG::Color& color) { m_text_color = color, set_needs_display(); }
     const LG::Color& text_color() const { return m_text_color; }
 
-    void set_font(const LG::Font& font) { m_font = font, recalc_text_size(), set_needs_display(); }
-    inline const LG::Font& font() const { return m_font; }
+    void set_font(const LG::Font& font) { m_font = &font, invalidate_line_widths(), set_needs_display(); }
+    inline const LG::Font& font() const { return *m_font; }
 
     virtual void display(const LG::Rect& rect) override;
     virtual void mouse_entered(const LG::Point<int>& location) override;
@@ -41,11 +47,20 @@ protected:
     TextView(View* superview, Window* window, const LG::Rect& frame);
 
 private:
-    void recalc_text_size();
+    int line_width(size_t line);
+    void invalidate_line_width(size_t line);
+    void invalidate_line_widths();
+    void update_content_size();
+    void set_needs_display_from_line(size_t line, bool to_end);
 
-    std::string m_text {};
+    TextStorage m_storage;
+    // Widths of lines measured so far, -1 for lines which were not displayed
+    // since they changed. Lines are measured as they become visible.
+    LFoundation::GapBuffer<int> m_line_widths;
+    int m_max_line_width { 0 };
+    bool m_max_line_width_valid { true };
     LG::Color m_text_color { LG::Color::Black };
-    LG::Font m_font { LG::Font::system_font() };
+    const LG::Font* m_font { &LG::Font::system_font() };
 };
 
 } // namespace UI
\ No newline at end of file
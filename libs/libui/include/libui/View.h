@@ -62,6 +62,13 @@ public:
 
     void remove_from_superview();
 
+    // Puts back a subview which was taken out with remove_from_superview().
+    void restore_subview(View& view)
+    {
+        m_subviews.push_back(&view);
+        did_add_subview(view);
+    }
+
     template <typename Callback>
     void foreach_subview(Callback callback) const
     {
@@ -118,6 +125,24 @@ public:
     inline void set_focusable(bool val) { m_focusable = val; }
     inline bool is_focusable() const { return m_focusable; }
 
+    // A retained view keeps its rendered content, subviews and layer
+    // shading included, in a backing bitmap until set_needs_display() is
+    // called for it or one of its subviews, and its superview just blits it.
+    // Suits static content like icons, buttons and labels.
+    void set_retained(bool retained);
+    inline bool is_retained() const { return m_retained; }
+    inline bool uses_backing_store() const;
+
+    // Blits the backing store in the context of the superview, rect is the
+    // area to redraw and frame is where the view is placed.
+    void display_backing_store(const LG::Rect& rect, const LG::Rect& frame);
+
+    // Backing stores can be turned off for all views to compare frame
+    // times, retained views are drawn directly then.
+    static void set_backing_stores_enabled(bool enabled);
+    static bool backing_stores_enabled();
+    static size_t backing_stores_memory();
+
     inline Layer& layer() { return m_layer; }
     inline const Layer& layer() const { return m_layer; }
 
@@ -172,6 +197,8 @@ private:
     void set_window(Window* window) { m_window = window; }
     void set_superview(View* superview) { m_superview = superview; }
     void remove_view(View* view);
+    void render_backing_store();
+    void release_backing_store();
 
     View* m_superview { nullptr };
     Window* m_window { nullptr };
@@ -190,9 +217,18 @@ private:
     LG::Color m_background_color { LG::Color::White };
     Layer m_layer {};
 
+    bool m_retained { false };
+    bool m_backing_store_valid { false };
+    LG::PixelBitmap m_backing_store;
+
     GestureManager m_gesture_manager;
 };
 
+inline bool View::uses_backing_store() const
+{
+    return m_retained && backing_stores_enabled();
+}
+
 inline void View::constraint_interpreter(const Constraint& constraint)
 {
     auto get_rel_item_attribute = [&]() {
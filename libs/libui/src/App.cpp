@@ -6,10 +6,8 @@
  * found in the LICENSE file.
  */
 
-#include <libipc/DoubleSidedConnection.h>
 #include <libui/App.h>
 #include <memory>
-#include <sys/socket.h>
 
 namespace UI {
 
@@ -17,7 +15,7 @@ App* s_UI_App_the = nullptr;
 
 App::App()
     : m_event_loop()
-    , m_server_connection(LIPC::DoubleSidedConnection(socket(PF_LOCAL, 0, 0), socket(PF_LOCAL, 0, 0)))
+    , m_server_connection()
 {
     s_UI_App_the = this;
 }
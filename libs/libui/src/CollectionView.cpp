@@ -23,6 +23,14 @@ CollectionView::CollectionView(View* superview, Window* window, const LG::Rect&
 {
 }
 
+CollectionView::~CollectionView()
+{
+    // Reusable views are not subviews, so they are not deleted with them.
+    for (auto& reusable : m_reusable_views) {
+        delete reusable.view;
+    }
+}
+
 void CollectionView::display(const LG::Rect& rect)
 {
     LG::Context ctx = graphics_current_context();
@@ -41,148 +49,207 @@ void CollectionView::mouse_exited()
     set_hovered(false);
 }
 
-void CollectionView::invalidate_row(int rowid)
+void CollectionView::reload_data()
 {
-    if (!m_data_source) {
+    if (!m_data_source.number_of_rows || !m_data_source.view_for_row) {
         return;
     }
 
-    auto remove_view_from_list = [this, rowid](std::list<View*>& lst, size_t view_offset) {
-        View* view = m_data_source((int)rowid);
-        if (!view) {
-            return;
-        }
+    recycle_all();
 
-        auto it = lst.begin();
-        std::advance(it, view_offset);
+    size_t row_count = m_data_source.number_of_rows();
+    for (size_t row = row_count; row < m_row_count; row++) {
+        set_row_height(row, 0);
+    }
+    m_row_heights.resize(row_count);
+    for (size_t row = m_row_count; row < row_count; row++) {
+        m_row_heights[row] = 0;
+    }
+    m_row_count = row_count;
 
-        View* prev_view = *it;
-        view->frame().set_y(prev_view->frame().min_y());
-        view->set_needs_layout();
+    if (m_first_row >= m_row_count) {
+        m_first_row = 0;
+        m_first_row_y = TopInset;
+    }
+    layout_rows();
+    set_needs_display();
+}
 
-        lst.insert(it, view);
-        lst.erase(it);
+void CollectionView::invalidate_row(size_t row)
+{
+    if (row >= m_row_count) {
+        return;
+    }
 
-        prev_view->remove_from_superview();
-        delete prev_view;
-    };
+    // The row could change its height, so it is measured again and the
+    // rows after it are laid out from scratch.
+    set_row_height(row, 0);
+    while (!m_cells.empty() && m_cells.back().row >= row) {
+        recycle(m_cells.back());
+        m_cells.pop_back();
+    }
+    layout_rows();
+    set_needs_display();
+}
+
+int CollectionView::estimated_row_height(size_t row)
+{
+    if (m_data_source.estimated_row_height) {
+        return m_data_source.estimated_row_height(size_t(row));
+    }
+    if (m_measured_rows) {
+        return m_measured_height / m_measured_rows;
+    }
+    return DefaultRowHeight;
+}
 
-    if (m_first_onscreen_row_index <= rowid && rowid < m_first_onscreen_row_index + m_views_on_screen.size()) {
-        remove_view_from_list(m_views_on_screen, rowid - m_first_onscreen_row_index);
-    } else if (m_first_offscreen_row_index <= rowid && rowid < m_first_offscreen_row_index + m_following_views.size()) {
-        remove_view_from_list(m_following_views, rowid - m_first_offscreen_row_index);
-    } else if (m_first_onscreen_row_index - m_preceding_views.size() <= rowid && rowid < m_first_onscreen_row_index) {
-        remove_view_from_list(m_preceding_views, rowid - (m_first_onscreen_row_index - m_preceding_views.size()));
+int CollectionView::row_height(size_t row)
+{
+    if (m_row_heights[row]) {
+        return m_row_heights[row];
     }
+    return estimated_row_height(row);
 }
 
-CollectionView::PrefetchStatus CollectionView::prefetch_row_forward(int id)
+void CollectionView::set_row_height(size_t row, int height)
 {
-    size_t cached_lines = m_first_offscreen_row_index + m_following_views.size();
-    if (id < cached_lines) {
-        return PrefetchStatus::Success;
+    if (m_row_heights[row]) {
+        m_measured_height -= m_row_heights[row];
+        m_measured_rows--;
+    }
+    if (height) {
+        m_measured_height += height;
+        m_measured_rows++;
     }
+    m_row_heights[row] = height;
+}
 
-    // See comment on CollectionViewRowStreamer
-    View* view = m_data_source((int)id);
+bool CollectionView::materialize_row(size_t row, Cell& cell)
+{
+    m_dequeued_reuse_id = -1;
+    View* view = m_data_source.view_for_row(size_t(row));
     if (!view) {
-        return PrefetchStatus::EndOfStream;
+        return false;
     }
 
-    m_following_views.push_back(view);
-    view->frame().set_y(m_next_frame_origin.y());
-    view->set_needs_layout();
+    cell.row = row;
+    cell.view = view;
+    cell.reuse_id = m_dequeued_reuse_id;
+    cell.height = view->bounds().height();
+    set_row_height(row, cell.height);
+    return true;
+}
 
-    int next_y = m_next_frame_origin.y() + view->bounds().height();
-    m_next_frame_origin.set_y(next_y);
-    content_size().set_height(next_y);
+void CollectionView::place(const Cell& cell)
+{
+    cell.view->frame().set_y(cell.y);
+    cell.view->set_needs_layout();
+}
+
+void CollectionView::recycle(const Cell& cell)
+{
+    View* view = cell.view;
+    if (view->is_hovered()) {
+        MouseLeaveEvent mle(0, 0);
+        view->receive_mouse_leave_event(mle);
+    }
+    view->remove_from_superview();
+
+    if (cell.reuse_id < 0) {
+        delete view;
+        return;
+    }
+    m_reusable_views.push_back({ cell.reuse_id, view });
+}
 
-    return PrefetchStatus::Success;
+void CollectionView::recycle_all()
+{
+    while (!m_cells.empty()) {
+        recycle(m_cells.front());
+        m_cells.pop_front();
+    }
 }
 
-void CollectionView::prefetch_forward()
+void CollectionView::layout_rows()
 {
-    if (!m_data_source) {
+    if (!m_data_source.view_for_row) {
         return;
     }
 
-    // Not initialized, so prefetching while data is on screen.
-    if (content_size().height() < bounds().height()) {
-        for (;; m_first_offscreen_row_index++) {
-            PrefetchStatus full_line_prefetched = prefetch_row_forward(m_first_offscreen_row_index);
-            if (full_line_prefetched == PrefetchStatus::EndOfStream) {
-                break;
-            }
+    int top = content_offset().y() - PrefetchMargin;
+    int bottom = content_offset().y() + (int)bounds().height() + PrefetchMargin;
+
+    while (!m_cells.empty() && m_cells.front().y + m_cells.front().height <= top) {
+        m_first_row++;
+        m_first_row_y += m_cells.front().height;
+        recycle(m_cells.front());
+        m_cells.pop_front();
+    }
 
-            m_views_on_screen.push_back(m_following_views.front());
-            m_following_views.pop_front();
+    while (!m_cells.empty() && m_cells.back().y >= bottom) {
+        recycle(m_cells.back());
+        m_cells.pop_back();
+    }
 
-            if (!bounds().contains(m_next_frame_origin)) {
-                m_first_offscreen_row_index++;
-                // Exiting here since the next frame is out of screen.
-                return;
-            }
+    if (m_cells.empty()) {
+        // Scrolled past all rows with views, rows which were never shown
+        // are stepped over with their estimated height.
+        while (m_first_row + 1 < m_row_count && m_first_row_y + row_height(m_first_row) <= top) {
+            m_first_row_y += row_height(m_first_row);
+            m_first_row++;
+        }
+        while (m_first_row > 0 && m_first_row_y > top) {
+            m_first_row--;
+            m_first_row_y -= row_height(m_first_row);
         }
     }
 
-    const int cache_depth = 4;
-    for (int i = 0; i < cache_depth; i++) {
-        PrefetchStatus full_line_prefetched = prefetch_row_forward(m_first_offscreen_row_index + i);
-        if (full_line_prefetched == PrefetchStatus::EndOfStream) {
+    while (!m_cells.empty() && m_first_row > 0 && m_first_row_y > top) {
+        Cell cell;
+        if (!materialize_row(m_first_row - 1, cell)) {
             break;
         }
+        m_first_row--;
+        m_first_row_y -= cell.height;
+        cell.y = m_first_row_y;
+        place(cell);
+        m_cells.push_front(cell);
     }
-}
 
-void CollectionView::after_scroll_backward()
-{
-
-    if (!m_preceding_views.empty()) {
-        View* back_view = m_preceding_views.back();
-        auto back_view_frame = back_view->frame();
-        back_view_frame.offset_by(-content_offset());
-        if (bounds().intersects(back_view_frame)) {
-            m_views_on_screen.push_front(m_preceding_views.back());
-            m_preceding_views.pop_back();
-            m_first_onscreen_row_index--;
+    size_t next_row = m_first_row + m_cells.size();
+    int next_y = m_cells.empty() ? m_first_row_y : m_cells.back().y + m_cells.back().height;
+    while (next_row < m_row_count && next_y < bottom) {
+        Cell cell;
+        if (!materialize_row(next_row, cell)) {
+            break;
         }
+        cell.y = next_y;
+        place(cell);
+        m_cells.push_back(cell);
+        next_y += cell.height;
+        next_row++;
     }
 
-    if (!m_views_on_screen.empty()) {
-        View* back_view = m_views_on_screen.back();
-        auto back_view_frame = back_view->frame();
-        back_view_frame.offset_by(-content_offset());
-        if (!bounds().intersects(back_view_frame)) {
-            m_following_views.push_front(m_views_on_screen.back());
-            m_views_on_screen.pop_back();
-            m_first_offscreen_row_index--;
+    // Estimates above could be wrong, so when the first row is reached, rows
+    // are moved to their real place along with the content offset.
+    if (m_first_row == 0 && m_first_row_y != TopInset) {
+        int diff = m_first_row_y - TopInset;
+        m_first_row_y = TopInset;
+        for (auto& cell : m_cells) {
+            cell.y -= diff;
+            place(cell);
         }
+        content_offset().set_y(std::max(0, content_offset().y() - diff));
     }
+
+    update_content_size();
 }
 
-void CollectionView::after_scroll_forward()
+void CollectionView::update_content_size()
 {
-    if (!m_views_on_screen.empty()) {
-        View* front_view = m_views_on_screen.front();
-        auto front_view_frame = front_view->frame();
-        front_view_frame.offset_by(-content_offset());
-        if (!bounds().intersects(front_view_frame)) {
-            m_preceding_views.push_back(m_views_on_screen.front());
-            m_views_on_screen.pop_front();
-            m_first_onscreen_row_index++;
-        }
-    }
-
-    if (!m_following_views.empty()) {
-        View* front_view = m_following_views.front();
-        auto front_view_frame = front_view->frame();
-        front_view_frame.offset_by(-content_offset());
-        if (bounds().intersects(front_view_frame)) {
-            m_views_on_screen.push_back(m_following_views.front());
-            m_following_views.pop_front();
-            m_first_offscreen_row_index++;
-        }
-    }
+    size_t unmeasured_rows = m_row_count - m_measured_rows;
+    size_t estimate = unmeasured_rows ? estimated_row_height(m_row_count - 1) : 0;
+    content_size().set_height(TopInset + m_measured_height + unmeasured_rows * estimate);
 }
 
-} // namespace UI
\ No newline at end of file
+} // namespace UI
@@ -8,23 +8,22 @@
 
 #include <libfoundation/Logger.h>
 #include <libfoundation/ProcessInfo.h>
+#include <libfoundation/SharedBuffer.h>
+#include <libg/Font.h>
+#include <libg/ImageLoaders/ImageCache.h>
 #include <libipc/ClientConnection.h>
+#include <libipc/Listener.h>
 #include <libui/Connection.h>
 #include <libui/Window.h>
 #include <memory>
 #include <new>
-#include <sched.h>
-#include <sys/socket.h>
+#include <vector>
 
 // #define DEBUG_CONNECTION
 
 namespace UI {
 
-#define WINSERVER_REQUEST_SOCKET_PATH "/tmp/winserver_requests.sock"
-#define WINSERVER_REQUEST_SOCKET_PATH_SIZE sizeof(WINSERVER_REQUEST_SOCKET_PATH)
-
-#define WINSERVER_RESPONSE_SOCKET_PATH "/tmp/winserver_response.sock"
-#define WINSERVER_RESPONSE_SOCKET_PATH_SIZE sizeof(WINSERVER_RESPONSE_SOCKET_PATH)
+#define WINSERVER_LISTENER_SOCKET_PATH "/tmp/winserver.sock"
 
 static Connection* s_the = nullptr;
 
@@ -32,51 +31,81 @@ Connection& Connection::the()
 {
     // FIXME: Thread-safe method to be applied
     if (!s_the) {
-        auto conn = LIPC::DoubleSidedConnection(socket(PF_LOCAL, 0, 0), socket(PF_LOCAL, 0, 0));
-        new Connection(conn);
+        new Connection();
     }
     return *s_the;
 }
 
-Connection::Connection(const LIPC::DoubleSidedConnection& connection)
-    : m_connection(connection)
+static LIPC::DoubleSidedConnection connect_to_window_server()
+{
+    auto channel = LIPC::Listener::connect(WINSERVER_LISTENER_SOCKET_PATH);
+    if (!channel.is_valid()) {
+        Logger::debug << getpid() << " :: can't connect to window server" << std::endl;
+        exit(-1);
+    }
+    return channel;
+}
+
+// Glyphs of system fonts are rasterized once by the window server and
+// drawn straight from its shared atlases.
+static LG::GlyphAtlas glyph_atlas_from_server(LG::Font::SystemFont font, size_t font_size)
+{
+    auto& connection = Connection::the();
+    auto reply = connection.send_sync_message<GetGlyphAtlasMessageReply>(GetGlyphAtlasMessage(connection.key(), (int)font, font_size));
+    if (!reply || reply->buffer_id() < 0) {
+        return LG::GlyphAtlas();
+    }
+
+    auto buffer = LFoundation::SharedBuffer<uint8_t>(reply->buffer_id(), SHBUF_READONLY);
+    if (!buffer.alive()) {
+        return LG::GlyphAtlas();
+    }
+    return LG::GlyphAtlas(buffer.data(), reply->atlas_size());
+}
+
+// Images are decoded once by the window server and packed into its shared
+// pages. Every page is mapped once and bitmaps point into it.
+static std::vector<LFoundation::SharedBuffer<uint8_t>> s_image_pages;
+
+static LG::PixelBitmap image_from_server(const std::string& path)
+{
+    auto& connection = Connection::the();
+    auto reply = connection.send_sync_message<GetSharedImageMessageReply>(GetSharedImageMessage(connection.key(), path));
+    if (!reply || reply->buffer_id() < 0) {
+        return LG::PixelBitmap();
+    }
+
+    uint8_t* page = nullptr;
+    for (size_t i = 0; i < s_image_pages.size(); i++) {
+        if (s_image_pages[i].id() == reply->buffer_id()) {
+            page = s_image_pages[i].data();
+            break;
+        }
+    }
+    if (!page) {
+        auto buffer = LFoundation::SharedBuffer<uint8_t>(reply->buffer_id(), SHBUF_READONLY);
+        if (!buffer.alive()) {
+            return LG::PixelBitmap();
+        }
+        s_image_pages.push_back(buffer);
+        page = buffer.data();
+    }
+
+    auto* pixels = (LG::Color*)(page + reply->offset());
+    return LG::PixelBitmap(pixels, reply->width(), reply->height(), LG::PixelBitmapFormat(reply->format()));
+}
+
+Connection::Connection()
+    : m_connection(connect_to_window_server())
     , m_server_decoder()
     , m_client_decoder()
     , m_connection_with_server(m_connection, m_server_decoder, m_client_decoder)
 {
     s_the = this;
-    if (m_connection.c2s_fd() > 0 && m_connection.s2c_fd() > 0) {
-        bool req_connected = false;
-        bool resp_connected = false;
-        // Trying to connect for 100 times. If unsuccesfull, it crashes.
-        for (int i = 0; i < 100; i++) {
-            if (!req_connected) {
-                if (connect(m_connection.c2s_fd(), WINSERVER_REQUEST_SOCKET_PATH, WINSERVER_REQUEST_SOCKET_PATH_SIZE) == 0) {
-                    req_connected = true;
-                }
-            }
-            if (!resp_connected) {
-                if (connect(m_connection.s2c_fd(), WINSERVER_RESPONSE_SOCKET_PATH, WINSERVER_RESPONSE_SOCKET_PATH_SIZE) == 0) {
-                    resp_connected = true;
-                }
-            }
-
-            if (req_connected && resp_connected) {
-                break;
-            }
-            sched_yield();
-        }
-
-        if (!req_connected || !resp_connected) {
-            goto crash;
-        }
-
-        greeting();
-        setup_listners();
-        return;
-    }
-crash:
-    exit(-1);
+    greeting();
+    setup_listners();
+    LG::Font::set_atlas_provider(glyph_atlas_from_server);
+    LG::ImageCache::set_provider(image_from_server);
 }
 
 void Connection::setup_listners()
@@ -65,6 +65,7 @@ void ScrollView::do_scroll(int n_x, int n_y)
     int max_y = std::max(0, (int)content_size().height() - (int)bounds().height());
     content_offset().set_x(std::max(0, std::min(x + n_x, max_x)));
     content_offset().set_y(std::max(0, std::min(y + n_y, max_y)));
+    did_scroll();
     auto me = MouseEvent(m_mouse_location.x(), m_mouse_location.y());
     receive_mouse_move_event(me);
     set_needs_display();
@@ -175,6 +176,11 @@ void ScrollView::receive_display_event(DisplayEvent& event)
         frame.offset_by(-m_content_offset);
         bounds.intersect(frame);
         if (!bounds.empty()) {
+            if (subview.uses_backing_store()) {
+                subview.display_backing_store(bounds, frame);
+                return true;
+            }
+
             subview.layer().display(bounds, frame);
             graphics_push_context(Context(subview, frame, Context::RelativeToCurrentContext::Yes));
             bounds.origin().offset_by(-frame.origin());
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <cstring>
+#include <libui/TextStorage.h>
+
+namespace UI {
+
+TextStorage::TextStorage()
+{
+    m_line_starts.insert(0, 0);
+}
+
+void TextStorage::set_text(const char* data, size_t len)
+{
+    m_text.clear();
+    m_line_starts.clear();
+    m_line_starts.insert(0, 0);
+    insert(0, data, len);
+}
+
+std::string TextStorage::text() const
+{
+    std::string res;
+    if (size()) {
+        res.resize(size());
+        copy(0, size(), &res[0]);
+    }
+    return res;
+}
+
+size_t TextStorage::line_start(size_t line) const
+{
+    if (line < m_line_starts.gap_position()) {
+        return m_line_starts[line];
+    }
+    return size() - m_line_starts[line];
+}
+
+size_t TextStorage::line_length(size_t line) const
+{
+    size_t end = line + 1 < line_count() ? line_start(line + 1) - 1 : size();
+    return end - line_start(line);
+}
+
+size_t TextStorage::line_of(size_t offset) const
+{
+    size_t lo = 0;
+    size_t hi = line_count();
+    while (hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if (line_start(mid) <= offset) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+void TextStorage::move_line_gap(size_t line)
+{
+    // Entries which cross the gap switch between the two encodings.
+    size_t gap = m_line_starts.gap_position();
+    size_t from = line < gap ? line : gap;
+    size_t to = line < gap ? gap : line;
+    for (size_t i = from; i < to; i++) {
+        m_line_starts[i] = size() - m_line_starts[i];
+    }
+    m_line_starts.move_gap(line);
+}
+
+void TextStorage::insert(size_t offset, const char* data, size_t len)
+{
+    // Lines after the one being edited are stored relative to the end, so
+    // they stay valid as the text grows.
+    move_line_gap(line_of(offset) + 1);
+    m_text.insert(offset, data, len);
+
+    const char* end = data + len;
+    const char* nl = data;
+    while ((nl = (const char*)memchr(nl, '\n', end - nl))) {
+        nl++;
+        m_line_starts.insert(m_line_starts.gap_position(), offset + (nl - data));
+    }
+}
+
+void TextStorage::erase(size_t offset, size_t len)
+{
+    size_t line = line_of(offset);
+    move_line_gap(line + 1);
+
+    // Lines whose line breaks are erased are merged into the edited one.
+    size_t removed = 0;
+    while (line + 1 + removed < line_count() && line_start(line + 1 + removed) <= offset + len) {
+        removed++;
+    }
+    m_line_starts.erase(line + 1, removed);
+    m_text.erase(offset, len);
+}
+
+} // namespace UI
@@ -6,6 +6,7 @@
  * found in the LICENSE file.
  */
 
+#include <algorithm>
 #include <libg/Color.h>
 #include <libui/Context.h>
 #include <libui/TextView.h>
@@ -16,11 +17,49 @@ namespace UI {
 TextView::TextView(View* superview, const LG::Rect& frame)
     : ScrollView(superview, frame)
 {
+    invalidate_line_widths();
 }
 
 TextView::TextView(View* superview, Window* window, const LG::Rect& frame)
     : ScrollView(superview, window, frame)
 {
+    invalidate_line_widths();
+}
+
+void TextView::set_text(const std::string& text)
+{
+    m_storage.set_text(text.c_str(), text.size());
+    invalidate_line_widths();
+    set_needs_display();
+}
+
+void TextView::insert_text(size_t offset, const std::string& text)
+{
+    size_t line = m_storage.line_of(offset);
+    size_t old_line_count = m_storage.line_count();
+    m_storage.insert(offset, text.c_str(), text.size());
+
+    size_t added_lines = m_storage.line_count() - old_line_count;
+    m_line_widths.insert_repeated(line + 1, -1, added_lines);
+    invalidate_line_width(line);
+    update_content_size();
+    set_needs_display_from_line(line, added_lines > 0);
+}
+
+void TextView::erase_text(size_t offset, size_t len)
+{
+    size_t line = m_storage.line_of(offset);
+    size_t old_line_count = m_storage.line_count();
+    m_storage.erase(offset, len);
+
+    size_t removed_lines = old_line_count - m_storage.line_count();
+    for (size_t i = line + 1; i <= line + removed_lines; i++) {
+        invalidate_line_width(i);
+    }
+    m_line_widths.erase(line + 1, removed_lines);
+    invalidate_line_width(line);
+    update_content_size();
+    set_needs_display_from_line(line, removed_lines > 0);
 }
 
 void TextView::display(const LG::Rect& rect)
@@ -29,27 +68,31 @@ void TextView::display(const LG::Rect& rect)
     ctx.add_clip(rect);
 
     auto& f = font();
-    const size_t line_height = f.size();
-
-    int start_x = -content_offset().x();
-    int start_y = -content_offset().y();
-    int cur_x = start_x;
-    int cur_y = start_y;
-
-    for (int i = 0; i < m_text.size(); i++) {
-        if (m_text[i] == '\n') {
-            cur_x = start_x;
-            cur_y += line_height;
-            continue;
-        }
-
-        size_t glyph_advance = f.glyph(m_text[i]).advance();
-        if (bounds().contains(cur_x, cur_y) || bounds().contains(cur_x + glyph_advance, cur_y + line_height)) {
-            ctx.draw({ cur_x, cur_y }, f.glyph(m_text[i]));
+    const int line_height = f.size();
+
+    // Only lines crossing the rect are visited.
+    int first_y = std::max(rect.min_y() + content_offset().y(), 0);
+    size_t first_line = first_y / line_height;
+    size_t last_line = std::min((size_t)((rect.max_y() + content_offset().y()) / line_height + 1), m_storage.line_count());
+
+    for (size_t line = first_line; line < last_line; line++) {
+        line_width(line);
+
+        int cur_x = -content_offset().x();
+        int cur_y = line * line_height - content_offset().y();
+        size_t start = m_storage.line_start(line);
+        size_t len = m_storage.line_length(line);
+        for (size_t i = 0; i < len && cur_x <= rect.max_x(); i++) {
+            auto& glyph = f.glyph(m_storage.at(start + i));
+            int glyph_advance = glyph.advance();
+            if (cur_x + glyph_advance > rect.min_x()) {
+                ctx.draw({ cur_x, cur_y }, glyph);
+            }
+            cur_x += glyph_advance;
         }
-        cur_x += glyph_advance;
     }
 
+    update_content_size();
     display_scroll_indicators(ctx);
 }
 
@@ -63,29 +106,63 @@ void TextView::mouse_exited()
     set_hovered(false);
 }
 
-void TextView::recalc_text_size()
+int TextView::line_width(size_t line)
 {
+    if (m_line_widths[line] >= 0) {
+        return m_line_widths[line];
+    }
+
     auto& f = font();
-    const size_t line_height = f.size();
-
-    int cur_x = 0;
-    int max_x = 0;
-    int cur_y = 0;
-
-    for (int i = 0; i < m_text.size(); i++) {
-        if (m_text[i] == '\n') {
-            std::max(max_x, cur_x);
-            cur_x = 0;
-            cur_y += line_height;
-            continue;
-        }
+    int width = 0;
+    size_t start = m_storage.line_start(line);
+    size_t len = m_storage.line_length(line);
+    for (size_t i = 0; i < len; i++) {
+        width += f.glyph(m_storage.at(start + i)).advance();
+    }
+
+    m_line_widths[line] = width;
+    m_max_line_width = std::max(m_max_line_width, width);
+    return width;
+}
 
-        size_t glyph_width = f.glyph(m_text[i]).advance();
-        cur_x += glyph_width;
+void TextView::invalidate_line_width(size_t line)
+{
+    if (m_line_widths[line] == m_max_line_width) {
+        m_max_line_width_valid = false;
     }
+    m_line_widths[line] = -1;
+}
+
+void TextView::invalidate_line_widths()
+{
+    m_line_widths.clear();
+    m_line_widths.insert_repeated(0, -1, m_storage.line_count());
+    m_max_line_width = 0;
+    m_max_line_width_valid = true;
+    update_content_size();
+}
 
-    std::max(max_x, cur_x);
-    content_size().set(LG::Size(cur_x, cur_y + line_height));
+void TextView::update_content_size()
+{
+    if (!m_max_line_width_valid) {
+        // The widest line changed, the next one is found among measured
+        // widths without measuring any text.
+        m_max_line_width = 0;
+        for (size_t i = 0; i < m_line_widths.size(); i++) {
+            m_max_line_width = std::max(m_max_line_width, m_line_widths[i]);
+        }
+        m_max_line_width_valid = true;
+    }
+
+    content_size().set(LG::Size(m_max_line_width, m_storage.line_count() * font().size()));
+}
+
+void TextView::set_needs_display_from_line(size_t line, bool to_end)
+{
+    const int line_height = font().size();
+    int y = line * line_height - content_offset().y();
+    int height = to_end ? std::max((int)bounds().height() - y, 0) : line_height;
+    set_needs_display(LG::Rect(0, y, bounds().width(), height));
 }
 
 } // namespace UI
\ No newline at end of file
@@ -7,12 +7,16 @@
  */
 
 #include <libfoundation/EventLoop.h>
+#include <libg/Blend.h>
 #include <libg/Color.h>
 #include <libui/Context.h>
 #include <libui/View.h>
 
 namespace UI {
 
+static bool s_backing_stores_enabled = true;
+static size_t s_backing_stores_memory = 0;
+
 View::View(View* superview, const LG::Rect& frame)
     : m_frame(frame)
     , m_superview(superview)
@@ -33,6 +37,7 @@ View::View(View* superview, Window* window, const LG::Rect& frame)
 
 View::~View()
 {
+    release_backing_store();
     for (auto* v : subviews()) {
         delete v;
     }
@@ -106,6 +111,10 @@ LG::Point<int> View::subview_location(const View& subview) const
 
 void View::set_needs_display(const LG::Rect& rect)
 {
+    // Backing stores of superviews hold this content too, they are
+    // invalidated as the rect goes up.
+    m_backing_store_valid = false;
+
     auto display_rect = rect;
     display_rect.intersect(bounds());
     if (has_superview()) {
@@ -117,6 +126,83 @@ void View::set_needs_display(const LG::Rect& rect)
     }
 }
 
+void View::set_backing_stores_enabled(bool enabled)
+{
+    s_backing_stores_enabled = enabled;
+}
+
+bool View::backing_stores_enabled()
+{
+    return s_backing_stores_enabled;
+}
+
+size_t View::backing_stores_memory()
+{
+    return s_backing_stores_memory;
+}
+
+void View::set_retained(bool retained)
+{
+    m_retained = retained;
+    if (!retained) {
+        release_backing_store();
+    }
+    set_needs_display();
+}
+
+void View::release_backing_store()
+{
+    s_backing_stores_memory -= m_backing_store.width() * m_backing_store.height() * sizeof(LG::Color);
+    m_backing_store.clear();
+    m_backing_store_valid = false;
+}
+
+void View::render_backing_store()
+{
+    // The layer shading is drawn around the view, so the store is extended
+    // by its spread.
+    int spread = layer().shading().spread();
+    size_t width = bounds().width() + 2 * spread;
+    size_t height = bounds().height() + 2 * spread;
+    if (m_backing_store.width() != width || m_backing_store.height() != height) {
+        release_backing_store();
+        m_backing_store.resize(width, height);
+        m_backing_store.set_format(LG::PixelBitmapFormat::RGBA);
+        s_backing_stores_memory += width * height * sizeof(LG::Color);
+    }
+
+    // Content is drawn over transparent pixels, so blitting it with
+    // source-over gives the same result as drawing it in place.
+    LG::blend_backend().fill(m_backing_store.data(), LG::Color(0, 0, 0, 0), width * height);
+
+    auto backing_bounds = LG::Rect(-spread, -spread, width, height);
+    Context ctx(m_backing_store);
+    ctx.set_draw_offset(LG::Point<int>(spread, spread));
+    graphics_push_context(ctx);
+    layer().display(backing_bounds, bounds());
+    graphics_pop_context();
+
+    ctx.add_clip(bounds());
+    graphics_push_context(ctx);
+    DisplayEvent own_event(bounds());
+    receive_display_event(own_event);
+    graphics_pop_context();
+
+    m_backing_store_valid = true;
+}
+
+void View::display_backing_store(const LG::Rect& rect, const LG::Rect& frame)
+{
+    int spread = layer().shading().spread();
+    if (!m_backing_store_valid || m_backing_store.width() != bounds().width() + 2 * spread || m_backing_store.height() != bounds().height() + 2 * spread) {
+        render_backing_store();
+    }
+
+    LG::Context ctx = graphics_current_context();
+    ctx.add_clip(rect);
+    ctx.draw(LG::Point<int>(frame.min_x() - spread, frame.min_y() - spread), m_backing_store);
+}
+
 void View::display(const LG::Rect& rect)
 {
     LG::Context ctx = graphics_current_context();
@@ -259,6 +345,11 @@ void View::receive_display_event(DisplayEvent& event)
     foreach_subview([&](View& subview) -> bool {
         auto bounds = event.bounds();
         if (bounds.intersects(subview.frame())) {
+            if (subview.uses_backing_store()) {
+                subview.display_backing_store(bounds, subview.frame());
+                return true;
+            }
+
             subview.layer().display(bounds, subview.frame());
             graphics_push_context(Context(subview, Context::RelativeToCurrentContext::Yes));
             bounds.offset_by(-subview.frame().origin());
@@ -12,9 +12,20 @@
 #include <libui/Context.h>
 #include <libui/Screen.h>
 #include <libui/Window.h>
+#include <sys/time.h>
+
+// #define DEBUG_STARTUP
+// #define DEBUG_FRAME_TIME
 
 namespace UI {
 
+#ifdef DEBUG_STARTUP
+// Time from the window creation to its first frame, which covers building
+// views and loading their fonts and images.
+static timeval_t s_window_created_at;
+static bool s_first_frame_shown = false;
+#endif
+
 Window::Window(const std::string& title, const LG::Size& size, WindowType type)
 {
     init_window(title, size, "", StatusBarStyle(), type);
@@ -32,6 +43,9 @@ Window::Window(const std::string& title, const LG::Size& size, const std::string
 
 void Window::init_window(const std::string& title, const LG::Size& size, const std::string& icon_path, const StatusBarStyle& style, WindowType type)
 {
+#ifdef DEBUG_STARTUP
+    gettimeofday(&s_window_created_at, nullptr);
+#endif
     m_scale = UI::Screen::main().scale();
     m_bounds = LG::Rect(0, 0, size.width(), size.height());
     m_native_bounds = LG::Rect(0, 0, size.width() * m_scale, size.height() * m_scale);
@@ -146,7 +160,28 @@ void Window::receive_event(std::unique_ptr<LFoundation::Event> event)
                 fill_with_opaque(own_event.bounds());
             }
 
+#ifdef DEBUG_FRAME_TIME
+            timeval_t frame_start;
+            gettimeofday(&frame_start, nullptr);
+#endif
             m_superview->receive_display_event(own_event);
+#ifdef DEBUG_FRAME_TIME
+            // Compare runs with View::set_backing_stores_enabled() on and off
+            // to see what retained views save.
+            timeval_t frame_end;
+            gettimeofday(&frame_end, nullptr);
+            int frame_usec = (frame_end.tv_sec - frame_start.tv_sec) * 1000000 + ((int)frame_end.tv_usec - (int)frame_start.tv_usec);
+            Logger::debug << title() << " :: frame in " << frame_usec << " usec, backing stores " << View::backing_stores_memory() << " bytes" << std::endl;
+#endif
+#ifdef DEBUG_STARTUP
+            if (!s_first_frame_shown) {
+                timeval_t now;
+                gettimeofday(&now, nullptr);
+                int usec = (now.tv_sec - s_window_created_at.tv_sec) * 1000000 + ((int)now.tv_usec - (int)s_window_created_at.tv_usec);
+                Logger::debug << title() << " :: first frame in " << usec << " usec" << std::endl;
+                s_first_frame_shown = true;
+            }
+#endif
         }
         break;
 
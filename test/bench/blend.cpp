@@ -0,0 +1,66 @@
+#include "common.h"
+#include <cstdio>
+#include <libg/Blend.h>
+
+static constexpr int width = 1024;
+static constexpr int height = 768;
+
+static LG::Color* dest;
+static LG::Color* src;
+static uint8_t* mask;
+
+template <typename Callback>
+static void bench_blend_op(const LG::BlendBackend& backend, const char* op, Callback callback)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "BLEND %s %s", op, backend.name);
+
+    RUN_BENCH(name, 3)
+    {
+        for (int y = 0; y < height; y++) {
+            callback(y * width);
+        }
+    }
+}
+
+static void bench_blend_backend(const LG::BlendBackend& backend)
+{
+    auto color = LG::Color(60, 120, 180, 140).premultiplied();
+
+    bench_blend_op(backend, "COPY", [&](int offset) {
+        backend.copy(&dest[offset], &src[offset], width);
+    });
+    bench_blend_op(backend, "FILL", [&](int offset) {
+        backend.fill(&dest[offset], color, width);
+    });
+    bench_blend_op(backend, "SRC-OVER", [&](int offset) {
+        backend.blend(&dest[offset], &src[offset], width);
+    });
+    bench_blend_op(backend, "SRC-OVER COLOR", [&](int offset) {
+        backend.blend_color(&dest[offset], color, width);
+    });
+    bench_blend_op(backend, "GLYPH MASK", [&](int offset) {
+        backend.blend_mask(&dest[offset], color, &mask[offset], width);
+    });
+}
+
+void bench_blend()
+{
+    dest = new LG::Color[width * height];
+    src = new LG::Color[width * height];
+    mask = new uint8_t[width * height];
+    for (int i = 0; i < width * height; i++) {
+        dest[i] = LG::Color(i & 0xff, (i >> 8) & 0xff, (i >> 16) & 0xff);
+        src[i] = LG::Color((i * 7) & 0xff, (i * 13) & 0xff, (i * 29) & 0xff, (i * 3) & 0xff).premultiplied();
+        mask[i] = (i * 5) & 0xff;
+    }
+
+    bench_blend_backend(LG::scalar_blend_backend());
+    if (&LG::blend_backend() != &LG::scalar_blend_backend()) {
+        bench_blend_backend(LG::blend_backend());
+    }
+
+    delete[] dest;
+    delete[] src;
+    delete[] mask;
+}
@@ -18,4 +18,12 @@ static inline int to_usec()
     return sec * 1000000 + diff;
 }
 
-void bench_pngloader();
\ No newline at end of file
+void bench_blend();
+void bench_ipc();
+void bench_json();
+void bench_malloc();
+void bench_pngloader();
+void bench_pty();
+void bench_string();
+void bench_textstorage();
+void bench_time();
\ No newline at end of file
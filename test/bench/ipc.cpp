@@ -0,0 +1,159 @@
+#include "common.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <libipc/DoubleSidedConnection.h>
+#include <libipc/Listener.h>
+#include <opuntia/shared_buffer.h>
+#include <sched.h>
+#include <string>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define IPC_ROUND_TRIPS 2000
+#define IPC_MESSAGES 20000
+#define IPC_BATCH 64
+#define IPC_MESSAGE_SIZE 32
+
+enum BenchMessageType {
+    Ping,
+    Data,
+    Sync,
+    Exit,
+};
+
+static void wait_for_doorbell(LIPC::DoubleSidedConnection& connection, int fd)
+{
+    fd_set_t readfds;
+    FD_ZERO(&readfds);
+    FD_SET(fd, &readfds);
+    select(fd + 1, &readfds, nullptr, nullptr, nullptr);
+    connection.drain_doorbell(fd);
+}
+
+static bool send(LIPC::SharedRing& ring, int type)
+{
+    uint8_t* buf;
+    while (!(buf = ring.reserve(IPC_MESSAGE_SIZE))) {
+        sched_yield();
+    }
+    memset(buf, 0, IPC_MESSAGE_SIZE);
+    *(int*)buf = type;
+    return ring.commit();
+}
+
+static int receive(LIPC::DoubleSidedConnection& connection, LIPC::SharedRing& ring, int fd)
+{
+    size_t len;
+    const uint8_t* record;
+    while (!(record = ring.front(len))) {
+        wait_for_doorbell(connection, fd);
+    }
+    int type = *(const int*)record;
+    ring.pop();
+    return type;
+}
+
+static void peer(LIPC::DoubleSidedConnection connection)
+{
+    int received = 0;
+    for (;;) {
+        switch (receive(connection, connection.c2s_ring(), connection.c2s_fd())) {
+        case Ping:
+            if (send(connection.s2c_ring(), Ping)) {
+                connection.ring_doorbell(connection.s2c_fd());
+            }
+            break;
+        case Data:
+            received++;
+            break;
+        case Sync:
+            if (send(connection.s2c_ring(), received)) {
+                connection.ring_doorbell(connection.s2c_fd());
+            }
+            received = 0;
+            break;
+        case Exit:
+            exit(0);
+        }
+    }
+}
+
+void bench_ipc()
+{
+    uint8_t* shared_memory = nullptr;
+    int shared_buffer_id = shared_buffer_create(&shared_memory, LIPC::DoubleSidedConnection::SharedMemorySize, 0);
+    if (shared_buffer_id < 0) {
+        return;
+    }
+    LIPC::DoubleSidedConnection::init_shared_memory(shared_memory);
+
+    std::string c2s_path = LIPC::Listener::channel_path("/tmp/bench_ipc", getpid(), "c2s");
+    std::string s2c_path = LIPC::Listener::channel_path("/tmp/bench_ipc", getpid(), "s2c");
+    int c2s_fd = socket(PF_LOCAL, 0, 0);
+    int s2c_fd = socket(PF_LOCAL, 0, 0);
+    bind(c2s_fd, c2s_path.c_str(), c2s_path.size() + 1);
+    bind(s2c_fd, s2c_path.c_str(), s2c_path.size() + 1);
+
+    int pid = fork();
+    if (pid < 0) {
+        return;
+    }
+    if (!pid) {
+        uint8_t* peer_memory = nullptr;
+        int peer_c2s_fd = socket(PF_LOCAL, 0, 0);
+        int peer_s2c_fd = socket(PF_LOCAL, 0, 0);
+        if (shared_buffer_get(shared_buffer_id, &peer_memory, 0) < 0
+            || connect(peer_c2s_fd, c2s_path.c_str(), c2s_path.size() + 1) < 0
+            || connect(peer_s2c_fd, s2c_path.c_str(), s2c_path.size() + 1) < 0) {
+            exit(1);
+        }
+        // Data written before the connection is not seen by the peer, so
+        // the parent waits for the ready signal before sending anything.
+        LIPC::DoubleSidedConnection connection(peer_s2c_fd, peer_c2s_fd, shared_buffer_id, peer_memory);
+        connection.ring_doorbell(peer_s2c_fd);
+        peer(connection);
+    }
+
+    LIPC::DoubleSidedConnection connection(s2c_fd, c2s_fd, shared_buffer_id, shared_memory);
+    wait_for_doorbell(connection, s2c_fd);
+
+    // Every message wakes up the other side.
+    RUN_BENCH("IPC ROUND TRIP", 3)
+    {
+        for (int i = 0; i < IPC_ROUND_TRIPS; i++) {
+            if (send(connection.c2s_ring(), Ping)) {
+                connection.ring_doorbell(c2s_fd);
+            }
+            receive(connection, connection.s2c_ring(), s2c_fd);
+        }
+    }
+
+    // Messages are sent in batches, a batch costs a single wakeup.
+    RUN_BENCH("IPC THROUGHPUT", 3)
+    {
+        for (int i = 0; i < IPC_MESSAGES; i += IPC_BATCH) {
+            bool doorbell = false;
+            for (int j = 0; j < IPC_BATCH; j++) {
+                doorbell |= send(connection.c2s_ring(), Data);
+            }
+            if (doorbell) {
+                connection.ring_doorbell(c2s_fd);
+            }
+        }
+        if (send(connection.c2s_ring(), Sync)) {
+            connection.ring_doorbell(c2s_fd);
+        }
+        receive(connection, connection.s2c_ring(), s2c_fd);
+    }
+
+    if (send(connection.c2s_ring(), Exit)) {
+        connection.ring_doorbell(c2s_fd);
+    }
+    wait(pid);
+    close(c2s_fd);
+    close(s2c_fd);
+    shared_buffer_free(shared_buffer_id);
+}
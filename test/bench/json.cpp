@@ -0,0 +1,58 @@
+#include "common.h"
+#include <cstdio>
+#include <libfoundation/FileManager.h>
+#include <libfoundation/json/Parser.h>
+#include <string>
+#include <vector>
+
+#define JSON_BENCH_RUNS 50
+
+// Walks the whole tree, so strings are decoded too.
+static size_t visit(LFoundation::Json::Object* obj)
+{
+    switch (obj->type()) {
+    case LFoundation::Json::Object::Dict: {
+        size_t res = 1;
+        for (auto& entry : *obj->cast_to<LFoundation::Json::DictObject>()) {
+            res += visit(entry.value);
+        }
+        return res;
+    }
+    case LFoundation::Json::Object::List: {
+        size_t res = 1;
+        for (auto* item : *obj->cast_to<LFoundation::Json::ListObject>()) {
+            res += visit(item);
+        }
+        return res;
+    }
+    case LFoundation::Json::Object::String:
+        return 1 + obj->cast_to<LFoundation::Json::StringObject>()->view().size();
+    default:
+        return 1;
+    }
+}
+
+// Parses the configs and bundle manifests installed from base/, the same
+// files ProcessInfo, applist and launch_server read on start.
+void bench_json()
+{
+    std::vector<std::string> files;
+    files.push_back("/System/launch_server_config.json");
+    LFoundation::FileManager().foreach_object("/Applications", [&files](const char* name) {
+        files.push_back(std::string("/Applications/") + name + "/Content/info.json");
+    });
+
+    RUN_BENCH("JSON BUNDLES", 3)
+    {
+        size_t nodes = 0;
+        for (int run = 0; run < JSON_BENCH_RUNS; run++) {
+            for (size_t i = 0; i < files.size(); i++) {
+                auto json_parser = LFoundation::Json::Parser(files[i]);
+                nodes += visit(json_parser.object());
+            }
+        }
+        if (!nodes) {
+            printf("no json\n");
+        }
+    }
+}
@@ -2,6 +2,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <sys/wait.h>
+#include <sysdep.h>
 #include <unistd.h>
 
 char* bench_name;
@@ -27,12 +28,28 @@ void bench_kernel()
             }
         }
     }
+
+    // SYS_RESTART_SYSCALL has an empty handler, so this measures pure entry/exit cost.
+    RUN_BENCH("NULL SYSCALL", 3)
+    {
+        for (int i = 0; i < 10000; i++) {
+            DO_SYSCALL_0(SYS_RESTART_SYSCALL);
+        }
+    }
 }
 
 int main(int argc, char** argv)
 {
     bench_kernel();
+    bench_blend();
+    bench_ipc();
+    bench_json();
+    bench_malloc();
     bench_pngloader();
+    bench_pty();
+    bench_string();
+    bench_textstorage();
+    bench_time();
     printf("[BENCH END]\n\n");
     fflush(stdout);
     return 0;
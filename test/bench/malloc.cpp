@@ -0,0 +1,100 @@
+#include "common.h"
+#include <cstdio>
+#include <cstdlib>
+#include <pthread.h>
+
+#define MALLOC_SLOTS 256
+#define MALLOC_ROUNDS 20000
+#define QUEUE_SIZE 64
+#define QUEUE_ITEMS 20000
+
+static void* slots[MALLOC_SLOTS];
+
+// Cheap LCG, so the same sequence of sizes is used on every run.
+static inline unsigned int next_rand(unsigned int& state)
+{
+    state = state * 1103515245 + 12345;
+    return state >> 8;
+}
+
+static inline size_t mixed_size(unsigned int& state)
+{
+    unsigned int r = next_rand(state);
+    // Mostly small objects, with an occasional large one.
+    if ((r & 63) == 0) {
+        return 16 * 1024 + (r & 0xffff);
+    }
+    return 8 + (r % 512);
+}
+
+struct bench_queue {
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    void* items[QUEUE_SIZE];
+    int head;
+    int count;
+};
+
+static void* consumer(void* arg)
+{
+    bench_queue* queue = (bench_queue*)arg;
+    for (int i = 0; i < QUEUE_ITEMS; i++) {
+        pthread_mutex_lock(&queue->lock);
+        while (!queue->count) {
+            pthread_cond_wait(&queue->not_empty, &queue->lock);
+        }
+        void* item = queue->items[queue->head];
+        queue->head = (queue->head + 1) % QUEUE_SIZE;
+        queue->count--;
+        pthread_cond_signal(&queue->not_full);
+        pthread_mutex_unlock(&queue->lock);
+        free(item);
+    }
+    return nullptr;
+}
+
+void bench_malloc()
+{
+    RUN_BENCH("MALLOC MIXED", 3)
+    {
+        unsigned int state = 1;
+        for (int i = 0; i < MALLOC_ROUNDS; i++) {
+            unsigned int slot = next_rand(state) % MALLOC_SLOTS;
+            free(slots[slot]);
+            slots[slot] = malloc(mixed_size(state));
+        }
+        for (int i = 0; i < MALLOC_SLOTS; i++) {
+            free(slots[i]);
+            slots[i] = nullptr;
+        }
+    }
+
+    // Blocks are allocated by one thread and freed by another one.
+    RUN_BENCH("MALLOC PRODUCER CONSUMER", 3)
+    {
+        bench_queue queue = {};
+        pthread_mutex_init(&queue.lock, nullptr);
+        pthread_cond_init(&queue.not_empty, nullptr);
+        pthread_cond_init(&queue.not_full, nullptr);
+
+        pthread_t consumer_thread;
+        if (pthread_create(&consumer_thread, nullptr, consumer, &queue)) {
+            return;
+        }
+
+        unsigned int state = 1;
+        for (int i = 0; i < QUEUE_ITEMS; i++) {
+            void* item = malloc(mixed_size(state));
+            pthread_mutex_lock(&queue.lock);
+            while (queue.count == QUEUE_SIZE) {
+                pthread_cond_wait(&queue.not_full, &queue.lock);
+            }
+            queue.items[(queue.head + queue.count) % QUEUE_SIZE] = item;
+            queue.count++;
+            pthread_cond_signal(&queue.not_empty);
+            pthread_mutex_unlock(&queue.lock);
+        }
+        pthread_join(consumer_thread, nullptr);
+    }
+}
@@ -0,0 +1,97 @@
+#include "common.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define PTY_FILE_PATH "/tmp/bench_pty.txt"
+#define PTY_FILE_SIZE (10 * 1024 * 1024)
+#define PTY_LINE_SIZE 80
+
+static bool create_text_file()
+{
+    int fd = open(PTY_FILE_PATH, O_CREAT | O_RDWR, 0600);
+    if (fd < 0) {
+        return false;
+    }
+
+    // Lines of text, as a terminal usually gets them.
+    char line[PTY_LINE_SIZE];
+    for (int i = 0; i < PTY_LINE_SIZE - 1; i++) {
+        line[i] = 'a' + (i % 26);
+    }
+    line[PTY_LINE_SIZE - 1] = '\n';
+
+    for (int written = 0; written < PTY_FILE_SIZE; written += PTY_LINE_SIZE) {
+        if (write(fd, line, PTY_LINE_SIZE) != PTY_LINE_SIZE) {
+            close(fd);
+            return false;
+        }
+    }
+    close(fd);
+    return true;
+}
+
+// Runs cat with its output going to a pty and reads the master side the same
+// way the terminal does, with a buffer as large as the pty buffer.
+static void cat_to_pty(char* buf, size_t buf_size)
+{
+    int ptmx = posix_openpt(O_RDONLY);
+    if (ptmx < 0) {
+        return;
+    }
+
+    int pid = fork();
+    if (pid < 0) {
+        return;
+    }
+    if (!pid) {
+        char* pname = ptsname(ptmx);
+        if (!pname) {
+            exit(1);
+        }
+        close(1);
+        open(pname, O_WRONLY);
+        execlp("/bin/cat", "/bin/cat", PTY_FILE_PATH, NULL);
+        exit(1);
+    }
+
+    size_t total = 0;
+    while (total < PTY_FILE_SIZE) {
+        int cnt = read(ptmx, buf, buf_size);
+        if (cnt <= 0) {
+            break;
+        }
+        total += cnt;
+    }
+    wait(pid);
+    close(ptmx);
+}
+
+void bench_pty()
+{
+    if (!create_text_file()) {
+        return;
+    }
+
+    size_t buf_size = 256;
+    int ptmx = posix_openpt(O_RDONLY);
+    if (ptmx >= 0) {
+        stat_t stat;
+        if (fstat(ptmx, &stat) == 0 && stat.st_blksize > buf_size) {
+            buf_size = stat.st_blksize;
+        }
+        close(ptmx);
+    }
+
+    char* buf = (char*)malloc(buf_size);
+    RUN_BENCH("PTY CAT 10MB", 3)
+    {
+        cat_to_pty(buf, buf_size);
+    }
+    free(buf);
+    unlink(PTY_FILE_PATH);
+}
@@ -0,0 +1,84 @@
+#include "common.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define STRING_BENCH_MAX_SIZE (1024 * 1024)
+#define STRING_BENCH_BYTES (4 * 1024 * 1024)
+#define STRING_BENCH_MAX_ITERS (100000)
+
+static const size_t string_bench_sizes[] = { 1, 16, 256, 4096, 65536, STRING_BENCH_MAX_SIZE };
+static const char* string_bench_size_names[] = { "1B", "16B", "256B", "4K", "64K", "1M" };
+
+// Every size moves about the same amount of bytes, capped for the tiny ones.
+static inline int string_bench_iters(size_t size)
+{
+    size_t iters = STRING_BENCH_BYTES / size;
+    return iters > STRING_BENCH_MAX_ITERS ? STRING_BENCH_MAX_ITERS : iters;
+}
+
+void bench_string()
+{
+    char* src = (char*)malloc(STRING_BENCH_MAX_SIZE + 1);
+    char* dst = (char*)malloc(STRING_BENCH_MAX_SIZE + 1);
+    if (!src || !dst) {
+        return;
+    }
+    memset(src, 'a', STRING_BENCH_MAX_SIZE + 1);
+
+    char name[32];
+    for (size_t i = 0; i < sizeof(string_bench_sizes) / sizeof(string_bench_sizes[0]); i++) {
+        size_t size = string_bench_sizes[i];
+        int iters = string_bench_iters(size);
+
+        snprintf(name, sizeof(name), "MEMCPY %s", string_bench_size_names[i]);
+        RUN_BENCH(name, 3)
+        {
+            for (int it = 0; it < iters; it++) {
+                memcpy(dst, src, size);
+            }
+        }
+
+        snprintf(name, sizeof(name), "MEMSET %s", string_bench_size_names[i]);
+        RUN_BENCH(name, 3)
+        {
+            for (int it = 0; it < iters; it++) {
+                memset(dst, it, size);
+            }
+        }
+
+        // Overlapping areas with dest above src take the backward path.
+        snprintf(name, sizeof(name), "MEMMOVE %s", string_bench_size_names[i]);
+        RUN_BENCH(name, 3)
+        {
+            for (int it = 0; it < iters; it++) {
+                memmove(src + 1, src, size);
+            }
+        }
+
+        src[size] = '\0';
+        snprintf(name, sizeof(name), "STRLEN %s", string_bench_size_names[i]);
+        RUN_BENCH(name, 3)
+        {
+            for (int it = 0; it < iters; it++) {
+                if (strlen(src) != size) {
+                    return;
+                }
+            }
+        }
+
+        snprintf(name, sizeof(name), "MEMCHR %s", string_bench_size_names[i]);
+        RUN_BENCH(name, 3)
+        {
+            for (int it = 0; it < iters; it++) {
+                if (memchr(src, 'b', size)) {
+                    return;
+                }
+            }
+        }
+        src[size] = 'a';
+    }
+
+    free(src);
+    free(dst);
+}
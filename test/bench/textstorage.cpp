@@ -0,0 +1,82 @@
+#include "common.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <libui/TextStorage.h>
+
+#define TEXT_BENCH_SIZE (4 * 1024 * 1024)
+#define TEXT_BENCH_LINE_SIZE 64
+#define TEXT_BENCH_KEYS 256
+#define TEXT_BENCH_LOOKUPS 20000
+
+static char* create_text()
+{
+    char* text = (char*)malloc(TEXT_BENCH_SIZE);
+    if (!text) {
+        return nullptr;
+    }
+    for (int i = 0; i < TEXT_BENCH_SIZE; i++) {
+        text[i] = (i % TEXT_BENCH_LINE_SIZE) == TEXT_BENCH_LINE_SIZE - 1 ? '\n' : 'a' + (i % 26);
+    }
+    return text;
+}
+
+// Keys typed at the top of the file, with a line break now and then, the
+// way an editor inserts them.
+static inline char key_at(int i)
+{
+    return (i % 40) == 39 ? '\n' : 'x';
+}
+
+void bench_textstorage()
+{
+    char* text = create_text();
+    if (!text) {
+        return;
+    }
+
+    UI::TextStorage storage;
+    RUN_BENCH("TEXT LOAD 4MB", 3)
+    {
+        storage.set_text(text, TEXT_BENCH_SIZE);
+    }
+
+    int typed = 0;
+    RUN_BENCH("TEXT TYPE 4MB", 3)
+    {
+        for (int i = 0; i < TEXT_BENCH_KEYS; i++, typed++) {
+            char key = key_at(typed);
+            storage.insert(1000 + typed, &key, 1);
+        }
+    }
+
+    // What a flat buffer costs, every key moves the rest of the text.
+    char* flat = (char*)malloc(TEXT_BENCH_SIZE + 3 * TEXT_BENCH_KEYS);
+    if (flat) {
+        memcpy(flat, text, TEXT_BENCH_SIZE);
+        size_t len = TEXT_BENCH_SIZE;
+        typed = 0;
+        RUN_BENCH("TEXT TYPE 4MB FLAT", 3)
+        {
+            for (int i = 0; i < TEXT_BENCH_KEYS; i++, typed++, len++) {
+                memmove(flat + 1000 + typed + 1, flat + 1000 + typed, len - 1000 - typed);
+                flat[1000 + typed] = key_at(typed);
+            }
+        }
+        free(flat);
+    }
+
+    RUN_BENCH("TEXT LINE LOOKUP 4MB", 3)
+    {
+        size_t sum = 0;
+        for (int i = 0; i < TEXT_BENCH_LOOKUPS; i++) {
+            size_t line = storage.line_of((i * 7919) % storage.size());
+            sum += storage.line_start(line) + storage.line_length(line);
+        }
+        if (!sum) {
+            printf("no lines\n");
+        }
+    }
+
+    free(text);
+}
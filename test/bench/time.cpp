@@ -0,0 +1,25 @@
+#include "common.h"
+#include <cstdio>
+#include <ctime>
+#include <sysdep.h>
+
+#define CLOCK_CALLS 10000
+
+void bench_time()
+{
+    timespec_t ts;
+    RUN_BENCH("CLOCK_GETTIME", 3)
+    {
+        for (int i = 0; i < CLOCK_CALLS; i++) {
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+        }
+    }
+
+    // The same amount of calls going through the trap, to compare with the vdso path.
+    RUN_BENCH("CLOCK_GETTIME SYSCALL", 3)
+    {
+        for (int i = 0; i < CLOCK_CALLS; i++) {
+            DO_SYSCALL_2(SYS_CLOCK_GETTIME, CLOCK_MONOTONIC, &ts);
+        }
+    }
+}
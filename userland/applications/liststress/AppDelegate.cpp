@@ -0,0 +1,23 @@
+#include "ViewController.h"
+#include <libui/AppDelegate.h>
+
+class AppDelegate : public UI::AppDelegate {
+public:
+    AppDelegate() = default;
+    virtual ~AppDelegate() = default;
+
+    LG::Size preferred_desktop_window_size() const override { return LG::Size(240, 320); }
+    const char* icon_path() const override { return "/res/icons/apps/about.icon"; }
+
+    virtual bool application() override
+    {
+        auto style = StatusBarStyle(LG::Color::LightSystemBackground);
+        auto& window = std::opuntiaos::construct<UI::Window>("List Stress", window_size(), icon_path(), style);
+        window.create_superview<UI::View, ViewController>();
+        return true;
+    }
+
+private:
+};
+
+SET_APP_DELEGATE(AppDelegate);
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2020-2022 The opuntiaOS Project Authors.
+ *  + Contributed by Nikita Melekhin <nimelehin@gmail.com>
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#pragma once
+#include <libfoundation/EventLoop.h>
+#include <libfoundation/Logger.h>
+#include <libui/App.h>
+#include <libui/CollectionView.h>
+#include <libui/Label.h>
+#include <libui/View.h>
+#include <libui/ViewController.h>
+#include <libui/Window.h>
+#include <string>
+#include <sys/time.h>
+
+// Scrolls a collection view of 100k rows from top to bottom a page per
+// frame and logs how long it took and how many views were alive.
+class ViewController : public UI::ViewController<UI::View> {
+public:
+    static constexpr size_t RowCount = 100000;
+    static constexpr int RowHeight = 24;
+
+    ViewController(UI::View& view)
+        : UI::ViewController<UI::View>(view)
+    {
+    }
+    virtual ~ViewController() = default;
+
+    void view_did_load() override
+    {
+        view().set_background_color(LG::Color::LightSystemBackground);
+
+        auto& collection_view = view().add_subview<UI::CollectionView>(view().bounds());
+        collection_view.set_data_source(UI::CollectionViewDataSource {
+            .number_of_rows = []() -> size_t { return RowCount; },
+            .view_for_row = [this](size_t row) -> UI::View* { return this->view_for_row(row); },
+            .estimated_row_height = [](size_t) -> size_t { return RowHeight; },
+        });
+        m_collection_view = &collection_view;
+
+        gettimeofday(&m_started_at, nullptr);
+        rearm_scroll();
+    }
+
+private:
+    UI::View* view_for_row(size_t row)
+    {
+        auto& label = m_collection_view->dequeue_reusable_view<UI::Label>(0, LG::Rect(UI::SafeArea::Left, 0, view().bounds().width() - 2 * UI::SafeArea::Left, RowHeight));
+        label.set_text_color(LG::Color::DarkSystemText);
+        label.set_text(std::string("Row ") + std::to_string((int)row));
+        m_views_for_rows++;
+        return &label;
+    }
+
+    void rearm_scroll()
+    {
+        LFoundation::EventLoop::the().add(LFoundation::Timer([this] {
+            auto& collection_view = *m_collection_view;
+            int max_offset = (int)collection_view.content_size().height() - (int)collection_view.bounds().height();
+            if (collection_view.content_offset().y() >= max_offset) {
+                log_result();
+                return;
+            }
+
+            collection_view.scroll_by(0, collection_view.bounds().height());
+            this->rearm_scroll();
+        },
+            1000 / 60));
+    }
+
+    void log_result()
+    {
+        timeval_t now;
+        gettimeofday(&now, nullptr);
+        int msec = (now.tv_sec - m_started_at.tv_sec) * 1000 + ((int)now.tv_usec - (int)m_started_at.tv_usec) / 1000;
+        Logger::debug << "List Stress :: " << RowCount << " rows in " << msec << " msec, " << m_views_for_rows << " rows shown, " << m_collection_view->subviews().size() << " views alive" << std::endl;
+    }
+
+    UI::CollectionView* m_collection_view {};
+    size_t m_views_for_rows { 0 };
+    timeval_t m_started_at;
+};
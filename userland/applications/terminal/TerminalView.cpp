@@ -1,5 +1,6 @@
 #include "TerminalView.h"
 #include <algorithm>
+#include <cstring>
 #include <libfoundation/EventLoop.h>
 #include <libfoundation/KeyboardMapping.h>
 #include <libg/Color.h>
@@ -20,6 +21,7 @@ TerminalView::TerminalView(UI::View* superview, UI::Window* window, const LG::Re
     LFoundation::EventLoop::the().add(LFoundation::Timer([this] {
         this->m_cursor_visible = !this->m_cursor_visible;
         this->invalidate_cursor_glyph();
+        this->flush();
     },
         400, LFoundation::Timer::Repeat));
 }
@@ -28,13 +30,82 @@ void TerminalView::recalc_dimensions(const LG::Rect& frame)
 {
     m_max_rows = (frame.height() - padding() - UI::SafeArea::Bottom) / glyph_height();
     m_max_cols = (frame.width() - 2 * padding()) / glyph_width();
+    m_ring_rows = m_max_rows + ScrollbackLines;
     // FIXME: Add copy and resize on window resize.
-    char* new_data = (char*)malloc(m_max_rows * m_max_cols);
-    memset(new_data, 0, m_max_rows * m_max_cols);
-    if (m_display_data) {
-        free(m_display_data);
+    char* new_data = (char*)malloc(m_ring_rows * m_max_cols);
+    memset(new_data, 0, m_ring_rows * m_max_cols);
+    if (m_lines) {
+        free(m_lines);
     }
-    m_display_data = new_data;
+    m_lines = new_data;
+    m_top_line = 0;
+    m_history_lines = 0;
+    m_scrollback_offset = 0;
+
+    m_dirty_spans.resize(m_max_rows);
+    mark_all_dirty();
+}
+
+void TerminalView::mark_dirty(size_t row, size_t begin_col, size_t end_col)
+{
+    end_col = std::min(end_col, m_max_cols);
+    if (row >= m_max_rows || begin_col >= end_col) {
+        return;
+    }
+
+    auto& span = m_dirty_spans[row];
+    if (span.begin < span.end) {
+        span.begin = std::min(span.begin, begin_col);
+        span.end = std::max(span.end, end_col);
+    } else {
+        span.begin = begin_col;
+        span.end = end_col;
+    }
+    m_has_dirty_cells = true;
+}
+
+void TerminalView::mark_all_dirty()
+{
+    for (auto& span : m_dirty_spans) {
+        span.begin = 0;
+        span.end = m_max_cols;
+    }
+    m_has_dirty_cells = true;
+}
+
+void TerminalView::flush()
+{
+    if (!m_has_dirty_cells) {
+        return;
+    }
+
+    // Each rect is a display pass of its own, so runs of dirty rows are
+    // merged, which makes a scrolled screen a single rect.
+    size_t run_start = 0;
+    DirtySpan run { 0, 0 };
+    for (size_t row = 0; row <= m_max_rows; row++) {
+        bool dirty = row < m_max_rows && m_dirty_spans[row].begin < m_dirty_spans[row].end;
+        if (dirty && run.begin < run.end) {
+            run.begin = std::min(run.begin, m_dirty_spans[row].begin);
+            run.end = std::max(run.end, m_dirty_spans[row].end);
+            continue;
+        }
+
+        if (run.begin < run.end) {
+            set_needs_display(LG::Rect(padding() + run.begin * glyph_width(), padding() + run_start * glyph_height(), (run.end - run.begin) * glyph_width(), (row - run_start) * glyph_height()));
+            run.begin = run.end = 0;
+        }
+        if (dirty) {
+            run_start = row;
+            run = m_dirty_spans[row];
+        }
+    }
+
+    for (auto& span : m_dirty_spans) {
+        span.begin = span.end = 0;
+    }
+    m_has_dirty_cells = false;
+    m_lines_scrolled = 0;
 }
 
 void TerminalView::display(const LG::Rect& rect)
@@ -43,39 +114,77 @@ void TerminalView::display(const LG::Rect& rect)
     ctx.add_clip(rect);
 
     ctx.set_fill_color(background_color());
-    ctx.fill(bounds());
+    ctx.fill(rect);
 
-    ctx.set_fill_color(cursor_color());
-    auto cursor_left_corner = pos_on_screen();
-    ctx.fill(LG::Rect(cursor_left_corner.x(), cursor_left_corner.y(), cursor_width(), glyph_height()));
+    // Only cells which intersect the rect are drawn.
+    int first_row = std::max(0, (rect.min_y() - padding()) / glyph_height());
+    int last_row = std::min((int)m_max_rows, (rect.max_y() - padding()) / glyph_height() + 1);
+    int first_col = std::max(0, (rect.min_x() - padding()) / glyph_width());
+    int last_col = std::min((int)m_max_cols, (rect.max_x() - padding()) / glyph_width() + 1);
+
+    if (!m_scrollback_offset) {
+        auto cursor_left_corner = pos_on_screen();
+        auto cursor_rect = LG::Rect(cursor_left_corner.x(), cursor_left_corner.y(), cursor_width(), glyph_height());
+        if (cursor_rect.intersects(rect)) {
+            ctx.set_fill_color(cursor_color());
+            ctx.fill(cursor_rect);
+        }
+    }
 
     auto& f = font();
     ctx.set_fill_color(font_color());
-    LG::Point<int> text_start { padding(), padding() };
-
-    for (int i = 0; i < m_max_rows; i++) {
-        for (int j = 0; j < m_max_cols; j++) {
-            int idx = i * m_max_cols + j;
-            ctx.draw(text_start, f.glyph(m_display_data[idx]));
+    for (int i = first_row; i < last_row; i++) {
+        const char* data = visible_line(i);
+        LG::Point<int> text_start { padding() + first_col * glyph_width(), padding() + i * glyph_height() };
+        for (int j = first_col; j < last_col; j++) {
+            if (data[j]) {
+                ctx.draw(text_start, f.glyph(data[j]));
+            }
             text_start.offset_by(glyph_width(), 0);
         }
-        text_start.set_x(padding());
-        text_start.offset_by(0, glyph_height());
+    }
+}
+
+UI::View::WheelEventResponse TerminalView::mouse_wheel_event(int wheel_data)
+{
+    const size_t lines_per_wheel = 3;
+    size_t offset = m_scrollback_offset;
+    if (wheel_data < 0) {
+        offset = std::min(offset + lines_per_wheel, m_history_lines);
+    } else {
+        offset = offset > lines_per_wheel ? offset - lines_per_wheel : 0;
+    }
+
+    if (offset != m_scrollback_offset) {
+        m_scrollback_offset = offset;
+        mark_all_dirty();
+        flush();
+    }
+    return UI::View::WheelEventResponse::Handled;
+}
+
+void TerminalView::scroll_to_bottom()
+{
+    if (m_scrollback_offset) {
+        m_scrollback_offset = 0;
+        mark_all_dirty();
     }
 }
 
 void TerminalView::scroll_line()
 {
     data_do_new_line();
-    set_needs_display();
 }
 
 void TerminalView::data_do_new_line()
 {
-    char* data_plus_line = m_display_data + (m_max_cols);
-    char* data_end_minus_line = m_display_data + (m_max_rows - 1) * m_max_cols;
-    memmove(m_display_data, data_plus_line, (m_max_rows - 1) * m_max_cols);
-    memset(data_end_minus_line, 0, m_max_cols);
+    // The first line of the screen goes to the scrollback, and the oldest
+    // line of the scrollback becomes the new last line.
+    m_top_line = (m_top_line + 1) % m_ring_rows;
+    memset(line(m_max_rows - 1), 0, m_max_cols);
+    m_history_lines = std::min(m_history_lines + 1, ScrollbackLines);
+    m_lines_scrolled++;
+    mark_all_dirty();
 }
 
 WindowStatus TerminalView::cursor_positions_do_new_line()
@@ -143,9 +252,7 @@ void TerminalView::decrement_counter()
 
 void TerminalView::put_char(char c)
 {
-    auto pt = pos_on_screen();
-    set_needs_display(LG::Rect(pt.x(), pt.y(), glyph_width(), glyph_height()));
-    m_display_data[pos_in_data()] = c;
+    data_set_char(c);
 }
 
 void TerminalView::push_back_char(char c)
@@ -158,45 +265,41 @@ void TerminalView::push_back_char(char c)
     increment_counter();
 }
 
-void TerminalView::put_text(const std::string& data)
+void TerminalView::put_text(const char* data, size_t len)
 {
-    auto current_pos = pos_on_screen();
-    LG::Point<int> top_left_update_location { current_pos.x(), current_pos.y() };
-    LG::Point<int> bottom_right_update_location { current_pos.x(), current_pos.y() };
-    auto set_to_redraw_full_screen = [&]() {
-        data_do_new_line();
-        top_left_update_location = { bounds().min_x(), bounds().min_y() };
-        bottom_right_update_location = { bounds().max_x(), bounds().max_y() };
-    };
-
+    scroll_to_bottom();
     will_move_cursor();
-    int n = data.size();
-    for (int i = 0; i < n; i++) {
-        char c = data[i];
-        if (c == '\n') {
-            auto status = cursor_positions_do_new_line();
-            if (status == DoNewLine) {
-                set_to_redraw_full_screen();
-            }
-        } else {
-            auto pt = pos_on_screen();
-            data_set_char(c);
-            auto status = cursor_position_move_right();
-            if (status == DoNewLine) {
-                set_to_redraw_full_screen();
-            } else {
-                top_left_update_location.set_x(std::min(top_left_update_location.x(), pt.x()));
-                top_left_update_location.set_y(std::min(top_left_update_location.y(), pt.y()));
-                bottom_right_update_location.set_x(std::max(bottom_right_update_location.x(), pt.x() + glyph_width()));
-                bottom_right_update_location.set_y(std::max(bottom_right_update_location.y(), pt.y() + glyph_height()));
+    size_t i = 0;
+    while (i < len) {
+        if (data[i] == '\n') {
+            if (cursor_positions_do_new_line() == DoNewLine) {
+                data_do_new_line();
             }
+            i++;
+            continue;
         }
-    }
 
-    auto w = bottom_right_update_location.x() - top_left_update_location.x() + 1;
-    auto h = bottom_right_update_location.y() - top_left_update_location.y() + 1;
-    set_needs_display(LG::Rect(top_left_update_location.x(), top_left_update_location.y(), w, h));
+        // Text up to the end of the row or a new line is copied at once.
+        size_t run = std::min(len - i, m_max_cols - m_col);
+        auto* newline = (const char*)memchr(data + i, '\n', run);
+        if (newline) {
+            run = newline - (data + i);
+        }
+        memcpy(line(m_row) + m_col, data + i, run);
+        mark_dirty(m_row, m_col, m_col + run);
+        m_col += run;
+        i += run;
+
+        if (m_col == m_max_cols && cursor_positions_do_new_line() == DoNewLine) {
+            data_do_new_line();
+        }
+    }
     did_move_cursor();
+
+    // A long burst is still shown once per screen of text.
+    if (m_lines_scrolled >= m_max_rows) {
+        flush();
+    }
 }
 
 void TerminalView::send_input()
@@ -211,6 +314,7 @@ void TerminalView::receive_keyup_event(UI::KeyUpEvent&)
 
 void TerminalView::receive_keydown_event(UI::KeyDownEvent& event)
 {
+    scroll_to_bottom();
     // FIXME: More symbols and static size of font
     if (event.key() == LFoundation::Keycode::KEY_BACKSPACE) {
         if (m_input.size()) {
@@ -226,4 +330,5 @@ void TerminalView::receive_keydown_event(UI::KeyDownEvent& event)
         m_input.push_back(char(event.key()));
         push_back_char(char(event.key()));
     }
+    flush();
 }
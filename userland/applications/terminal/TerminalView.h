@@ -2,6 +2,7 @@
 #include <libg/Font.h>
 #include <libui/View.h>
 #include <string>
+#include <vector>
 
 enum WindowStatus {
     Normal,
@@ -24,12 +25,21 @@ public:
     inline int glyph_height() const { return font().size() + 2; }
 
     inline LG::Point<int> pos_on_screen() const { return { (int)m_col * glyph_width() + padding(), (int)m_row * glyph_height() + padding() }; }
-    inline int pos_in_data() const { return m_max_cols * m_row + m_col; }
+
+    // Lines which are kept above the screen and could be scrolled back to.
+    static constexpr size_t ScrollbackLines = 500;
 
     void put_char(char c);
-    void put_text(const std::string& data);
+
+    // Text is only stored and its cells are marked dirty, flush() asks to
+    // repaint them. Output of a program comes in bursts, so the screen is
+    // flushed once the burst is read rather than after every piece of it.
+    void put_text(const char* data, size_t len);
+    inline void put_text(const std::string& data) { put_text(data.data(), data.size()); }
+    void flush();
 
     void display(const LG::Rect& rect) override;
+    WheelEventResponse mouse_wheel_event(int wheel_data) override;
     void receive_keyup_event(UI::KeyUpEvent&) override;
     void receive_keydown_event(UI::KeyDownEvent&) override;
 
@@ -44,9 +54,19 @@ private:
     void data_do_new_line();
     inline void data_set_char(char c)
     {
-        m_display_data[pos_in_data()] = c;
+        line(m_row)[m_col] = c;
+        mark_dirty(m_row, m_col, m_col + 1);
     }
 
+    // Lines are stored in a ring, so scrolling moves the first line of the
+    // screen instead of the data.
+    inline char* line(size_t row) const { return m_lines + ((m_top_line + row) % m_ring_rows) * m_max_cols; }
+    inline const char* visible_line(size_t row) const { return line(m_ring_rows - m_scrollback_offset + row); }
+
+    void mark_dirty(size_t row, size_t begin_col, size_t end_col);
+    void mark_all_dirty();
+    void scroll_to_bottom();
+
     void scroll_line();
     void new_line();
     void increment_counter();
@@ -56,11 +76,8 @@ private:
     void push_back_char(char c);
     void send_input();
 
-    inline void invalidate_cursor_glyph()
-    {
-        auto pt = pos_on_screen();
-        set_needs_display(LG::Rect(pt.x(), pt.y(), cursor_width() + spacing(), glyph_height()));
-    }
+    // The cursor is wider than a glyph, so it covers the next cell too.
+    inline void invalidate_cursor_glyph() { mark_dirty(m_row, m_col, m_col + 2); }
     inline void will_move_cursor() { invalidate_cursor_glyph(); }
     inline void did_move_cursor() { invalidate_cursor_glyph(); }
 
@@ -80,5 +97,19 @@ private:
     size_t m_max_rows { 0 };
     size_t m_col { 0 };
     size_t m_row { 0 };
-    char* m_display_data { nullptr };
+
+    size_t m_ring_rows { 0 };
+    size_t m_top_line { 0 };
+    size_t m_history_lines { 0 };
+    size_t m_scrollback_offset { 0 };
+    size_t m_lines_scrolled { 0 };
+    char* m_lines { nullptr };
+
+    // Dirty cells of a screen row are kept as a span of columns.
+    struct DirtySpan {
+        size_t begin;
+        size_t end;
+    };
+    std::vector<DirtySpan> m_dirty_spans;
+    bool m_has_dirty_cells { false };
 };
\ No newline at end of file
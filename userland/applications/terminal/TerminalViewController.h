@@ -10,8 +10,10 @@
 #include "TerminalView.h"
 #include <libui/ViewController.h>
 #include <memory>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <vector>
 
 class TerminalViewController : public UI::ViewController<TerminalView> {
 public:
@@ -23,12 +25,28 @@ public:
 
     void init_listners()
     {
+        // The buffer matches the one of the pty, so a read drains all the
+        // output which is ready.
+        stat_t stat;
+        size_t buffer_size = 256;
+        if (fstat(view().ptmx(), &stat) == 0 && stat.st_blksize > buffer_size) {
+            buffer_size = stat.st_blksize;
+        }
+        m_read_buffer.resize(buffer_size);
+
         LFoundation::EventLoop::the().add(
             view().ptmx(), [this] {
-                char text[256];
-                int cnt = read(view().ptmx(), text, 255);
-                text[cnt] = '\0';
-                view().put_text(std::string(text, cnt));
+                int cnt = read(view().ptmx(), m_read_buffer.data(), m_read_buffer.size());
+                if (cnt <= 0) {
+                    return;
+                }
+                view().put_text(m_read_buffer.data(), cnt);
+
+                // A short read means the burst is over, otherwise more output
+                // is waiting and the screen is repainted after it.
+                if (cnt < m_read_buffer.size()) {
+                    view().flush();
+                }
             },
             nullptr);
     }
@@ -39,4 +57,5 @@ public:
     }
 
 private:
+    std::vector<char> m_read_buffer;
 };
\ No newline at end of file
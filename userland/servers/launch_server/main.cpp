@@ -12,9 +12,9 @@ void load_from_file(LaunchServer::LaunchWatchdog& launch_watchdog)
     }
 
     auto* jdict_root = jobj_root->cast_to<LFoundation::Json::DictObject>();
-    auto* jlaunch_list = jdict_root->data()["launch"]->cast_to<LFoundation::Json::ListObject>();
-    for (auto* jobj : jlaunch_list->data()) {
-        const std::string& strdata = jobj->cast_to<LFoundation::Json::StringObject>()->data();
+    auto* jlaunch_list = jdict_root->get("launch")->cast_to<LFoundation::Json::ListObject>();
+    for (auto* jobj : *jlaunch_list) {
+        std::string strdata = jobj->cast_to<LFoundation::Json::StringObject>()->to_string();
         launch_watchdog.add(LaunchServer::Exec(strdata, LaunchServer::Exec::Flags::RestartOnFail));
     }
 }
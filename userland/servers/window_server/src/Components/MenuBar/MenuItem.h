@@ -28,7 +28,7 @@ public:
 
     ~MenuDir() = default;
 
-    inline void set_font(LG::Font& f) { m_font = f; }
+    inline void set_font(const LG::Font& f) { m_font = &f; }
     inline void add_item(PopupItem&& item) { m_items.push_back(std::move(item)); }
     inline void add_item(const PopupItem& item) { m_items.push_back(item); }
 
@@ -39,12 +39,12 @@ public:
     inline const PopupData& items() const { return m_items; }
     inline PopupData& items() { return m_items; }
 
-    inline size_t width() const { return Helpers::text_width(m_title, m_font); }
+    inline size_t width() const { return Helpers::text_width(m_title, *m_font); }
 
     [[gnu::always_inline]] inline void draw(LG::Context& ctx)
     {
         ctx.set_fill_color(LG::Color::Black);
-        Helpers::draw_text(ctx, { 0, 6 }, m_title, m_font);
+        Helpers::draw_text(ctx, { 0, 6 }, m_title, *m_font);
     }
 
     inline MenuItemAnswer mouse_down(int x, int y)
@@ -62,7 +62,7 @@ private:
     int m_id { -1 };
     bool m_active { false };
     std::string m_title;
-    LG::Font& m_font { LG::Font::system_font() };
+    const LG::Font* m_font { &LG::Font::system_font() };
     PopupData m_items;
 };
 
@@ -13,6 +13,7 @@
 #include <sys/ioctl.h>
 #include <sys/mman.h>
 #include <utility>
+#include <vector>
 
 namespace WinServer {
 
@@ -40,11 +41,76 @@ Screen::Screen()
     m_active_buffer = 0;
 }
 
-void Screen::swap_buffers()
+void Screen::swap_buffers(const LG::Region& damage)
 {
     m_write_bitmap_ptr.swap(m_display_bitmap_ptr);
     m_active_buffer ^= 1;
+    for (int i = 0; i < BufferCount; i++) {
+        if (m_buffer_age[i]) {
+            m_buffer_age[i]++;
+        }
+    }
+    m_buffer_age[m_active_buffer] = 1;
+    present(damage);
+}
+
+void Screen::flush_display_buffer(const LG::Region& damage)
+{
+    present(damage);
+}
+
+void Screen::present(const LG::Region& damage)
+{
+    // Drivers which can send only the changed rects to the display take
+    // them, others show the whole buffer.
+    if (m_damaged_swap_supported) {
+        bga_swap_damaged_t swap;
+        swap.buffer = m_active_buffer;
+        swap.rects_count = 0;
+        if (damage.rect_count() > BGA_MAX_DAMAGED_RECTS) {
+            auto bounds = damage.bounds();
+            swap.rects[swap.rects_count++] = { (uint32_t)bounds.min_x(), (uint32_t)bounds.min_y(), (uint32_t)bounds.width(), (uint32_t)bounds.height() };
+        } else {
+            damage.for_each_rect([&](const LG::Rect& rect) {
+                swap.rects[swap.rects_count++] = { (uint32_t)rect.min_x(), (uint32_t)rect.min_y(), (uint32_t)rect.width(), (uint32_t)rect.height() };
+            });
+        }
+
+        if (ioctl(m_screen_fd, BGA_SWAP_BUFFERS_DAMAGED, (uintptr_t)&swap) == 0) {
+            return;
+        }
+        m_damaged_swap_supported = false;
+    }
     ioctl(m_screen_fd, BGA_SWAP_BUFFERS, m_active_buffer);
 }
 
+bool Screen::set_cursor(const LG::PixelBitmap& bitmap, int hot_x, int hot_y)
+{
+    bga_cursor_t cursor;
+    cursor.width = bitmap.width();
+    cursor.height = bitmap.height();
+    cursor.hot_x = hot_x;
+    cursor.hot_y = hot_y;
+
+    // Bitmaps keep premultiplied colors with opacity, while the device
+    // expects straight alpha, so the image is converted on its way out.
+    size_t count = bitmap.width() * bitmap.height();
+    std::vector<uint32_t> pixels;
+    pixels.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        auto color = bitmap.data()[i].unpremultiplied();
+        pixels[i] = (color.u32() & 0x00ffffff) | ((uint32_t)color.alpha() << 24);
+    }
+    cursor.pixels = pixels.data();
+    return ioctl(m_screen_fd, BGA_SET_CURSOR, (uintptr_t)&cursor) == 0;
+}
+
+bool Screen::move_cursor(int x, int y)
+{
+    bga_cursor_pos_t pos;
+    pos.x = x;
+    pos.y = y;
+    return ioctl(m_screen_fd, BGA_MOVE_CURSOR, (uintptr_t)&pos) == 0;
+}
+
 } // namespace WinServer
@@ -9,6 +9,7 @@
 #pragma once
 #include <libg/Color.h>
 #include <libg/PixelBitmap.h>
+#include <libg/Region.h>
 #include <memory>
 
 namespace WinServer {
@@ -21,9 +22,22 @@ public:
         return *s_WinServer_Screen_the;
     }
 
+    static constexpr int BufferCount = 2;
+
     Screen();
 
-    void swap_buffers();
+    // Shows the write buffer, damage is the part of it which was redrawn.
+    void swap_buffers(const LG::Region& damage);
+    // Sends changes made right in the display buffer to the display.
+    void flush_display_buffer(const LG::Region& damage);
+
+    // Cursor plane of the display, if the driver has one.
+    bool set_cursor(const LG::PixelBitmap& bitmap, int hot_x, int hot_y);
+    bool move_cursor(int x, int y);
+
+    // Number of frames since the write buffer was shown, 0 if its content
+    // is undefined. The write buffer lacks changes of the last age-1 frames.
+    inline int write_buffer_age() const { return m_buffer_age[m_active_buffer ^ 1]; }
 
     inline size_t width() { return m_bounds.width(); }
     inline size_t height() const { return m_bounds.height(); }
@@ -37,11 +51,15 @@ public:
     inline const LG::PixelBitmap& display_bitmap() const { return *m_display_bitmap_ptr; }
 
 private:
+    void present(const LG::Region& damage);
+
     int m_screen_fd;
     LG::Rect m_bounds;
     uint32_t m_depth;
 
     int m_active_buffer;
+    int m_buffer_age[BufferCount] {};
+    bool m_damaged_swap_supported { true };
 
     LG::PixelBitmap m_write_bitmap;
     LG::PixelBitmap m_display_bitmap;
@@ -7,37 +7,165 @@
  */
 
 #include "Connection.h"
+#include "../Managers/WindowManager.h"
 #include "Event.h"
 #include <libfoundation/EventLoop.h>
-#include <sys/socket.h>
+#include <libfoundation/Logger.h>
+#include <signal.h>
 
-#define WINSERVER_REQUEST_SOCKET_PATH "/tmp/winserver_requests.sock"
-#define WINSERVER_REQUEST_SOCKET_PATH_SIZE sizeof(WINSERVER_REQUEST_SOCKET_PATH)
+#define WINSERVER_LISTENER_SOCKET_PATH "/tmp/winserver.sock"
 
-#define WINSERVER_RESPONSE_SOCKET_PATH "/tmp/winserver_response.sock"
-#define WINSERVER_RESPONSE_SOCKET_PATH_SIZE sizeof(WINSERVER_RESPONSE_SOCKET_PATH)
+// #define DEBUG_CONNECTION
 
 namespace WinServer {
 
 Connection* s_WinServer_Connection_the = nullptr;
 
 Connection::Connection()
-    : m_connection(LIPC::DoubleSidedConnection(socket(PF_LOCAL, 0, 0), socket(PF_LOCAL, 0, 0)))
+    : m_listener(WINSERVER_LISTENER_SOCKET_PATH)
     , m_server_decoder()
     , m_client_decoder()
-    , m_connection_with_clients(m_connection, m_server_decoder, m_client_decoder)
 {
     s_WinServer_Connection_the = this;
-    int err1 = bind(m_connection.c2s_fd(), WINSERVER_REQUEST_SOCKET_PATH, WINSERVER_REQUEST_SOCKET_PATH_SIZE);
-    int err2 = bind(m_connection.s2c_fd(), WINSERVER_RESPONSE_SOCKET_PATH, WINSERVER_RESPONSE_SOCKET_PATH_SIZE);
+    m_clients.push_back(Client { 0, nullptr }); // Connection ids start from 1.
+    if (m_listener.is_valid()) {
+        LFoundation::EventLoop::the().add(
+            m_listener.fd(), [] {
+                Connection::the().accept_clients();
+            },
+            nullptr);
+    }
+    LFoundation::EventLoop::the().add(LFoundation::Timer([] {
+        Connection::the().disconnect_dead_clients();
+    },
+        1000, LFoundation::Timer::Repeat));
+}
+
+void Connection::accept_clients()
+{
+    m_listener.accept_pending([this](const LIPC::Listener::Announce& announce) {
+        auto channel = m_listener.accept(announce);
+        if (!channel.is_valid()) {
+            Logger::debug << "WinServer: can't accept client " << announce.pid << std::endl;
+            return;
+        }
 
-    if (!err1 && !err2) {
+        int connection_id = ++m_connections_number;
+        m_clients.push_back(Client { announce.pid, std::make_unique<ClientConnection>(channel, m_server_decoder, m_client_decoder) });
         LFoundation::EventLoop::the().add(
-            m_connection.c2s_fd(), [] {
-                Connection::the().listen();
+            channel.c2s_fd(), [connection_id] {
+                Connection::the().listen(connection_id);
             },
             nullptr);
+#ifdef DEBUG_CONNECTION
+        Logger::debug << "WinServer: accepted " << announce.pid << " as " << connection_id << std::endl;
+#endif
+    });
+}
+
+void Connection::listen(int connection_id)
+{
+    auto* connection = client(connection_id);
+    if (!connection) {
+        return;
+    }
+
+    m_serving_connection_id = connection_id;
+    m_serving_connection_rejected = false;
+    connection->pump_messages();
+    m_serving_connection_id = -1;
+
+    if (connection->is_broken() || m_serving_connection_rejected) {
+        disconnect(connection_id);
+    }
+}
+
+void Connection::disconnect(int connection_id)
+{
+    auto* connection = client(connection_id);
+    if (!connection) {
+        return;
+    }
+
+#ifdef DEBUG_CONNECTION
+    Logger::debug << "WinServer: disconnecting " << m_clients[connection_id].pid << " as " << connection_id << std::endl;
+#endif
+    LFoundation::EventLoop::the().remove(connection->connection().c2s_fd());
+    m_listener.release(m_clients[connection_id].pid, connection->connection());
+    m_clients[connection_id].connection.reset();
+    WindowManager::the().remove_windows_of_connection(connection_id);
+}
+
+bool Connection::is_alive(int connection_id) const
+{
+    return kill(m_clients[connection_id].pid, 0) == 0;
+}
+
+void Connection::disconnect_dead_clients()
+{
+    for (int connection_id = 1; connection_id < m_clients.size(); connection_id++) {
+        if (client(connection_id) && !is_alive(connection_id)) {
+            disconnect(connection_id);
+        }
+    }
+}
+
+bool Connection::send_async_message(const Message& msg)
+{
+    auto* connection = client(msg.key());
+    if (!connection) {
+        return false;
     }
+    schedule_flush();
+    return connection->send_message(msg);
+}
+
+void Connection::schedule_flush()
+{
+    if (m_flush_scheduled) {
+        return;
+    }
+    m_flush_scheduled = true;
+    LFoundation::EventLoop::the().add(*this, new LFoundation::CallEvent(nullptr));
+}
+
+void Connection::flush_clients()
+{
+    m_flush_scheduled = false;
+    bool delivered = true;
+    for (int connection_id = 1; connection_id < m_clients.size(); connection_id++) {
+        auto* connection = client(connection_id);
+        if (!connection) {
+            continue;
+        }
+
+        // A dead client never frees its ring, so it is not waited for.
+        bool flushed = connection->flush();
+        if (connection->is_broken() || (!flushed && !is_alive(connection_id))) {
+            disconnect(connection_id);
+            continue;
+        }
+        delivered &= flushed;
+    }
+
+    // Some client is too slow to take its messages. Rescheduling right away would
+    // spin the event loop until the client wakes up, so the retry waits a bit.
+    if (!delivered) {
+        schedule_flush_retry();
+    }
+}
+
+void Connection::schedule_flush_retry()
+{
+    if (m_flush_retry_scheduled) {
+        return;
+    }
+    m_flush_retry_scheduled = true;
+    LFoundation::EventLoop::the().add(LFoundation::Timer([] {
+        Connection::the().m_flush_retry_scheduled = false;
+        Connection::the().schedule_flush();
+    },
+        FlushRetryIntervalMs, LFoundation::Timer::Once));
 }
 
 void Connection::receive_event(std::unique_ptr<LFoundation::Event> event)
@@ -45,10 +173,14 @@ void Connection::receive_event(std::unique_ptr<LFoundation::Event> event)
     switch (event->type()) {
     case WinServer::Event::Type::SendEvent: {
         std::unique_ptr<SendEvent> send_event = std::move(event);
-        m_connection_with_clients.send_message(*send_event->message());
+        send_async_message(*send_event->message());
+        break;
+    }
+    case LFoundation::Event::Type::DeferredInvoke: {
+        flush_clients();
         break;
     }
     }
 }
 
-} // namespace WinServer
\ No newline at end of file
+} // namespace WinServer
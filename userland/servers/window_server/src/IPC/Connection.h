@@ -11,12 +11,17 @@
 #include <libapi/window_server/Connections/WSConnection.h>
 #include <libfoundation/EventReceiver.h>
 #include <libipc/DoubleSidedConnection.h>
+#include <libipc/Listener.h>
 #include <libipc/ServerConnection.h>
+#include <memory>
+#include <vector>
 
 namespace WinServer {
 
 class Connection : public LFoundation::EventReceiver {
 public:
+    using ClientConnection = ServerConnection<WindowServerDecoder, BaseWindowClientDecoder>;
+
     inline static Connection& the()
     {
         extern Connection* s_WinServer_Connection_the;
@@ -25,21 +30,56 @@ public:
 
     Connection();
 
-    inline void listen()
+    inline ClientConnection* client(int connection_id) const
     {
-        m_connection_with_clients.pump_messages();
+        if (connection_id <= 0 || connection_id >= m_clients.size()) {
+            return nullptr;
+        }
+        return m_clients[connection_id].connection.get();
     }
 
-    inline bool send_async_message(const Message& msg) const { return m_connection_with_clients.send_message(msg); }
-    inline int alloc_connection() { return ++m_connections_number; }
+    void accept_clients();
+    void listen(int connection_id);
+
+    // Drops the client with all its windows, its id stays unused.
+    void disconnect(int connection_id);
+    // Sockets tell nothing about a hangup, so clients are checked by their pids.
+    void disconnect_dead_clients();
+
+    // Messages from the server are keyed with the connection id of the receiver.
+    // They are delivered to all clients in one go at the next event loop pass.
+    bool send_async_message(const Message& msg);
+    void flush_clients();
+
+    // Id of the connection whose messages are being handled now.
+    inline int serving_connection_id() const { return m_serving_connection_id; }
+    // The connection is dropped once its pending messages are pumped.
+    inline void reject_serving_connection() { m_serving_connection_rejected = true; }
+
     void receive_event(std::unique_ptr<LFoundation::Event> event) override;
 
 private:
-    LIPC::DoubleSidedConnection m_connection;
+    static constexpr int FlushRetryIntervalMs = 10;
+
+    struct Client {
+        pid_t pid;
+        std::unique_ptr<ClientConnection> connection;
+    };
+
+    void schedule_flush();
+    void schedule_flush_retry();
+    bool is_alive(int connection_id) const;
+
+    LIPC::Listener m_listener;
     int m_connections_number { 0 };
-    ServerConnection<WindowServerDecoder, BaseWindowClientDecoder> m_connection_with_clients;
+    int m_serving_connection_id { -1 };
+    bool m_serving_connection_rejected { false };
+    bool m_flush_scheduled { false };
+    bool m_flush_retry_scheduled { false };
+    // Indexed by connection id, ids are never reused.
+    std::vector<Client> m_clients;
     WindowServerDecoder m_server_decoder;
     BaseWindowClientDecoder m_client_decoder;
 };
 
-} // namespace WinServer
\ No newline at end of file
+} // namespace WinServer
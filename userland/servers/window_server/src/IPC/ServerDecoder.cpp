@@ -8,14 +8,28 @@
 
 #include "ServerDecoder.h"
 #include "../Components/Security/Violations.h"
+#include "../Managers/ResourceManager.h"
 #include "../Managers/WindowManager.h"
 #include "../Target/Generic/Window.h"
 
 namespace WinServer {
 
+std::unique_ptr<Message> WindowServerDecoder::handle(Message& msg)
+{
+    // Keys tell whose windows a message may touch, so a client is allowed to
+    // use its own connection id only. The greeting is the exception, since
+    // the client learns its id from the reply.
+    static const int greet_id = GreetMessage(0).id();
+    if (msg.id() != greet_id && msg.key() != Connection::the().serving_connection_id()) {
+        Connection::the().reject_serving_connection();
+        return nullptr;
+    }
+    return BaseWindowServerDecoder::handle(msg);
+}
+
 std::unique_ptr<Message> WindowServerDecoder::handle(GreetMessage& msg)
 {
-    return new GreetMessageReply(msg.key(), Connection::the().alloc_connection());
+    return new GreetMessageReply(msg.key(), Connection::the().serving_connection_id());
 }
 
 #ifdef TARGET_DESKTOP
@@ -225,4 +239,28 @@ std::unique_ptr<Message> WindowServerDecoder::handle(AskBringToFrontMessage& msg
     return nullptr;
 }
 
+std::unique_ptr<Message> WindowServerDecoder::handle(GetGlyphAtlasMessage& msg)
+{
+    auto font = LG::Font::SystemFont(msg.font());
+    if (font != LG::Font::SystemFont::Regular && font != LG::Font::SystemFont::Bold) {
+        return new GetGlyphAtlasMessageReply(msg.key(), -1, 0);
+    }
+
+    auto* atlas = ResourceManager::the().glyph_atlas(font, msg.font_size());
+    if (!atlas) {
+        return new GetGlyphAtlasMessageReply(msg.key(), -1, 0);
+    }
+    return new GetGlyphAtlasMessageReply(msg.key(), atlas->buffer.id(), atlas->size);
+}
+
+std::unique_ptr<Message> WindowServerDecoder::handle(GetSharedImageMessage& msg)
+{
+    auto& resource_manager = ResourceManager::the();
+    auto* image = resource_manager.shared_image(msg.path().string());
+    if (!image) {
+        return new GetSharedImageMessageReply(msg.key(), -1, 0, 0, 0, 0);
+    }
+    return new GetSharedImageMessageReply(msg.key(), resource_manager.shared_image_buffer_id(*image), image->offset, image->width, image->height, image->format);
+}
+
 } // namespace WinServer
\ No newline at end of file
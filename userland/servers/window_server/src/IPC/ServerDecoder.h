@@ -18,6 +18,7 @@ public:
     ~WindowServerDecoder() = default;
 
     using BaseWindowServerDecoder::handle;
+    virtual std::unique_ptr<Message> handle(Message& msg) override;
     virtual std::unique_ptr<Message> handle(GreetMessage& msg) override;
     virtual std::unique_ptr<Message> handle(CreateWindowMessage& msg) override;
     virtual std::unique_ptr<Message> handle(DestroyWindowMessage& msg) override;
@@ -29,6 +30,8 @@ public:
     virtual std::unique_ptr<Message> handle(MenuBarCreateItemMessage& msg) override;
     virtual std::unique_ptr<Message> handle(PopupShowMenuMessage& msg) override;
     virtual std::unique_ptr<Message> handle(AskBringToFrontMessage& msg) override;
+    virtual std::unique_ptr<Message> handle(GetGlyphAtlasMessage& msg) override;
+    virtual std::unique_ptr<Message> handle(GetSharedImageMessage& msg) override;
 };
 
 } // namespace WinServer
\ No newline at end of file
@@ -16,9 +16,12 @@
 #include "../Managers/ResourceManager.h"
 #include "../Managers/WindowManager.h"
 #include <libfoundation/EventLoop.h>
+#include <libfoundation/Logger.h>
 #include <libfoundation/Memory.h>
 #include <libg/Context.h>
 
+// #define DEBUG_COMPOSITOR
+
 namespace WinServer {
 
 Compositor* s_WinServer_Compositor_the = nullptr;
@@ -40,42 +43,137 @@ Compositor::Compositor()
         1000 / 60, LFoundation::Timer::Repeat));
 }
 
-void Compositor::copy_changes_to_second_buffer(const std::vector<LG::Rect>& areas)
+// The write buffer has not seen the damage of the frames which were drawn
+// since it was shown last time, so that is repainted together with the new
+// damage. This replaces copying every change back to the second buffer.
+LG::Region Compositor::region_to_repaint(const LG::Region& damage)
 {
     auto& screen = Screen::the();
+    int age = screen.write_buffer_age();
 
-    for (int i = 0; i < areas.size(); i++) {
-        auto bounds = areas[i].intersection(screen.bounds());
-        auto* buf1_ptr = reinterpret_cast<uint32_t*>(&screen.display_bitmap()[bounds.min_y()][bounds.min_x()]);
-        auto* buf2_ptr = reinterpret_cast<uint32_t*>(&screen.write_bitmap()[bounds.min_y()][bounds.min_x()]);
-        for (int j = 0; j < bounds.height(); j++) {
-            LFoundation::fast_copy(buf2_ptr, buf1_ptr, bounds.width());
-            buf1_ptr += screen.width();
-            buf2_ptr += screen.width();
+    LG::Region repaint = damage;
+    if (!age || age > Screen::BufferCount) {
+        repaint = LG::Region(screen.bounds());
+    } else {
+        for (int i = 1; i < age; i++) {
+            int pos = (m_damage_history_pos + Screen::BufferCount - i) % Screen::BufferCount;
+            repaint.unite(m_damage_history[pos]);
         }
     }
+
+    m_damage_history[m_damage_history_pos] = damage;
+    m_damage_history_pos = (m_damage_history_pos + 1) % Screen::BufferCount;
+    return repaint;
+}
+
+void Compositor::invalidate_cursor()
+{
+    if (m_cursor_manager.has_hardware_cursor()) {
+        m_cursor_manager.move_hardware_cursor();
+        return;
+    }
+    m_cursor_moved = true;
+}
+
+LG::Rect Compositor::cursor_bounds() const
+{
+    auto bounds = m_cursor_manager.current_cursor().bounds();
+    bounds.origin().set(m_cursor_manager.draw_position());
+    return bounds.intersection(Screen::the().bounds());
+}
+
+void Compositor::save_under_cursor(const LG::PixelBitmap& bitmap, const LG::Rect& rect)
+{
+    if (m_cursor_saved_under.width() != rect.width() || m_cursor_saved_under.height() != rect.height()) {
+        m_cursor_saved_under.resize(rect.width(), rect.height());
+    }
+
+    for (int y = 0; y < rect.height(); y++) {
+        auto* src = reinterpret_cast<const uint32_t*>(&bitmap[rect.min_y() + y][rect.min_x()]);
+        LFoundation::fast_copy(reinterpret_cast<uint32_t*>(m_cursor_saved_under[y]), src, rect.width());
+    }
+    m_cursor_saved_rect = rect;
+}
+
+void Compositor::restore_under_cursor(LG::PixelBitmap& bitmap)
+{
+    const auto& rect = m_cursor_saved_rect;
+    for (int y = 0; y < rect.height(); y++) {
+        auto* dest = reinterpret_cast<uint32_t*>(&bitmap[rect.min_y() + y][rect.min_x()]);
+        LFoundation::fast_copy(dest, reinterpret_cast<const uint32_t*>(m_cursor_saved_under[y]), rect.width());
+    }
+}
+
+// Moving the software cursor touches only the shown buffer: the pixels
+// under the old position are put back and the cursor is drawn at the new one.
+void Compositor::refresh_cursor()
+{
+    auto& screen = Screen::the();
+    auto& bitmap = screen.display_bitmap();
+    LG::Region damage(m_cursor_saved_rect);
+    restore_under_cursor(bitmap);
+
+    auto cursor_rect = cursor_bounds();
+    save_under_cursor(bitmap, cursor_rect);
+    LG::Context ctx(bitmap);
+    ctx.add_clip(cursor_rect);
+    ctx.draw(m_cursor_manager.draw_position(), m_cursor_manager.current_cursor());
+    ctx.reset_clip();
+    damage.unite(cursor_rect);
+
+    // The other buffer catches up on this change as if it was a part of
+    // the frame which is shown now.
+    int shown_frame = (m_damage_history_pos + Screen::BufferCount - 1) % Screen::BufferCount;
+    m_damage_history[shown_frame].unite(damage);
+    screen.flush_display_buffer(damage);
+    m_cursor_moved = false;
+}
+
+void Compositor::account_frame_time(const std::timespec& start)
+{
+    std::timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    uint32_t usec = (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+
+    m_stats.frames++;
+    m_stats.last_frame_usec = usec;
+    m_stats.max_frame_usec = std::max(m_stats.max_frame_usec, usec);
+    m_stats.total_frame_usec += usec;
+
+#ifdef DEBUG_COMPOSITOR
+    if (m_stats.frames % 60 == 0) {
+        Logger::debug << "Compositor: " << m_stats.frames << " frames, avg " << (uint32_t)(m_stats.total_frame_usec / m_stats.frames)
+                      << " usec, max " << m_stats.max_frame_usec << " usec, last frame drew " << m_stats.drawn_windows
+                      << " windows, skipped " << m_stats.occluded_windows << std::endl;
+    }
+#endif
 }
 
 [[gnu::flatten]] void Compositor::refresh()
 {
-    if (m_invalidated_areas.empty()) {
+    if (m_invalidated_region.empty()) {
+        if (m_cursor_moved) {
+            refresh_cursor();
+        }
         return;
     }
 
+    std::timespec frame_start;
+    clock_gettime(CLOCK_MONOTONIC, &frame_start);
+
     auto& screen = Screen::the();
     auto& wm = WindowManager::the();
-    auto invalidated_areas = std::move(m_invalidated_areas);
+    auto damage = std::move(m_invalidated_region);
+    m_invalidated_region.clear();
+    if (!m_cursor_manager.has_hardware_cursor()) {
+        // The cursor is redrawn with every frame to save the pixels under it.
+        damage.unite(m_cursor_saved_rect);
+        damage.unite(cursor_bounds());
+    }
+    damage.intersect(screen.bounds());
+    auto invalidated_region = region_to_repaint(damage);
     LG::Context ctx(screen.write_bitmap());
 
-    auto is_window_area_invalidated = [&](const std::vector<LG::Rect>& areas, const LG::Rect& area) -> bool {
-        for (int i = 0; i < areas.size(); i++) {
-            if (area.intersects(areas[i])) {
-                return true;
-            }
-        }
-        return false;
-    };
-
     auto draw_wallpaper_for_area = [&](const LG::Rect& area) {
         ctx.add_clip(area);
         ctx.draw({ 0, 0 }, m_resource_manager.background());
@@ -83,6 +181,7 @@ void Compositor::copy_changes_to_second_buffer(const std::vector<LG::Rect>& area
     };
 
 #ifdef TARGET_DESKTOP
+    using Window = Desktop::Window;
     auto draw_window = [&](Desktop::Window& window, const LG::Rect& area) {
         ctx.add_clip(area);
         ctx.add_clip(window.bounds());
@@ -90,78 +189,119 @@ void Compositor::copy_changes_to_second_buffer(const std::vector<LG::Rect>& area
         ctx.draw_rounded(window.content_bounds().origin(), window.content_bitmap(), window.corner_mask());
         ctx.reset_clip();
     };
+
+    // Only the content can hide what is below: frames have shadows and
+    // the rounded corners of the content are see-through.
+    auto opaque_region = [&](Desktop::Window& window) -> LG::Region {
+        const auto& bitmap = window.content_bitmap();
+        if (bitmap.has_alpha_channel()) {
+            return LG::Region();
+        }
+
+        auto content = LG::Rect(window.content_bounds().min_x(), window.content_bounds().min_y(), bitmap.width(), bitmap.height());
+        content.intersect(window.content_bounds());
+        const auto& mask = window.corner_mask();
+        int radius = std::min((int)mask.radius(), (int)std::min(content.width(), content.height()) / 2);
+        int top_radius = mask.top_rounded() ? radius : 0;
+        int bottom_radius = mask.bottom_rounded() ? radius : 0;
+
+        LG::Region region(LG::Rect(content.min_x(), content.min_y() + top_radius, content.width(), content.height() - top_radius - bottom_radius));
+        region.unite(LG::Rect(content.min_x() + top_radius, content.min_y(), content.width() - 2 * top_radius, top_radius));
+        region.unite(LG::Rect(content.min_x() + bottom_radius, content.max_y() + 1 - bottom_radius, content.width() - 2 * bottom_radius, bottom_radius));
+        return region;
+    };
 #elif TARGET_MOBILE
+    using Window = Mobile::Window;
     auto draw_window = [&](Mobile::Window& window, const LG::Rect& area) {
         ctx.add_clip(area);
         ctx.add_clip(window.bounds());
         ctx.draw(window.content_bounds().origin(), window.content_bitmap());
         ctx.reset_clip();
     };
-#endif // TARGET_DESKTOP
-
-    auto& windows = wm.windows();
-    auto top_std_window = windows.rbegin();
-#ifdef TARGET_DESKTOP
-    for (int i = 0; i < invalidated_areas.size(); i++) {
-        draw_wallpaper_for_area(invalidated_areas[i]);
-    }
-#elif TARGET_MOBILE
-    // Standard windows could not be transparent in mobile view, thus
-    // no need to render everything behind the first standard window.
-    for (auto it = windows.rbegin(); it != windows.rend(); it++) {
-        top_std_window = it;
-    }
 
-    if (top_std_window == windows.rend() || (*top_std_window)->type() != WindowType::Standard) {
-        for (int i = 0; i < invalidated_areas.size(); i++) {
-            draw_wallpaper_for_area(invalidated_areas[i]);
+    // Standard windows could not be transparent in mobile view.
+    auto opaque_region = [&](Mobile::Window& window) -> LG::Region {
+        if (window.type() != WindowType::Standard && window.content_bitmap().has_alpha_channel()) {
+            return LG::Region();
         }
-    }
+        return LG::Region(window.content_bounds());
+    };
 #endif // TARGET_DESKTOP
 
-    for (auto it = top_std_window; it != windows.rend(); it++) {
+    // Walking windows front to back, every window gets the part of the
+    // damage which is not hidden by opaque windows above it. Windows with
+    // nothing left are skipped, and so is the wallpaper under them.
+    auto& windows = wm.windows();
+    std::vector<Window*> windows_to_draw;
+    std::vector<LG::Region> window_regions;
+    LG::Region uncovered = invalidated_region;
+    m_stats.drawn_windows = 0;
+    m_stats.occluded_windows = 0;
+    for (auto it = windows.begin(); it != windows.end(); it++) {
         auto& window = *(*it);
-        if (window.visible() && is_window_area_invalidated(invalidated_areas, window.bounds())) {
-            for (int i = 0; i < invalidated_areas.size(); i++) {
-                draw_window(window, invalidated_areas[i]);
+        if (!window.visible()) {
+            continue;
+        }
+
+        LG::Region visible = uncovered;
+        visible.intersect(window.bounds());
+        if (visible.empty()) {
+            if (invalidated_region.intersects(window.bounds())) {
+                m_stats.occluded_windows++;
             }
+            continue;
         }
+
+        windows_to_draw.push_back(&window);
+        window_regions.push_back(std::move(visible));
+        uncovered.subtract(opaque_region(window));
+    }
+
+    uncovered.for_each_rect(draw_wallpaper_for_area);
+
+    for (size_t i = windows_to_draw.size(); i > 0; i--) {
+        auto& window = *windows_to_draw[i - 1];
+        window_regions[i - 1].for_each_rect([&](const LG::Rect& area) {
+            draw_window(window, area);
+        });
     }
+    m_stats.drawn_windows = windows_to_draw.size();
 
     if (m_popup.visible()) {
-        for (int i = 0; i < invalidated_areas.size(); i++) {
-            ctx.add_clip(invalidated_areas[i]);
+        invalidated_region.for_each_rect([&](const LG::Rect& area) {
+            ctx.add_clip(area);
             m_popup.draw(ctx);
             ctx.reset_clip();
-        }
+        });
     }
 
-    for (int i = 0; i < invalidated_areas.size(); i++) {
-        if (m_menu_bar.bounds().intersects(invalidated_areas[i])) {
-            ctx.add_clip(invalidated_areas[i]);
+    invalidated_region.for_each_rect([&](const LG::Rect& area) {
+        if (m_menu_bar.bounds().intersects(area)) {
+            ctx.add_clip(area);
             m_menu_bar.draw(ctx);
             ctx.reset_clip();
         }
-    }
+    });
 
 #ifdef TARGET_MOBILE
-    for (int i = 0; i < invalidated_areas.size(); i++) {
-        ctx.add_clip(invalidated_areas[i]);
+    invalidated_region.for_each_rect([&](const LG::Rect& area) {
+        ctx.add_clip(area);
         m_control_bar.draw(ctx);
         ctx.reset_clip();
-    }
+    });
 #endif // TARGET_MOBILE
 
-    auto mouse_draw_position = m_cursor_manager.draw_position();
-    auto& current_mouse_bitmap = m_cursor_manager.current_cursor();
-    for (int i = 0; i < invalidated_areas.size(); i++) {
-        ctx.add_clip(invalidated_areas[i]);
-        ctx.draw(mouse_draw_position, current_mouse_bitmap);
+    if (!m_cursor_manager.has_hardware_cursor()) {
+        auto cursor_rect = cursor_bounds();
+        save_under_cursor(screen.write_bitmap(), cursor_rect);
+        ctx.add_clip(cursor_rect);
+        ctx.draw(m_cursor_manager.draw_position(), m_cursor_manager.current_cursor());
         ctx.reset_clip();
     }
+    m_cursor_moved = false;
 
-    screen.swap_buffers();
-    copy_changes_to_second_buffer(invalidated_areas);
+    screen.swap_buffers(invalidated_region);
+    account_frame_time(frame_start);
 }
 
-} // namespace WinServer
\ No newline at end of file
+} // namespace WinServer
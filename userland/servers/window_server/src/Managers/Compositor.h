@@ -7,8 +7,11 @@
  */
 
 #pragma once
+#include "../Devices/Screen.h"
 #include "../IPC/ServerDecoder.h"
+#include <ctime>
 #include <libapi/window_server/Connections/WSConnection.h>
+#include <libg/Region.h>
 #include <libipc/ServerConnection.h>
 #include <vector>
 
@@ -22,6 +25,15 @@ class ControlBar;
 #endif // TARGET_MOBILE
 class Popup;
 
+struct CompositorStats {
+    uint32_t frames { 0 };
+    uint32_t last_frame_usec { 0 };
+    uint32_t max_frame_usec { 0 };
+    uint64_t total_frame_usec { 0 };
+    uint32_t drawn_windows { 0 };
+    uint32_t occluded_windows { 0 };
+};
+
 class Compositor {
 public:
     inline static Compositor& the()
@@ -34,42 +46,8 @@ public:
 
     void refresh();
 
-    void optimized_invalidate_insert(std::vector<LG::Rect>& data, const LG::Rect& inv_area)
-    {
-        auto area = inv_area;
-        bool intersects = false;
-        int int_index = 0;
-        for (auto& rect : data) {
-            if (rect.contains(area)) {
-                return;
-            }
-        }
-
-        for (auto& rect : data) {
-            if (rect.intersects(area)) {
-                intersects = true;
-                break;
-            }
-            int_index++;
-        }
-
-        if (!intersects) {
-            data.push_back(area);
-            return;
-        }
-
-        data[int_index].unite(area);
-        for (int i = int_index + 1; i < data.size(); i++) {
-            if (data[int_index].intersects(data[i])) {
-                data[int_index].unite(data[i]);
-                std::swap(data[i], data.back());
-                data.pop_back();
-                i--;
-            }
-        }
-    }
-
-    inline void invalidate(const LG::Rect& area) { optimized_invalidate_insert(m_invalidated_areas, area); }
+    inline void invalidate(const LG::Rect& area) { m_invalidated_region.unite(area); }
+    void invalidate_cursor();
     inline CursorManager& cursor_manager() { return m_cursor_manager; }
     inline const CursorManager& cursor_manager() const { return m_cursor_manager; }
     inline ResourceManager& resource_manager() { return m_resource_manager; }
@@ -86,10 +64,28 @@ public:
     inline const ControlBar& control_bar() const { return m_control_bar; }
 #endif // TARGET_MOBILE
 
+    // Counters of the last frame and of all frames since the start.
+    inline const CompositorStats& stats() const { return m_stats; }
+
 private:
-    void copy_changes_to_second_buffer(const std::vector<LG::Rect>& areas);
+    LG::Region region_to_repaint(const LG::Region& damage);
+    void refresh_cursor();
+    LG::Rect cursor_bounds() const;
+    void save_under_cursor(const LG::PixelBitmap& bitmap, const LG::Rect& rect);
+    void restore_under_cursor(LG::PixelBitmap& bitmap);
+    void account_frame_time(const std::timespec& start);
+
+    LG::Region m_invalidated_region;
+    // Damage of the last frames, used to bring an older buffer up to date.
+    LG::Region m_damage_history[Screen::BufferCount];
+    int m_damage_history_pos { 0 };
 
-    std::vector<LG::Rect> m_invalidated_areas;
+    // Software cursor: pixels under it in the display buffer, so moving it
+    // needs no recomposition.
+    bool m_cursor_moved { false };
+    LG::Rect m_cursor_saved_rect { 0, 0, 0, 0 };
+    LG::PixelBitmap m_cursor_saved_under;
+    CompositorStats m_stats;
     MenuBar& m_menu_bar;
     Popup& m_popup;
     CursorManager& m_cursor_manager;
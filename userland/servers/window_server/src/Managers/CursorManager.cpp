@@ -25,6 +25,7 @@ CursorManager::CursorManager()
     s_WinServer_CursorManager_the = this;
     LG::PNG::PNGLoader loader;
     m_std_cursor = loader.load_from_file(CURSOR_PATH);
+    m_hardware_cursor = m_screen.set_cursor(m_std_cursor, CURSOR_OFFSET, CURSOR_OFFSET);
 }
 
 } // namespace WinServer
\ No newline at end of file
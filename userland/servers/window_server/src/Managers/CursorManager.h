@@ -50,6 +50,10 @@ public:
     inline const LG::PixelBitmap& std_cursor() const { return m_std_cursor; }
     inline LG::Point<int> draw_position() { return { m_mouse_x - CURSOR_OFFSET, m_mouse_y - CURSOR_OFFSET }; }
 
+    // With a cursor plane the cursor is not drawn by the compositor.
+    inline bool has_hardware_cursor() const { return m_hardware_cursor; }
+    inline void move_hardware_cursor() { m_screen.move_cursor(m_mouse_x, m_mouse_y); }
+
     inline int x() const
     {
         return m_mouse_x;
@@ -158,6 +162,7 @@ private:
     bool m_mouse_right_button_pressed { false };
     uint32_t m_mask_changed_objects { 0 };
     bool m_mouse_changed_button_status { false };
+    bool m_hardware_cursor { false };
 
     Screen& m_screen;
     LG::PixelBitmap m_std_cursor;
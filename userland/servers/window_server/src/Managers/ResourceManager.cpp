@@ -7,17 +7,178 @@
  */
 
 #include "ResourceManager.h"
+#include <cstring>
+#include <fcntl.h>
+#include <libg/ImageLoaders/ImageCache.h>
 #include <libg/ImageLoaders/PNGLoader.h>
+#include <unistd.h>
 
 namespace WinServer {
 
 ResourceManager* s_WinServer_ResourceManager_the = nullptr;
 
+static LG::GlyphAtlas provide_glyph_atlas(LG::Font::SystemFont font, size_t font_size)
+{
+    auto* atlas = ResourceManager::the().glyph_atlas(font, font_size);
+    if (!atlas) {
+        return LG::GlyphAtlas();
+    }
+    return LG::GlyphAtlas(atlas->buffer.data(), atlas->size);
+}
+
+static LG::PixelBitmap provide_image(const std::string& path)
+{
+    auto& resource_manager = ResourceManager::the();
+    auto* image = resource_manager.shared_image(path);
+    if (!image) {
+        return LG::PixelBitmap();
+    }
+    return resource_manager.shared_image_bitmap(*image);
+}
+
 ResourceManager::ResourceManager()
 {
     s_WinServer_ResourceManager_the = this;
+    LG::Font::set_atlas_provider(provide_glyph_atlas);
+    LG::ImageCache::set_provider(provide_image);
+    m_background = LG::ImageCache::load("/res/wallpapers/abstract.png");
+}
+
+const ResourceManager::SharedGlyphAtlas* ResourceManager::glyph_atlas(LG::Font::SystemFont font, size_t font_size)
+{
+    for (size_t i = 0; i < m_glyph_atlases.size(); i++) {
+        if (m_glyph_atlases[i].font == font && m_glyph_atlases[i].font_size == font_size) {
+            return &m_glyph_atlases[i];
+        }
+    }
+
+    // Every atlas holds a shared buffer, which are limited system-wide.
+    if (font_size > LG::Font::SystemMaxSize || m_glyph_atlases.size() >= MaxGlyphAtlases) {
+        return nullptr;
+    }
+
+    auto* rasterizer = LG::Font::load_from_file_ttf(LG::Font::system_font_path(font), font_size);
+    if (!rasterizer) {
+        return nullptr;
+    }
+
+    SharedGlyphAtlas atlas = { font, font_size, LG::GlyphAtlas::build(*rasterizer, nullptr, 0) };
+    atlas.buffer.create(atlas.size, SHBUF_READONLY);
+    if (!atlas.buffer.alive()) {
+        delete rasterizer;
+        return nullptr;
+    }
+
+    LG::GlyphAtlas::build(*rasterizer, atlas.buffer.data(), atlas.size);
+    delete rasterizer;
+    m_glyph_atlases.push_back(std::move(atlas));
+    return &m_glyph_atlases.back();
+}
+
+// Only system resources are shared, clients can't make the server read
+// arbitrary files. A ".." component could lead out of /res, so such paths
+// are rejected as a whole.
+static bool is_resource_path(const std::string& path)
+{
+    const char* str = path.c_str();
+    if (strncmp(str, "/res/", 5) != 0) {
+        return false;
+    }
+
+    for (const char* sep = str + 4; sep; sep = strchr(sep + 1, '/')) {
+        const char* name = sep + 1;
+        if (name[0] == '.' && name[1] == '.' && (name[2] == '/' || name[2] == '\0')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const ResourceManager::SharedImage* ResourceManager::shared_image(const std::string& path)
+{
+    if (!is_resource_path(path)) {
+        return nullptr;
+    }
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    stat_t stat;
+    int err = fstat(fd, &stat);
+    close(fd);
+    if (err) {
+        return nullptr;
+    }
+
+    SharedImage* cached = nullptr;
+    for (size_t i = 0; i < m_images.size(); i++) {
+        if (m_images[i].path == path) {
+            cached = &m_images[i];
+            break;
+        }
+    }
+    if (cached && cached->mtime.tv_sec == stat.st_mtim.tv_sec && cached->mtime.tv_nsec == stat.st_mtim.tv_nsec) {
+        return cached;
+    }
+
     LG::PNG::PNGLoader loader;
-    m_background = loader.load_from_file("/res/wallpapers/abstract.png");
+    LG::PixelBitmap bitmap = loader.load_from_file(path);
+    if (!bitmap.width() || !bitmap.height()) {
+        return nullptr;
+    }
+
+    // A changed image is decoded again. Clients may still draw the old one,
+    // so its pixels are not reused.
+    size_t len = bitmap.width() * bitmap.height() * sizeof(LG::Color);
+    size_t page, offset;
+    if (!allocate_image(len, page, offset)) {
+        return nullptr;
+    }
+    memcpy(m_image_pages[page].buffer.data() + offset, (uint8_t*)bitmap.data(), len);
+
+    SharedImage image = { path, stat.st_mtim, page, offset, bitmap.width(), bitmap.height(), bitmap.format() };
+    if (cached) {
+        *cached = std::move(image);
+        return cached;
+    }
+    m_images.push_back(std::move(image));
+    return &m_images.back();
+}
+
+LG::PixelBitmap ResourceManager::shared_image_bitmap(const SharedImage& image)
+{
+    auto* pixels = (LG::Color*)(m_image_pages[image.page].buffer.data() + image.offset);
+    return LG::PixelBitmap(pixels, image.width, image.height, image.format);
+}
+
+bool ResourceManager::allocate_image(size_t len, size_t& page, size_t& offset)
+{
+    // Sizes are multiples of a pixel, so every image stays aligned.
+    for (size_t i = 0; i < m_image_pages.size(); i++) {
+        if (m_image_pages[i].size - m_image_pages[i].used >= len) {
+            page = i;
+            offset = m_image_pages[i].used;
+            m_image_pages[i].used += len;
+            return true;
+        }
+    }
+
+    // Every page holds a shared buffer, which are limited system-wide.
+    if (m_image_pages.size() >= MaxImagePages) {
+        return false;
+    }
+
+    SharedImagePage new_page = { len > ImagePageSize ? len : ImagePageSize, len };
+    new_page.buffer.create(new_page.size, SHBUF_READONLY);
+    if (!new_page.buffer.alive()) {
+        return false;
+    }
+
+    m_image_pages.push_back(std::move(new_page));
+    page = m_image_pages.size() - 1;
+    offset = 0;
+    return true;
 }
 
 } // namespace WinServer
\ No newline at end of file
@@ -7,8 +7,14 @@
  */
 
 #pragma once
+#include <libfoundation/SharedBuffer.h>
+#include <libg/Font.h>
+#include <libg/GlyphAtlas.h>
 #include <libg/PixelBitmap.h>
 #include <libg/Point.h>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
 
 namespace WinServer {
 
@@ -24,8 +30,51 @@ public:
 
     inline const LG::PixelBitmap& background() const { return m_background; }
 
+    // Glyph atlases of system fonts are rasterized here once and shared
+    // with every client, see LG::GlyphAtlas. Clients map them read-only.
+    struct SharedGlyphAtlas {
+        LG::Font::SystemFont font;
+        size_t font_size;
+        size_t size;
+        LFoundation::SharedBuffer<uint8_t> buffer;
+    };
+
+    const SharedGlyphAtlas* glyph_atlas(LG::Font::SystemFont font, size_t font_size);
+
+    // Images are decoded here once and shared with every client, see
+    // LG::ImageCache. They are keyed on path and modification time and
+    // packed into shared pages, which clients map read-only.
+    struct SharedImage {
+        std::string path;
+        timespec mtime;
+        size_t page;
+        size_t offset;
+        size_t width;
+        size_t height;
+        LG::PixelBitmapFormat format;
+    };
+
+    const SharedImage* shared_image(const std::string& path);
+    LG::PixelBitmap shared_image_bitmap(const SharedImage& image);
+    inline int shared_image_buffer_id(const SharedImage& image) const { return m_image_pages[image.page].buffer.id(); }
+
 private:
+    static constexpr size_t MaxGlyphAtlases = 16;
+    static constexpr size_t ImagePageSize = 1 << 20;
+    static constexpr size_t MaxImagePages = 16;
+
+    struct SharedImagePage {
+        size_t size;
+        size_t used;
+        LFoundation::SharedBuffer<uint8_t> buffer;
+    };
+
+    bool allocate_image(size_t len, size_t& page, size_t& offset);
+
     LG::PixelBitmap m_background;
+    std::vector<SharedGlyphAtlas> m_glyph_atlases;
+    std::vector<SharedImagePage> m_image_pages;
+    std::vector<SharedImage> m_images;
 };
 
 } // namespace WinServer
\ No newline at end of file
@@ -126,6 +126,20 @@ void WindowManager::remove_window(Window* window_ptr)
     delete window_ptr;
 }
 
+void WindowManager::remove_windows_of_connection(int connection_id)
+{
+    std::vector<Window*> removed;
+    for (auto* window : m_windows) {
+        if (window && window->connection_id() == connection_id) {
+            removed.push_back(window);
+        }
+    }
+
+    for (auto* window : removed) {
+        remove_window(window);
+    }
+}
+
 void WindowManager::minimize_window(Window& window)
 {
     Window* window_ptr = &window;
@@ -271,14 +285,10 @@ bool WindowManager::continue_window_move()
 
 void WindowManager::update_mouse_position(std::unique_ptr<LFoundation::Event> mouse_event)
 {
-    auto invalidate_bounds = m_cursor_manager.current_cursor().bounds();
-    invalidate_bounds.origin().set(m_cursor_manager.draw_position());
-    m_compositor.invalidate(invalidate_bounds);
-
     m_cursor_manager.update_position((WinServer::MouseEvent*)mouse_event.get());
-
-    invalidate_bounds.origin().set(m_cursor_manager.draw_position());
-    m_compositor.invalidate(invalidate_bounds);
+    if (m_cursor_manager.is_changed<CursorManager::Params::Coords>()) {
+        m_compositor.invalidate_cursor();
+    }
 }
 
 #ifdef TARGET_DESKTOP
@@ -45,6 +45,7 @@ public:
 
     void add_window(Window* window);
     void remove_window(Window* window);
+    void remove_windows_of_connection(int connection_id);
 
     void resize_window(Window& window, const LG::Size& size);
     void close_window(Window& window) { send_event(new WindowCloseRequestMessage(window.connection_id(), window.id())); }
@@ -41,8 +41,9 @@ AppListView::AppListView(UI::View* superview, UI::Window* window, const LG::Rect
     searchbar.set_placeholder_text("SEARCH");
 
     auto& applist_grid_view = add_subview<UI::CollectionView>(LG::Rect(0, 2 * padding() + 30, bounds().width(), bounds().height() - (2 * padding() + 30)));
-    applist_grid_view.set_data_source([this](int id) -> View* {
-        return this->view_streamer(id);
+    applist_grid_view.set_data_source(UI::CollectionViewDataSource {
+        .number_of_rows = [this]() -> size_t { return (m_app_entities.size() + items_per_row() - 1) / items_per_row(); },
+        .view_for_row = [this](size_t id) -> View* { return this->view_for_row(id); },
     });
     m_applist_grid_view = &applist_grid_view;
 }
@@ -59,26 +60,35 @@ void AppListView::display(const LG::Rect& rect)
     ctx.draw_shading(LG::Rect(0, 30 + 2 * padding(), bounds().width(), 4), LG::Shading(LG::Shading::Type::TopToBottom));
 }
 
-UI::View* AppListView::view_streamer(int id)
+UI::View* AppListView::view_for_row(size_t id)
 {
     if (id * items_per_row() >= m_app_entities.size()) {
         return nullptr;
     }
 
+    // Rows are reused by the number of icons in them.
+    size_t rem = std::min(items_per_row(), (int)m_app_entities.size() - (int)id * items_per_row());
     size_t calc_padding = (m_applist_grid_view->bounds().width() - 2 * padding() - (icon_view_size() * items_per_row())) / (items_per_row() - 1);
-    UI::StackView& dock_stack_view = m_applist_grid_view->add_subview<UI::StackView>(LG::Rect(padding(), 0, m_applist_grid_view->bounds().width() - 2 * padding(), icon_view_size() + calc_padding));
-    dock_stack_view.set_spacing(calc_padding);
-    dock_stack_view.set_background_color(LG::Color::Opaque);
-    dock_stack_view.set_axis(UI::LayoutConstraints::Axis::Horizontal);
-    dock_stack_view.set_distribution(UI::StackView::Distribution::Standard);
+    UI::StackView& dock_stack_view = m_applist_grid_view->dequeue_reusable_view<UI::StackView>(rem, LG::Rect(padding(), 0, m_applist_grid_view->bounds().width() - 2 * padding(), icon_view_size() + calc_padding));
+
+    if (dock_stack_view.arranged_subviews().empty()) {
+        dock_stack_view.set_spacing(calc_padding);
+        dock_stack_view.set_background_color(LG::Color::Opaque);
+        dock_stack_view.set_axis(UI::LayoutConstraints::Axis::Horizontal);
+        dock_stack_view.set_distribution(UI::StackView::Distribution::Standard);
+
+        for (int i = 0; i < rem; i++) {
+            auto& icon_view = dock_stack_view.add_arranged_subview<IconView>();
+            icon_view.add_constraint(UI::Constraint(icon_view, UI::Constraint::Attribute::Height, UI::Constraint::Relation::Equal, icon_view_size()));
+            icon_view.add_constraint(UI::Constraint(icon_view, UI::Constraint::Attribute::Width, UI::Constraint::Relation::Equal, icon_view_size()));
+        }
+    }
 
-    size_t rem = std::min(items_per_row(), (int)m_app_entities.size() - id * items_per_row());
     for (int i = 0; i < rem; i++) {
-        auto& icon_view = dock_stack_view.add_arranged_subview<IconView>();
+        auto& icon_view = *(IconView*)dock_stack_view.arranged_subviews()[i];
         icon_view.set_title(m_app_entities[id * items_per_row() + i].title());
         icon_view.entity() = m_app_entities[id * items_per_row() + i];
-        icon_view.add_constraint(UI::Constraint(icon_view, UI::Constraint::Attribute::Height, UI::Constraint::Relation::Equal, icon_view_size()));
-        icon_view.add_constraint(UI::Constraint(icon_view, UI::Constraint::Attribute::Width, UI::Constraint::Relation::Equal, icon_view_size()));
+        icon_view.set_needs_display();
     }
 
     return &dock_stack_view;
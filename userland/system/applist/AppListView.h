@@ -25,7 +25,7 @@ public:
     void register_entity(AppEntity&& ent);
 
 private:
-    UI::View* view_streamer(int id);
+    UI::View* view_for_row(size_t id);
 
     UI::CollectionView* m_applist_grid_view {};
     std::vector<AppEntity> m_app_entities {};
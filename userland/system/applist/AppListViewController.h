@@ -10,7 +10,7 @@
 #include "AppListView.h"
 #include <libfoundation/FileManager.h>
 #include <libfoundation/json/Parser.h>
-#include <libg/ImageLoaders/PNGLoader.h>
+#include <libg/ImageLoaders/ImageCache.h>
 #include <libui/App.h>
 #include <libui/Button.h>
 #include <libui/Label.h>
@@ -39,22 +39,19 @@ public:
         }
 
         auto* jdict_root = jobj_root->cast_to<LFoundation::Json::DictObject>();
-        const std::string& bundle_id = jdict_root->data()["bundle_id"]->cast_to<LFoundation::Json::StringObject>()->data();
+        std::string bundle_id = jdict_root->get("bundle_id")->cast_to<LFoundation::Json::StringObject>()->to_string();
 
         AppEntity new_ent;
-        LG::PNG::PNGLoader loader;
 
-        std::string icon_path = jdict_root->data()["icon_path"]->cast_to<LFoundation::Json::StringObject>()->data();
-        new_ent.set_icon(loader.load_from_file(icon_path + "/32x32.png"));
+        std::string icon_path = jdict_root->get("icon_path")->cast_to<LFoundation::Json::StringObject>()->to_string();
+        new_ent.set_icon(LG::ImageCache::load(icon_path + "/32x32.png"));
 
-        std::string rel_exec_path = jdict_root->data()["exec_rel_path"]->cast_to<LFoundation::Json::StringObject>()->data();
+        std::string rel_exec_path = jdict_root->get("exec_rel_path")->cast_to<LFoundation::Json::StringObject>()->to_string();
         new_ent.set_path_to_exec(content_dir + rel_exec_path);
 
-        new_ent.set_title(jdict_root->data()["name"]->cast_to<LFoundation::Json::StringObject>()->data());
-        new_ent.set_bundle_id(jdict_root->data()["bundle_id"]->cast_to<LFoundation::Json::StringObject>()->data());
+        new_ent.set_title(jdict_root->get("name")->cast_to<LFoundation::Json::StringObject>()->to_string());
+        new_ent.set_bundle_id(jdict_root->get("bundle_id")->cast_to<LFoundation::Json::StringObject>()->to_string());
         view().register_entity(std::move(new_ent));
-
-        delete jdict_root;
     }
 
     void load_application_list()
@@ -74,9 +71,8 @@ public:
 #if 0
         for (int i = 0; i < 32; i++) {
             AppEntity new_ent;
-            LG::PNG::PNGLoader loader;
 
-            new_ent.set_icon(loader.load_from_file("/res/icons/apps/about.icon/32x32.png"));
+            new_ent.set_icon(LG::ImageCache::load("/res/icons/apps/about.icon/32x32.png"));
             new_ent.set_path_to_exec("/Applications/about.app/Content/about");
             new_ent.set_title("TestApp");
             new_ent.set_bundle_id("com.opuntia.test");
@@ -1,6 +1,6 @@
 #include "AppListView.h"
 #include "DockView.h"
-#include <libg/ImageLoaders/PNGLoader.h>
+#include <libg/ImageLoaders/ImageCache.h>
 #include <libui/App.h>
 #include <libui/Context.h>
 #include <libui/Label.h>
@@ -10,8 +10,7 @@
 AppListView::AppListView(View* superview, const LG::Rect& frame)
     : View(superview, frame)
 {
-    LG::PNG::PNGLoader loader;
-    m_icon = loader.load_from_file("/res/system/app_list_32.png");
+    m_icon = LG::ImageCache::load("/res/system/app_list_32.png");
 }
 
 void AppListView::display(const LG::Rect& rect)
@@ -6,7 +6,7 @@
 #include <libfoundation/EventLoop.h>
 #include <libfoundation/KeyboardMapping.h>
 #include <libg/Color.h>
-#include <libg/ImageLoaders/PNGLoader.h>
+#include <libg/ImageLoaders/ImageCache.h>
 #include <libui/App.h>
 #include <libui/Context.h>
 #include <unistd.h>
@@ -66,13 +66,11 @@ void DockView::display(const LG::Rect& rect)
 
 void DockView::new_dock_entity(const std::string& exec_path, const std::string& icon_path, const std::string& bundle_id)
 {
-    LG::PNG::PNGLoader loader;
-
     fill_bounds_expand(icon_view_size() + padding());
     auto& icon_view = m_dock_stackview->add_arranged_subview<IconView>();
     icon_view.add_constraint(UI::Constraint(icon_view, UI::Constraint::Attribute::Height, UI::Constraint::Relation::Equal, icon_view_size()));
     icon_view.add_constraint(UI::Constraint(icon_view, UI::Constraint::Attribute::Width, UI::Constraint::Relation::Equal, icon_view_size()));
-    icon_view.entity().set_icon(loader.load_from_file(icon_path + "/32x32.png"));
+    icon_view.entity().set_icon(LG::ImageCache::load(icon_path + "/32x32.png"));
     icon_view.entity().set_path_to_exec(std::move(exec_path));
     icon_view.entity().set_bundle_id(std::move(bundle_id));
     m_icon_views.push_back(&icon_view);
@@ -108,7 +106,7 @@ void DockView::on_window_create(const std::string& bundle_id, const std::string&
     for (auto* view : m_icon_views) {
         if (view->entity().bundle_id() == bundle_id) {
             view->entity().add_window(WindowEntity(window_id));
-            set_needs_display();
+            view->set_needs_display();
             return;
         }
     }
@@ -117,7 +115,7 @@ void DockView::on_window_create(const std::string& bundle_id, const std::string&
     for (auto* view : m_icon_views) {
         if (view->entity().bundle_id() == bundle_id) {
             view->entity().add_window(WindowEntity(window_id));
-            set_needs_display();
+            view->set_needs_display();
             return;
         }
     }
@@ -141,7 +139,7 @@ void DockView::on_window_remove(int window_id)
             if (wins.window_id() == window_id) {
                 auto& win = view->entity().windows();
                 win.erase(std::find(win.begin(), win.end(), WindowEntity(window_id)));
-                set_needs_display();
+                view->set_needs_display();
                 return;
             }
         }
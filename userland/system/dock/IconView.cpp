@@ -9,6 +9,7 @@
 IconView::IconView(View* superview, const LG::Rect& frame)
     : View(superview, frame)
 {
+    set_retained(true);
 }
 
 void IconView::display(const LG::Rect& rect)
@@ -6,7 +6,7 @@
 #include <libfoundation/EventLoop.h>
 #include <libfoundation/KeyboardMapping.h>
 #include <libg/Color.h>
-#include <libg/ImageLoaders/PNGLoader.h>
+#include <libg/ImageLoaders/ImageCache.h>
 #include <libui/App.h>
 #include <libui/Context.h>
 #include <libui/StackView.h>
@@ -84,7 +84,6 @@ void HomeScreenView::display(const LG::Rect& rect)
 void HomeScreenView::new_grid_entity(const std::string& title, const std::string& icon_path, std::string&& exec_path)
 {
     // TODO: Add pages.
-    LG::PNG::PNGLoader loader;
     int row_to_put_to = 0;
     for (int i = 0; i < grid_entities_per_column(); i++) {
         if (m_grid_stackviews[i]->subviews().size() < grid_entities_per_row()) {
@@ -96,7 +95,7 @@ void HomeScreenView::new_grid_entity(const std::string& title, const std::string
     icon_view.add_constraint(UI::Constraint(icon_view, UI::Constraint::Attribute::Height, UI::Constraint::Relation::Equal, icon_view_size()));
     icon_view.add_constraint(UI::Constraint(icon_view, UI::Constraint::Attribute::Width, UI::Constraint::Relation::Equal, icon_view_size()));
     icon_view.set_title(title);
-    icon_view.entity().set_icon(loader.load_from_file(icon_path + "/48x48.png"));
+    icon_view.entity().set_icon(LG::ImageCache::load(icon_path + "/48x48.png"));
     icon_view.entity().set_path_to_exec(std::move(exec_path));
     set_needs_layout();
 }
@@ -107,11 +106,10 @@ void HomeScreenView::new_fast_launch_entity(const std::string& title, const std:
         return;
     }
 
-    LG::PNG::PNGLoader loader;
     auto& icon_view = m_dock_stackview->add_arranged_subview<IconView>();
     icon_view.add_constraint(UI::Constraint(icon_view, UI::Constraint::Attribute::Height, UI::Constraint::Relation::Equal, icon_view_size()));
     icon_view.add_constraint(UI::Constraint(icon_view, UI::Constraint::Attribute::Width, UI::Constraint::Relation::Equal, icon_view_size()));
-    icon_view.entity().set_icon(loader.load_from_file(icon_path + "/48x48.png"));
+    icon_view.entity().set_icon(LG::ImageCache::load(icon_path + "/48x48.png"));
     icon_view.entity().set_path_to_exec(std::move(exec_path));
     set_needs_layout();
 }
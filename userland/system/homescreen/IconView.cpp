@@ -8,6 +8,7 @@ IconView::IconView(View* superview, const LG::Rect& frame)
 {
     m_label = &add_subview<UI::Label>(LG::Rect(0, HomeScreenView::icon_view_size() - 12, HomeScreenView::icon_view_size(), 12));
     m_label->set_alignment(UI::Text::Alignment::Center);
+    set_retained(true);
 }
 
 void IconView::display(const LG::Rect& rect)
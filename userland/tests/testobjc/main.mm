@@ -1,6 +1,11 @@
 #include <libfoundation/NSObject.h>
+#include <libobjc/class.h>
 #include <libobjc/helpers.h>
+#include <libobjc/runtime.h>
 #include <stdio.h>
+#include <sys/time.h>
+
+#define MSGSEND_BENCH_ITERS 1000000
 
 @interface SampleClass : NSObject {
 @public
@@ -31,11 +36,62 @@
 
 @end
 
+@interface SampleClass (Doubling)
+- (int)doubled_last;
+@end
+
+@implementation SampleClass (Doubling)
+
+- (int)doubled_last
+{
+    return 2 * last_val;
+}
+
+@end
+
+@interface SampleSubclass : SampleClass
+@end
+
+@implementation SampleSubclass
+@end
+
+static int subclass_get_last(id self, SEL _cmd)
+{
+    return -1;
+}
+
+static void bench_msgsend(id object)
+{
+    timeval_t tv, ttv;
+    timezone_t tz;
+    int sum = 0;
+
+    gettimeofday(&tv, &tz);
+    for (int i = 0; i < MSGSEND_BENCH_ITERS; i++) {
+        sum += [object get_last];
+    }
+    gettimeofday(&ttv, &tz);
+
+    int usec = (ttv.tv_sec - tv.tv_sec) * 1000000 + (ttv.tv_usec - tv.tv_usec);
+    printf("[BENCH][OBJC MSGSEND 1M] %d (usec) %d\n", usec, sum);
+}
+
 int main()
 {
     id objectAlloc = [[SampleClass alloc] init];
     [objectAlloc sampleMethod:22];
     [SampleClass sampleMethod];
     printf("Last called with %d", [objectAlloc get_last]);
+    printf("Doubled by category %d", [objectAlloc doubled_last]);
+
+    // The subclass caches the inherited method, adding its own one should
+    // drop it.
+    id subobject = [[SampleSubclass alloc] init];
+    [subobject sampleMethod:5];
+    printf("Subclass last before %d", [subobject get_last]);
+    class_addMethod(objc_getClass("SampleSubclass"), @selector(get_last), (IMP)subclass_get_last, "i@:");
+    printf("Subclass last after %d", [subobject get_last]);
+
+    bench_msgsend(objectAlloc);
     return 0;
 }
\ No newline at end of file
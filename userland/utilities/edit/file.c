@@ -1,30 +1,78 @@
 #include "file.h"
 #include "viewer.h"
 #include <fcntl.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 file_view_area_t view_area;
 
+#define FILE_GAP_SIZE 4096
+
+static inline int _file_gap_size()
+{
+    return view_area.gap_end - view_area.gap_start;
+}
+
+static void _file_move_gap(int offset)
+{
+    if (offset < view_area.gap_start) {
+        int len = view_area.gap_start - offset;
+        memmove(view_area.buffer + view_area.gap_end - len, view_area.buffer + offset, len);
+        view_area.gap_start -= len;
+        view_area.gap_end -= len;
+    } else if (offset > view_area.gap_start) {
+        int len = offset - view_area.gap_start;
+        memmove(view_area.buffer + view_area.gap_start, view_area.buffer + view_area.gap_end, len);
+        view_area.gap_start += len;
+        view_area.gap_end += len;
+    }
+}
+
+static int _file_reserve_gap(int len)
+{
+    if (_file_gap_size() >= len) {
+        return 0;
+    }
+
+    int new_buf_len = view_area.buf_len * 2 + len;
+    char* new_buffer = (char*)malloc(new_buf_len);
+    if (!new_buffer) {
+        return -1;
+    }
+
+    int after_gap = view_area.buf_len - view_area.gap_end;
+    memcpy(new_buffer, view_area.buffer, view_area.gap_start);
+    memcpy(new_buffer + new_buf_len - after_gap, view_area.buffer + view_area.gap_end, after_gap);
+    free(view_area.buffer);
+
+    view_area.buffer = new_buffer;
+    view_area.gap_end = new_buf_len - after_gap;
+    view_area.buf_len = new_buf_len;
+    return 0;
+}
+
 static int _file_get_size_of_first_line()
 {
     int res = 0;
     for (int i = view_area.start; i < view_area.data_len; i++) {
         res++;
-        if (view_area.buffer[i] == '\n') {
+        if (file_char_at(i) == '\n') {
             return res;
         }
     }
     return view_area.data_len - view_area.start;
 }
 
-static void _file_find_start(uint32_t old_offset)
+static void _file_find_start(int old_offset)
 {
     old_offset -= 2;
-    while (old_offset > view_area.offset) {
-        if (view_area.buffer[old_offset - view_area.offset] == '\n') {
-            view_area.start = old_offset - view_area.offset + 1;
+    while (old_offset > 0) {
+        if (file_char_at(old_offset) == '\n') {
+            view_area.start = old_offset + 1;
             return;
         }
         old_offset--;
@@ -37,42 +85,75 @@ static inline int _file_remaining_size()
     return view_area.data_len - view_area.start;
 }
 
-static inline int _file_is_last_line_in_buf()
-{
-    return 1;
-}
-
 int _file_buf_flush()
 {
-    /* FIXME: for now we think that we have all file in our buffer */
-    lseek(view_area.fd, view_area.offset, SEEK_SET);
-    view_area.data_len = write(view_area.fd, view_area.buffer, view_area.data_len);
+    int after_gap = view_area.buf_len - view_area.gap_end;
+    lseek(view_area.fd, 0, SEEK_SET);
+    if (write(view_area.fd, view_area.buffer, view_area.gap_start) != view_area.gap_start) {
+        return -1;
+    }
+    if (write(view_area.fd, view_area.buffer + view_area.gap_end, after_gap) != after_gap) {
+        return -1;
+    }
+    view_area.was_changed = 0;
     return 0;
 }
 
-int _file_buf_reload(int offset_in_file)
+/**
+ * _file_buf_load maps the file and copies it behind the gap, so the first
+ * edits at the top of the file do not move the text.
+ */
+int _file_buf_load()
 {
-    /* TODO: Get real file size */
-    view_area.buf_len = 4000;
-    view_area.buffer = (char*)malloc(view_area.buf_len);
+    struct stat stat;
+    if (fstat(view_area.fd, &stat) < 0) {
+        return -1;
+    }
 
+    view_area.data_len = stat.st_size;
+    view_area.buf_len = view_area.data_len + FILE_GAP_SIZE;
+    view_area.buffer = (char*)malloc(view_area.buf_len);
+    if (!view_area.buffer) {
+        return -1;
+    }
+    view_area.gap_start = 0;
+    view_area.gap_end = FILE_GAP_SIZE;
     view_area.start = 0;
-    view_area.offset = offset_in_file;
+    view_area.line = 0;
     view_area.was_changed = 0;
-    lseek(view_area.fd, view_area.offset, SEEK_SET);
-    view_area.data_len = read(view_area.fd, view_area.buffer, view_area.buf_len);
-    if (view_area.data_len < 0) {
+
+    if (!view_area.data_len) {
+        return 0;
+    }
+
+    char* data = (char*)mmap(NULL, view_area.data_len, PROT_READ, MAP_PRIVATE, view_area.fd, 0);
+    if ((intptr_t)data < 0) {
         return -1;
     }
+    memcpy(view_area.buffer + view_area.gap_end, data, view_area.data_len);
+    munmap(data, view_area.data_len);
     return 0;
 }
 
+char file_char_at(int offset)
+{
+    if (offset >= view_area.gap_start) {
+        offset += _file_gap_size();
+    }
+    return view_area.buffer[offset];
+}
+
+int file_size()
+{
+    return view_area.data_len;
+}
+
 int file_line_len(int offset)
 {
     int res = 0;
     for (int i = offset; i < view_area.data_len; i++) {
         res++;
-        if (view_area.buffer[i] == '\n') {
+        if (file_char_at(i) == '\n') {
             return res;
         }
     }
@@ -83,8 +164,8 @@ int file_line_len_backwards(int offset)
 {
 
     int res = 1;
-    for (int i = offset - 1; i >= view_area.offset; i--) {
-        if (view_area.buffer[i] == '\n') {
+    for (int i = offset - 1; i >= 0; i--) {
+        if (file_char_at(i) == '\n') {
             return res;
         }
         res++;
@@ -99,12 +180,11 @@ int file_open(char* path)
         return -1;
     }
 
-    _file_buf_reload(0);
-    if (view_area.data_len < 0) {
+    if (_file_buf_load() < 0) {
         return -1;
     }
 
-    viewer_display(view_area.buffer, view_area.start, _file_remaining_size());
+    viewer_display(view_area.start, _file_remaining_size());
 
     return view_area.fd;
 }
@@ -119,27 +199,32 @@ void file_exit()
  */
 int file_paste_char(char c, int offset)
 {
-    view_area.was_changed = 1;
-    view_area.data_len++;
+    if (_file_reserve_gap(1) < 0) {
+        return -1;
+    }
 
-    memmove(view_area.buffer + offset + 1, view_area.buffer + offset, view_area.data_len - offset - 1);
-    view_area.buffer[offset] = c;
+    _file_move_gap(offset);
+    view_area.buffer[view_area.gap_start++] = c;
+    view_area.data_len++;
+    view_area.was_changed = 1;
     viewer_cursor_next();
-    viewer_display(view_area.buffer, view_area.start, _file_remaining_size());
+    viewer_display(view_area.start, _file_remaining_size());
+    return 0;
 }
 
 /**
- * file_paste_char pastes and flush updates to disk.
+ * file_save flushes updates to disk.
  */
 int file_save()
 {
     if (view_area.was_changed) {
-        _file_buf_flush();
+        return _file_buf_flush();
     }
+    return 0;
 }
 
 /**
- * Scroll functions update file buffer, to contain line scrolled to.
+ * Scroll functions move the first shown line, the whole file is in memory.
  */
 int file_scroll_up()
 {
@@ -147,30 +232,23 @@ int file_scroll_up()
         return -1;
     }
     view_area.line--;
-    int old_offset_in_file = view_area.offset + view_area.start;
-    int offset_in_file = view_area.offset + view_area.start - SCREEN_X;
+    int old_offset_in_file = view_area.start;
+    int offset_in_file = view_area.start - SCREEN_X;
     if (offset_in_file < 0) {
         offset_in_file = 0;
     }
 
-    if (offset_in_file >= view_area.offset) {
-        view_area.start = offset_in_file - view_area.offset;
-        _file_find_start(old_offset_in_file);
-        viewer_display(view_area.buffer, view_area.start, _file_remaining_size());
-    } else {
-        _file_buf_reload(offset_in_file);
-        _file_find_start(old_offset_in_file);
-        viewer_display(view_area.buffer, view_area.start, _file_remaining_size());
-    }
+    view_area.start = offset_in_file;
+    _file_find_start(old_offset_in_file);
+    viewer_display(view_area.start, _file_remaining_size());
+    return 0;
 }
 
 int file_scroll_down()
 {
     int line_size = _file_get_size_of_first_line();
     view_area.start += line_size;
-    if (!_file_is_last_line_in_buf()) {
-        _file_buf_reload(view_area.offset + view_area.start);
-    }
-    viewer_display(view_area.buffer, view_area.start, _file_remaining_size());
+    viewer_display(view_area.start, _file_remaining_size());
     view_area.line++;
-}
\ No newline at end of file
+    return 0;
+}
@@ -7,12 +7,14 @@
 #include <stdint.h>
 #endif
 
+/* The whole file is kept in a gap buffer, the gap follows the last edit. */
 struct file_view_area {
     char* buffer;
-    int start; /* offset in buffer where the line starts */
-    int offset; /* offset in file */
-    int data_len;
     int buf_len;
+    int gap_start;
+    int gap_end;
+    int data_len; /* length of the file, the gap is not counted */
+    int start; /* offset in file where the first shown line starts */
     int line;
     char was_changed;
     int fd;
@@ -22,6 +24,8 @@ typedef struct file_view_area file_view_area_t;
 int file_open(char* path);
 void file_exit();
 int file_save();
+char file_char_at(int offset);
+int file_size();
 int file_line_len(int offset);
 int file_line_len_backwards(int offset);
 int file_paste_char(char c, int offset);
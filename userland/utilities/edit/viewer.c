@@ -5,7 +5,6 @@
 
 int out_x, out_y;
 int cursor_x, cursor_y;
-char* displaying_buffer;
 int working_with_offset;
 
 static int _viewer_get_offset(int cx, int cy)
@@ -107,9 +106,8 @@ static void _log_dec(uint32_t dec)
     }
 }
 
-void viewer_display(char* buf, int start, int len)
+void viewer_display(int start, int len)
 {
-    displaying_buffer = buf;
     int last_cx = 0;
     viewer_clear_screen();
     for (int i = start; i < start + len; i++) {
@@ -117,7 +115,7 @@ void viewer_display(char* buf, int start, int len)
             working_with_offset = i;
             last_cx = out_x;
         }
-        if (!_viewer_display_one(buf[i])) {
+        if (!_viewer_display_one(file_char_at(i))) {
             goto out;
         }
     }
@@ -142,12 +140,10 @@ void viewer_cursor_left()
 
 void viewer_cursor_right()
 {
-    if (displaying_buffer) {
-        if (displaying_buffer[working_with_offset] != '\n') {
-            cursor_x++;
-            working_with_offset++;
-            _viewer_set_cursor(cursor_x, cursor_y);
-        }
+    if (working_with_offset < file_size() && file_char_at(working_with_offset) != '\n') {
+        cursor_x++;
+        working_with_offset++;
+        _viewer_set_cursor(cursor_x, cursor_y);
     }
 }
 
@@ -7,7 +7,7 @@
 #define SCREEN_Y 24
 
 void viewer_clear_screen();
-void viewer_display(char* buf, int start, int len);
+void viewer_display(int start, int len);
 void viewer_enter_menu_mode();
 void viewer_cursor_left();
 void viewer_cursor_right();
@@ -2,6 +2,8 @@
 # Use of this source code is governed by a BSD-style license that can be
 # found in the LICENSE file.
 
+import zlib
+
 class Message:
     def __init__(self, name, id, reply_id, decoder_magic, params, protected=False):
         self.name = name
@@ -11,6 +13,17 @@ class Message:
         self.params = params
         self.protected = protected
 
+    def wire_params(self):
+        if self.protected:
+            return [('message_key_t', 'key')] + self.params
+        return self.params
+
+    # Changes whenever the encoded layout of the message changes.
+    def layout_version(self):
+        signature = "{0}:{1}({2})".format(self.decoder_magic, self.name, ",".join(
+            "{0} {1}".format(i[0], i[1]) for i in self.wire_params()))
+        return zlib.crc32(signature.encode("ascii")) & 0xffffffff
+
 
 class Generator:
 
@@ -70,26 +83,107 @@ class Generator:
         else:
             self.out(res+" {}", 1)
 
+    def wire(self, type):
+        return "LIPC::Wire<{0}>".format(type)
+
+    def message_create_layout(self, msg):
+        self.out("struct [[gnu::packed]] Layout {", 1)
+        self.out("LIPC::MessageHeader header;", 2)
+        for i in msg.wire_params():
+            self.out("{0}::Slot {1};".format(self.wire(i[0]), i[1]), 2)
+        self.out("};", 1)
+        self.out("static constexpr size_t fixed_size = sizeof(Layout);", 1)
+        self.out("static constexpr uint32_t layout_version = {0};".format(
+            hex(msg.layout_version())), 1)
+        self.out("", 0)
+
+    def message_create_view(self, msg):
+        self.out("// Reads the encoded message in place, valid while the buffer is alive.", 1)
+        self.out("class View {", 1)
+        self.out("public:", 1)
+        self.out("explicit View(const uint8_t* msg)", 2)
+        self.out(": m_msg(msg)", 3)
+        self.out("{", 2)
+        self.out("}", 2)
+        self.out("", 0)
+        self.out("static bool validate(const uint8_t* msg, size_t size)", 2)
+        self.out("{", 2)
+        self.out("const Layout* layout = (const Layout*)msg;", 3)
+        self.out("if (size < fixed_size || layout->header.layout_version != layout_version) {", 3)
+        self.out("return false;", 4)
+        self.out("}", 3)
+        self.out("if (layout->header.size < fixed_size || layout->header.size > size) {", 3)
+        self.out("return false;", 4)
+        self.out("}", 3)
+        checks = ["{0}::validate(msg, layout->header.size, layout->{1})".format(self.wire(i[0]), i[1])
+                  for i in msg.wire_params() if self.is_variable(i[0])]
+        if len(checks) > 0:
+            self.out("return {0};".format(("\n" + "    " * 4 + "&& ").join(checks)), 3)
+        else:
+            self.out("return true;", 3)
+        self.out("}", 2)
+        self.out("", 0)
+        self.out("size_t size() const { return layout()->header.size; }", 2)
+        for i in msg.wire_params():
+            self.out("{0}::View {1}() const {{ return {0}::view(m_msg, layout()->{1}); }}".format(
+                self.wire(i[0]), i[1]), 2)
+        self.out("", 0)
+        self.out("private:", 1)
+        self.out("const Layout* layout() const { return (const Layout*)m_msg; }", 2)
+        self.out("const uint8_t* m_msg;", 2)
+        self.out("};", 1)
+        self.out("", 0)
+
+    def message_create_view_constructor(self, msg):
+        params = msg.wire_params()
+        if len(params) == 0:
+            self.out("explicit {0}(const View& view) {{}}".format(msg.name), 1)
+            return
+        self.out("explicit {0}(const View& view)".format(msg.name), 1)
+        sign = ':'
+        for i in params:
+            self.out("{0} m_{1}({2}::materialize(view.{1}()))".format(
+                sign, i[1], self.wire(i[0])), 2)
+            sign = ','
+        self.out("{", 1)
+        self.out("}", 1)
+
+    def is_variable(self, type):
+        return type.startswith("LIPC::StringEncoder") or type.startswith("LIPC::VectorEncoder")
+
     def message_create_encoder(self, msg):
-        self.out("EncodedMessage encode() const override".format(
-            msg.decoder_magic), 1)
+        tails = ["{0}::tail_size(m_{1})".format(self.wire(i[0]), i[1])
+                 for i in msg.wire_params() if self.is_variable(i[0])]
+        self.out("size_t encoded_size() const override {{ return {0}; }}".format(
+            " + ".join(["fixed_size"] + tails)), 1)
+
+        self.out("void encode_to(uint8_t* buf) const override", 1)
         self.out("{", 1)
+        self.out("Layout layout;", 2)
+        self.out("size_t tail = fixed_size;", 2)
+        for i in msg.wire_params():
+            self.out("layout.{1} = {0}::encode(m_{1}, buf, tail);".format(
+                self.wire(i[0]), i[1]), 2)
+        self.out("layout.header = {{ {0}, {1}, (uint32_t)tail, layout_version }};".format(
+            msg.decoder_magic, msg.id), 2)
+        self.out("memcpy(buf, &layout, sizeof(layout));", 2)
+        self.out("}", 1)
 
+        self.out("EncodedMessage encode() const override", 1)
+        self.out("{", 1)
         self.out("EncodedMessage buffer;", 2)
-        self.out("Encoder::append(buffer, decoder_magic());", 2)
-        self.out("Encoder::append(buffer, id());", 2)
-        if msg.protected:
-            self.out("Encoder::append(buffer, key());", 2)
-        for i in msg.params:
-            self.out("Encoder::append(buffer, m_{0});".format(i[1]), 2)
-
+        self.out("buffer.resize(encoded_size());", 2)
+        self.out("encode_to(buffer.data());", 2)
         self.out("return buffer;", 2)
         self.out("}", 1)
 
     def generate_message(self, msg):
         self.out("class {0} : public Message {{".format(msg.name))
         self.out("public:")
+        self.message_create_layout(msg)
+        self.message_create_view(msg)
         self.message_create_constructor(msg)
+        self.message_create_view_constructor(msg)
         self.message_create_std_funcs(msg)
         self.message_create_encoder(msg)
         self.out("private:")
@@ -97,28 +191,6 @@ class Generator:
         self.out("};")
         self.out("")
 
-    def decoder_create_vars(self, messages, offset=0):
-        var_names = set()
-        for (name, params) in messages.items():
-            for i in params:
-                if 'var_{0}'.format(i[1]) not in var_names:
-                    self.out("{0} var_{1};".format(i[0], i[1]), offset)
-                    var_names.add('var_{0}'.format(i[1]))
-
-    def decoder_decode_message(self, msg, offset=0):
-        params_str = ""
-        if msg.protected:
-            params_str = "secret_key, "
-        for i in msg.params:
-            params_str += "var_{0}, ".format(i[1])
-
-        if len(params_str) > 0:
-            params_str = params_str[:-2]
-        for i in msg.params:
-            self.out(
-                "Encoder::decode(buf, decoded_msg_len, var_{0});".format(i[1]), offset)
-        self.out("return new {0}({1});".format(msg.name, params_str), offset)
-
     def decoder_create_std_funcs(self, decoder):
         self.out("int magic() const {{ return {0}; }}".format(
             decoder.magic), 1)
@@ -127,38 +199,33 @@ class Generator:
         self.out(
             "std::unique_ptr<Message> decode(const char* buf, size_t size, size_t& decoded_msg_len) override", 1)
         self.out("{", 1)
-        self.out("int msg_id, decoder_magic;", 2)
-        self.out("size_t saved_dml = decoded_msg_len;", 2)
-        self.out("Encoder::decode(buf, decoded_msg_len, decoder_magic);", 2)
-        self.out("Encoder::decode(buf, decoded_msg_len, msg_id);", 2)
-        self.out("if (magic() != decoder_magic) {", 2)
-        self.out("decoded_msg_len = saved_dml;", 3)
+        self.out("const uint8_t* msg = (const uint8_t*)buf;", 2)
+        self.out("LIPC::MessageHeader header;", 2)
+        self.out("if (size < sizeof(header)) {", 2)
+        self.out("return nullptr;", 3)
+        self.out("}", 2)
+        self.out("memcpy(&header, msg, sizeof(header));", 2)
+        self.out("if (magic() != header.decoder_magic) {", 2)
         self.out("return nullptr;", 3)
         self.out("}", 2)
-
-        if decoder.protected:
-            self.out("message_key_t secret_key;", 2)
-            self.out("Encoder::decode(buf, decoded_msg_len, secret_key);", 2)
-            self.out("", 0)
-
-        self.decoder_create_vars(decoder.messages, 2)
 
         unique_msg_id = 1
-        self.out("", 2)
-        self.out("switch(msg_id) {", 2)
+        self.out("", 0)
+        self.out("switch (header.id) {", 2)
         for (name, params) in decoder.messages.items():
             self.out("case {0}:".format(unique_msg_id), 2)
-            # Here it doen't need to know the real reply_id, so we can put 0 here.
-            self.decoder_decode_message(
-                Message(name, unique_msg_id, 0, decoder.magic, params, decoder.protected), 3)
+            self.out("if (!{0}::View::validate(msg, size)) {{".format(name), 3)
+            self.out("return nullptr;", 4)
+            self.out("}", 3)
+            self.out("decoded_msg_len += header.size;", 3)
+            self.out("return new {0}({0}::View(msg));".format(name), 3)
             unique_msg_id += 1
 
         self.out("default:", 2)
-        self.out("decoded_msg_len = saved_dml;", 3)
         self.out("return nullptr;", 3)
         self.out("}", 2)
         self.out("}", 1)
-        self.out("", 1)
+        self.out("", 0)
 
     def decoder_create_handle(self, decoder):
         self.out("std::unique_ptr<Message> handle(Message& msg) override", 1)
@@ -205,13 +272,14 @@ class Generator:
         self.out("// See .ipc file")
         self.out("")
         self.out("#pragma once")
-        self.out("#include <libipc/Encoder.h>")
+        self.out("#include <cstring>")
+        self.out("#include <libg/Rect.h>")
         self.out("#include <libipc/ClientConnection.h>")
         self.out("#include <libipc/ServerConnection.h>")
         self.out("#include <libipc/StringEncoder.h>")
         self.out("#include <libipc/VectorEncoder.h>")
+        self.out("#include <libipc/Wire.h>")
         self.out("#include <new>")
-        self.out("#include <libg/Rect.h>")
         self.out("")
 
     def generate(self, filename, decoders):
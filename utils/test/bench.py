@@ -33,10 +33,13 @@ def print_results():
     mper = 0.0
     for key, value in sum_of_benchs.items():
         new_val = int(value / count_of_benchs[key])
-        percent = (1 - new_val /
-                   expected_benchmark_results[target_arch][key]) * 100
-        res.append([key, expected_benchmark_results[target_arch][key],
-                    new_val, "{:.2f}%".format(percent)])
+        expected = expected_benchmark_results[target_arch].get(key, None)
+        if expected is None:
+            # No baseline yet, just report the number.
+            res.append([key, "-", new_val, "-"])
+            continue
+        percent = (1 - new_val / expected) * 100
+        res.append([key, expected, new_val, "{:.2f}%".format(percent)])
         mper = min(mper, percent)
 
     data = tabulate(